@@ -13,6 +13,8 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -20,21 +22,37 @@
 #include "google/protobuf/descriptor.pb.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_check.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor_database.h"
 #include "google/protobuf/dynamic_message.h"
+#include "google/protobuf/io/tokenizer.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 #include "google/protobuf/json/json.h"
+#include "google/protobuf/message_equality.h"
+#include "google/protobuf/parse_projection.h"
+#include "google/protobuf/text_format.h"
+#include "google/protobuf/util/message_differencer.h"
+#include "benchmarks/blob.pb.h"
 #include "benchmarks/descriptor.pb.h"
 #include "benchmarks/descriptor.upb.h"
 #include "benchmarks/descriptor.upb_minitable.h"
 #include "benchmarks/descriptor.upbdefs.h"
 #include "benchmarks/descriptor_sv.pb.h"
+#include "benchmarks/descriptor_unrolled.pb.h"
+#include "benchmarks/keyed_maps.upb.h"
+#include "benchmarks/wide.pb.h"
+#include "benchmarks/wide.upb.h"
 #include "upb/base/status.h"
 #include "upb/base/string_view.h"
 #include "upb/base/upcast.h"
 #include "upb/json/decode.h"
 #include "upb/json/encode.h"
 #include "upb/mem/arena.h"
+#include "upb/message/copy.h"
+#include "upb/message/map.h"
 #include "upb/message/message.h"
 #include "upb/mini_table/message.h"
 #include "upb/reflection/def.h"
@@ -42,6 +60,7 @@
 #include "upb/reflection/internal/def_pool.h"
 #include "upb/wire/decode.h"
 #include "upb/wire/encode.h"
+#include "upb/wire/find_path.h"
 
 upb_StringView descriptor =
     benchmarks_descriptor_proto_upbdefinit.descriptor;
@@ -126,6 +145,95 @@ static void BM_ArenaFuseBalanced(benchmark::State& state) {
 }
 BENCHMARK(BM_ArenaFuseBalanced)->Range(2, 128);
 
+// The benchmarks below run the same loop on 1 to 64 threads, so comparing the
+// reported real time per thread count shows how fusing and refcounting scale.
+static constexpr int kMaxArenaThreads = 64;
+
+// Fuses and frees private pairs of arenas: no fuse state is shared between
+// threads.
+static void BM_ArenaFuseFreeThreaded(benchmark::State& state) {
+  for (auto _ : state) {
+    upb_Arena* a = upb_Arena_New();
+    upb_Arena* b = upb_Arena_New();
+    ABSL_CHECK(upb_Arena_Fuse(a, b));
+    upb_Arena_Free(a);
+    upb_Arena_Free(b);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ArenaFuseFreeThreaded)
+    ->ThreadRange(1, kMaxArenaThreads)
+    ->UseRealTime();
+
+static upb_Arena* shared_arena;
+static upb_Arena* shared_arena_child;
+
+// Every thread fuses new arenas into the same group and frees them, so all of
+// them update the refcount of one root.  Fused arenas are only freed along
+// with their whole group, so the iteration count is capped to bound memory.
+static void BM_ArenaFuseSharedThreaded(benchmark::State& state) {
+  if (state.thread_index() == 0) shared_arena = upb_Arena_New();
+  for (auto _ : state) {
+    upb_Arena* arena = upb_Arena_New();
+    ABSL_CHECK(upb_Arena_Fuse(shared_arena, arena));
+    upb_Arena_Free(arena);
+  }
+  if (state.thread_index() == 0) upb_Arena_Free(shared_arena);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ArenaFuseSharedThreaded)
+    ->ThreadRange(1, kMaxArenaThreads)
+    ->Iterations(4096)
+    ->UseRealTime();
+
+// Every thread takes and drops refs on a non-root arena of a shared group, as
+// messages that alias a shared arena from many threads do.
+static void BM_ArenaRefSharedThreaded(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_arena = upb_Arena_New();
+    shared_arena_child = upb_Arena_New();
+    ABSL_CHECK(upb_Arena_Fuse(shared_arena, shared_arena_child));
+  }
+  for (auto _ : state) {
+    ABSL_CHECK(upb_Arena_IncRefFor(shared_arena_child, nullptr));
+    upb_Arena_DecRefFor(shared_arena_child, nullptr);
+  }
+  if (state.thread_index() == 0) {
+    upb_Arena_Free(shared_arena_child);
+    upb_Arena_Free(shared_arena);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ArenaRefSharedThreaded)
+    ->ThreadRange(1, kMaxArenaThreads)
+    ->UseRealTime();
+
+static upb_Arena* thread_arenas[kMaxArenaThreads];
+
+// Every thread allocates from its own arena while the next thread takes and
+// drops refs on it, which exposes any false sharing between the allocation
+// pointer and the refcount.
+static void BM_ArenaAllocWhileRefThreaded(benchmark::State& state) {
+  const int index = state.thread_index();
+  thread_arenas[index] = upb_Arena_New();
+  for (auto _ : state) {
+    upb_Arena* arena = thread_arenas[index];
+    upb_Arena* neighbor = thread_arenas[(index + 1) % state.threads()];
+    for (int i = 0; i < 16; i++) {
+      void* ptr = upb_Arena_Malloc(arena, 16);
+      benchmark::DoNotOptimize(ptr);
+      upb_Arena_ShrinkLast(arena, ptr, 16, 0);
+    }
+    ABSL_CHECK(upb_Arena_IncRefFor(neighbor, nullptr));
+    upb_Arena_DecRefFor(neighbor, nullptr);
+  }
+  upb_Arena_Free(thread_arenas[index]);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ArenaAllocWhileRefThreaded)
+    ->ThreadRange(1, kMaxArenaThreads)
+    ->UseRealTime();
+
 enum LoadDescriptorMode {
   NoLayout,
   WithLayout,
@@ -197,6 +305,112 @@ static void BM_LoadAdsDescriptor_Proto2(benchmark::State& state) {
 BENCHMARK_TEMPLATE(BM_LoadAdsDescriptor_Proto2, NoLayout);
 BENCHMARK_TEMPLATE(BM_LoadAdsDescriptor_Proto2, WithLayout);
 
+static void BM_LoadAdsDescriptor_Proto2Snapshot(benchmark::State& state) {
+  extern _upb_DefPool_Init
+      google_ads_googleads_v17_services_google_ads_service_proto_upbdefinit;
+  std::vector<upb_StringView> serialized_files;
+  absl::flat_hash_set<const _upb_DefPool_Init*> seen_files;
+  CollectFileDescriptors(
+      &google_ads_googleads_v17_services_google_ads_service_proto_upbdefinit,
+      serialized_files, seen_files);
+  // Producing the snapshot would normally happen at build time.
+  std::string snapshot;
+  {
+    protobuf::DescriptorPool pool;
+    std::vector<const protobuf::FileDescriptor*> files;
+    for (auto file : serialized_files) {
+      protobuf::FileDescriptorProto proto;
+      const protobuf::FileDescriptor* built = nullptr;
+      if (proto.ParseFromArray(file.data, file.size)) {
+        built = pool.BuildFile(proto);
+      }
+      if (built == nullptr) {
+        printf("Failed to add file.\n");
+        exit(1);
+      }
+      files.push_back(built);
+    }
+    snapshot = protobuf::DescriptorPool::SerializeSnapshot(files);
+  }
+  for (auto _ : state) {
+    protobuf::DescriptorPool pool;
+    if (!pool.LoadSnapshot(snapshot)) {
+      printf("Failed to load snapshot.\n");
+      exit(1);
+    }
+    benchmark::DoNotOptimize(&pool);
+  }
+  state.SetBytesProcessed(state.iterations() * snapshot.size());
+}
+BENCHMARK(BM_LoadAdsDescriptor_Proto2Snapshot);
+
+enum DatabaseIndexing {
+  Eager,
+  Lazy,
+};
+
+static std::vector<std::string> MakeManyFiles(int count) {
+  std::vector<std::string> serialized_files;
+  for (int i = 0; i < count; ++i) {
+    protobuf::FileDescriptorProto file;
+    file.set_name(absl::StrCat("file", i, ".proto"));
+    file.set_package(absl::StrCat("pkg", i));
+    for (int j = 0; j < 10; ++j) {
+      auto* message = file.add_message_type();
+      message->set_name(absl::StrCat("M", j));
+      auto* field = message->add_field();
+      field->set_name("f");
+      field->set_number(1);
+      field->set_label(protobuf::FieldDescriptorProto::LABEL_OPTIONAL);
+      field->set_type(protobuf::FieldDescriptorProto::TYPE_INT32);
+    }
+    serialized_files.push_back(file.SerializeAsString());
+  }
+  return serialized_files;
+}
+
+// Registering many files with an EncodedDescriptorDatabase, as generated code
+// does before main().
+template <DatabaseIndexing Indexing>
+static void BM_GeneratedDatabaseRegister(benchmark::State& state) {
+  std::vector<std::string> serialized_files = MakeManyFiles(state.range(0));
+  for (auto _ : state) {
+    protobuf::EncodedDescriptorDatabase db;
+    for (const std::string& file : serialized_files) {
+      if (Indexing == Lazy) {
+        db.AddLazily(file.data(), file.size());
+      } else {
+        ABSL_CHECK(db.Add(file.data(), file.size()));
+      }
+    }
+    benchmark::DoNotOptimize(&db);
+  }
+}
+BENCHMARK_TEMPLATE(BM_GeneratedDatabaseRegister, Eager)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_GeneratedDatabaseRegister, Lazy)->Arg(10000);
+
+// Time from registering the files to the first descriptor lookup.
+template <DatabaseIndexing Indexing>
+static void BM_GeneratedDatabaseFirstLookup(benchmark::State& state) {
+  std::vector<std::string> serialized_files = MakeManyFiles(state.range(0));
+  const std::string name = absl::StrCat("pkg", state.range(0) / 2, ".M0");
+  for (auto _ : state) {
+    protobuf::EncodedDescriptorDatabase db;
+    for (const std::string& file : serialized_files) {
+      if (Indexing == Lazy) {
+        db.AddLazily(file.data(), file.size());
+      } else {
+        ABSL_CHECK(db.Add(file.data(), file.size()));
+      }
+    }
+    protobuf::DescriptorPool pool(&db);
+    pool.InternalSetLazilyBuildDependencies();
+    ABSL_CHECK(pool.FindMessageTypeByName(name) != nullptr);
+  }
+}
+BENCHMARK_TEMPLATE(BM_GeneratedDatabaseFirstLookup, Eager)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_GeneratedDatabaseFirstLookup, Lazy)->Arg(10000);
+
 enum CopyStrings {
   Copy,
   Alias,
@@ -270,6 +484,88 @@ BENCHMARK_TEMPLATE(BM_Parse_Upb_FileDesc, Parsed, UseArena, Alias);
 BENCHMARK_TEMPLATE(BM_Parse_Upb_FileDesc, Parsed, InitBlock, Copy);
 BENCHMARK_TEMPLATE(BM_Parse_Upb_FileDesc, Parsed, InitBlock, Alias);
 
+// Projected parses of descriptor.proto select the file name, the package and
+// the names of top-level messages: a small fraction of the fields, which is
+// typical of readers that only look at a few fields of a wide message.
+static const uint32_t kProjectionName[] = {1};
+static const uint32_t kProjectionPackage[] = {2};
+static const uint32_t kProjectionMessageName[] = {4, 1};
+
+template <CopyStrings Copy>
+static void BM_Parse_Upb_FileDesc_Projected(benchmark::State& state) {
+  const upb_MiniTable* mt = &upb_0benchmark__FileDescriptorProto_msg_init;
+  upb_Arena* projection_arena = upb_Arena_New();
+  upb_DecodeProjection* projection =
+      upb_DecodeProjection_New(projection_arena);
+  ABSL_CHECK(upb_DecodeProjection_AddPath(projection, kProjectionName, 1,
+                                          projection_arena));
+  ABSL_CHECK(upb_DecodeProjection_AddPath(projection, kProjectionPackage, 1,
+                                          projection_arena));
+  ABSL_CHECK(upb_DecodeProjection_AddPath(projection, kProjectionMessageName,
+                                          2, projection_arena));
+
+  for (auto _ : state) {
+    upb_Arena* arena = upb_Arena_Init(buf, sizeof(buf), nullptr);
+    upb_Message* set = upb_Message_New(mt, arena);
+    upb_DecodeStatus status = upb_DecodeWithProjection(
+        descriptor.data, descriptor.size, set, mt, nullptr, projection,
+        Copy == Alias ? kUpb_DecodeOption_AliasString : 0, arena);
+    if (status != kUpb_DecodeStatus_Ok) {
+      printf("Failed to parse with status %d.\n", status);
+      exit(1);
+    }
+    benchmark::DoNotOptimize(set);
+    upb_Arena_Free(arena);
+  }
+  upb_Arena_Free(projection_arena);
+  state.SetBytesProcessed(state.iterations() * descriptor.size);
+}
+BENCHMARK_TEMPLATE(BM_Parse_Upb_FileDesc_Projected, Copy);
+BENCHMARK_TEMPLATE(BM_Parse_Upb_FileDesc_Projected, Alias);
+
+enum StatsMode {
+  NoStats,
+  Unsampled,
+  Sampled,
+};
+
+// Parses with the MiniTable decoder, which records the fields of sampled
+// upb_DecodeWithStats() calls. NoStats is plain upb_Decode(), and must not
+// regress from the per-field stats check; Unsampled is upb_DecodeWithStats()
+// on decodes that are not sampled, and Sampled records every decode.
+template <StatsMode SMode>
+static void BM_Parse_Upb_FileDesc_MiniTableDecoder(benchmark::State& state) {
+  const upb_MiniTable* mt = &upb_0benchmark__FileDescriptorProto_msg_init;
+  const int options = kUpb_DecodeOption_DisableFastTable;
+  upb_Arena* stats_arena = upb_Arena_New();
+  upb_DecodeStats* stats = upb_DecodeStats_New(
+      SMode == Sampled ? 1 : std::numeric_limits<uint32_t>::max(),
+      stats_arena);
+  ABSL_CHECK(stats);
+
+  for (auto _ : state) {
+    upb_Arena* arena = upb_Arena_Init(buf, sizeof(buf), nullptr);
+    upb_Message* set = upb_Message_New(mt, arena);
+    upb_DecodeStatus status =
+        SMode == NoStats
+            ? upb_Decode(descriptor.data, descriptor.size, set, mt, nullptr,
+                         options, arena)
+            : upb_DecodeWithStats(descriptor.data, descriptor.size, set, mt,
+                                  nullptr, options, arena, stats);
+    if (status != kUpb_DecodeStatus_Ok) {
+      printf("Failed to parse with status %d.\n", status);
+      exit(1);
+    }
+    benchmark::DoNotOptimize(set);
+    upb_Arena_Free(arena);
+  }
+  upb_Arena_Free(stats_arena);
+  state.SetBytesProcessed(state.iterations() * descriptor.size);
+}
+BENCHMARK_TEMPLATE(BM_Parse_Upb_FileDesc_MiniTableDecoder, NoStats);
+BENCHMARK_TEMPLATE(BM_Parse_Upb_FileDesc_MiniTableDecoder, Unsampled);
+BENCHMARK_TEMPLATE(BM_Parse_Upb_FileDesc_MiniTableDecoder, Sampled);
+
 template <ArenaMode AMode, class P>
 struct Proto2Factory;
 
@@ -310,6 +606,8 @@ struct Proto2Factory<InitBlock, P> {
 
 using FileDesc = ::upb_benchmark::FileDescriptorProto;
 using FileDescSV = ::upb_benchmark::sv::FileDescriptorProto;
+// Same schema, generated with `features.(pb.cpp).unrolled_codegen`.
+using FileDescUnrolled = ::upb_benchmark::unrolled::FileDescriptorProto;
 
 template <class P, ArenaMode AMode, CopyStrings kCopy>
 void BM_Parse_Proto2(benchmark::State& state) {
@@ -334,9 +632,283 @@ BENCHMARK_TEMPLATE(BM_Parse_Proto2, FileDesc, NoArena, Copy);
 BENCHMARK_TEMPLATE(BM_Parse_Proto2, FileDesc, UseArena, Copy);
 BENCHMARK_TEMPLATE(BM_Parse_Proto2, FileDesc, InitBlock, Copy);
 BENCHMARK_TEMPLATE(BM_Parse_Proto2, FileDescSV, InitBlock, Alias);
+BENCHMARK_TEMPLATE(BM_Parse_Proto2, FileDescUnrolled, NoArena, Copy);
+BENCHMARK_TEMPLATE(BM_Parse_Proto2, FileDescUnrolled, InitBlock, Copy);
+
+// Parses a message dominated by large string fields, using a DynamicMessage so
+// that its string_view fields use the MicroString representation whenever the
+// runtime supports it (PROTOBUF_ENABLE_EXPERIMENTAL_MICRO_STRING).  Only those
+// fields can alias the input; the Alias variant is skipped when they do not,
+// since it would then measure the same code as the Copy variant.
+template <CopyStrings kCopy>
+void BM_Parse_Proto2_LargeStrings(benchmark::State& state) {
+  FileDescSV source;
+  const std::string payload(state.range(0), 'x');
+  source.set_name(payload);
+  source.set_package(payload);
+  for (int i = 0; i < 16; ++i) {
+    source.add_message_type()->set_name(payload);
+  }
+  const std::string input = source.SerializeAsString();
+  protobuf::DynamicMessageFactory factory;
+  const protobuf::Message* prototype =
+      factory.GetPrototype(FileDescSV::descriptor());
+  const auto parse = [&](protobuf::Message* proto) {
+    return kCopy == Copy ? proto->ParseFromString(input)
+                         : proto->ParseFromStringWithAliasing(input);
+  };
 
+  if (kCopy == Alias) {
+    std::unique_ptr<protobuf::Message> probe(prototype->New());
+    ABSL_CHECK(parse(probe.get()));
+    const protobuf::FieldDescriptor* name_field =
+        FileDescSV::descriptor()->FindFieldByName("name");
+    protobuf::Reflection::ScratchSpace scratch;
+    absl::string_view name =
+        probe->GetReflection()->GetStringView(*probe, name_field, scratch);
+    if (name.data() < input.data() ||
+        name.data() >= input.data() + input.size()) {
+      state.SkipWithError(
+          "string fields do not alias the input in this build; enable "
+          "PROTOBUF_ENABLE_EXPERIMENTAL_MICRO_STRING");
+      return;
+    }
+  }
+
+  for (auto _ : state) {
+    protobuf::Arena arena;
+    protobuf::Message* proto = prototype->New(&arena);
+    if (!parse(proto)) {
+      printf("Failed to parse.\n");
+      exit(1);
+    }
+    benchmark::DoNotOptimize(proto);
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK_TEMPLATE(BM_Parse_Proto2_LargeStrings, Copy)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_Parse_Proto2_LargeStrings, Alias)->Range(64, 64 << 10);
+
+// Parses a message with a single large Cord field. When the input is itself a
+// Cord the parsed field shares the input's chunks; from a flat string it must
+// copy the payload.
+enum BlobInput { FlatInput, CordInput };
+
+template <BlobInput kInput>
+void BM_Parse_Proto2_CordBlob(benchmark::State& state) {
+  upb_benchmark::Blob source;
+  source.set_name("blob");
+  source.set_payload(std::string(state.range(0), 'x'));
+  const std::string flat = source.SerializeAsString();
+  // Moving a large string into a Cord wraps it without copying, like a Cord
+  // received from the network would.
+  const absl::Cord cord(std::string{flat});
+  for (auto _ : state) {
+    upb_benchmark::Blob proto;
+    bool ok = kInput == FlatInput ? proto.ParseFromString(flat)
+                                  : proto.ParseFromCord(cord);
+    if (!ok) {
+      printf("Failed to parse.\n");
+      exit(1);
+    }
+    benchmark::DoNotOptimize(proto);
+  }
+  state.SetBytesProcessed(state.iterations() * flat.size());
+}
+BENCHMARK_TEMPLATE(BM_Parse_Proto2_CordBlob, FlatInput)
+    ->RangeMultiplier(4)
+    ->Range(1 << 20, 64 << 20);
+BENCHMARK_TEMPLATE(BM_Parse_Proto2_CordBlob, CordInput)
+    ->RangeMultiplier(4)
+    ->Range(1 << 20, 64 << 20);
+
+template <ArenaMode AMode>
+void BM_Parse_Proto2_Projected(benchmark::State& state) {
+  // Same selection as BM_Parse_Upb_FileDesc_Projected.
+  const protobuf::ParseProjection projection({{1}, {2}, {4, 1}});
+  for (auto _ : state) {
+    Proto2Factory<AMode, FileDesc> proto_factory;
+    auto proto = proto_factory.GetProto();
+    absl::string_view input(descriptor.data, descriptor.size);
+    bool ok = projection.MergePartialFromString(input, proto);
+    if (!ok) {
+      printf("Failed to parse.\n");
+      exit(1);
+    }
+    benchmark::DoNotOptimize(proto);
+  }
+  state.SetBytesProcessed(state.iterations() * descriptor.size);
+}
+BENCHMARK_TEMPLATE(BM_Parse_Proto2_Projected, NoArena);
+BENCHMARK_TEMPLATE(BM_Parse_Proto2_Projected, InitBlock);
+
+// Projected parses of a wide message that select 5 of its 100 fields (5%),
+// against full parses of the same payload.
+enum WideParse { WideFull, WideProjected };
+static const uint32_t kWideProjectedFields[] = {1, 23, 47, 70, 96};
+
+static const std::string& WidePayload() {
+  static const std::string* payload = [] {
+    upb_benchmark::Wide msg;
+    const protobuf::Descriptor* d = msg.GetDescriptor();
+    const protobuf::Reflection* r = msg.GetReflection();
+    for (int i = 0; i < d->field_count(); ++i) {
+      const protobuf::FieldDescriptor* f = d->field(i);
+      switch (f->cpp_type()) {
+        case protobuf::FieldDescriptor::CPPTYPE_INT32:
+          r->SetInt32(&msg, f, 1000 * i);
+          break;
+        case protobuf::FieldDescriptor::CPPTYPE_INT64:
+          r->SetInt64(&msg, f, int64_t{1000000007} * i);
+          break;
+        case protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+          r->SetDouble(&msg, f, 0.5 * i);
+          break;
+        default:
+          r->SetString(&msg, f, absl::StrCat("wide field value ", i));
+          break;
+      }
+    }
+    return new std::string(msg.SerializeAsString());
+  }();
+  return *payload;
+}
+
+template <WideParse kParse>
+static void BM_Parse_Upb_Wide(benchmark::State& state) {
+  const upb_MiniTable* mt = &upb_0benchmark__Wide_msg_init;
+  const std::string& payload = WidePayload();
+  upb_Arena* projection_arena = upb_Arena_New();
+  upb_DecodeProjection* projection = nullptr;
+  if (kParse == WideProjected) {
+    projection = upb_DecodeProjection_New(projection_arena);
+    for (uint32_t number : kWideProjectedFields) {
+      ABSL_CHECK(upb_DecodeProjection_AddPath(projection, &number, 1,
+                                              projection_arena));
+    }
+  }
+  for (auto _ : state) {
+    upb_Arena* arena = upb_Arena_Init(buf, sizeof(buf), nullptr);
+    upb_Message* msg = upb_Message_New(mt, arena);
+    upb_DecodeStatus status =
+        kParse == WideFull
+            ? upb_Decode(payload.data(), payload.size(), msg, mt, nullptr, 0,
+                         arena)
+            : upb_DecodeWithProjection(payload.data(), payload.size(), msg,
+                                       mt, nullptr, projection, 0, arena);
+    ABSL_CHECK(status == kUpb_DecodeStatus_Ok);
+    benchmark::DoNotOptimize(msg);
+    upb_Arena_Free(arena);
+  }
+  upb_Arena_Free(projection_arena);
+  state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK_TEMPLATE(BM_Parse_Upb_Wide, WideFull);
+BENCHMARK_TEMPLATE(BM_Parse_Upb_Wide, WideProjected);
+
+template <WideParse kParse>
+static void BM_Parse_Proto2_Wide(benchmark::State& state) {
+  const std::string& payload = WidePayload();
+  protobuf::ParseProjection projection;
+  for (uint32_t number : kWideProjectedFields) {
+    ABSL_CHECK(projection.AddPath({static_cast<int>(number)}));
+  }
+  for (auto _ : state) {
+    protobuf::Arena arena(reinterpret_cast<char*>(buf), sizeof(buf));
+    auto* msg = protobuf::Arena::Create<upb_benchmark::Wide>(&arena);
+    bool ok = kParse == WideProjected
+                  ? projection.MergePartialFromString(payload, msg)
+                  : msg->ParseFromString(payload);
+    ABSL_CHECK(ok);
+    benchmark::DoNotOptimize(msg);
+  }
+  state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK_TEMPLATE(BM_Parse_Proto2_Wide, WideFull);
+BENCHMARK_TEMPLATE(BM_Parse_Proto2_Wide, WideProjected);
+
+// Extracts a single field from the serialized descriptor without parsing it,
+// for comparison with the full parses above.
+enum FindPathMode { LastMatch, FirstMatch };
+
+template <FindPathMode Mode>
+static void BM_FindPath_Upb_FileDesc(benchmark::State& state) {
+  // The package, which is near the start of the input.
+  const uint32_t path[] = {2};
+  for (auto _ : state) {
+    upb_WireValue value;
+    upb_FindPath_Status status = upb_Wire_FindPath(
+        descriptor.data, descriptor.size, path, 1,
+        Mode == FirstMatch ? kUpb_FindPathOption_FirstMatch : 0, &value);
+    if (status != kUpb_FindPath_Ok) {
+      printf("Failed to find field with status %d.\n", status);
+      exit(1);
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetBytesProcessed(state.iterations() * descriptor.size);
+}
+BENCHMARK_TEMPLATE(BM_FindPath_Upb_FileDesc, LastMatch);
+BENCHMARK_TEMPLATE(BM_FindPath_Upb_FileDesc, FirstMatch);
+
+static void BM_FindPathBatch_Upb_FileDesc(benchmark::State& state) {
+  // The name of the last top-level message, which requires a full scan.
+  const uint32_t path[] = {4, 1};
+  std::vector<upb_StringView> inputs(state.range(0), descriptor);
+  std::vector<upb_WireValue> values(inputs.size());
+  std::vector<upb_FindPath_Status> statuses(inputs.size());
+  for (auto _ : state) {
+    size_t found =
+        upb_Wire_FindPathBatch(inputs.data(), inputs.size(), path, 2, 0,
+                               values.data(), statuses.data());
+    if (found != inputs.size()) {
+      printf("Failed to find field.\n");
+      exit(1);
+    }
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetBytesProcessed(state.iterations() * inputs.size() *
+                          descriptor.size);
+}
+BENCHMARK(BM_FindPathBatch_Upb_FileDesc)->Range(1, 1024);
+
+// Compares two equal copies of the parsed descriptor, which visits every
+// field.
+enum EqualsMode { TableDriven, Differencer };
+
+template <EqualsMode Mode>
+static void BM_Equals_Proto2(benchmark::State& state) {
+  FileDesc a;
+  ABSL_CHECK(a.ParseFromString(
+      absl::string_view(descriptor.data, descriptor.size)));
+  FileDesc b = a;
+  for (auto _ : state) {
+    bool equal = Mode == TableDriven
+                     ? protobuf::MessageEquals(a, b)
+                     : protobuf::util::MessageDifferencer::Equals(a, b);
+    ABSL_CHECK(equal);
+    benchmark::DoNotOptimize(equal);
+  }
+  state.SetBytesProcessed(state.iterations() * descriptor.size);
+}
+BENCHMARK_TEMPLATE(BM_Equals_Proto2, TableDriven);
+BENCHMARK_TEMPLATE(BM_Equals_Proto2, Differencer);
+
+static void BM_Hash_Proto2(benchmark::State& state) {
+  FileDesc proto;
+  ABSL_CHECK(proto.ParseFromString(
+      absl::string_view(descriptor.data, descriptor.size)));
+  for (auto _ : state) {
+    size_t hash = protobuf::MessageHash(proto);
+    benchmark::DoNotOptimize(hash);
+  }
+  state.SetBytesProcessed(state.iterations() * descriptor.size);
+}
+BENCHMARK(BM_Hash_Proto2);
+
+template <class P>
 static void BM_SerializeDescriptor_Proto2(benchmark::State& state) {
-  upb_benchmark::FileDescriptorProto proto;
+  P proto;
   (void)proto.ParseFromString(
       absl::string_view(descriptor.data, descriptor.size));
   for (auto _ : state) {
@@ -345,7 +917,8 @@ static void BM_SerializeDescriptor_Proto2(benchmark::State& state) {
   }
   state.SetBytesProcessed(state.iterations() * descriptor.size);
 }
-BENCHMARK(BM_SerializeDescriptor_Proto2);
+BENCHMARK_TEMPLATE(BM_SerializeDescriptor_Proto2, FileDesc);
+BENCHMARK_TEMPLATE(BM_SerializeDescriptor_Proto2, FileDescUnrolled);
 
 template <MinitableMode MMode, ArenaMode AMode>
 static void BM_SerializeDescriptor_Upb(benchmark::State& state) {
@@ -389,6 +962,95 @@ BENCHMARK_TEMPLATE(BM_SerializeDescriptor_Upb, CompiledIn, InitBlock);
 BENCHMARK_TEMPLATE(BM_SerializeDescriptor_Upb, Parsed, UseArena);
 BENCHMARK_TEMPLATE(BM_SerializeDescriptor_Upb, Parsed, InitBlock);
 
+// Parses descriptor.proto, renames its first message and serializes it again,
+// as a proxy that rewrites one field of each request it forwards.
+enum RetainMode { Reencode, RetainEncoding };
+
+template <RetainMode Mode>
+static void BM_ParseModifySerialize_Upb(benchmark::State& state) {
+  const int options =
+      kUpb_DecodeOption_AliasString |
+      (Mode == RetainEncoding ? kUpb_DecodeOption_RetainEncoding : 0);
+  const upb_StringView new_name = upb_StringView_FromString("Renamed");
+
+  for (auto _ : state) {
+    upb_Arena* arena = upb_Arena_Init(buf, sizeof(buf), nullptr);
+    upb_benchmark_FileDescriptorProto* file =
+        upb_benchmark_FileDescriptorProto_parse_ex(
+            descriptor.data, descriptor.size, nullptr, options, arena);
+    ABSL_CHECK(file != nullptr);
+
+    size_t count;
+    upb_benchmark_DescriptorProto** messages =
+        upb_benchmark_FileDescriptorProto_mutable_message_type(file, &count);
+    ABSL_CHECK(count > 0);
+    if (Mode == RetainEncoding) {
+      // Retained submessages are frozen; modify a copy instead.
+      messages[0] = (upb_benchmark_DescriptorProto*)upb_Message_ShallowClone(
+          UPB_UPCAST(messages[0]), &upb_0benchmark__DescriptorProto_msg_init,
+          arena);
+      ABSL_CHECK(messages[0] != nullptr);
+    }
+    upb_benchmark_DescriptorProto_set_name(messages[0], new_name);
+
+    size_t size;
+    char* data = upb_benchmark_FileDescriptorProto_serialize(file, arena, &size);
+    ABSL_CHECK(data != nullptr);
+    benchmark::DoNotOptimize(data);
+    upb_Arena_Free(arena);
+  }
+  state.SetBytesProcessed(state.iterations() * descriptor.size);
+}
+BENCHMARK_TEMPLATE(BM_ParseModifySerialize_Upb, Reencode);
+BENCHMARK_TEMPLATE(BM_ParseModifySerialize_Upb, RetainEncoding);
+
+// Deterministically serializes a message holding a string-keyed and an
+// int-keyed map of `state.range(0)` entries each, as when content-hashing the
+// same large maps repeatedly.
+enum SortedKeysMode { SortEachTime, CachedSortedKeys };
+
+template <SortedKeysMode Mode>
+static void BM_SerializeDeterministicMap_Upb(benchmark::State& state) {
+  upb_Arena* arena = upb_Arena_New();
+  upb_benchmark_KeyedMaps* msg = upb_benchmark_KeyedMaps_new(arena);
+  const int64_t n = state.range(0);
+  for (int64_t i = 0; i < n; ++i) {
+    // Spread the keys so that insertion order is not sorted order.
+    int64_t key = i * 7919 % n;
+    std::string name = absl::StrCat("key", key);
+    ABSL_CHECK(upb_benchmark_KeyedMaps_by_name_set(
+        msg, upb_StringView_FromDataAndSize(name.data(), name.size()), i,
+        arena));
+    ABSL_CHECK(upb_benchmark_KeyedMaps_by_id_set(msg, key, i, arena));
+  }
+  if (Mode == CachedSortedKeys) {
+    ABSL_CHECK(upb_Map_CacheSortedKeys(
+        _upb_benchmark_KeyedMaps_by_name_mutable_upb_map(msg, arena),
+        kUpb_CType_String, arena));
+    ABSL_CHECK(upb_Map_CacheSortedKeys(
+        _upb_benchmark_KeyedMaps_by_id_mutable_upb_map(msg, arena),
+        kUpb_CType_Int64, arena));
+  }
+
+  size_t total = 0;
+  for (auto _ : state) {
+    upb_Arena* enc_arena = upb_Arena_New();
+    size_t size;
+    char* data = upb_benchmark_KeyedMaps_serialize_ex(
+        msg, kUpb_EncodeOption_Deterministic, enc_arena, &size);
+    ABSL_CHECK(data != nullptr);
+    total += size;
+    benchmark::DoNotOptimize(data);
+    upb_Arena_Free(enc_arena);
+  }
+  state.SetBytesProcessed(total);
+  upb_Arena_Free(arena);
+}
+BENCHMARK_TEMPLATE(BM_SerializeDeterministicMap_Upb, SortEachTime)
+    ->Range(1 << 10, 1 << 17);
+BENCHMARK_TEMPLATE(BM_SerializeDeterministicMap_Upb, CachedSortedKeys)
+    ->Range(1 << 10, 1 << 17);
+
 static absl::string_view UpbJsonEncode(upb_benchmark_FileDescriptorProto* proto,
                                        const upb_MessageDef* md,
                                        upb_Arena* arena) {
@@ -492,3 +1154,71 @@ static void BM_JsonSerialize_Proto2(benchmark::State& state) {
   state.SetBytesProcessed(state.iterations() * json.size());
 }
 BENCHMARK(BM_JsonSerialize_Proto2);
+
+// Returns a text-format FileDescriptorSet holding `copies` copies of
+// descriptor.proto, as a stand-in for a large hand-written config.
+static std::string TextFormatDescriptorSet(int copies) {
+  protobuf::FileDescriptorProto file;
+  ABSL_CHECK(file.ParseFromString(
+      absl::string_view(descriptor.data, descriptor.size)));
+  protobuf::FileDescriptorSet set;
+  for (int i = 0; i < copies; ++i) *set.add_file() = file;
+  std::string text;
+  ABSL_CHECK(protobuf::TextFormat::PrintToString(set, &text));
+  return text;
+}
+
+// Baseline for BM_TextFormatParse_Proto2: only runs the tokenizer over the
+// same input, unescaping string literals the way the parser does. The
+// difference between the two is the cost of field lookup and message
+// construction.
+static void BM_TextFormatTokenize_Proto2(benchmark::State& state) {
+  struct NullErrorCollector : protobuf::io::ErrorCollector {
+    void RecordError(int, protobuf::io::ColumnNumber,
+                     absl::string_view) override {}
+  };
+  const std::string text = TextFormatDescriptorSet(state.range(0));
+  NullErrorCollector errors;
+  std::string value;
+  for (auto _ : state) {
+    protobuf::io::ArrayInputStream input(text.data(), text.size());
+    protobuf::io::Tokenizer tokenizer(&input, &errors);
+    while (tokenizer.Next()) {
+      if (tokenizer.current().type == protobuf::io::Tokenizer::TYPE_STRING) {
+        value.clear();
+        protobuf::io::Tokenizer::ParseStringAppend(tokenizer.current().text,
+                                                   &value);
+        benchmark::DoNotOptimize(value);
+      }
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_TextFormatTokenize_Proto2)->Range(1, 64);
+
+static void BM_TextFormatParse_Proto2(benchmark::State& state) {
+  const std::string text = TextFormatDescriptorSet(state.range(0));
+  for (auto _ : state) {
+    protobuf::FileDescriptorSet parsed;
+    ABSL_CHECK(protobuf::TextFormat::ParseFromString(text, &parsed));
+    benchmark::DoNotOptimize(parsed);
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_TextFormatParse_Proto2)->Range(1, 64);
+
+static void BM_TextFormatPrint_Proto2(benchmark::State& state) {
+  protobuf::FileDescriptorProto file;
+  ABSL_CHECK(file.ParseFromString(
+      absl::string_view(descriptor.data, descriptor.size)));
+  protobuf::FileDescriptorSet set;
+  for (int i = 0; i < state.range(0); ++i) *set.add_file() = file;
+  std::string text;
+  for (auto _ : state) {
+    text.clear();
+    ABSL_CHECK(protobuf::TextFormat::PrintToString(set, &text));
+    benchmark::DoNotOptimize(text);
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_TextFormatPrint_Proto2)->Range(1, 64);
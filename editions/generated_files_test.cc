@@ -158,6 +158,7 @@ TEST(Generated, EditionDefaults2023InternalFeatures) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 }
               )pb"));
 }
@@ -193,6 +194,7 @@ TEST(Generated, EditionDefaults2024InternalFeatures) {
                   string_type: VIEW
                   enum_name_uses_string_view: true
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 }
               )pb"));
 }
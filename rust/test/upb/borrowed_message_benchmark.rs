@@ -0,0 +1,64 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+//! Compares copying and zero-copy parsing of messages with large string and
+//! bytes fields.
+//!
+//! bazel run -c opt //rust/test/upb:borrowed_message_benchmark
+
+use protobuf::prelude::*;
+use protobuf::BorrowedMessage;
+use std::hint::black_box;
+use std::time::{Duration, Instant};
+
+use unittest_rust_proto::TestAllTypes;
+
+/// Runs `f` repeatedly for about a second and prints the mean time per
+/// iteration and the throughput over `bytes` bytes of input.
+fn bench(name: &str, bytes: usize, mut f: impl FnMut()) {
+    // Warm up, and estimate how many iterations fit in the time budget.
+    let start = Instant::now();
+    let mut warmup_iters = 0u64;
+    while start.elapsed() < Duration::from_millis(100) {
+        f();
+        warmup_iters += 1;
+    }
+    let iters = warmup_iters * 10;
+    let start = Instant::now();
+    for _ in 0..iters {
+        f();
+    }
+    let elapsed = start.elapsed();
+    let ns_per_iter = elapsed.as_nanos() as f64 / iters as f64;
+    let mib_per_sec = (bytes as f64 * iters as f64) / elapsed.as_secs_f64() / (1 << 20) as f64;
+    println!("{name:<40} {ns_per_iter:>12.1} ns/iter {mib_per_sec:>10.1} MiB/s");
+}
+
+fn make_payload(field_size: usize) -> Vec<u8> {
+    let mut msg = TestAllTypes::new();
+    msg.set_optional_int32(1);
+    msg.set_optional_string("x".repeat(field_size));
+    msg.set_optional_bytes(vec![0xab; field_size]);
+    for _ in 0..8 {
+        msg.repeated_bytes_mut().push(vec![0xcd; field_size]);
+    }
+    msg.serialize().unwrap()
+}
+
+fn main() {
+    for field_size in [16, 1024, 64 * 1024] {
+        let data = make_payload(field_size);
+        bench(&format!("parse/copy/{field_size}"), data.len(), || {
+            let msg = TestAllTypes::parse(black_box(&data)).unwrap();
+            black_box(msg.optional_bytes().len());
+        });
+        bench(&format!("parse/borrowed/{field_size}"), data.len(), || {
+            let msg = BorrowedMessage::<TestAllTypes>::parse(black_box(&data)).unwrap();
+            black_box(msg.as_view().optional_bytes().len());
+        });
+    }
+}
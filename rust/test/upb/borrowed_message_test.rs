@@ -0,0 +1,62 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+use googletest::prelude::*;
+use protobuf::prelude::*;
+use protobuf::BorrowedMessage;
+
+use unittest_rust_proto::{TestAllTypes, TestRequired};
+
+fn points_into(data: &[u8], field: &[u8]) -> bool {
+    data.as_ptr_range().contains(&field.as_ptr())
+}
+
+#[gtest]
+fn test_string_fields_alias_input() {
+    let mut msg = TestAllTypes::new();
+    msg.set_optional_string("hello");
+    msg.set_optional_bytes(b"world");
+    msg.repeated_string_mut().push("repeated");
+    msg.optional_nested_message_mut().set_bb(7);
+    let data = msg.serialize().unwrap();
+
+    let borrowed = BorrowedMessage::<TestAllTypes>::parse(&data).unwrap();
+    let view = borrowed.as_view();
+    assert_that!(view.optional_string(), eq("hello"));
+    assert_that!(view.optional_bytes(), eq(b"world"));
+    assert_that!(view.repeated_string().get(0), some(eq("repeated")));
+    assert_that!(view.optional_nested_message().bb(), eq(7));
+
+    assert_that!(points_into(&data, view.optional_string().as_bytes()), eq(true));
+    assert_that!(points_into(&data, view.optional_bytes()), eq(true));
+    assert_that!(points_into(&data, view.repeated_string().get(0).unwrap().as_bytes()), eq(true));
+}
+
+#[gtest]
+fn test_copy_does_not_alias_input() {
+    let mut msg = TestAllTypes::new();
+    msg.set_optional_bytes(b"payload");
+    let data = msg.serialize().unwrap();
+
+    let mut copy = TestAllTypes::new();
+    {
+        let borrowed = BorrowedMessage::<TestAllTypes>::parse(&data).unwrap();
+        copy.copy_from(borrowed.as_view());
+    }
+    drop(data);
+    assert_that!(copy.optional_bytes(), eq(b"payload"));
+}
+
+#[gtest]
+fn test_parse_errors() {
+    expect_that!(BorrowedMessage::<TestAllTypes>::parse(b"\xff"), err(anything()));
+
+    // Required fields are enforced unless asked otherwise.
+    expect_that!(BorrowedMessage::<TestRequired>::parse(&[]), err(anything()));
+    let borrowed = BorrowedMessage::<TestRequired>::parse_dont_enforce_required(&[]).unwrap();
+    expect_that!(borrowed.as_view().has_a(), eq(false));
+}
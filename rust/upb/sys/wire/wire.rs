@@ -24,6 +24,7 @@ pub enum EncodeStatus {
     MaxDepthExceeded = 3,
     MissingRequired = 10,
     MaxSizeExceeded = 11,
+    SinkError = 12,
 }
 // LINT.ThenChange()
 
@@ -38,6 +39,7 @@ pub enum DecodeStatus {
     MaxDepthExceeded = 3,
     BadUtf8 = 10,
     MissingRequired = 11,
+    NeedMoreInput = 12,
 }
 // LINT.ThenChange()
 
@@ -0,0 +1,94 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+//! Zero-copy parsing for the upb kernel.
+
+use super::*;
+
+/// A read-only message parsed from a borrowed buffer without copying the
+/// contents of its string and bytes fields.
+///
+/// The message is decoded with upb's string aliasing enabled, so `string` and
+/// `bytes` fields (as well as unknown fields) point directly into the input
+/// instead of being copied into the message's arena. The `'buf` lifetime ties
+/// the message to the input, so the input cannot be modified or dropped while
+/// the message, or any view obtained from it, is alive.
+///
+/// The message can be viewed but not mutated. Use `CopyFrom::copy_from()` to
+/// make an owned copy that no longer borrows from the input.
+///
+/// ```ignore
+/// let body: Vec<u8> = read_request_body();
+/// let request = BorrowedMessage::<MyRequest>::parse(&body)?;
+/// let payload: &[u8] = request.as_view().payload(); // Points into `body`.
+/// ```
+pub struct BorrowedMessage<'buf, T: Message> {
+    inner: OwnedMessageInner<T>,
+    _buf: PhantomData<&'buf [u8]>,
+}
+
+// SAFETY:
+// - The message is never mutated after it is parsed, and the input it aliases
+//   is a shared borrow, so it is safe to move and share across threads like
+//   any other owned message.
+unsafe impl<'buf, T: Message> Send for BorrowedMessage<'buf, T> {}
+unsafe impl<'buf, T: Message> Sync for BorrowedMessage<'buf, T> {}
+
+impl<'buf, T> BorrowedMessage<'buf, T>
+where
+    T: Message,
+    for<'a> View<'a, T>: From<MessageViewInner<'a, T>>,
+{
+    /// Parses `data` without copying string and bytes fields. Returns an error
+    /// if `data` is not a valid serialization of `T` or if any required field
+    /// is missing.
+    pub fn parse(data: &'buf [u8]) -> Result<Self, ParseError> {
+        Self::parse_with_options(data, upb::wire::decode_options::CHECK_REQUIRED)
+    }
+
+    /// Like `parse()`, but does not check that required fields are present.
+    pub fn parse_dont_enforce_required(data: &'buf [u8]) -> Result<Self, ParseError> {
+        Self::parse_with_options(data, 0)
+    }
+
+    fn parse_with_options(data: &'buf [u8], decode_options: i32) -> Result<Self, ParseError> {
+        let mut inner = OwnedMessageInner::<T>::new();
+        let ptr = inner.ptr_mut();
+        // SAFETY:
+        // - `ptr` is a valid mutable message associated with `T::mini_table()`
+        //   and allocated on `inner.arena()`.
+        // - With `ALIAS_STRING` the decoded message points into `data`. The
+        //   returned value borrows `data` for `'buf`, and never exposes the
+        //   arena in a way that would let the message outlive it (e.g. by
+        //   fusing it into another arena).
+        unsafe {
+            upb::wire::decode_with_options(
+                data,
+                ptr,
+                generated_extension_registry().as_ptr(),
+                inner.arena(),
+                decode_options | upb::wire::decode_options::ALIAS_STRING,
+            )
+        }
+        .map_err(|_| ParseError)?;
+        Ok(Self { inner, _buf: PhantomData })
+    }
+
+    /// Returns a view of the message. String and bytes fields read through the
+    /// view point into the buffer that the message was parsed from.
+    pub fn as_view(&self) -> View<'_, T> {
+        MessageViewInner::view_of_owned(&self.inner).into()
+    }
+}
+
+impl<'buf, T: Message> Debug for BorrowedMessage<'buf, T> {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        // SAFETY: `self.inner` holds a valid message of type `T`.
+        let s = unsafe { upb::debug_string(self.inner.ptr()) };
+        write!(f, "{s}")
+    }
+}
@@ -12,6 +12,10 @@
 
 use super::*;
 
+/// Zero-copy parsing relies on upb's ability to alias the input buffer, so it
+/// is only available with the upb kernel.
+pub use super::borrowed::BorrowedMessage;
+
 /// Provides functionality for conversion to and from a raw `upb_Message*`.
 ///
 /// This trait is empty for the `upb` kernel because interop for owned messages
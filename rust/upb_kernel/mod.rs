@@ -7,6 +7,7 @@
 
 //! UPB FFI wrapper code for use by Rust Protobuf.
 
+pub mod borrowed;
 pub mod conversions;
 pub mod extension;
 pub mod interop;
@@ -16,6 +17,7 @@ pub mod minitable;
 pub mod repeated;
 pub mod string;
 
+pub use borrowed::*;
 pub use conversions::*;
 pub use extension::*;
 pub use interop::*;
@@ -500,6 +500,51 @@ TEST_F(CppGeneratorTest, MapOptionsDeterministicSerialization) {
   EXPECT_EQ(file_content1, file_content2);
 }
 
+TEST_F(CppGeneratorTest, UnrolledCodegen) {
+  CreateTempFile("foo.proto", R"schema(
+    edition = "UNSTABLE";
+    import "google/protobuf/cpp_features.proto";
+    message Foo {
+      option features.(pb.cpp).unrolled_codegen = true;
+      int32 a = 1;
+      double b = 2;
+      string c = 3;
+      sint64 d = 4;
+    })schema");
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir --cpp_out=$tmpdir "
+      "--experimental_editions foo.proto");
+
+  ExpectNoErrors();
+  ExpectFileContentContainsSubstring("foo.pb.cc",
+                                     "Foo::_Internal::ParseUnrolled(");
+  ExpectFileContentContainsSubstring("foo.pb.cc",
+                                     "{_Internal::ParseUnrolled,");
+  // Each unrolled field predicts the next one; `c` is left to the table.
+  ExpectFileContentContainsSubstring("foo.pb.cc", "goto parse_2;");
+  ExpectFileContentContainsSubstring("foo.pb.cc", "goto parse_4;");
+  ExpectFileContentNotContainsSubstring("foo.pb.cc", "parse_3:");
+  ExpectFileContentContainsSubstring(
+      "foo.pb.cc", "BatchCheckHasBit(cached_has_bits, 0x0000000fU)");
+}
+
+TEST_F(CppGeneratorTest, UnrolledCodegenIsOptIn) {
+  CreateTempFile("foo.proto", R"schema(
+    edition = "UNSTABLE";
+    message Foo {
+      int32 a = 1;
+      double b = 2;
+    })schema");
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir --cpp_out=$tmpdir "
+      "--experimental_editions foo.proto");
+
+  ExpectNoErrors();
+  ExpectFileContentNotContainsSubstring("foo.pb.cc", "ParseUnrolled");
+}
+
 
 }  // namespace
 }  // namespace cpp
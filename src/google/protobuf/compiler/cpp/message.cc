@@ -4588,10 +4588,35 @@ void MessageGenerator::GenerateSerializeWithCachedSizesBody(io::Printer* p) {
           }
         }
 
+        if (auto it = fused_runs_.find(field); it != fused_runs_.end()) {
+          p_->Emit({{"mask", absl::StrFormat("0x%08xU", it->second.mask)}},
+                   R"cc(
+                     if (BatchCheckHasBit(cached_has_bits, $mask$)) {
+                   )cc");
+          p_->Indent();
+          fused_run_end_ = it->second.last;
+        }
         mg_->GenerateSerializeOneField(p_, field, cached_has_bit_index_);
+        if (field == fused_run_end_) {
+          p_->Outdent();
+          p_->Emit(R"cc(
+            }
+          )cc");
+          fused_run_end_ = nullptr;
+        }
       }
     }
 
+    // Wraps `fields`, which are emitted back to back and whose has-bits share
+    // a word, in a single check of their combined mask.
+    void AddFusedRun(absl::Span<const FieldDescriptor* const> fields) {
+      uint32_t mask = 0;
+      for (const auto* field : fields) {
+        mask |= 1u << (mg_->field_layout_.GetHasBitIndex(field).value() % 32);
+      }
+      fused_runs_[fields.front()] = {mask, fields.back()};
+    }
+
     void EmitIfNotNull(const FieldDescriptor* field) {
       if (field != nullptr) {
         Emit(field);
@@ -4634,11 +4659,20 @@ void MessageGenerator::GenerateSerializeWithCachedSizesBody(io::Printer* p) {
              v_[0]->containing_oneof() != field->containing_oneof();
     }
 
+    struct FusedRun {
+      uint32_t mask;
+      const FieldDescriptor* last;
+    };
+
     MessageGenerator* mg_;
     io::Printer* p_;
     bool is_split_open_ = false;
     const Options& options_;
     std::vector<const FieldDescriptor*> v_;
+    // Fused runs keyed by their first field, and the last field of the run
+    // currently open, if any.
+    absl::flat_hash_map<const FieldDescriptor*, FusedRun> fused_runs_;
+    const FieldDescriptor* fused_run_end_ = nullptr;
 
     // cached_has_bit_index_ maintains that:
     //   cached_has_bits = from._has_bits_[cached_has_bit_index_]
@@ -4696,6 +4730,38 @@ void MessageGenerator::GenerateSerializeWithCachedSizesBody(io::Printer* p) {
   }
   std::sort(sorted_extensions.begin(), sorted_extensions.end(),
             ExtensionRangeSorter());
+
+  // With unrolled codegen, runs of consecutive fields whose has-bits share a
+  // word are skipped with one check when none of them is set.
+  auto add_fused_runs = [&](LazySerializerEmitter& e) {
+    std::vector<const FieldDescriptor*> run;
+    auto flush = [&] {
+      if (run.size() > 1) e.AddFusedRun(run);
+      run.clear();
+    };
+    for (const auto* field : ordered_fields) {
+      const bool fusable = HasHasbit(field, options_) &&
+                           field->real_containing_oneof() == nullptr &&
+                           !ShouldSplit(field, options_);
+      if (!fusable) {
+        flush();
+        continue;
+      }
+      if (!run.empty()) {
+        const bool same_word = field_layout_.GetHasWordIndex(field) ==
+                               field_layout_.GetHasWordIndex(run.back());
+        const bool extensions_between = absl::c_any_of(
+            sorted_extensions, [&](const Descriptor::ExtensionRange* range) {
+              return range->start_number() > run.back()->number() &&
+                     range->start_number() < field->number();
+            });
+        if (!same_word || extensions_between) flush();
+      }
+      run.push_back(field);
+    }
+    flush();
+  };
+
   p->Emit(
       {
           {"serialize_split_var",
@@ -4711,6 +4777,9 @@ void MessageGenerator::GenerateSerializeWithCachedSizesBody(io::Printer* p) {
              // Merge fields and extension ranges, sorted by field number.
              LazySerializerEmitter e(this, p, options_);
              LazyExtensionRangeEmitter re(this, p);
+             if (UseUnrolledCodegen(descriptor_, options_)) {
+               add_fused_runs(e);
+             }
 
              size_t i, j;
              for (i = 0, j = 0;
@@ -5454,6 +5523,10 @@ void MessageGenerator::GenerateSourceDefaultInstance(io::Printer* p) {
                     return total_size;
                   }
                 )cc");
+          }},
+         {"unrolled_parse",
+          [&] {
+            parse_function_generator_->GenerateUnrolledParseDeclaration(p);
           }}},
         R"cc(
           class $Msg$::_Internal {
@@ -5465,6 +5538,7 @@ void MessageGenerator::GenerateSourceDefaultInstance(io::Printer* p) {
 
             static constexpr $Msg$::ParseTableT_ GenerateParseTable(
                 const $pbi$::ClassData* $nonnull$ class_data);
+            $unrolled_parse$;
             static constexpr auto GenerateClassData();
 
             static void* $nonnull$ PlacementNew(const void* $nonnull$,
@@ -15,6 +15,7 @@
 #include <variant>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
@@ -23,13 +24,16 @@
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
+#include "google/protobuf/compiler/cpp/generator.h"
 #include "google/protobuf/compiler/cpp/helpers.h"
 #include "google/protobuf/compiler/cpp/options.h"
+#include "google/protobuf/cpp_features.pb.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/generated_message_tctable_gen.h"
 #include "google/protobuf/generated_message_tctable_impl.h"
 #include "google/protobuf/has_bits.h"
 #include "google/protobuf/micro_string.h"
+#include "google/protobuf/wire_format.h"
 
 namespace google {
 namespace protobuf {
@@ -52,6 +56,46 @@ std::vector<const FieldDescriptor*> GetOrderedFields(
   return ordered_fields;
 }
 
+bool UseUnrolledCodegen(const Descriptor* descriptor, const Options& options) {
+  return GetOptimizeFor(descriptor->file(), options) == FileOptions::SPEED &&
+         CppGenerator::GetResolvedSourceFeatures(*descriptor)
+             .GetExtension(::pb::cpp)
+             .unrolled_codegen();
+}
+
+// The unrolled parser handles singular scalar fields with one-byte tags that
+// can be stored without validation or allocation. Everything else is left to
+// the table.
+static bool IsUnrolledField(const TailCallTableInfo::FieldEntryInfo& entry,
+                            const Options& options) {
+  const FieldDescriptor* field = entry.field;
+  if (field->is_repeated() || field->real_containing_oneof() != nullptr ||
+      field->number() >= 16 || ShouldSplit(field, options) ||
+      entry.hasbit_idx > TailCallTableInfo::kMaxFastFieldHasbitIndex) {
+    return false;
+  }
+  switch (field->type()) {
+    case FieldDescriptor::TYPE_INT32:
+    case FieldDescriptor::TYPE_INT64:
+    case FieldDescriptor::TYPE_UINT32:
+    case FieldDescriptor::TYPE_UINT64:
+    case FieldDescriptor::TYPE_SINT32:
+    case FieldDescriptor::TYPE_SINT64:
+    case FieldDescriptor::TYPE_BOOL:
+    case FieldDescriptor::TYPE_FIXED32:
+    case FieldDescriptor::TYPE_FIXED64:
+    case FieldDescriptor::TYPE_SFIXED32:
+    case FieldDescriptor::TYPE_SFIXED64:
+    case FieldDescriptor::TYPE_FLOAT:
+    case FieldDescriptor::TYPE_DOUBLE:
+      return true;
+    case FieldDescriptor::TYPE_ENUM:
+      return internal::cpp::HasPreservingUnknownEnumSemantics(field);
+    default:
+      return false;
+  }
+}
+
 ParseFunctionGenerator::ParseFunctionGenerator(
     const Descriptor* descriptor, bool has_hasbits,
     GetHasBitIndex get_has_bit_index, const Options& options,
@@ -67,6 +111,11 @@ ParseFunctionGenerator::ParseFunctionGenerator(
                                   get_has_bit_index, options_);
   tc_table_info_ = std::make_unique<TailCallTableInfo>(
       BuildTcTableInfoFromDescriptor(descriptor_, options_, fields));
+  if (UseUnrolledCodegen(descriptor_, options_)) {
+    for (const auto& entry : tc_table_info_->field_entries) {
+      if (IsUnrolledField(entry, options_)) unrolled_fields_.push_back(&entry);
+    }
+  }
   SetCommonMessageDataVariables(descriptor_, &variables_);
   SetUnknownFieldsVariable(descriptor_, options_, &variables_);
 }
@@ -346,6 +395,8 @@ void ParseFunctionGenerator::GenerateParseTableHelperDefinition(
     }
   };
 
+  GenerateUnrolledParseDefinition(p);
+
   p->Emit(
       {{"const",
         // FileDescriptorProto's table must be constant initialized. For MSVC
@@ -511,6 +562,11 @@ void ParseFunctionGenerator::GenerateFastFieldEntries(io::Printer* p) {
               ">()");
         }
       }
+      if (absl::c_any_of(unrolled_fields_, [&](const auto* entry) {
+            return entry->field == as_field->field;
+          })) {
+        func_name = "_Internal::ParseUnrolled";
+      }
 
       p->Emit(
           {
@@ -534,6 +590,145 @@ void ParseFunctionGenerator::GenerateFastFieldEntries(io::Printer* p) {
   }
 }
 
+void ParseFunctionGenerator::GenerateUnrolledParseDeclaration(io::Printer* p) {
+  if (unrolled_fields_.empty()) return;
+  auto v = p->WithVars(variables_);
+  p->Emit(R"cc(
+    PROTOBUF_CC static const char* $nullable$
+    ParseUnrolled(PROTOBUF_TC_PARAM_NO_DATA_DECL);
+  )cc");
+}
+
+// The unrolled parse function is installed as the fast-table entry of every
+// field it handles. It parses fields straight-line, predicting that the next
+// tag is the next unrolled field in number order, and hands control back to
+// the table-driven loop on the first miss. Tags it does not handle, including
+// wire-type mismatches, go to MiniParse.
+void ParseFunctionGenerator::GenerateUnrolledParseDefinition(io::Printer* p) {
+  if (unrolled_fields_.empty()) return;
+  auto v = p->WithVars(variables_);
+  p->Emit(
+      {{"cases",
+        [&] {
+          for (const auto* entry : unrolled_fields_) {
+            p->Emit({{"tag", internal::WireFormat::MakeTag(entry->field)},
+                     {"number", entry->field->number()}},
+                     R"cc(
+                       case $tag$:
+                         goto parse_$number$;
+                     )cc");
+          }
+        }},
+       {"fields",
+        [&] {
+          for (size_t i = 0; i < unrolled_fields_.size(); ++i) {
+            GenerateUnrolledField(p, i);
+          }
+        }}},
+      R"cc(
+        const char* $nullable$ $Msg$::_Internal::ParseUnrolled(
+            PROTOBUF_TC_PARAM_NO_DATA_DECL) {
+          auto* const _this = static_cast<$Msg$*>(msg);
+          switch (static_cast<::uint8_t>(*ptr)) {
+            $cases$;
+            default:
+              PROTOBUF_MUSTTAIL return ::_pbi::TcParser::MiniParse(
+                  PROTOBUF_TC_PARAM_NO_DATA_PASS);
+          }
+          $fields$;
+        }
+      )cc");
+  p->Emit("\n");
+}
+
+void ParseFunctionGenerator::GenerateUnrolledField(io::Printer* p,
+                                                   size_t index) {
+  const TailCallTableInfo::FieldEntryInfo& entry = *unrolled_fields_[index];
+  const FieldDescriptor* field = entry.field;
+  const auto wire_type =
+      internal::WireFormat::WireTypeForFieldType(field->type());
+  std::string value;
+  switch (field->type()) {
+    case FieldDescriptor::TYPE_BOOL:
+      value = "value != 0";
+      break;
+    case FieldDescriptor::TYPE_SINT32:
+      value =
+          "::_pbi::WireFormatLite::ZigZagDecode32(static_cast<::uint32_t>("
+          "value))";
+      break;
+    case FieldDescriptor::TYPE_SINT64:
+      value = "::_pbi::WireFormatLite::ZigZagDecode64(value)";
+      break;
+    default:
+      value = absl::StrCat("static_cast<",
+                           PrimitiveTypeName(options_, field->cpp_type()),
+                           ">(value)");
+      break;
+  }
+  {
+    // TODO: refactor this to use Emit.
+    Formatter format(p, variables_);
+    PrintFieldComment(format, field, options_);
+  }
+  p->Emit(
+      {{"number", field->number()},
+       {"field", FieldMemberName(field, /*split=*/false)},
+       {"type", PrimitiveTypeName(options_, field->cpp_type())},
+       {"size",
+        wire_type == internal::WireFormatLite::WIRETYPE_FIXED64 ? 9 : 5},
+       {"value", value},
+       {"read",
+        [&] {
+          if (wire_type == internal::WireFormatLite::WIRETYPE_VARINT) {
+            p->Emit(R"cc(
+              ::uint64_t value;
+              ptr = ::_pbi::VarintParse(ptr + 1, &value);
+              if (ABSL_PREDICT_FALSE(ptr == nullptr)) {
+                PROTOBUF_MUSTTAIL return ::_pbi::TcParser::UnrolledError(
+                    PROTOBUF_TC_PARAM_NO_DATA_PASS);
+              }
+              _this->$field$ = $value$;
+            )cc");
+          } else {
+            p->Emit(R"cc(
+              _this->$field$ = ::_pbi::UnalignedLoad<$type$>(ptr + 1);
+              ptr += $size$;
+            )cc");
+          }
+        }},
+       {"set_hasbit",
+        [&] {
+          if (entry.hasbit_idx < 0) return;
+          p->Emit({{"hasbit_idx", entry.hasbit_idx}},
+                  R"cc(
+                    hasbits |= ::uint64_t{1} << $hasbit_idx$;
+                  )cc");
+        }},
+       {"next",
+        [&] {
+          if (index + 1 == unrolled_fields_.size()) return;
+          const FieldDescriptor* next = unrolled_fields_[index + 1]->field;
+          p->Emit({{"next_tag", internal::WireFormat::MakeTag(next)},
+                   {"next_number", next->number()}},
+                  R"cc(
+                    if (ABSL_PREDICT_TRUE(ctx->DataAvailable(ptr)) &&
+                        static_cast<::uint8_t>(*ptr) == $next_tag$) {
+                      goto parse_$next_number$;
+                    }
+                  )cc");
+        }}},
+      R"cc(
+        parse_$number$: {
+          $read$;
+          $set_hasbit$;
+          $next$;
+          PROTOBUF_MUSTTAIL return ::_pbi::TcParser::UnrolledContinue(
+              PROTOBUF_TC_PARAM_NO_DATA_PASS);
+        }
+      )cc");
+}
+
 void ParseFunctionGenerator::GenerateFieldEntries(io::Printer* p) {
   for (const auto& entry : tc_table_info_->field_entries) {
     const FieldDescriptor* field = entry.field;
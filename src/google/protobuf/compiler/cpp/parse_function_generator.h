@@ -32,6 +32,10 @@ namespace cpp {
 std::vector<const FieldDescriptor*> GetOrderedFields(
     const Descriptor* descriptor);
 
+// Returns true if `descriptor` opted into `features.(pb.cpp).unrolled_codegen`
+// and its file is optimized for speed.
+bool UseUnrolledCodegen(const Descriptor* descriptor, const Options& options);
+
 // ParseFunctionGenerator generates the _InternalParse function for a message
 // (and any associated supporting members).
 class ParseFunctionGenerator {
@@ -79,6 +83,11 @@ class ParseFunctionGenerator {
   // Emits the helper function definition to `printer`:
   void GenerateParseTableHelperDefinition(io::Printer* printer);
 
+  // Emits the declaration of the straight-line parse function into the
+  // message's `_Internal` class. Does nothing unless the message uses unrolled
+  // codegen and has fields the unrolled parser can handle.
+  void GenerateUnrolledParseDeclaration(io::Printer* printer);
+
  private:
   friend class TailCallTableInfoTest;
 
@@ -89,11 +98,17 @@ class ParseFunctionGenerator {
   void GenerateFastFieldEntries(io::Printer* printer);
   void GenerateFieldEntries(io::Printer* p);
   void GenerateFieldNames(Formatter& format);
+  void GenerateUnrolledParseDefinition(io::Printer* p);
+  void GenerateUnrolledField(io::Printer* p, size_t index);
 
   const Descriptor* descriptor_;
   const Options& options_;
   absl::flat_hash_map<absl::string_view, std::string> variables_;
   std::unique_ptr<internal::TailCallTableInfo> tc_table_info_;
+  // Fields parsed inline by the unrolled parse function, in field number
+  // order. Empty unless the message uses unrolled codegen.
+  std::vector<const internal::TailCallTableInfo::FieldEntryInfo*>
+      unrolled_fields_;
   const std::vector<const FieldDescriptor*> ordered_fields_;
   bool has_hasbits_;
   int index_in_file_messages_;
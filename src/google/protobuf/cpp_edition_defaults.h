@@ -5,7 +5,7 @@
 // the C++ runtime.  This is used for feature resolution under Editions.
 // NOLINTBEGIN
 // clang-format off
-#define PROTOBUF_INTERNAL_CPP_EDITION_DEFAULTS "\n\'\030\204\007\"\003\302>\000*\035\010\001\020\002\030\002 \003(\0010\0028\002@\001H\001\302>\010\010\001\020\003\030\000 \001\n\'\030\347\007\"\003\302>\000*\035\010\002\020\001\030\001 \002(\0010\0018\002@\001H\001\302>\010\010\000\020\003\030\000 \001\n\'\030\350\007\"\023\010\001\020\001\030\001 \002(\0010\001\302>\004\010\000\020\003*\r8\002@\001H\001\302>\004\030\000 \001\n\'\030\351\007\"\031\010\001\020\001\030\001 \002(\0010\0018\001@\002\302>\006\010\000\020\001\030\001*\007H\001\302>\002 \001\n\'\030\352\007\"\033\010\001\020\001\030\001 \002(\0010\0018\003@\004H\002\302>\006\010\000\020\001\030\001*\005\302>\002 \001\n\'\030\217N\"\035\010\001\020\001\030\001 \002(\0010\0018\003@\004H\002\302>\010\010\000\020\001\030\001 \001*\003\302>\000 \346\007(\352\007"
+#define PROTOBUF_INTERNAL_CPP_EDITION_DEFAULTS "\n)\030\204\007\"\003\302>\000*\037\010\001\020\002\030\002 \003(\0010\0028\002@\001H\001\302>\n\010\001\020\003\030\000 \001(\000\n)\030\347\007\"\003\302>\000*\037\010\002\020\001\030\001 \002(\0010\0018\002@\001H\001\302>\n\010\000\020\003\030\000 \001(\000\n)\030\350\007\"\023\010\001\020\001\030\001 \002(\0010\001\302>\004\010\000\020\003*\0178\002@\001H\001\302>\006\030\000 \001(\000\n)\030\351\007\"\031\010\001\020\001\030\001 \002(\0010\0018\001@\002\302>\006\010\000\020\001\030\001*\tH\001\302>\004 \001(\000\n)\030\352\007\"\033\010\001\020\001\030\001 \002(\0010\0018\003@\004H\002\302>\006\010\000\020\001\030\001*\007\302>\004 \001(\000\n)\030\217N\"\037\010\001\020\001\030\001 \002(\0010\0018\003@\004H\002\302>\n\010\000\020\001\030\001 \001(\000*\003\302>\000 \346\007(\352\007"
 // clang-format on
 // NOLINTEND
 
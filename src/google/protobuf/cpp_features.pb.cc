@@ -54,21 +54,18 @@ constexpr CppFeatures::ParseTableT_ CppFeatures::_Internal::GenerateParseTable(c
     {
       PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_._has_bits_),
       0, // no _extensions_
-      4, 24,  // max_field_number, fast_idx_mask
+      5, 56,  // max_field_number, fast_idx_mask
       offsetof(ParseTableT_, field_lookup_table),
-      4294967280,  // skipmap
+      4294967264,  // skipmap
       offsetof(ParseTableT_, field_entries),
-      4,  // num_field_entries
+      5,  // num_field_entries
       2,  // num_aux_entries
       offsetof(ParseTableT_, aux_entries),
       class_data,
       nullptr,  // post_loop_handler
       ::_pbi::TcParser::MpUnknownFields,  // fallback
     }, {{
-      // optional .pb.CppFeatures.RepeatedType repeated_type = 4 [retention = RETENTION_RUNTIME, targets = TARGET_TYPE_FIELD, targets = TARGET_TYPE_FILE, edition_defaults = {
-      {::_pbi::TcParser::FastEr0S1,
-       {32, 3, 2,
-        PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.repeated_type_)}},
+      {::_pbi::TcParser::MiniParse, {}},
       // optional bool legacy_closed_enum = 1 [retention = RETENTION_RUNTIME, targets = TARGET_TYPE_FIELD, targets = TARGET_TYPE_FILE, edition_defaults = {
       {::_pbi::TcParser::SingularVarintNoZag1<bool, offsetof(CppFeatures, _impl_.legacy_closed_enum_), 1>(),
        {8, 1, 0,
@@ -81,6 +78,16 @@ constexpr CppFeatures::ParseTableT_ CppFeatures::_Internal::GenerateParseTable(c
       {::_pbi::TcParser::SingularVarintNoZag1<bool, offsetof(CppFeatures, _impl_.enum_name_uses_string_view_), 2>(),
        {24, 2, 0,
         PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.enum_name_uses_string_view_)}},
+      // optional .pb.CppFeatures.RepeatedType repeated_type = 4 [retention = RETENTION_RUNTIME, targets = TARGET_TYPE_FIELD, targets = TARGET_TYPE_FILE, edition_defaults = {
+      {::_pbi::TcParser::FastEr0S1,
+       {32, 3, 2,
+        PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.repeated_type_)}},
+      // optional bool unrolled_codegen = 5 [retention = RETENTION_RUNTIME, targets = TARGET_TYPE_MESSAGE, targets = TARGET_TYPE_FILE, edition_defaults = {
+      {::_pbi::TcParser::SingularVarintNoZag1<bool, offsetof(CppFeatures, _impl_.unrolled_codegen_), 4>(),
+       {40, 4, 0,
+        PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.unrolled_codegen_)}},
+      {::_pbi::TcParser::MiniParse, {}},
+      {::_pbi::TcParser::MiniParse, {}},
     }}, {{
       65535, 65535
     }}, {{
@@ -92,6 +99,8 @@ constexpr CppFeatures::ParseTableT_ CppFeatures::_Internal::GenerateParseTable(c
       {PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.enum_name_uses_string_view_), _Internal::kHasBitsOffset + 2, 0, (0 | ::_fl::kFcOptional | ::_fl::kBool)},
       // optional .pb.CppFeatures.RepeatedType repeated_type = 4 [retention = RETENTION_RUNTIME, targets = TARGET_TYPE_FIELD, targets = TARGET_TYPE_FILE, edition_defaults = {
       {PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.repeated_type_), _Internal::kHasBitsOffset + 3, 1, (0 | ::_fl::kFcOptional | ::_fl::kEnumRange)},
+      // optional bool unrolled_codegen = 5 [retention = RETENTION_RUNTIME, targets = TARGET_TYPE_MESSAGE, targets = TARGET_TYPE_FILE, edition_defaults = {
+      {PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.unrolled_codegen_), _Internal::kHasBitsOffset + 4, 0, (0 | ::_fl::kFcOptional | ::_fl::kBool)},
     }},
     {{
         {0, 3},
@@ -109,7 +118,8 @@ inline constexpr CppFeatures::Impl_::Impl_(
       : string_type_{static_cast< ::pb::CppFeatures_StringType >(0)},
         legacy_closed_enum_{false},
         enum_name_uses_string_view_{false},
-        repeated_type_{static_cast< ::pb::CppFeatures_RepeatedType >(0)} {}
+        repeated_type_{static_cast< ::pb::CppFeatures_RepeatedType >(0)},
+        unrolled_codegen_{false} {}
 
 template <typename>
 PROTOBUF_ALWAYS_INLINE_NODEBUG constexpr CppFeatures::CppFeatures(
@@ -174,15 +184,17 @@ const ::uint32_t
         protodesc_cold) = {
         0x081, // bitmap
         PROTOBUF_FIELD_OFFSET(::pb::CppFeatures, _impl_._has_bits_),
-        7, // hasbit index offset
+        8, // hasbit index offset
         PROTOBUF_FIELD_OFFSET(::pb::CppFeatures, _impl_.legacy_closed_enum_),
         PROTOBUF_FIELD_OFFSET(::pb::CppFeatures, _impl_.string_type_),
         PROTOBUF_FIELD_OFFSET(::pb::CppFeatures, _impl_.enum_name_uses_string_view_),
         PROTOBUF_FIELD_OFFSET(::pb::CppFeatures, _impl_.repeated_type_),
+        PROTOBUF_FIELD_OFFSET(::pb::CppFeatures, _impl_.unrolled_codegen_),
         1,
         0,
         2,
         3,
+        4,
 };
 
 static const ::_pbi::MigrationSchema
@@ -196,7 +208,7 @@ static const ::_pbi::MessageGlobalsBase* PROTOBUF_NONNULL const
 const char descriptor_table_protodef_google_2fprotobuf_2fcpp_5ffeatures_2eproto[] ABSL_ATTRIBUTE_SECTION_VARIABLE(
     protodesc_cold) = {
     "\n\"google/protobuf/cpp_features.proto\022\002pb"
-    "\032 google/protobuf/descriptor.proto\"\222\005\n\013C"
+    "\032 google/protobuf/descriptor.proto\"\312\005\n\013C"
     "ppFeatures\022\373\001\n\022legacy_closed_enum\030\001 \001(\010B"
     "\336\001\210\001\001\230\001\004\230\001\001\242\001\t\022\004true\030\204\007\242\001\n\022\005false\030\347\007\262\001\270\001"
     "\010\350\007\020\350\007\032\257\001The legacy closed enum behavior"
@@ -209,7 +221,9 @@ const char descriptor_table_protodef_google_2fprotobuf_2fcpp_5ffeatures_2eproto[
     "enum_name_uses_string_view\030\003 \001(\010B(\210\001\001\230\001\006"
     "\230\001\001\242\001\n\022\005false\030\204\007\242\001\t\022\004true\030\351\007\262\001\003\010\351\007\022R\n\rre"
     "peated_type\030\004 \001(\0162\034.pb.CppFeatures.Repea"
-    "tedTypeB\035\210\001\001\230\001\004\230\001\001\242\001\013\022\006LEGACY\030\204\007\262\001\003\010\217N\"E"
+    "tedTypeB\035\210\001\001\230\001\004\230\001\001\242\001\013\022\006LEGACY\030\204\007\262\001\003\010\217N\0226"
+    "\n\020unrolled_codegen\030\005 \001(\010B\034\210\001\001\230\001\003\230"
+    "\001\001\242\001\n\022\005false\030\204\007\262\001\003\010\217N\"E"
     "\n\nStringType\022\027\n\023STRING_TYPE_UNKNOWN\020\000\022\010\n"
     "\004VIEW\020\001\022\010\n\004CORD\020\002\022\n\n\006STRING\020\003\"@\n\014Repeate"
     "dType\022\031\n\025REPEATED_TYPE_UNKNOWN\020\000\022\n\n\006LEGA"
@@ -224,7 +238,7 @@ static ::absl::once_flag descriptor_table_google_2fprotobuf_2fcpp_5ffeatures_2ep
 PROTOBUF_CONSTINIT const ::_pbi::DescriptorTable descriptor_table_google_2fprotobuf_2fcpp_5ffeatures_2eproto = {
     false,
     false,
-    795,
+    851,
     descriptor_table_protodef_google_2fprotobuf_2fcpp_5ffeatures_2eproto,
     "google/protobuf/cpp_features.proto",
     &descriptor_table_google_2fprotobuf_2fcpp_5ffeatures_2eproto_once,
@@ -286,9 +300,9 @@ inline void CppFeatures::Helpers_::SharedCtor(
   ::memset(reinterpret_cast<char*>(&this_._impl_) +
                offsetof(Impl_, string_type_),
            0,
-           offsetof(Impl_, repeated_type_) -
+           offsetof(Impl_, unrolled_codegen_) -
                offsetof(Impl_, string_type_) +
-               sizeof(Impl_::repeated_type_));
+               sizeof(Impl_::unrolled_codegen_));
 }
 CppFeatures::~CppFeatures() {
   // @@protoc_insertion_point(destructor:pb.CppFeatures)
@@ -324,12 +338,12 @@ PROTOBUF_NOINLINE void CppFeatures::Clear() {
   ::uint32_t cached_has_bits [[maybe_unused]] = 0;
 
   cached_has_bits = this_._impl_._has_bits_[0];
-  if (BatchCheckHasBit(cached_has_bits, 0x0000000fU)) {
+  if (BatchCheckHasBit(cached_has_bits, 0x0000001fU)) {
     ::memset(&this_._impl_.string_type_, 0,
              static_cast<::size_t>(
-                 reinterpret_cast<char*>(&this_._impl_.repeated_type_) -
+                 reinterpret_cast<char*>(&this_._impl_.unrolled_codegen_) -
                  reinterpret_cast<char*>(&this_._impl_.string_type_)) +
-                 sizeof(_impl_.repeated_type_));
+                 sizeof(_impl_.unrolled_codegen_));
   }
   this_._impl_._has_bits_.Clear();
   this_._internal_metadata_.Clear<::google::protobuf::UnknownFieldSet>();
@@ -382,6 +396,13 @@ PROTOBUF_NOINLINE void CppFeatures::Clear() {
         4, this_._internal_repeated_type(), target);
   }
 
+  // optional bool unrolled_codegen = 5 [retention = RETENTION_RUNTIME, targets = TARGET_TYPE_MESSAGE, targets = TARGET_TYPE_FILE, edition_defaults = {
+  if (CheckHasBit(cached_has_bits, 0x00000010U)) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteBoolToArray(
+        5, this_._internal_unrolled_codegen(), target);
+  }
+
   if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
     target =
         ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
@@ -405,7 +426,7 @@ PROTOBUF_NOINLINE void CppFeatures::Clear() {
 
   ::_pbi::Prefetch5LinesFrom7Lines(&this_);
   cached_has_bits = this_._impl_._has_bits_[0];
-  total_size += ::absl::popcount(0x00000006U & cached_has_bits) * 2;
+  total_size += ::absl::popcount(0x00000016U & cached_has_bits) * 2;
   if (BatchCheckHasBit(cached_has_bits, 0x00000009U)) {
     // optional .pb.CppFeatures.StringType string_type = 2 [retention = RETENTION_RUNTIME, targets = TARGET_TYPE_FIELD, targets = TARGET_TYPE_FILE, edition_defaults = {
     if (CheckHasBit(cached_has_bits, 0x00000001U)) {
@@ -435,7 +456,7 @@ void CppFeatures::MergeImpl(::google::protobuf::MessageLite& to_msg,
   (void)cached_has_bits;
 
   cached_has_bits = from._impl_._has_bits_[0];
-  if (BatchCheckHasBit(cached_has_bits, 0x0000000fU)) {
+  if (BatchCheckHasBit(cached_has_bits, 0x0000001fU)) {
     if (CheckHasBit(cached_has_bits, 0x00000001U)) {
       _this->_impl_.string_type_ = from._impl_.string_type_;
     }
@@ -448,6 +469,9 @@ void CppFeatures::MergeImpl(::google::protobuf::MessageLite& to_msg,
     if (CheckHasBit(cached_has_bits, 0x00000008U)) {
       _this->_impl_.repeated_type_ = from._impl_.repeated_type_;
     }
+    if (CheckHasBit(cached_has_bits, 0x00000010U)) {
+      _this->_impl_.unrolled_codegen_ = from._impl_.unrolled_codegen_;
+    }
   }
   _this->_impl_._has_bits_[0] |= cached_has_bits;
   _this->_internal_metadata_.MergeFrom<::google::protobuf::UnknownFieldSet>(
@@ -469,8 +493,8 @@ void CppFeatures::Helpers_::InternalSwap(
   CppFeatures& this_ = static_cast<CppFeatures&>(self);
   this_._internal_metadata_.InternalSwap(&other->_internal_metadata_);
   swap(this_._impl_._has_bits_[0], other->_impl_._has_bits_[0]);
-  ::google::protobuf::internal::memswap<PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.repeated_type_) +
-                 sizeof(CppFeatures::_impl_.repeated_type_) -
+  ::google::protobuf::internal::memswap<PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.unrolled_codegen_) +
+                 sizeof(CppFeatures::_impl_.unrolled_codegen_) -
                  PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.string_type_)>(
       reinterpret_cast<char*>(&this_._impl_.string_type_),
       reinterpret_cast<char*>(&other->_impl_.string_type_));
@@ -351,6 +351,7 @@ class PROTOBUF_EXPORT  PROTOBUF_FUTURE_ADD_EARLY_WARN_UNUSED CppFeatures final :
     kLegacyClosedEnumFieldNumber = 1,
     kEnumNameUsesStringViewFieldNumber = 3,
     kRepeatedTypeFieldNumber = 4,
+    kUnrolledCodegenFieldNumber = 5,
   };
   // optional .pb.CppFeatures.StringType string_type = 2 [retention = RETENTION_RUNTIME, targets = TARGET_TYPE_FIELD, targets = TARGET_TYPE_FILE, edition_defaults = {
   [[nodiscard]] bool has_string_type() const;
@@ -395,6 +396,17 @@ class PROTOBUF_EXPORT  PROTOBUF_FUTURE_ADD_EARLY_WARN_UNUSED CppFeatures final :
   ::pb::CppFeatures_RepeatedType _internal_repeated_type() const;
   void _internal_set_repeated_type(::pb::CppFeatures_RepeatedType value);
 
+  public:
+  // optional bool unrolled_codegen = 5 [retention = RETENTION_RUNTIME, targets = TARGET_TYPE_MESSAGE, targets = TARGET_TYPE_FILE, edition_defaults = {
+  [[nodiscard]] bool has_unrolled_codegen() const;
+  void clear_unrolled_codegen() ;
+  [[nodiscard]] bool unrolled_codegen() const;
+  void set_unrolled_codegen(bool value);
+
+  private:
+  bool _internal_unrolled_codegen() const;
+  void _internal_set_unrolled_codegen(bool value);
+
   public:
   // @@protoc_insertion_point(class_scope:pb.CppFeatures)
  private:
@@ -416,7 +428,7 @@ class PROTOBUF_EXPORT  PROTOBUF_FUTURE_ADD_EARLY_WARN_UNUSED CppFeatures final :
 #endif  // PROTOBUF_CUSTOM_VTABLE
   };
   using ParseTableT_ =
-      ::google::protobuf::internal::TcParseTable<2, 4,
+      ::google::protobuf::internal::TcParseTable<3, 5,
                           2, 0,
                           2>;
 
@@ -443,6 +455,7 @@ class PROTOBUF_EXPORT  PROTOBUF_FUTURE_ADD_EARLY_WARN_UNUSED CppFeatures final :
     bool legacy_closed_enum_;
     bool enum_name_uses_string_view_;
     int repeated_type_;
+    bool unrolled_codegen_;
     PROTOBUF_TSAN_DECLARE_MEMBER
   };
   union { Impl_ _impl_; };
@@ -586,6 +599,34 @@ inline void CppFeatures::_internal_set_repeated_type(::pb::CppFeatures_RepeatedT
                                           _impl_.repeated_type_ = value;
 }
 
+// optional bool unrolled_codegen = 5 [retention = RETENTION_RUNTIME, targets = TARGET_TYPE_MESSAGE, targets = TARGET_TYPE_FILE, edition_defaults = {
+inline bool CppFeatures::has_unrolled_codegen() const {
+  bool value = CheckHasBit(_impl_._has_bits_[0], 0x00000010U);
+  return value;
+}
+inline void CppFeatures::clear_unrolled_codegen() {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.unrolled_codegen_ = false;
+  ClearHasBit(_impl_._has_bits_[0], 0x00000010U);
+}
+inline bool CppFeatures::unrolled_codegen() const {
+  // @@protoc_insertion_point(field_get:pb.CppFeatures.unrolled_codegen)
+  return _internal_unrolled_codegen();
+}
+inline void CppFeatures::set_unrolled_codegen(bool value) {
+  _internal_set_unrolled_codegen(value);
+  SetHasBit(_impl_._has_bits_[0], 0x00000010U);
+  // @@protoc_insertion_point(field_set:pb.CppFeatures.unrolled_codegen)
+}
+inline bool CppFeatures::_internal_unrolled_codegen() const {
+  ::google::protobuf::internal::TSanRead(&_impl_);
+  return _impl_.unrolled_codegen_;
+}
+inline void CppFeatures::_internal_set_unrolled_codegen(bool value) {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.unrolled_codegen_ = value;
+}
+
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
 #endif  // __GNUC__
@@ -2277,8 +2277,12 @@ void DescriptorPool::InternalAddGeneratedFile(
   // Therefore, when we parse one, we have to be very careful to avoid using
   // any descriptor-based operations, since this might cause infinite recursion
   // or deadlock.
+  //
+  // Even indexing the file's symbols requires parsing it, which adds up for
+  // binaries that link thousands of generated files, so that is deferred until
+  // the first lookup in the generated database as well.
   absl::MutexLockMaybe lock(internal_generated_pool()->mutex_);
-  ABSL_CHECK(GeneratedDatabase()->Add(encoded_file_descriptor, size));
+  GeneratedDatabase()->AddLazily(encoded_file_descriptor, size);
 }
 
 
@@ -4275,6 +4279,61 @@ const FileDescriptor* DescriptorPool::BuildFileCollectingErrors(
   return nullptr;
 }
 
+std::string DescriptorPool::SerializeSnapshot(
+    absl::Span<const FileDescriptor* const> files) {
+  FileDescriptorSet set;
+  absl::flat_hash_set<const FileDescriptor*> seen;
+  // Emit files in post-order so that each one follows its dependencies.
+  const auto visit = [&](const auto& visit, const FileDescriptor* file) {
+    if (!seen.insert(file).second) return;
+    for (int i = 0; i < file->dependency_count(); ++i) {
+      visit(visit, file->dependency(i));
+    }
+    file->CopyTo(set.add_file());
+  };
+  for (const FileDescriptor* file : files) {
+    visit(visit, file);
+  }
+  return set.SerializeAsString();
+}
+
+bool DescriptorPool::LoadSnapshot(absl::string_view snapshot,
+                                  ErrorCollector* error_collector) {
+  ABSL_CHECK(fallback_database_ == nullptr)
+      << "Cannot call LoadSnapshot on a DescriptorPool that uses a "
+         "DescriptorDatabase.";
+  Arena arena;
+  auto* set = Arena::Create<FileDescriptorSet>(&arena);
+  if (!set->ParseFromString(snapshot)) {
+    if (error_collector == nullptr) {
+      ABSL_LOG(ERROR) << "Invalid DescriptorPool snapshot.";
+    } else {
+      error_collector->RecordError("", "", nullptr, ErrorCollector::OTHER,
+                                   "Invalid DescriptorPool snapshot.");
+    }
+    return false;
+  }
+
+  tables_->known_bad_symbols_.clear();
+  tables_->known_bad_files_.clear();
+  build_started_ = true;
+  DeferredValidation deferred_validation(this, error_collector);
+  for (const FileDescriptorProto& proto : set->file()) {
+    if (underlay_ != nullptr &&
+        underlay_->FindFileByName(proto.name()) != nullptr) {
+      continue;
+    }
+    auto builder = internal::DescriptorBuilder::New(
+        this, tables_.get(), deferred_validation, error_collector);
+    builder->SkipValidationForTrustedInput();
+    if (builder->BuildFile(proto) == nullptr) {
+      deferred_validation.Validate();
+      return false;
+    }
+  }
+  return deferred_validation.Validate();
+}
+
 const FileDescriptor* DescriptorPool::BuildFileFromDatabase(
     const FileDescriptorProto& proto,
     DeferredValidation& deferred_validation) const {
@@ -5889,7 +5948,8 @@ FileDescriptor* internal::DescriptorBuilder::BuildFileImpl(
 
   // Validate options. See comments at InternalSetLazilyBuildDependencies about
   // error checking and lazy import building.
-  if (!has_errors() && !pool_->lazily_build_dependencies_) {
+  if (!has_errors() && !pool_->lazily_build_dependencies_ &&
+      !skip_validation_) {
     internal::VisitDescriptors(
         *result, proto, [&](const auto& descriptor, const auto& desc_proto) {
           ValidateOptions(&descriptor, desc_proto);
@@ -5909,13 +5969,14 @@ FileDescriptor* internal::DescriptorBuilder::BuildFileImpl(
   // checking. Also, don't log unused dependencies if there were previous
   // errors, since the results might be inaccurate.
   if (!has_errors() && !unused_dependency_.empty() &&
-      !pool_->lazily_build_dependencies_) {
+      !pool_->lazily_build_dependencies_ && !skip_validation_) {
     LogUnusedDependency(proto, result);
   }
 
   // Store feature information for deferred validation outside of the database
   // mutex.
-  if (!has_errors() && !pool_->lazily_build_dependencies_) {
+  if (!has_errors() && !pool_->lazily_build_dependencies_ &&
+      !skip_validation_) {
     internal::VisitDescriptors(
         *result, proto, [&](const auto& descriptor, const auto& desc_proto) {
           if (!IsDefaultInstance(*descriptor.proto_features_)) {
@@ -5932,7 +5993,7 @@ FileDescriptor* internal::DescriptorBuilder::BuildFileImpl(
         });
   }
 
-  if (!has_errors() && pool_->enforce_naming_style_) {
+  if (!has_errors() && !skip_validation_ && pool_->enforce_naming_style_) {
     internal::VisitDescriptors(
         *result, proto, [&](const auto& descriptor, const auto& desc_proto) {
           if (IsStyleOrGreater(&descriptor, FeatureSet::STYLE2024)) {
@@ -5941,7 +6002,7 @@ FileDescriptor* internal::DescriptorBuilder::BuildFileImpl(
         });
   }
 
-  if (!has_errors() && pool_->enforce_proto_limits_) {
+  if (!has_errors() && !skip_validation_ && pool_->enforce_proto_limits_) {
     internal::VisitDescriptors(
         *result, proto, [&](const auto& descriptor, const auto& desc_proto) {
           if (internal::InternalFeatureHelper::GetFeatures(descriptor)
@@ -5951,7 +6012,8 @@ FileDescriptor* internal::DescriptorBuilder::BuildFileImpl(
           }
         });
   }
-  if (!has_errors() && pool_->enforce_symbol_visibility_) {
+  if (!has_errors() && !skip_validation_ &&
+      pool_->enforce_symbol_visibility_) {
     SymbolChecker symbol_checker(result, proto);
     // Check Symbol Visibility and future co-location Rules.
     auto errors = symbol_checker.CheckSymbolVisibilityRules();
@@ -56,6 +56,7 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "google/protobuf/class_data.h"
 #include "google/protobuf/descriptor_lite.h"  // IWYU pragma: export
 #include "google/protobuf/extension_set.h"
@@ -2528,6 +2529,35 @@ class PROTOBUF_EXPORT DescriptorPool {
   const FileDescriptor* BuildFileCollectingErrors(
       const FileDescriptorProto& proto, ErrorCollector* error_collector);
 
+  // Pool snapshots ----------------------------------------------------
+  // A snapshot holds a set of already-built files, and everything they
+  // import, in a form that can be loaded into another pool much faster than
+  // building each FileDescriptorProto with BuildFile().  It is meant to be
+  // produced at build time, e.g. by a small tool that links in the generated
+  // code for a binary's protos, and embedded in or shipped with the binary.
+  //
+  // The snapshot is a serialized FileDescriptorSet in which every file comes
+  // after its dependencies, with options already interpreted and source code
+  // info removed.  Because its contents were validated when they were first
+  // built, LoadSnapshot() skips the validation checks that BuildFile() runs
+  // and never needs to look dependencies up out of order.
+
+  // Serializes `files` and their transitive dependencies into a snapshot.
+  static std::string SerializeSnapshot(
+      absl::Span<const FileDescriptor* const> files);
+
+  // Builds every file in `snapshot`, which must have been produced by
+  // SerializeSnapshot(), into this pool.  Files that are already present in
+  // the pool or its underlay are skipped.  Returns false if the snapshot
+  // could not be parsed or a file failed to build; files loaded before the
+  // failure remain in the pool.  Like BuildFile(), this cannot be used on a
+  // pool that has a fallback database.
+  //
+  // Never pass untrusted data to this method: invalid definitions that
+  // BuildFile() would reject may be accepted.
+  bool LoadSnapshot(absl::string_view snapshot,
+                    ErrorCollector* error_collector = nullptr);
+
   // By default, it is an error if a FileDescriptorProto contains references
   // to types or other files that are not found in the DescriptorPool (or its
   // backing DescriptorDatabase, if any).  If you call
@@ -90,6 +90,13 @@ class DescriptorBuilder {
 
   const FileDescriptor* BuildFile(const FileDescriptorProto& proto);
 
+  // Skips the checks that only reject invalid definitions (option validation,
+  // naming style, proto limits, symbol visibility, feature lifetimes and unused
+  // imports).  Only for input that was produced from an already-built pool,
+  // such as a DescriptorPool snapshot.  Building, cross-linking and option
+  // interpretation still happen as usual.
+  void SkipValidationForTrustedInput() { skip_validation_ = true; }
+
  private:
   static constexpr size_t kMaxNumErrors = 1000;
 
@@ -119,6 +126,7 @@ class DescriptorBuilder {
 
   size_t error_count_ = 0;
   size_t warning_count_ = 0;
+  bool skip_validation_ = false;
   std::string filename_;
   FileDescriptor* file_;
   FileDescriptorTables* file_tables_ = nullptr;
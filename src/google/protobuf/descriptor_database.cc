@@ -424,6 +424,198 @@ bool SimpleDescriptorDatabase::MaybeCopy(
 
 // -------------------------------------------------------------------
 
+namespace {
+
+// The parts of the descriptor protos that
+// EncodedDescriptorDatabase::DescriptorIndex::AddFile() reads, scanned from an
+// encoded FileDescriptorProto without parsing the rest of it.  This lets
+// AddLazily() defer the full parse of a file until a lookup returns it.  Names
+// point into the encoded data.
+
+constexpr uint32_t DelimitedTag(int field_number) {
+  return internal::WireFormatLite::MakeTag(
+      field_number, internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+}
+
+bool ScanString(io::CodedInputStream* input, absl::string_view* output) {
+  int length;
+  if (!input->ReadVarintSizeAsInt(&length)) return false;
+  if (length == 0) {
+    *output = absl::string_view();
+    return true;
+  }
+  const void* data;
+  int size;
+  if (!input->GetDirectBufferPointer(&data, &size) || size < length) {
+    return false;
+  }
+  *output = absl::string_view(static_cast<const char*>(data), length);
+  return input->Skip(length);
+}
+
+template <typename Scanned>
+bool ScanSubmessage(io::CodedInputStream* input,
+                    std::vector<Scanned>* output) {
+  int length;
+  if (!input->ReadVarintSizeAsInt(&length)) return false;
+  std::pair<io::CodedInputStream::Limit, int> limit =
+      input->IncrementRecursionDepthAndPushLimit(length);
+  if (limit.second < 0) return false;
+  output->emplace_back();
+  return output->back().Scan(input) &&
+         input->DecrementRecursionDepthAndPopLimit(limit.first);
+}
+
+// An EnumDescriptorProto or ServiceDescriptorProto.
+class ScannedName {
+ public:
+  bool Scan(io::CodedInputStream* input) {
+    while (uint32_t tag = input->ReadTag()) {
+      bool ok = tag == DelimitedTag(EnumDescriptorProto::kNameFieldNumber)
+                    ? ScanString(input, &name_)
+                    : internal::WireFormatLite::SkipField(input, tag);
+      if (!ok) return false;
+    }
+    return input->ConsumedEntireMessage();
+  }
+
+  absl::string_view name() const { return name_; }
+
+ private:
+  absl::string_view name_;
+};
+
+// A FieldDescriptorProto that declares an extension.
+class ScannedExtension {
+ public:
+  bool Scan(io::CodedInputStream* input) {
+    while (uint32_t tag = input->ReadTag()) {
+      bool ok;
+      switch (tag) {
+        case DelimitedTag(FieldDescriptorProto::kNameFieldNumber):
+          ok = ScanString(input, &name_);
+          break;
+        case DelimitedTag(FieldDescriptorProto::kExtendeeFieldNumber):
+          ok = ScanString(input, &extendee_);
+          break;
+        case internal::WireFormatLite::MakeTag(
+            FieldDescriptorProto::kNumberFieldNumber,
+            internal::WireFormatLite::WIRETYPE_VARINT): {
+          uint32_t number;
+          ok = input->ReadVarint32(&number);
+          number_ = static_cast<int>(number);
+          break;
+        }
+        default:
+          ok = internal::WireFormatLite::SkipField(input, tag);
+          break;
+      }
+      if (!ok) return false;
+    }
+    return input->ConsumedEntireMessage();
+  }
+
+  absl::string_view name() const { return name_; }
+  absl::string_view extendee() const { return extendee_; }
+  int number() const { return number_; }
+
+ private:
+  absl::string_view name_;
+  absl::string_view extendee_;
+  int number_ = 0;
+};
+
+// A DescriptorProto, keeping the extensions declared in it and in its nested
+// messages.
+class ScannedMessage {
+ public:
+  bool Scan(io::CodedInputStream* input) {
+    while (uint32_t tag = input->ReadTag()) {
+      bool ok;
+      switch (tag) {
+        case DelimitedTag(DescriptorProto::kNameFieldNumber):
+          ok = ScanString(input, &name_);
+          break;
+        case DelimitedTag(DescriptorProto::kNestedTypeFieldNumber):
+          ok = ScanSubmessage(input, &nested_type_);
+          break;
+        case DelimitedTag(DescriptorProto::kExtensionFieldNumber):
+          ok = ScanSubmessage(input, &extension_);
+          break;
+        default:
+          ok = internal::WireFormatLite::SkipField(input, tag);
+          break;
+      }
+      if (!ok) return false;
+    }
+    return input->ConsumedEntireMessage();
+  }
+
+  absl::string_view name() const { return name_; }
+  const std::vector<ScannedMessage>& nested_type() const {
+    return nested_type_;
+  }
+  const std::vector<ScannedExtension>& extension() const { return extension_; }
+
+ private:
+  absl::string_view name_;
+  std::vector<ScannedMessage> nested_type_;
+  std::vector<ScannedExtension> extension_;
+};
+
+class ScannedFile {
+ public:
+  bool Scan(io::CodedInputStream* input) {
+    while (uint32_t tag = input->ReadTag()) {
+      bool ok;
+      switch (tag) {
+        case DelimitedTag(FileDescriptorProto::kNameFieldNumber):
+          ok = ScanString(input, &name_);
+          break;
+        case DelimitedTag(FileDescriptorProto::kPackageFieldNumber):
+          ok = ScanString(input, &package_);
+          break;
+        case DelimitedTag(FileDescriptorProto::kMessageTypeFieldNumber):
+          ok = ScanSubmessage(input, &message_type_);
+          break;
+        case DelimitedTag(FileDescriptorProto::kEnumTypeFieldNumber):
+          ok = ScanSubmessage(input, &enum_type_);
+          break;
+        case DelimitedTag(FileDescriptorProto::kExtensionFieldNumber):
+          ok = ScanSubmessage(input, &extension_);
+          break;
+        case DelimitedTag(FileDescriptorProto::kServiceFieldNumber):
+          ok = ScanSubmessage(input, &service_);
+          break;
+        default:
+          ok = internal::WireFormatLite::SkipField(input, tag);
+          break;
+      }
+      if (!ok) return false;
+    }
+    return input->ConsumedEntireMessage();
+  }
+
+  absl::string_view name() const { return name_; }
+  absl::string_view package() const { return package_; }
+  const std::vector<ScannedMessage>& message_type() const {
+    return message_type_;
+  }
+  const std::vector<ScannedName>& enum_type() const { return enum_type_; }
+  const std::vector<ScannedExtension>& extension() const { return extension_; }
+  const std::vector<ScannedName>& service() const { return service_; }
+
+ private:
+  absl::string_view name_;
+  absl::string_view package_;
+  std::vector<ScannedMessage> message_type_;
+  std::vector<ScannedName> enum_type_;
+  std::vector<ScannedExtension> extension_;
+  std::vector<ScannedName> service_;
+};
+
+}  // namespace
+
 class EncodedDescriptorDatabase::DescriptorIndex {
  public:
   using Value = std::pair<const void*, int>;
@@ -444,6 +636,10 @@ class EncodedDescriptorDatabase::DescriptorIndex {
  private:
   friend class EncodedDescriptorDatabase;
 
+  // Indexes the files added with AddLazily(), scanning only the symbol names
+  // out of each of them.
+  void IndexPendingFiles();
+
   bool AddSymbol(absl::string_view symbol);
 
   template <typename DescProto>
@@ -477,6 +673,9 @@ class EncodedDescriptorDatabase::DescriptorIndex {
   };
   std::vector<EncodedEntry> all_values_;
 
+  // Files added with AddLazily() that have not been indexed yet.
+  std::vector<Value> pending_;
+
   struct FileEntry {
     int data_offset;
     String encoded_name;
@@ -612,6 +811,8 @@ class EncodedDescriptorDatabase::DescriptorIndex {
 
 bool EncodedDescriptorDatabase::Add(
     const void* PROTOBUF_NONNULL encoded_file_descriptor, int size) {
+  // Index pending files first so that conflicts are reported here.
+  index_->IndexPendingFiles();
   FileDescriptorProto file;
   if (file.ParseFromArray(encoded_file_descriptor, size)) {
     return index_->AddFile(file, std::make_pair(encoded_file_descriptor, size));
@@ -630,6 +831,11 @@ bool EncodedDescriptorDatabase::AddCopy(
   return Add(copy, size);
 }
 
+void EncodedDescriptorDatabase::AddLazily(
+    const void* PROTOBUF_NONNULL encoded_file_descriptor, int size) {
+  index_->pending_.emplace_back(encoded_file_descriptor, size);
+}
+
 bool EncodedDescriptorDatabase::FindFileByName(
     absl::string_view filename, FileDescriptorProto* PROTOBUF_NONNULL output) {
   return MaybeParse(index_->FindFile(filename), output);
@@ -872,7 +1078,23 @@ static void MergeIntoFlat(absl::btree_set<T, Less>* s, std::vector<T>* flat) {
   s->clear();
 }
 
+void EncodedDescriptorDatabase::DescriptorIndex::IndexPendingFiles() {
+  if (pending_.empty()) return;
+  std::vector<Value> pending;
+  pending.swap(pending_);
+  all_values_.reserve(all_values_.size() + pending.size());
+  for (const Value& value : pending) {
+    io::CodedInputStream input(static_cast<const uint8_t*>(value.first),
+                               value.second);
+    ScannedFile file;
+    bool ok = file.Scan(&input) && AddFile(file, value);
+    ABSL_CHECK(ok) << "Invalid or conflicting file descriptor data passed to "
+                      "EncodedDescriptorDatabase::AddLazily().";
+  }
+}
+
 void EncodedDescriptorDatabase::DescriptorIndex::EnsureFlat() {
+  IndexPendingFiles();
   all_values_.shrink_to_fit();
   // Merge each of the sets into their flat counterpart.
   MergeIntoFlat(&by_name_, &by_name_flat_);
@@ -927,6 +1149,7 @@ EncodedDescriptorDatabase::DescriptorIndex::FindFile(
 
 bool EncodedDescriptorDatabase::FindAllFileNames(
     std::vector<std::string>* PROTOBUF_NONNULL output) {
+  index_->IndexPendingFiles();
   index_->FindAllFileNames(output);
   return true;
 }
@@ -306,6 +306,18 @@ class PROTOBUF_EXPORT EncodedDescriptorDatabase : public DescriptorDatabase {
   // need to keep it around.
   bool AddCopy(const void* PROTOBUF_NONNULL encoded_file_descriptor, int size);
 
+  // Like Add(), but defers indexing the file until the first lookup, and
+  // never parses it in full unless a lookup returns it.  This keeps
+  // registration cheap for databases that hold many files of which only a few
+  // are ever looked up, like the one backing DescriptorPool::generated_pool().
+  // Pending files are indexed all at once, with a single sort of each index,
+  // by scanning only their top-level symbol names and extensions out of the
+  // encoded data.  Since errors cannot be returned to the caller, a malformed
+  // or conflicting file is a fatal error when it is indexed, so this should
+  // only be used for data that is known to be valid.
+  void AddLazily(const void* PROTOBUF_NONNULL encoded_file_descriptor,
+                 int size);
+
   // Like FindFileContainingSymbol but returns only the name of the file.
   PROTOBUF_FUTURE_ADD_EARLY_NODISCARD bool FindNameOfFileContainingSymbol(
       absl::string_view symbol_name, std::string* PROTOBUF_NONNULL output);
@@ -530,6 +530,97 @@ TEST(EncodedDescriptorDatabaseExtraTest,
   EXPECT_THAT(files, ElementsAre("app.proto"));
 }
 
+TEST(EncodedDescriptorDatabaseExtraTest, AddLazily) {
+  FileDescriptorProto foo, bar;
+  foo.set_name("foo.proto");
+  foo.set_package("foo");
+  foo.add_message_type()->set_name("Foo");
+  bar.set_name("bar.proto");
+  FieldDescriptorProto* ext = bar.add_extension();
+  ext->set_name("bar");
+  ext->set_number(5);
+  ext->set_extendee(".foo.Foo");
+  std::string data_foo = foo.SerializeAsString();
+  std::string data_bar = bar.SerializeAsString();
+
+  EncodedDescriptorDatabase db;
+  db.AddLazily(data_foo.data(), data_foo.size());
+  db.AddLazily(data_bar.data(), data_bar.size());
+
+  FileDescriptorProto file;
+  ASSERT_TRUE(db.FindFileContainingSymbol("foo.Foo", &file));
+  EXPECT_EQ(file.name(), "foo.proto");
+  ASSERT_TRUE(db.FindFileContainingExtension("foo.Foo", 5, &file));
+  EXPECT_EQ(file.name(), "bar.proto");
+  std::vector<std::string> files;
+  ASSERT_TRUE(db.FindAllFileNames(&files));
+  EXPECT_THAT(files, ::testing::UnorderedElementsAre("foo.proto", "bar.proto"));
+
+  // Files added eagerly are still checked against the lazily added ones.
+  EXPECT_FALSE(db.Add(data_foo.data(), data_foo.size()));
+
+  // Pending files are also indexed before listing them.
+  FileDescriptorProto baz;
+  baz.set_name("baz.proto");
+  std::string data_baz = baz.SerializeAsString();
+  db.AddLazily(data_baz.data(), data_baz.size());
+  files.clear();
+  ASSERT_TRUE(db.FindAllFileNames(&files));
+  EXPECT_THAT(files, ::testing::UnorderedElementsAre("foo.proto", "bar.proto",
+                                                     "baz.proto"));
+}
+
+TEST(EncodedDescriptorDatabaseExtraTest, AddLazilyIndexesAllSymbolKinds) {
+  FileDescriptorProto file;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"pb(
+        name: "foo.proto"
+        package: "foo"
+        message_type {
+          name: "Foo"
+          field { name: "x" number: 1 type: TYPE_INT32 }
+          nested_type {
+            name: "Nested"
+            extension { name: "nested_ext" number: 7 extendee: ".foo.Foo" }
+          }
+          extension_range { start: 5 end: 10 }
+        }
+        enum_type {
+          name: "Color"
+          value { name: "RED" number: 0 }
+        }
+        service { name: "Svc" }
+      )pb",
+      &file));
+  std::string data = file.SerializeAsString();
+  EncodedDescriptorDatabase db;
+  db.AddLazily(data.data(), data.size());
+
+  FileDescriptorProto found;
+  for (const char* symbol :
+       {"foo.Foo", "foo.Foo.Nested", "foo.Color", "foo.Svc"}) {
+    ASSERT_TRUE(db.FindFileContainingSymbol(symbol, &found)) << symbol;
+    EXPECT_EQ(found.SerializeAsString(), data);
+  }
+  EXPECT_FALSE(db.FindFileContainingSymbol("foo.Bar", &found));
+  ASSERT_TRUE(db.FindFileContainingExtension("foo.Foo", 7, &found));
+  EXPECT_EQ(found.name(), "foo.proto");
+  std::vector<int> numbers;
+  ASSERT_TRUE(db.FindAllExtensionNumbers("foo.Foo", &numbers));
+  EXPECT_THAT(numbers, ElementsAre(7));
+}
+
+TEST(EncodedDescriptorDatabaseExtraTest, AddLazilyConflictIsFatal) {
+  FileDescriptorProto file;
+  file.set_name("foo.proto");
+  std::string data = file.SerializeAsString();
+  EncodedDescriptorDatabase db;
+  db.AddLazily(data.data(), data.size());
+  db.AddLazily(data.data(), data.size());
+  EXPECT_DEATH((void)db.FindFileByName("foo.proto", &file),
+               "Invalid or conflicting file descriptor data");
+}
+
 TEST(SimpleDescriptorDatabaseExtraTest, FindAllFileNames) {
   FileDescriptorProto f;
   f.set_name("foo.proto");
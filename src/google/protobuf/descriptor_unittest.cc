@@ -10546,6 +10546,7 @@ TEST_F(FeaturesTest, Proto2Features) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
   EXPECT_THAT(GetCoreFeatures(field), EqualsProto(R"pb(
                 field_presence: EXPLICIT
@@ -10562,6 +10563,7 @@ TEST_F(FeaturesTest, Proto2Features) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
   EXPECT_THAT(GetCoreFeatures(group), EqualsProto(R"pb(
                 field_presence: EXPLICIT
@@ -10578,6 +10580,7 @@ TEST_F(FeaturesTest, Proto2Features) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
   EXPECT_TRUE(field->has_presence());
   EXPECT_FALSE(field->requires_utf8_validation());
@@ -10662,6 +10665,7 @@ TEST_F(FeaturesTest, Proto3Features) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
   EXPECT_THAT(GetCoreFeatures(field), EqualsProto(R"pb(
                 field_presence: IMPLICIT
@@ -10678,6 +10682,7 @@ TEST_F(FeaturesTest, Proto3Features) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
   EXPECT_FALSE(field->has_presence());
   EXPECT_FALSE(field->requires_utf8_validation());
@@ -10862,6 +10867,7 @@ TEST_F(FeaturesTest, Edition2023Defaults) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 }
               )pb"));
 
@@ -10980,6 +10986,7 @@ TEST_F(FeaturesTest, Edition2024Defaults) {
                   string_type: VIEW
                   enum_name_uses_string_view: true
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 }
               )pb"));
 
@@ -11015,6 +11022,7 @@ TEST_F(FeaturesTest, Edition2026Defaults) {
                   string_type: VIEW
                   enum_name_uses_string_view: true
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 }
               )pb"));
 
@@ -11052,6 +11060,7 @@ TEST_F(FeaturesBaseTest, DefaultEdition2023Defaults) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 }
               )pb"));
   EXPECT_FALSE(GetFeatures(file).HasExtension(pb::test));
@@ -11084,6 +11093,7 @@ TEST_F(FeaturesTest, ClearsOptions) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
 }
 
@@ -11455,6 +11465,7 @@ TEST_F(FeaturesTest, NoOptions) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
 }
 
@@ -11492,6 +11503,7 @@ TEST_F(FeaturesTest, FileFeatures) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
 }
 
@@ -11577,6 +11589,7 @@ TEST_F(FeaturesTest, MessageFeaturesDefault) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
 }
 
@@ -11692,6 +11705,7 @@ TEST_F(FeaturesTest, FieldFeaturesDefault) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
 }
 
@@ -12764,6 +12778,7 @@ TEST_F(FeaturesTest, EnumFeaturesDefault) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
 }
 
@@ -12883,6 +12898,7 @@ TEST_F(FeaturesTest, EnumValueFeaturesDefault) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
 }
 
@@ -12986,6 +13002,7 @@ TEST_F(FeaturesTest, OneofFeaturesDefault) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
 }
 
@@ -13098,6 +13115,7 @@ TEST_F(FeaturesTest, ExtensionRangeFeaturesDefault) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
 }
 
@@ -13195,6 +13213,7 @@ TEST_F(FeaturesTest, ServiceFeaturesDefault) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
 }
 
@@ -13269,6 +13288,7 @@ TEST_F(FeaturesTest, MethodFeaturesDefault) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
 }
 
@@ -14480,6 +14500,7 @@ TEST_F(FeaturesTest, UninterpretedOptions) {
                   string_type: STRING
                   enum_name_uses_string_view: false
                   repeated_type: LEGACY
+                  unrolled_codegen: false
                 })pb"));
 }
 
@@ -16444,6 +16465,72 @@ TEST_F(ValidationErrorTest, TooManyFieldsInMessage) {
 }
 
 
+// ===================================================================
+// Pool snapshots
+
+TEST(DescriptorPoolSnapshotTest, RoundTrip) {
+  const FileDescriptor* file =
+      proto2_unittest::TestMessageWithCustomOptions::descriptor()->file();
+  std::string snapshot = DescriptorPool::SerializeSnapshot({file});
+
+  FileDescriptorSet set;
+  ASSERT_TRUE(set.ParseFromString(snapshot));
+  ASSERT_GE(set.file_size(), file->dependency_count() + 1);
+  // Dependencies come first.
+  EXPECT_EQ(set.file(set.file_size() - 1).name(), file->name());
+  for (const FileDescriptorProto& proto : set.file()) {
+    EXPECT_FALSE(proto.has_source_code_info());
+  }
+
+  DescriptorPool pool;
+  MockErrorCollector error_collector;
+  ASSERT_TRUE(pool.LoadSnapshot(snapshot, &error_collector));
+  EXPECT_EQ(error_collector.text_, "");
+  const FileDescriptor* loaded = pool.FindFileByName(file->name());
+  ASSERT_THAT(loaded, NotNull());
+  EXPECT_EQ(loaded->DebugString(), file->DebugString());
+  for (int i = 0; i < file->dependency_count(); ++i) {
+    EXPECT_EQ(loaded->dependency(i)->DebugString(),
+              file->dependency(i)->DebugString());
+  }
+
+  // Loading the same snapshot again is a no-op.
+  EXPECT_TRUE(pool.LoadSnapshot(snapshot));
+  EXPECT_EQ(pool.FindFileByName(file->name()), loaded);
+}
+
+TEST(DescriptorPoolSnapshotTest, SkipsFilesInUnderlay) {
+  const FileDescriptor* file =
+      proto2_unittest::TestAllTypes::descriptor()->file();
+  std::string snapshot = DescriptorPool::SerializeSnapshot({file});
+
+  DescriptorPool pool(DescriptorPool::generated_pool());
+  ASSERT_TRUE(pool.LoadSnapshot(snapshot));
+  EXPECT_EQ(pool.FindFileByName(file->name()), file);
+}
+
+TEST(DescriptorPoolSnapshotTest, Errors) {
+  DescriptorPool pool;
+  MockErrorCollector error_collector;
+  EXPECT_FALSE(pool.LoadSnapshot("\xff", &error_collector));
+  EXPECT_EQ(error_collector.text_,
+            ": : OTHER: Invalid DescriptorPool snapshot.\n");
+
+  FileDescriptorSet set;
+  *set.add_file() = MakeFile(R"pb(
+    name: "foo.proto" message_type { name: "Foo" }
+  )pb");
+  *set.add_file() = MakeFile(R"pb(
+    name: "bar.proto" dependency: "missing.proto"
+  )pb");
+  error_collector.text_.clear();
+  EXPECT_FALSE(pool.LoadSnapshot(set.SerializeAsString(), &error_collector));
+  EXPECT_THAT(error_collector.text_, HasSubstr("missing.proto"));
+  // Files before the failure stay in the pool.
+  EXPECT_THAT(pool.FindFileByName("foo.proto"), NotNull());
+  EXPECT_EQ(pool.FindFileByName("bar.proto"), nullptr);
+}
+
 // ===================================================================
 // DescriptorDatabase
 
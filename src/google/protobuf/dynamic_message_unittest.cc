@@ -128,6 +128,46 @@ TEST(DynamicMessageTest,
       static_cast<const void*>(default_value.data()));
 }
 
+TEST(DynamicMessageTest, ParseWithAliasingPointsIntoInput) {
+  edition_unittest::TestAllTypes source;
+  const std::string payload(100, 'x');
+  source.set_optional_string(payload);
+  source.set_optional_bytes(payload);
+  source.add_repeated_string(payload);
+  const std::string input = source.SerializeAsString();
+  const auto points_into_input = [&](absl::string_view str) {
+    return str.data() >= input.data() &&
+           str.data() + str.size() <= input.data() + input.size();
+  };
+
+  DynamicMessageFactory factory;
+  const Message* prototype =
+      factory.GetPrototype(edition_unittest::TestAllTypes::descriptor());
+  const Descriptor* descriptor = prototype->GetDescriptor();
+  Reflection::ScratchSpace scratch;
+  for (bool aliasing : {false, true}) {
+    SCOPED_TRACE(aliasing);
+    std::unique_ptr<Message> msg(prototype->New());
+    ASSERT_TRUE(aliasing ? msg->ParseFromStringWithAliasing(input)
+                         : msg->ParseFromString(input));
+    const Reflection* reflection = msg->GetReflection();
+    for (const char* name : {"optional_string", "optional_bytes"}) {
+      absl::string_view str = reflection->GetStringView(
+          *msg, descriptor->FindFieldByName(name), scratch);
+      EXPECT_EQ(str, payload) << name;
+      // Only MicroString fields alias the input.
+      EXPECT_EQ(points_into_input(str),
+                aliasing && internal::EnableExperimentalMicroString())
+          << name;
+    }
+    // Repeated fields never alias.
+    absl::string_view repeated = reflection->GetRepeatedStringView(
+        *msg, descriptor->FindFieldByName("repeated_string"), 0, scratch);
+    EXPECT_EQ(repeated, payload);
+    EXPECT_FALSE(points_into_input(repeated));
+  }
+}
+
 struct OverflowTestCase {
   DescriptorPool pool;
   DynamicMessageFactory factory{&pool};
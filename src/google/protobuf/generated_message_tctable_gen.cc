@@ -506,6 +506,7 @@ uint16_t MakeTypeCardForField(const FieldDescriptor* field, bool has_hasbit,
     type_card = fl::kFcRepeated;
   } else if (has_hasbit) {
     type_card = fl::kFcOptional;
+    if (!field->has_presence()) type_card |= fl::kHbHint;
   } else if (field->real_containing_oneof()) {
     type_card = fl::kFcOneof;
   } else {
@@ -190,11 +190,24 @@ enum FormatDiscriminator : uint16_t {
   kFmtShow       = 1 << kFmtShift,  // message, map
 };
 
+// Has-bit mode (1 bit):
+// Only used with kFcOptional. Implicit-presence fields may have a has-bit that
+// is merely a hint: it is set whenever the field is written, even to its
+// default value, so only the field value tells whether the field is present.
+enum FieldHasbit : uint16_t {
+  kHbShift = kFmtShift + kFmtBits,
+  kHbBits  = 1,
+  kHbMask  = ((1 << kHbBits) - 1) << kHbShift,
+
+  kHbTrue  = 0,
+  kHbHint  = 1 << kHbShift,
+};
+
 // Update this assertion (and comments above) when adding or removing bits:
-static_assert(kFmtShift + kFmtBits == 13, "number of bits changed");
+static_assert(kHbShift + kHbBits == 14, "number of bits changed");
 
 // This assertion should not change unless the storage width changes:
-static_assert(kFmtShift + kFmtBits <= 16, "too many bits");
+static_assert(kHbShift + kHbBits <= 16, "too many bits");
 
 // Convenience aliases (16 bits, with format):
 enum FieldType : uint16_t {
@@ -829,13 +842,38 @@ class PROTOBUF_EXPORT TcParser final {
   static void CheckHasBitConsistency(const MessageLite* msg,
                                      const TcParseTableBase* table);
 
+  // Table-driven implementations of MessageEquals() and MessageHash(). See
+  // message_equality.h.
+  static bool MessageEquals(const MessageLite& a, const MessageLite& b);
+  static uint64_t MessageHash(const MessageLite& msg);
+
   static constexpr uint16_t kMiniParseTableTypeCardMask =
       +field_layout::kSplitMask | field_layout::kFkMask;
 
+  // Continuations for the straight-line parse functions protoc emits for
+  // messages with `features.(pb.cpp).unrolled_codegen`. Those functions are
+  // installed as fast-table entries, parse a run of fields in field number
+  // order, and then hand control back to the table-driven loop through one of
+  // these.
+  PROTOBUF_CC static const char* UnrolledContinue(
+      PROTOBUF_TC_PARAM_NO_DATA_DECL);
+  PROTOBUF_CC static const char* UnrolledError(PROTOBUF_TC_PARAM_NO_DATA_DECL);
+
  private:
   static const TailCallParseFunc kMiniParseTable[];
   static const size_t kMiniParseTableSize;
 
+  // Dispatches fields until the end of input or a terminating tag. Shared by
+  // ParseLoop and ParseProjectedFields; does not run the post-loop handler.
+  static const char* ParseFields(MessageLite* msg, const char* ptr,
+                                 ParseContext* ctx,
+                                 const TcParseTableBase* table);
+  // Like ParseFields, but skips the fields that are not selected by
+  // `ctx->data().projection`. See ParseProjection.
+  PROTOBUF_NOINLINE static const char* ParseProjectedFields(
+      MessageLite* msg, const char* ptr, ParseContext* ctx,
+      const TcParseTableBase* table);
+
   // Returns true if the repeated field is empty. This method is not
   // well-optimized, so it should only be called in debug builds.
   static bool RepeatedFieldIsEmptySlow(
@@ -843,6 +881,17 @@ class PROTOBUF_EXPORT TcParser final {
       const TcParseTableBase::FieldEntry& entry, const void* base,
       bool is_split);
 
+  // Helpers for MessageEquals() and MessageHash(). The field must be present
+  // in the messages, or be a field without presence.
+  static bool FieldEquals(const TcParseTableBase* table,
+                          const TcParseTableBase::FieldEntry& entry,
+                          const MessageLite& a, const MessageLite& b);
+  // Returns 0 if the field holds its default value.
+  static uint64_t FieldHash(const TcParseTableBase* table,
+                            const TcParseTableBase::FieldEntry& entry,
+                            const MessageLite& msg);
+  static bool MapEquals(const UntypedMapBase& a, const UntypedMapBase& b);
+
   template <typename TagTaype>
   PROTOBUF_ALWAYS_INLINE PROTOBUF_CC static const char* FastMpImpl(
       PROTOBUF_TC_PARAM_DECL);
@@ -1130,7 +1179,17 @@ PROTOBUF_ALWAYS_INLINE const char* TcParser::ToParseLoop(
   return ptr;
 }
 
-PROTOBUF_ALWAYS_INLINE const char* TcParser::ParseLoop(
+PROTOBUF_ALWAYS_INLINE const char* TcParser::UnrolledContinue(
+    PROTOBUF_TC_PARAM_NO_DATA_DECL) {
+  PROTOBUF_MUSTTAIL return ToTagDispatch(PROTOBUF_TC_PARAM_NO_DATA_PASS);
+}
+
+PROTOBUF_ALWAYS_INLINE const char* TcParser::UnrolledError(
+    PROTOBUF_TC_PARAM_NO_DATA_DECL) {
+  PROTOBUF_MUSTTAIL return Error(PROTOBUF_TC_PARAM_NO_DATA_PASS);
+}
+
+PROTOBUF_ALWAYS_INLINE const char* TcParser::ParseFields(
     MessageLite* msg, const char* ptr, ParseContext* ctx,
     const TcParseTableBase* table) {
   // Note: TagDispatch uses a dispatch table at "&table->fast_entries".
@@ -1152,7 +1211,17 @@ PROTOBUF_ALWAYS_INLINE const char* TcParser::ParseLoop(
     if (ptr == nullptr) break;
     if (ctx->LastTag() != 1) break;  // Ended on terminating tag
   }
-  table -= 1;
+  return ptr;
+}
+
+PROTOBUF_ALWAYS_INLINE const char* TcParser::ParseLoop(
+    MessageLite* msg, const char* ptr, ParseContext* ctx,
+    const TcParseTableBase* table) {
+  if (ABSL_PREDICT_FALSE(ctx->data().projection != nullptr)) {
+    ptr = ParseProjectedFields(msg, ptr, ctx, table);
+  } else {
+    ptr = ParseFields(msg, ptr, ctx, table);
+  }
   if (ABSL_PREDICT_FALSE(table->has_post_loop_handler)) {
     return table->post_loop_handler(msg, ptr, ctx);
   }
@@ -6,6 +6,7 @@
 // https://developers.google.com/open-source/licenses/bsd
 
 #include <algorithm>
+#include <climits>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -39,6 +40,7 @@
 #include "google/protobuf/message_traits.h"
 #include "google/protobuf/micro_string.h"
 #include "google/protobuf/parse_context.h"
+#include "google/protobuf/parse_projection.h"
 #include "google/protobuf/port.h"
 #include "google/protobuf/repeated_field.h"
 #include "google/protobuf/repeated_ptr_field.h"
@@ -306,6 +308,94 @@ PROTOBUF_NOINLINE const char* TcParser::ParseLoopPreserveNone(
   return ParseLoop(msg, ptr, ctx, table);
 }
 
+PROTOBUF_NOINLINE const char* TcParser::ParseProjectedFields(
+    MessageLite* msg, const char* ptr, ParseContext* ctx,
+    const TcParseTableBase* table) {
+  const ParseProjectionNode* projection = ctx->data().projection;
+  while (!ctx->Done(&ptr)) {
+    const char* field_start = ptr;
+    uint32_t tag;
+    ptr = ReadTag(ptr, &tag);
+    if (ABSL_PREDICT_FALSE(ptr == nullptr)) return nullptr;
+    const uint32_t wire_type = tag & 7;
+    if (tag == 0 || wire_type == WireFormatLite::WIRETYPE_END_GROUP) {
+      ctx->SetLastTag(tag);
+      break;
+    }
+
+    const ParseProjectionNode* child;
+    if (!projection->Find(tag >> 3, &child)) {
+      // Unselected fields are skipped without being stored as unknown.
+      ptr = UnknownFieldParse(tag, nullptr, ptr, ctx);
+      if (ABSL_PREDICT_FALSE(ptr == nullptr)) return nullptr;
+      continue;
+    }
+
+    if (wire_type == WireFormatLite::WIRETYPE_START_GROUP) {
+      // The extent of a group is unknown until it has been scanned, so copy it
+      // out and parse the copy on its own.
+      std::string group;
+      ptr = UnknownFieldParse(tag, &group, ptr, ctx);
+      if (ABSL_PREDICT_FALSE(ptr == nullptr)) return nullptr;
+      const char* group_ptr;
+      ParseContext group_ctx(ParseContext::kSpawn, *ctx, &group_ptr,
+                             absl::string_view(group));
+      group_ctx.data().projection = child;
+      group_ptr = ParseFields(msg, group_ptr, &group_ctx, table);
+      if (ABSL_PREDICT_FALSE(group_ptr == nullptr ||
+                             !group_ctx.EndedAtLimit())) {
+        return nullptr;
+      }
+      continue;
+    }
+
+    // Bound the input to this one field and dispatch it normally. Everything
+    // up to the field's payload lies within the slop region, so it can be
+    // read directly.
+    int size;
+    switch (wire_type) {
+      case WireFormatLite::WIRETYPE_VARINT: {
+        const char* p = ptr;
+        while (static_cast<uint8_t>(*p) & 0x80) {
+          if (ABSL_PREDICT_FALSE(++p - ptr == 10)) return nullptr;
+        }
+        size = static_cast<int>(p + 1 - field_start);
+        break;
+      }
+      case WireFormatLite::WIRETYPE_FIXED64:
+        size = static_cast<int>(ptr + 8 - field_start);
+        break;
+      case WireFormatLite::WIRETYPE_FIXED32:
+        size = static_cast<int>(ptr + 4 - field_start);
+        break;
+      case WireFormatLite::WIRETYPE_LENGTH_DELIMITED: {
+        const char* p = ptr;
+        const uint32_t length = ReadSize(&p);
+        if (ABSL_PREDICT_FALSE(p == nullptr)) return nullptr;
+        const int header = static_cast<int>(p - field_start);
+        // PushLimit() requires the limit to stay kSlopBytes (16) below
+        // INT_MAX.
+        if (ABSL_PREDICT_FALSE(length >
+                               static_cast<uint32_t>(INT_MAX - 16 - header))) {
+          return nullptr;
+        }
+        size = header + static_cast<int>(length);
+        break;
+      }
+      default:
+        return nullptr;
+    }
+
+    ctx->data().projection = child;
+    auto old_limit = ctx->PushLimit(field_start, size);
+    ptr = ParseFields(msg, field_start, ctx, table);
+    const bool ended_at_limit = ctx->PopLimit(std::move(old_limit));
+    ctx->data().projection = projection;
+    if (ABSL_PREDICT_FALSE(ptr == nullptr || !ended_at_limit)) return nullptr;
+  }
+  return ptr;
+}
+
 // On the fast path, a (matching) 1-byte tag already has the decoded value.
 static uint32_t FastDecodeTag(uint8_t coded_tag) { return coded_tag; }
 
@@ -3151,7 +3241,8 @@ std::string TypeCardToString(uint16_t type_card) {
 
   switch (type_card & fl::kFkMask) {
     case fl::kFkString: {
-      switch (type_card & ~fl::kFcMask & ~fl::kRepMask & ~fl::kSplitMask) {
+      switch (type_card & ~fl::kFcMask & ~fl::kRepMask & ~fl::kSplitMask &
+              ~fl::kHbMask) {
         PROTOBUF_INTERNAL_TYPE_CARD_CASE(Bytes);
         PROTOBUF_INTERNAL_TYPE_CARD_CASE(Utf8String);
         default:
@@ -3207,7 +3298,7 @@ std::string TypeCardToString(uint16_t type_card) {
     case fl::kFkPackedVarint:
     case fl::kFkFixed:
     case fl::kFkPackedFixed: {
-      switch (type_card & ~fl::kFcMask & ~fl::kSplitMask) {
+      switch (type_card & ~fl::kFcMask & ~fl::kSplitMask & ~fl::kHbMask) {
         PROTOBUF_INTERNAL_TYPE_CARD_CASE(Bool);
         PROTOBUF_INTERNAL_TYPE_CARD_CASE(Fixed32);
         PROTOBUF_INTERNAL_TYPE_CARD_CASE(UInt32);
@@ -3250,6 +3341,10 @@ std::string TypeCardToString(uint16_t type_card) {
     absl::StrAppend(&out, " | ::_fl::kSplitTrue");
   }
 
+  if (type_card & fl::kHbMask) {
+    absl::StrAppend(&out, " | ::_fl::kHbHint");
+  }
+
 #undef PROTOBUF_INTERNAL_TYPE_CARD_CASE
 
   return out;
@@ -30,6 +30,7 @@
 #include "google/protobuf/io/coded_stream.h"
 #include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 #include "google/protobuf/message_lite.h"
+#include "google/protobuf/micro_string.h"
 #include "google/protobuf/parse_context.h"
 #include "google/protobuf/port.h"
 #include "google/protobuf/test_protos/tctable_long_name_test.pb.h"
@@ -1071,6 +1072,55 @@ TEST(TcParserTest, OobGenReproduction) {
   (void)msg->ParseFromString(payload);
 }
 
+namespace {
+
+// Reads a length-prefixed string from `input` into `str`.
+const char* ReadMicroString(absl::string_view input, bool aliasing,
+                            MicroString& str, Arena* arena) {
+  const char* ptr = nullptr;
+  ParseContext ctx(io::CodedInputStream::GetDefaultRecursionLimit(), aliasing,
+                   &ptr, input);
+  return ctx.ReadMicroString(ptr, str, MicroString::kInlineCapacity, arena);
+}
+
+bool PointsInto(absl::string_view outer, absl::string_view inner) {
+  return inner.data() >= outer.data() &&
+         inner.data() + inner.size() <= outer.data() + outer.size();
+}
+
+TEST(ParseContextTest, ReadMicroStringAliasesInput) {
+  Arena arena;
+  // Long enough that the input is read in place, and short enough that it is
+  // copied into the patch buffer first.
+  for (size_t payload_size : {100, 12}) {
+    const std::string payload(payload_size, 'x');
+    const std::string input =
+        absl::StrCat(std::string(1, static_cast<char>(payload_size)), payload);
+    for (Arena* a : {&arena, static_cast<Arena*>(nullptr)}) {
+      SCOPED_TRACE(absl::StrCat(payload_size, a == nullptr ? " heap" : ""));
+      MicroString str;
+      ASSERT_NE(ReadMicroString(input, /*aliasing=*/true, str, a), nullptr);
+      EXPECT_EQ(str.Get(), payload);
+      EXPECT_TRUE(PointsInto(input, str.Get()));
+
+      ASSERT_NE(ReadMicroString(input, /*aliasing=*/false, str, a), nullptr);
+      EXPECT_EQ(str.Get(), payload);
+      EXPECT_FALSE(PointsInto(input, str.Get()));
+      if (a == nullptr) str.Destroy();
+    }
+  }
+}
+
+TEST(ParseContextTest, ReadMicroStringCopiesInlinePayloads) {
+  const std::string input = "\x03abc";
+  MicroString str;
+  ASSERT_NE(ReadMicroString(input, /*aliasing=*/true, str, nullptr), nullptr);
+  EXPECT_EQ(str.Get(), "abc");
+  EXPECT_FALSE(PointsInto(input, str.Get()));
+  str.Destroy();
+}
+
+}  // namespace
 }  // namespace internal
 }  // namespace protobuf
 }  // namespace google
@@ -68,8 +68,10 @@
 #include "google/protobuf/io/tokenizer.h"
 
 #include <algorithm>
+#include <cstring>
 #include <limits>
 #include <string>
+#include <utility>
 
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
@@ -607,7 +609,10 @@ bool Tokenizer::TryConsumeNewline() {
 // -------------------------------------------------------------------
 
 bool Tokenizer::Next() {
-  previous_ = current_;
+  // Every path below reinitializes current_, so swap rather than copy to keep
+  // the token text buffers (and their capacity) alive across calls.
+  using std::swap;
+  swap(previous_, current_);
 
   while (!read_error_) {
     StartToken();
@@ -1187,58 +1192,70 @@ void Tokenizer::ParseStringAppend(const std::string& text,
   // interpreting escape sequences.  Note that any invalid escape
   // sequences or other errors were already reported while tokenizing.
   // In this case we do not need to produce valid results.
-  for (const char* ptr = text.c_str() + 1; *ptr != '\0'; ptr++) {
-    if (*ptr == '\\' && ptr[1] != '\0') {
-      // An escape sequence.
-      ++ptr;
-
-      if (kOctalDigit.contains(*ptr)) {
-        // An octal escape.  May one, two, or three digits.
-        int code = DigitValue(*ptr);
-        if (kOctalDigit.contains(ptr[1])) {
-          ++ptr;
-          code = code * 8 + DigitValue(*ptr);
-        }
-        if (kOctalDigit.contains(ptr[1])) {
-          ++ptr;
-          code = code * 8 + DigitValue(*ptr);
-        }
-        output->push_back(static_cast<char>(code));
-
-      } else if (*ptr == 'x' || *ptr == 'X') {
-        // A hex escape.  May zero, one, or two digits.  (The zero case
-        // will have been caught as an error earlier.)
-        int code = 0;
-        if (kHexDigit.contains(ptr[1])) {
-          ++ptr;
-          code = DigitValue(*ptr);
-        }
-        if (kHexDigit.contains(ptr[1])) {
-          ++ptr;
-          code = code * 16 + DigitValue(*ptr);
-        }
-        output->push_back(static_cast<char>(code));
-
-      } else if (*ptr == 'u' || *ptr == 'U') {
-        uint32_t unicode;
-        const char* end = FetchUnicodePoint(ptr, &unicode);
-        if (end == ptr) {
-          // Failure: Just dump out what we saw, don't try to parse it.
-          output->push_back(*ptr);
-        } else {
-          AppendUTF8(unicode, output);
-          ptr = end - 1;  // Because we're about to ++ptr.
-        }
+  const char* ptr = text.c_str() + 1;
+  while (*ptr != '\0') {
+    // Copy everything up to the next escape sequence in one go; most string
+    // literals in large text-format inputs contain no escapes at all.
+    size_t run = strcspn(ptr, "\\");
+    if (ptr[run] == '\0') {
+      // Ignore final quote matching the starting quote.
+      if (ptr[run - 1] == text[0]) --run;
+      output->append(ptr, run);
+      return;
+    }
+    output->append(ptr, run);
+    ptr += run;
+    if (ptr[1] == '\0') {
+      // A trailing backslash is copied as-is.
+      output->push_back('\\');
+      return;
+    }
+
+    // An escape sequence.
+    ++ptr;
+
+    if (kOctalDigit.contains(*ptr)) {
+      // An octal escape.  May one, two, or three digits.
+      int code = DigitValue(*ptr);
+      if (kOctalDigit.contains(ptr[1])) {
+        ++ptr;
+        code = code * 8 + DigitValue(*ptr);
+      }
+      if (kOctalDigit.contains(ptr[1])) {
+        ++ptr;
+        code = code * 8 + DigitValue(*ptr);
+      }
+      output->push_back(static_cast<char>(code));
+
+    } else if (*ptr == 'x' || *ptr == 'X') {
+      // A hex escape.  May zero, one, or two digits.  (The zero case
+      // will have been caught as an error earlier.)
+      int code = 0;
+      if (kHexDigit.contains(ptr[1])) {
+        ++ptr;
+        code = DigitValue(*ptr);
+      }
+      if (kHexDigit.contains(ptr[1])) {
+        ++ptr;
+        code = code * 16 + DigitValue(*ptr);
+      }
+      output->push_back(static_cast<char>(code));
+
+    } else if (*ptr == 'u' || *ptr == 'U') {
+      uint32_t unicode;
+      const char* end = FetchUnicodePoint(ptr, &unicode);
+      if (end == ptr) {
+        // Failure: Just dump out what we saw, don't try to parse it.
+        output->push_back(*ptr);
       } else {
-        // Some other escape code.
-        output->push_back(TranslateEscape(*ptr));
+        AppendUTF8(unicode, output);
+        ptr = end - 1;  // Because we're about to ++ptr.
       }
-
-    } else if (*ptr == text[0] && ptr[1] == '\0') {
-      // Ignore final quote matching the starting quote.
     } else {
-      output->push_back(*ptr);
+      // Some other escape code.
+      output->push_back(TranslateEscape(*ptr));
     }
+    ++ptr;
   }
 }
 
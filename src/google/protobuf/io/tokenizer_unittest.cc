@@ -21,6 +21,7 @@
 #include <gmock/gmock.h>
 #include "absl/base/macros.h"
 #include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/substitute.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
 #include "google/protobuf/testing/googletest.h"
@@ -1189,6 +1190,11 @@ TEST_F(TokenizerTest, ParseString) {
   EXPECT_EQ("\x20\x4", output);
   Tokenizer::ParseString("'\\X20\\X4'", &output);
   EXPECT_EQ("\x20\x4", output);
+  Tokenizer::ParseString("'it\"s \\'quoted\\''", &output);
+  EXPECT_EQ("it\"s 'quoted'", output);
+  Tokenizer::ParseString(absl::StrCat("'", std::string(1000, 'a'), "\\n'"),
+                         &output);
+  EXPECT_EQ(absl::StrCat(std::string(1000, 'a'), "\n"), output);
 
   // Test invalid strings that may still be tokenized as strings.
   Tokenizer::ParseString("\"\\a\\l\\v\\t", &output);  // \l is invalid
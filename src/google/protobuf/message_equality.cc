@@ -0,0 +1,570 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/message_equality.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "absl/algorithm/container.h"
+#include "absl/base/casts.h"
+#include "absl/hash/hash.h"
+#include "absl/numeric/bits.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/arenastring.h"
+#include "google/protobuf/extension_set.h"
+#include "google/protobuf/generated_message_tctable_decl.h"
+#include "google/protobuf/generated_message_tctable_impl.h"
+#include "google/protobuf/has_bits.h"
+#include "google/protobuf/inlined_string_field.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/map.h"
+#include "google/protobuf/message_lite.h"
+#include "google/protobuf/micro_string.h"
+#include "google/protobuf/port.h"
+#include "google/protobuf/repeated_field.h"
+#include "google/protobuf/repeated_ptr_field.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+namespace {
+
+namespace fl = field_layout;
+using FieldEntry = TcParseTableBase::FieldEntry;
+
+// Calls `f(entry, field_number)` for each field entry of `table` in field
+// number order, stopping early if `f` returns false. Returns false if it did.
+template <typename F>
+bool VisitFieldEntries(const TcParseTableBase* table, F f) {
+  // Field entries are in the same order as the fields in the lookup bitmaps,
+  // see TcParser::FieldNumber().
+  const FieldEntry* entry = table->field_entries_begin();
+  const auto visit_bitmap = [&](uint32_t field_bitmap,
+                                uint32_t base_field_number) {
+    for (; field_bitmap != 0; field_bitmap &= field_bitmap - 1) {
+      if (!f(*entry++, absl::countr_zero(field_bitmap) + base_field_number)) {
+        return false;
+      }
+    }
+    return true;
+  };
+  if (!visit_bitmap(~table->skipmap32, 1)) return false;
+  for (const uint16_t* lookup_table = table->field_lookup_begin();
+       lookup_table[0] != 0xFFFF || lookup_table[1] != 0xFFFF;) {
+    uint32_t fstart = lookup_table[0] | (lookup_table[1] << 16);
+    lookup_table += 2;
+    const uint16_t num_skip_entries = *lookup_table++;
+    for (uint16_t i = 0; i < num_skip_entries; ++i) {
+      if (!visit_bitmap(static_cast<uint16_t>(~*lookup_table),
+                        fstart + 16 * i)) {
+        return false;
+      }
+      lookup_table += 2;
+    }
+  }
+  return true;
+}
+
+// Returns false for fields whose storage the tables do not describe: weak
+// fields (kFkNone), lazy fields and string representations only used through
+// reflection.
+bool IsTableComparable(uint16_t type_card) {
+  switch (type_card & fl::kFkMask) {
+    case fl::kFkNone:
+      return false;
+    case fl::kFkString:
+      switch (type_card & fl::kRepMask) {
+        case fl::kRepSString:
+        case fl::kRepCord:
+          return true;
+        case fl::kRepAString:
+        case fl::kRepIString:
+        case fl::kRepMString:
+          return (type_card & fl::kFcMask) != fl::kFcRepeated;
+        default:
+          return false;
+      }
+    case fl::kFkMessage:
+      return (type_card & fl::kRepMask) != fl::kRepLazy;
+    default:
+      return true;
+  }
+}
+
+// Whether the field is present according to its has bit or oneof case.
+// Fields without presence are reported as present, unless a hint has bit says
+// they still hold their default value.
+bool HasField(const FieldEntry& entry, uint32_t field_number,
+              const MessageLite& msg) {
+  switch (entry.type_card & fl::kFcMask) {
+    case fl::kFcOneof:
+      // The _oneof_case_ value offset is stored in the has-bit index.
+      return TcParser::RefAt<uint32_t>(&msg, entry.has_idx) == field_number;
+    case fl::kFcOptional: {
+      if (entry.has_idx == kNoHasbit) return true;
+      const auto has_idx = static_cast<uint32_t>(entry.has_idx);
+      return (TcParser::RefAt<uint32_t>(&msg, has_idx / 32 * 4) &
+              (uint32_t{1} << (has_idx % 32))) != 0;
+    }
+    default:
+      return true;
+  }
+}
+
+bool HasExplicitPresence(const FieldEntry& entry) {
+  const uint16_t card = entry.type_card & fl::kFcMask;
+  return card == fl::kFcOneof ||
+         (card == fl::kFcOptional && entry.has_idx != kNoHasbit &&
+          (entry.type_card & fl::kHbMask) == fl::kHbTrue);
+}
+
+template <typename T>
+bool RepeatedFieldEquals(const RepeatedField<T>& a, const RepeatedField<T>& b) {
+  return a.size() == b.size() &&
+         (a.empty() ||
+          std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+template <typename T>
+uint64_t RepeatedFieldHash(const RepeatedField<T>& field) {
+  if (field.empty()) return 0;
+  return absl::HashOf(
+      absl::string_view(reinterpret_cast<const char*>(field.data()),
+                        field.size() * sizeof(T)));
+}
+
+template <typename T>
+uint64_t StringHash(const T& value) {
+  return value.empty() ? 0 : absl::HashOf(value);
+}
+
+template <typename T>
+uint64_t RepeatedStringHash(const T& field) {
+  uint64_t hash = 0;
+  for (const auto& value : field) hash = absl::HashOf(hash, value);
+  return hash;
+}
+
+// Map values are visited as their storage type; enums are visited as
+// uint32_t.
+template <typename T>
+bool MapValueEquals(const T& a, const T& b) {
+  return a == b;
+}
+bool MapValueEquals(float a, float b) {
+  return absl::bit_cast<uint32_t>(a) == absl::bit_cast<uint32_t>(b);
+}
+bool MapValueEquals(double a, double b) {
+  return absl::bit_cast<uint64_t>(a) == absl::bit_cast<uint64_t>(b);
+}
+bool MapValueEquals(const MessageLite& a, const MessageLite& b) {
+  return TcParser::MessageEquals(a, b);
+}
+
+template <typename T>
+uint64_t MapValueHash(const T& value) {
+  return absl::HashOf(value);
+}
+uint64_t MapValueHash(float value) {
+  return absl::bit_cast<uint32_t>(value);
+}
+uint64_t MapValueHash(double value) { return absl::bit_cast<uint64_t>(value); }
+uint64_t MapValueHash(const MessageLite& value) {
+  return TcParser::MessageHash(value);
+}
+
+// Entries are combined with addition so that the result does not depend on
+// iteration order.
+uint64_t MapHash(const UntypedMapBase& map) {
+  uint64_t hash = 0;
+  map.VisitAllNodes([&](const auto* key, const auto* value) {
+    hash += absl::HashOf(*key, MapValueHash(*value));
+  });
+  return hash;
+}
+
+const UntypedMapBase& GetMap(const TcParseTableBase* table,
+                             const FieldEntry& entry, const void* base) {
+  const auto map_info = table->field_aux(&entry)[0].map_info;
+  return map_info.use_lite
+             ? TcParser::RefAt<const UntypedMapBase>(base, entry.offset)
+             : TcParser::RefAt<const MapFieldBaseForParse>(base, entry.offset)
+                   .GetMap();
+}
+
+const void* GetFieldBase(const TcParseTableBase* table, const FieldEntry& entry,
+                         const MessageLite& msg) {
+  if ((entry.type_card & fl::kSplitMask) == fl::kSplitFalse) return &msg;
+  const size_t offset = table->field_aux(kSplitOffsetAuxIdx)->offset;
+  return TcParser::RefAt<const void*>(&msg, offset);
+}
+
+std::string SerializeDeterministically(const MessageLite& msg) {
+  std::string out;
+  {
+    io::StringOutputStream stream(&out);
+    io::CodedOutputStream coded(&stream);
+    coded.SetSerializationDeterministic(true);
+    (void)msg.SerializePartialToCodedStream(&coded);
+  }
+  return out;
+}
+
+std::string SerializeExtensions(const ExtensionSet& extensions,
+                                const MessageLite& extendee) {
+  std::string out;
+  // Serialization relies on the sizes cached by ByteSize().
+  (void)extensions.ByteSize();
+  {
+    io::StringOutputStream stream(&out);
+    io::CodedOutputStream coded(&stream);
+    coded.SetSerializationDeterministic(true);
+    coded.SetCur(extensions._InternalSerializeAll(&extendee, coded.Cur(),
+                                                  coded.EpsCopy()));
+  }
+  return out;
+}
+
+bool ExtensionsEqual(const TcParseTableBase* table, const MessageLite& a,
+                     const MessageLite& b) {
+  const auto& ext_a = TcParser::RefAt<ExtensionSet>(&a, table->extension_offset);
+  const auto& ext_b = TcParser::RefAt<ExtensionSet>(&b, table->extension_offset);
+  const bool empty_a = ext_a.IsEmpty();
+  if (empty_a != ext_b.IsEmpty()) return false;
+  return empty_a ||
+         SerializeExtensions(ext_a, a) == SerializeExtensions(ext_b, b);
+}
+
+}  // namespace
+
+bool TcParser::MessageEquals(const MessageLite& a, const MessageLite& b) {
+  if (&a == &b) return true;
+  const ClassData* class_data = a.GetClassData();
+  if (class_data != b.GetClassData()) return false;
+  const TcParseTableBase* table = class_data->GetTcParseTable();
+
+  // Has bits are compared a 32-bit word at a time. Fields whose bit is clear
+  // in both messages are skipped without touching their storage.
+  uint32_t has_word_idx = ~uint32_t{0};
+  uint32_t has_word_a = 0;
+  uint32_t has_word_diff = 0;
+  bool compare_serialized = false;
+  const bool equal =
+      VisitFieldEntries(table, [&](const FieldEntry& entry, uint32_t number) {
+        const uint16_t card = entry.type_card & fl::kFcMask;
+        if (card == fl::kFcOneof) {
+          const bool has_a = HasField(entry, number, a);
+          if (has_a != HasField(entry, number, b)) return false;
+          if (!has_a) return true;
+        } else if (card == fl::kFcOptional && entry.has_idx != kNoHasbit) {
+          const auto has_idx = static_cast<uint32_t>(entry.has_idx);
+          if (has_idx / 32 != has_word_idx) {
+            has_word_idx = has_idx / 32;
+            has_word_a = RefAt<uint32_t>(&a, has_word_idx * 4);
+            has_word_diff = has_word_a ^ RefAt<uint32_t>(&b, has_word_idx * 4);
+          }
+          const uint32_t mask = uint32_t{1} << (has_idx % 32);
+          if ((entry.type_card & fl::kHbMask) == fl::kHbHint) {
+            // A hint has bit may be set for a default value, so only skip
+            // the field when it is clear in both messages.
+            if (((has_word_a | has_word_diff) & mask) == 0) return true;
+          } else {
+            if ((has_word_diff & mask) != 0) return false;
+            if ((has_word_a & mask) == 0) return true;
+          }
+        }
+        if (ABSL_PREDICT_FALSE(!IsTableComparable(entry.type_card))) {
+          compare_serialized = true;
+          return true;
+        }
+        return FieldEquals(table, entry, a, b);
+      });
+  if (!equal) return false;
+  if (table->extension_offset != 0 && !ExtensionsEqual(table, a, b)) {
+    return false;
+  }
+  if (ABSL_PREDICT_FALSE(compare_serialized)) {
+    return SerializeDeterministically(a) == SerializeDeterministically(b);
+  }
+  return true;
+}
+
+bool TcParser::FieldEquals(const TcParseTableBase* table,
+                           const FieldEntry& entry, const MessageLite& a,
+                           const MessageLite& b) {
+  const uint16_t type_card = entry.type_card;
+  const bool is_split = (type_card & fl::kSplitMask) == fl::kSplitTrue;
+  const bool is_repeated = (type_card & fl::kFcMask) == fl::kFcRepeated;
+  const void* base_a = GetFieldBase(table, entry, a);
+  const void* base_b = GetFieldBase(table, entry, b);
+  const auto field_a = [&](auto type) -> const auto& {
+    using T = typename decltype(type)::type;
+    return is_repeated ? GetRepeatedFieldAt<T>(base_a, entry.offset, &a,
+                                               is_split)
+                       : RefAt<T>(base_a, entry.offset);
+  };
+  const auto field_b = [&](auto type) -> const auto& {
+    using T = typename decltype(type)::type;
+    return is_repeated ? GetRepeatedFieldAt<T>(base_b, entry.offset, &b,
+                                               is_split)
+                       : RefAt<T>(base_b, entry.offset);
+  };
+  const auto equal = [&](auto type) {
+    return field_a(type) == field_b(type);
+  };
+  const auto repeated_equal = [&](auto type) {
+    return RepeatedFieldEquals(field_a(type), field_b(type));
+  };
+  const auto elements_equal = [&](auto type) {
+    return absl::c_equal(field_a(type), field_b(type));
+  };
+
+  switch (type_card & fl::kFkMask) {
+    case fl::kFkVarint:
+    case fl::kFkFixed:
+      if (!is_repeated) {
+        // Floating point values are compared bitwise.
+        switch (type_card & fl::kRepMask) {
+          case fl::kRep8Bits:
+            return equal(std::enable_if<true, bool>{});
+          case fl::kRep32Bits:
+            return equal(std::enable_if<true, uint32_t>{});
+          case fl::kRep64Bits:
+            return equal(std::enable_if<true, uint64_t>{});
+          default:
+            Unreachable();
+        }
+      }
+      ABSL_FALLTHROUGH_INTENDED;
+    case fl::kFkPackedVarint:
+    case fl::kFkPackedFixed:
+      switch (type_card & fl::kRepMask) {
+        case fl::kRep8Bits:
+          return repeated_equal(std::enable_if<true, RepeatedField<bool>>{});
+        case fl::kRep32Bits:
+          return repeated_equal(
+              std::enable_if<true, RepeatedField<uint32_t>>{});
+        case fl::kRep64Bits:
+          return repeated_equal(
+              std::enable_if<true, RepeatedField<uint64_t>>{});
+        default:
+          Unreachable();
+      }
+
+    case fl::kFkString:
+      switch (type_card & fl::kRepMask) {
+        case fl::kRepAString:
+          return field_a(std::enable_if<true, ArenaStringPtr>{}).Get() ==
+                 field_b(std::enable_if<true, ArenaStringPtr>{}).Get();
+        case fl::kRepIString:
+          return field_a(std::enable_if<true, InlinedStringField>{}).Get() ==
+                 field_b(std::enable_if<true, InlinedStringField>{}).Get();
+        case fl::kRepMString:
+          return field_a(std::enable_if<true, MicroString>{}).Get() ==
+                 field_b(std::enable_if<true, MicroString>{}).Get();
+        case fl::kRepCord:
+          if (is_repeated) {
+            return elements_equal(
+                std::enable_if<true, RepeatedField<absl::Cord>>{});
+          }
+          return equal(std::enable_if<true, absl::Cord>{});
+        case fl::kRepSString:
+          return elements_equal(
+              std::enable_if<true, RepeatedPtrField<std::string>>{});
+        default:
+          Unreachable();
+      }
+
+    case fl::kFkMessage: {
+      if (is_repeated) {
+        const auto& messages_a =
+            field_a(std::enable_if<true, RepeatedPtrFieldBase>{});
+        const auto& messages_b =
+            field_b(std::enable_if<true, RepeatedPtrFieldBase>{});
+        const int size = messages_a.size();
+        if (size != messages_b.size()) return false;
+        void* const* elements_a = messages_a.raw_data();
+        void* const* elements_b = messages_b.raw_data();
+        for (int i = 0; i < size; ++i) {
+          if (!MessageEquals(*static_cast<const MessageLite*>(elements_a[i]),
+                             *static_cast<const MessageLite*>(elements_b[i]))) {
+            return false;
+          }
+        }
+        return true;
+      }
+      const MessageLite* msg_a = RefAt<const MessageLite*>(base_a, entry.offset);
+      const MessageLite* msg_b = RefAt<const MessageLite*>(base_b, entry.offset);
+      if (ABSL_PREDICT_FALSE(msg_a == nullptr || msg_b == nullptr)) {
+        // Only fields without presence can be null here. An unset message
+        // equals an empty one.
+        if (msg_a == msg_b) return true;
+        const MessageLite* msg = msg_a != nullptr ? msg_a : msg_b;
+        return MessageEquals(*msg, *msg->GetClassData()->default_instance());
+      }
+      return MessageEquals(*msg_a, *msg_b);
+    }
+
+    case fl::kFkMap:
+      return MapEquals(GetMap(table, entry, base_a),
+                       GetMap(table, entry, base_b));
+
+    default:
+      Unreachable();
+  }
+}
+
+bool TcParser::MapEquals(const UntypedMapBase& a, const UntypedMapBase& b) {
+  if (a.size() != b.size()) return false;
+  if (a.empty()) return true;
+  bool equal = true;
+  a.VisitAllNodes([&](const auto* key, const auto* value) {
+    if (!equal) return;
+    using Key = std::decay_t<decltype(*key)>;
+    using Value = std::decay_t<decltype(*value)>;
+    const auto& typed_b = static_cast<const KeyMapBase<Key>&>(b);
+    NodeBase* node =
+        typed_b.FindHelper(TransparentSupport<Key>::ToView(*key)).node;
+    equal = node != nullptr && MapValueEquals(*value, *b.GetValue<Value>(node));
+  });
+  return equal;
+}
+
+uint64_t TcParser::MessageHash(const MessageLite& msg) {
+  const TcParseTableBase* table = msg.GetTcParseTable();
+  uint64_t hash = 0;
+  VisitFieldEntries(table, [&](const FieldEntry& entry, uint32_t number) {
+    if (!HasField(entry, number, msg)) return true;
+    const uint64_t field_hash = IsTableComparable(entry.type_card)
+                                    ? FieldHash(table, entry, msg)
+                                    : 0;
+    // MessageEquals() compares unset fields without presence as if they held
+    // their default value, so those must not contribute to the hash.
+    if (field_hash != 0 || HasExplicitPresence(entry)) {
+      hash = absl::HashOf(hash, number, field_hash);
+    }
+    return true;
+  });
+  return hash;
+}
+
+uint64_t TcParser::FieldHash(const TcParseTableBase* table,
+                             const FieldEntry& entry, const MessageLite& msg) {
+  const uint16_t type_card = entry.type_card;
+  const bool is_split = (type_card & fl::kSplitMask) == fl::kSplitTrue;
+  const bool is_repeated = (type_card & fl::kFcMask) == fl::kFcRepeated;
+  const void* base = GetFieldBase(table, entry, msg);
+  const auto field = [&](auto type) -> const auto& {
+    using T = typename decltype(type)::type;
+    return is_repeated
+               ? GetRepeatedFieldAt<T>(base, entry.offset, &msg, is_split)
+               : RefAt<T>(base, entry.offset);
+  };
+
+  switch (type_card & fl::kFkMask) {
+    case fl::kFkVarint:
+    case fl::kFkFixed:
+      if (!is_repeated) {
+        // The bits of the value are its hash, which is 0 for the default.
+        switch (type_card & fl::kRepMask) {
+          case fl::kRep8Bits:
+            return field(std::enable_if<true, bool>{});
+          case fl::kRep32Bits:
+            return field(std::enable_if<true, uint32_t>{});
+          case fl::kRep64Bits:
+            return field(std::enable_if<true, uint64_t>{});
+          default:
+            Unreachable();
+        }
+      }
+      ABSL_FALLTHROUGH_INTENDED;
+    case fl::kFkPackedVarint:
+    case fl::kFkPackedFixed:
+      switch (type_card & fl::kRepMask) {
+        case fl::kRep8Bits:
+          return RepeatedFieldHash(
+              field(std::enable_if<true, RepeatedField<bool>>{}));
+        case fl::kRep32Bits:
+          return RepeatedFieldHash(
+              field(std::enable_if<true, RepeatedField<uint32_t>>{}));
+        case fl::kRep64Bits:
+          return RepeatedFieldHash(
+              field(std::enable_if<true, RepeatedField<uint64_t>>{}));
+        default:
+          Unreachable();
+      }
+
+    case fl::kFkString:
+      switch (type_card & fl::kRepMask) {
+        case fl::kRepAString:
+          return StringHash(field(std::enable_if<true, ArenaStringPtr>{}).Get());
+        case fl::kRepIString:
+          return StringHash(
+              field(std::enable_if<true, InlinedStringField>{}).Get());
+        case fl::kRepMString:
+          return StringHash(field(std::enable_if<true, MicroString>{}).Get());
+        case fl::kRepCord:
+          if (is_repeated) {
+            return RepeatedStringHash(
+                field(std::enable_if<true, RepeatedField<absl::Cord>>{}));
+          }
+          return StringHash(field(std::enable_if<true, absl::Cord>{}));
+        case fl::kRepSString:
+          return RepeatedStringHash(
+              field(std::enable_if<true, RepeatedPtrField<std::string>>{}));
+        default:
+          Unreachable();
+      }
+
+    case fl::kFkMessage: {
+      if (is_repeated) {
+        const auto& messages =
+            field(std::enable_if<true, RepeatedPtrFieldBase>{});
+        void* const* elements = messages.raw_data();
+        uint64_t hash = 0;
+        for (int i = 0, size = messages.size(); i < size; ++i) {
+          hash = absl::HashOf(
+              hash, MessageHash(*static_cast<const MessageLite*>(elements[i])));
+        }
+        return hash;
+      }
+      const MessageLite* sub = RefAt<const MessageLite*>(base, entry.offset);
+      return sub == nullptr ? 0 : MessageHash(*sub);
+    }
+
+    case fl::kFkMap:
+      return MapHash(GetMap(table, entry, base));
+
+    default:
+      Unreachable();
+  }
+}
+
+}  // namespace internal
+
+bool MessageEquals(const MessageLite& a, const MessageLite& b) {
+  return internal::TcParser::MessageEquals(a, b);
+}
+
+size_t MessageHash(const MessageLite& msg) {
+  return static_cast<size_t>(internal::TcParser::MessageHash(msg));
+}
+
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
@@ -0,0 +1,85 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Reflection-free equality and hashing for messages.
+//
+// MessageEquals() and MessageHash() walk the table-driven parser's field
+// tables directly instead of going through Reflection, so they work for lite
+// messages and are much cheaper than util::MessageDifferencer for the common
+// "are these two messages identical?" question:
+//
+//   absl::flat_hash_set<MyMessage, MessageHasher, MessageEq> unique;
+//   if (MessageEquals(a, b)) { ... }
+//
+// Semantics match upb_Message_IsEqual() without options:
+//   * Messages of different types are never equal.
+//   * Fields with explicit presence must be present in both messages, or in
+//     neither. Fields without presence are compared by value, so an unset
+//     field equals one set to its default value.
+//   * float and double values are compared bitwise: NaN equals a NaN with the
+//     same bits, and 0.0 does not equal -0.0.
+//   * Repeated fields are compared in order. Map fields are compared as
+//     unordered collections.
+//   * Unknown fields are ignored. Extensions are compared by their
+//     deterministic serialization.
+//   * Messages with fields the tables do not describe (weak and lazy fields)
+//     are compared by their deterministic serialization, which includes
+//     unknown fields.
+//
+// MessageHash() is consistent with MessageEquals(): equal messages have equal
+// hashes. The value is only stable within a process, like absl::Hash.
+
+#ifndef GOOGLE_PROTOBUF_MESSAGE_EQUALITY_H__
+#define GOOGLE_PROTOBUF_MESSAGE_EQUALITY_H__
+
+#include <cstddef>
+#include <utility>
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+
+class MessageLite;
+
+// Returns true if `a` and `b` are messages of the same type with equal field
+// values. See above for details.
+PROTOBUF_EXPORT bool MessageEquals(const MessageLite& a, const MessageLite& b);
+
+// Returns a hash of `msg` that is consistent with MessageEquals().
+PROTOBUF_EXPORT size_t MessageHash(const MessageLite& msg);
+
+// Combines `msg` into the absl::Hash state `state`. This lets types holding
+// messages implement AbslHashValue() consistently with MessageEquals():
+//
+//   template <typename H>
+//   friend H AbslHashValue(H h, const Key& key) {
+//     return CombineMessageHash(std::move(h), key.msg);
+//   }
+template <typename H>
+H CombineMessageHash(H state, const MessageLite& msg) {
+  return H::combine(std::move(state), MessageHash(msg));
+}
+
+// Functors for hash containers keyed by messages.
+struct MessageEq {
+  bool operator()(const MessageLite& a, const MessageLite& b) const {
+    return MessageEquals(a, b);
+  }
+};
+
+struct MessageHasher {
+  size_t operator()(const MessageLite& msg) const { return MessageHash(msg); }
+};
+
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_MESSAGE_EQUALITY_H__
@@ -0,0 +1,255 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/message_equality.h"
+
+#include <limits>
+#include <utility>
+
+#include <gtest/gtest.h>
+#include "absl/container/flat_hash_set.h"
+#include "absl/hash/hash.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/duration.pb.h"
+#include "google/protobuf/map_test_util.h"
+#include "google/protobuf/map_unittest.pb.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/test_util.h"
+#include "google/protobuf/test_util_lite.h"
+#include "google/protobuf/unittest.pb.h"
+#include "google/protobuf/unittest_lite.pb.h"
+#include "google/protobuf/unittest_proto3.pb.h"
+#include "google/protobuf/unittest_proto3_optional.pb.h"
+
+namespace google {
+namespace protobuf {
+namespace {
+
+using ::proto2_unittest::TestAllExtensions;
+using ::proto2_unittest::TestAllTypes;
+using ::proto2_unittest::TestAllTypesLite;
+using ::proto2_unittest::TestMap;
+using ::proto2_unittest::TestOneof2;
+
+void ExpectEqual(const MessageLite& a, const MessageLite& b) {
+  EXPECT_TRUE(MessageEquals(a, b));
+  EXPECT_TRUE(MessageEquals(b, a));
+  EXPECT_EQ(MessageHash(a), MessageHash(b));
+}
+
+void ExpectNotEqual(const MessageLite& a, const MessageLite& b) {
+  EXPECT_FALSE(MessageEquals(a, b));
+  EXPECT_FALSE(MessageEquals(b, a));
+}
+
+TEST(MessageEqualityTest, EmptyMessagesAreEqual) {
+  ExpectEqual(TestAllTypes(), TestAllTypes());
+  ExpectEqual(TestAllTypes(), TestAllTypes::default_instance());
+}
+
+TEST(MessageEqualityTest, CopiesAreEqual) {
+  TestAllTypes a;
+  TestUtil::SetAllFields(&a);
+  TestAllTypes b = a;
+  ExpectEqual(a, b);
+
+  Arena arena;
+  auto* c = Arena::Create<TestAllTypes>(&arena, a);
+  ExpectEqual(a, *c);
+}
+
+TEST(MessageEqualityTest, DetectsEveryField) {
+  TestAllTypes a;
+  TestUtil::SetAllFields(&a);
+  const Descriptor* descriptor = a.GetDescriptor();
+  const Reflection* reflection = a.GetReflection();
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const FieldDescriptor* field = descriptor->field(i);
+    if (!field->is_repeated() && !reflection->HasField(a, field)) continue;
+    SCOPED_TRACE(field->full_name());
+    TestAllTypes b = a;
+    reflection->ClearField(&b, field);
+    ExpectNotEqual(a, b);
+  }
+}
+
+TEST(MessageEqualityTest, RepeatedFieldsAreOrdered) {
+  TestAllTypes a;
+  TestUtil::SetAllFields(&a);
+  TestAllTypes b = a;
+  TestUtil::ModifyRepeatedFields(&b);
+  ExpectNotEqual(a, b);
+
+  b = a;
+  b.mutable_repeated_int32()->SwapElements(0, 1);
+  ExpectNotEqual(a, b);
+  b.mutable_repeated_int32()->SwapElements(0, 1);
+  ExpectEqual(a, b);
+
+  b.mutable_repeated_nested_message(1)->set_bb(1234);
+  ExpectNotEqual(a, b);
+}
+
+TEST(MessageEqualityTest, ExplicitPresence) {
+  TestAllTypes a;
+  TestAllTypes b;
+  b.set_optional_int32(0);
+  ExpectNotEqual(a, b);
+  b.clear_optional_int32();
+  ExpectEqual(a, b);
+
+  b.mutable_optional_nested_message();
+  ExpectNotEqual(a, b);
+  a.mutable_optional_nested_message();
+  ExpectEqual(a, b);
+}
+
+TEST(MessageEqualityTest, ImplicitPresence) {
+  proto3_unittest::TestAllTypes a;
+  proto3_unittest::TestAllTypes b;
+  b.set_optional_int32(0);
+  b.set_optional_string("");
+  ExpectEqual(a, b);
+
+  b.set_optional_int32(1);
+  ExpectNotEqual(a, b);
+  b.set_optional_int32(0);
+  ExpectEqual(a, b);
+}
+
+TEST(MessageEqualityTest, ImplicitPresenceWellKnownType) {
+  Duration a;
+  Duration b;
+  b.set_seconds(0);
+  b.set_nanos(0);
+  ExpectEqual(a, b);
+
+  b.set_nanos(1);
+  ExpectNotEqual(a, b);
+}
+
+TEST(MessageEqualityTest, Proto3ExplicitPresence) {
+  proto2_unittest::TestProto3Optional a;
+  proto2_unittest::TestProto3Optional b;
+  b.set_optional_int32(0);
+  ExpectNotEqual(a, b);
+  a.set_optional_int32(0);
+  ExpectEqual(a, b);
+}
+
+TEST(MessageEqualityTest, FloatsAreComparedBitwise) {
+  TestAllTypes a;
+  a.set_optional_double(std::numeric_limits<double>::quiet_NaN());
+  TestAllTypes b = a;
+  ExpectEqual(a, b);
+
+  a.set_optional_float(0.0f);
+  b.set_optional_float(-0.0f);
+  ExpectNotEqual(a, b);
+}
+
+TEST(MessageEqualityTest, Oneofs) {
+  TestOneof2 a;
+  TestOneof2 b;
+  a.set_foo_int(1);
+  b.set_foo_int(1);
+  ExpectEqual(a, b);
+
+  b.set_foo_string("1");
+  ExpectNotEqual(a, b);
+
+  TestUtil::SetOneof1(&a);
+  TestUtil::SetOneof1(&b);
+  ExpectEqual(a, b);
+}
+
+TEST(MessageEqualityTest, MapsAreUnordered) {
+  TestMap a;
+  MapTestUtil::SetMapFields(&a);
+  TestMap b;
+  // Insert in a different order, and with rehashing in between.
+  for (int i = 0; i < 100; ++i) (*b.mutable_map_int32_int32())[1000 + i] = i;
+  b.mutable_map_int32_int32()->clear();
+  MapTestUtil::SetMapFields(&b);
+  ExpectEqual(a, b);
+
+  TestMap c = a;
+  (*c.mutable_map_int32_foreign_message())[0].set_c(1234);
+  ExpectNotEqual(a, c);
+
+  c = a;
+  (*c.mutable_map_string_string())["missing"] = "";
+  ExpectNotEqual(a, c);
+}
+
+TEST(MessageEqualityTest, Extensions) {
+  TestAllExtensions a;
+  TestUtil::SetAllExtensions(&a);
+  TestAllExtensions b = a;
+  ExpectEqual(a, b);
+
+  b.SetExtension(proto2_unittest::optional_int32_extension, 1234);
+  ExpectNotEqual(a, b);
+
+  ExpectNotEqual(a, TestAllExtensions());
+}
+
+TEST(MessageEqualityTest, UnknownFieldsAreIgnored) {
+  TestAllTypes a;
+  a.set_optional_int32(1);
+  TestAllTypes b = a;
+  b.GetReflection()->MutableUnknownFields(&b)->AddVarint(12345, 1);
+  ExpectEqual(a, b);
+}
+
+TEST(MessageEqualityTest, DifferentTypesAreNotEqual) {
+  EXPECT_FALSE(MessageEquals(TestAllTypes(), TestAllExtensions()));
+}
+
+TEST(MessageEqualityTest, LiteMessages) {
+  TestAllTypesLite a;
+  TestUtilLite::SetAllFields(&a);
+  TestAllTypesLite b = a;
+  ExpectEqual(a, b);
+
+  b.set_optional_string("changed");
+  ExpectNotEqual(a, b);
+}
+
+TEST(MessageEqualityTest, HashContainers) {
+  TestAllTypes a;
+  TestUtil::SetAllFields(&a);
+  TestAllTypes b = a;
+  b.set_optional_int32(1234);
+
+  absl::flat_hash_set<TestAllTypes, MessageHasher, MessageEq> set;
+  EXPECT_TRUE(set.insert(a).second);
+  EXPECT_TRUE(set.insert(b).second);
+  EXPECT_FALSE(set.insert(TestAllTypes(a)).second);
+  EXPECT_EQ(set.size(), 2);
+}
+
+struct Key {
+  TestAllTypes msg;
+
+  template <typename H>
+  friend H AbslHashValue(H h, const Key& key) {
+    return CombineMessageHash(std::move(h), key.msg);
+  }
+};
+
+TEST(MessageEqualityTest, CombineMessageHash) {
+  Key a;
+  TestUtil::SetAllFields(&a.msg);
+  Key b = a;
+  EXPECT_EQ(absl::HashOf(a), absl::HashOf(b));
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
@@ -439,6 +439,16 @@ bool MessageLite::ParsePartialFromArray(const void* data, int size) {
   return ParseFrom<kParsePartial>(as_string_view(data, size));
 }
 
+bool MessageLite::ParseFromStringWithAliasing(absl::string_view data) {
+  if (ABSL_PREDICT_FALSE(data.size() > INT_MAX)) return false;
+  return ParseFrom<kParseWithAliasing>(data);
+}
+
+bool MessageLite::ParsePartialFromStringWithAliasing(absl::string_view data) {
+  if (ABSL_PREDICT_FALSE(data.size() > INT_MAX)) return false;
+  return ParseFrom<kParsePartialWithAliasing>(data);
+}
+
 bool MessageLite::MergeFromString(absl::string_view data) {
   if (ABSL_PREDICT_FALSE(data.size() > INT_MAX)) return false;
   return ParseFrom<kMerge>(data);
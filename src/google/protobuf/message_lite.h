@@ -66,6 +66,7 @@ class FastReflectionStringSetter;
 class Reflection;
 class Descriptor;
 class AssignDescriptorsHelper;
+class ParseProjection;
 class MessageLite;
 
 namespace io {
@@ -548,6 +549,28 @@ class PROTOBUF_EXPORT MessageLite {
   // required fields.
   PROTOBUF_FUTURE_ADD_EARLY_NODISCARD ABSL_ATTRIBUTE_REINITIALIZES bool
   ParsePartialFromArray(const void* data, int size);
+  // Like ParseFromString(), but the message may keep pointers into `data`
+  // instead of copying string and bytes payloads into its own storage. This
+  // avoids a copy per field for messages dominated by large string or bytes
+  // fields.
+  //
+  // Only singular string and bytes fields that use the MicroString
+  // representation alias the input.  Those are the fields with
+  // `string_type = VIEW` (or `ctype = STRING_PIECE`) in code generated with the
+  // `experimental_cpp_micro_string` option, and in DynamicMessage when the
+  // runtime is built with PROTOBUF_ENABLE_EXPERIMENTAL_MICRO_STRING.  Repeated
+  // and map fields and all other string fields are copied as usual, so in a
+  // default build this behaves exactly like ParseFromString().
+  //
+  // The caller must keep `data` alive and unmodified for as long as the
+  // message is alive. Copies of the message made with CopyFrom() or MergeFrom()
+  // do not alias `data`.
+  PROTOBUF_FUTURE_ADD_EARLY_NODISCARD ABSL_ATTRIBUTE_REINITIALIZES bool
+  ParseFromStringWithAliasing(absl::string_view data);
+  // Like ParseFromStringWithAliasing(), but accepts messages that are missing
+  // required fields.
+  PROTOBUF_FUTURE_ADD_EARLY_NODISCARD ABSL_ATTRIBUTE_REINITIALIZES bool
+  ParsePartialFromStringWithAliasing(absl::string_view data);
 
 
   // Reads a protocol buffer from the stream and merges it into this
@@ -919,7 +942,8 @@ class PROTOBUF_EXPORT MessageLite {
     // Default:  when merging, pointer is followed and expanded (deep-copy).
     // Aliasing: when merging, the destination message is allowed to retain
     //           pointers to the original structure (shallow-copy). This mostly
-    //           is intended for use with STRING_PIECE.
+    //           is intended for use with STRING_PIECE, and applies to string
+    //           and bytes fields using the MicroString representation.
     // NOTE: STRING_PIECE is not recommended for new usage. Prefer Cords.
     kMergeWithAliasing = 4,
     kParseWithAliasing = 5,
@@ -962,6 +986,7 @@ class PROTOBUF_EXPORT MessageLite {
   friend class AssignDescriptorsHelper;
   friend class FastReflectionStringSetter;
   friend class Message;
+  friend class ParseProjection;
   friend class Reflection;
   friend class TypeId;
   friend class compiler::cpp::MessageTableTester;
@@ -402,13 +402,16 @@ const char* EpsCopyInputStream::ReadCordFallback(const char* ptr, int size,
   if (bytes_from_buffer > kPatchBufferSize || !in_patch_buf) {
     cord->Clear();
     StreamBackUp(bytes_from_buffer);
-  } else if (bytes_from_buffer == kSlopBytes && next_chunk_ != nullptr &&
+  } else if (bytes_from_buffer <= kSlopBytes && next_chunk_ != nullptr &&
              // Only backup if next_chunk_ points to a valid buffer returned by
              // ZeroCopyInputStream. This happens when NextStream() returns a
              // chunk that's smaller than or equal to kSlopBytes.
              next_chunk_ != patch_buffer_) {
+    // All remaining bytes in the patch buffer are a copy of the head of
+    // next_chunk_. Rewind the stream to `ptr` so that ReadCord can share the
+    // underlying chunk instead of copying the first few bytes.
     cord->Clear();
-    StreamBackUp(size_);
+    StreamBackUp(size_ - (kSlopBytes - bytes_from_buffer));
   } else {
     size -= bytes_from_buffer;
     ABSL_DCHECK_GT(size, 0);
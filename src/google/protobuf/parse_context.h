@@ -57,6 +57,7 @@ class MessageFactory;
 namespace internal {
 
 class LazyField;
+class ParseProjectionNode;
 
 // Template code below needs to know about the existence of these functions.
 PROTOBUF_EXPORT void WriteVarint(uint32_t num, uint64_t val, std::string* s);
@@ -563,6 +564,16 @@ class PROTOBUF_EXPORT EpsCopyInputStream {
   uint32_t last_tag_minus_1_ = 0;
   int overall_limit_ = INT_MAX;  // Overall limit independent of pushed limits.
 
+  // Returns the address of the byte at `ptr` in the buffer it was read from.
+  // `ptr` may point into the patch buffer, which holds copies of input bytes.
+  // REQUIRES: aliasing_ >= kNoDelta, i.e. the current bytes can be aliased.
+  const char* AliasedPtr(const char* ptr) const {
+    ABSL_DCHECK_GE(aliasing_, +kNoDelta);
+    if (aliasing_ == kNoDelta) return ptr;
+    return reinterpret_cast<const char*>(reinterpret_cast<std::uintptr_t>(ptr) +
+                                         aliasing_);
+  }
+
   // Returns true if it has enough available data given requested. Note that
   // "available" can be negative but "requested" must not. Casting is done to
   // preserve sign bit for the latter only.
@@ -695,6 +706,9 @@ class PROTOBUF_EXPORT ParseContext : public EpsCopyInputStream {
   struct Data {
     const DescriptorPool* pool = nullptr;
     MessageFactory* factory = nullptr;
+    // If set, only the fields selected by the projection are parsed at the
+    // current nesting level. See ParseProjection.
+    const ParseProjectionNode* projection = nullptr;
   };
 
   template <typename... T>
@@ -1487,7 +1501,15 @@ inline const char* EpsCopyInputStream::ReadMicroStringWithSize(
     const char* ptr, int size, MicroString& str, size_t inline_capacity,
     Arena* arena) {
   if (size <= BytesAvailable(ptr)) {
-    str.Set(absl::string_view(ptr, size), arena, inline_capacity);
+    // With aliasing enabled, point into the caller's buffer instead of copying
+    // the payload. Payloads that fit inline are cheaper to copy.
+    if (ABSL_PREDICT_FALSE(aliasing_ >= kNoDelta) &&
+        static_cast<size_t>(size) > inline_capacity) {
+      str.SetAlias(absl::string_view(AliasedPtr(ptr), size), arena,
+                   inline_capacity);
+    } else {
+      str.Set(absl::string_view(ptr, size), arena, inline_capacity);
+    }
     return ptr + size;
   }
   return ReadMicroStringFallback(ptr, size, str, inline_capacity, arena);
@@ -0,0 +1,99 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/parse_projection.h"
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+
+#include "absl/algorithm/container.h"
+#include "absl/log/absl_check.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "google/protobuf/generated_message_tctable_impl.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/message_lite.h"
+#include "google/protobuf/parse_context.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+void ParseProjectionNode::AddPath(absl::Span<const int> path) {
+  ABSL_DCHECK(!path.empty());
+  ParseProjectionNode* node = this;
+  for (size_t i = 0; i < path.size(); ++i) {
+    const uint32_t number = static_cast<uint32_t>(path[i]);
+    auto it = absl::c_lower_bound(
+        node->fields_, number,
+        [](const Field& field, uint32_t n) { return field.number < n; });
+    const bool last = i + 1 == path.size();
+    if (it == node->fields_.end() || it->number != number) {
+      it = node->fields_.insert(it, Field{number, nullptr});
+      if (number <= 64) node->low_mask_ |= uint64_t{1} << (number - 1);
+      if (last) return;
+      it->child = std::make_unique<ParseProjectionNode>();
+    } else if (it->child == nullptr) {
+      // The entire field is already selected.
+      return;
+    } else if (last) {
+      // Selecting the entire field subsumes the longer paths below it.
+      it->child.reset();
+      return;
+    }
+    node = it->child.get();
+  }
+}
+
+}  // namespace internal
+
+namespace {
+// Mirrors FieldDescriptor::kMaxNumber, which is not available in lite.
+constexpr int kMaxFieldNumber = (1 << 29) - 1;
+}  // namespace
+
+ParseProjection::ParseProjection(
+    std::initializer_list<std::initializer_list<int>> paths) {
+  for (const auto& path : paths) {
+    ABSL_CHECK(AddPath(absl::MakeConstSpan(path.begin(), path.size())));
+  }
+}
+
+bool ParseProjection::AddPath(absl::Span<const int> path) {
+  if (path.empty()) return false;
+  for (int number : path) {
+    if (number < 1 || number > kMaxFieldNumber) return false;
+  }
+  root_.AddPath(path);
+  return true;
+}
+
+bool ParseProjection::MergePartialFromString(absl::string_view data,
+                                             MessageLite* msg) const {
+  const char* ptr;
+  internal::ParseContext ctx(io::CodedInputStream::GetDefaultRecursionLimit(),
+                             false, &ptr, data);
+  ctx.data().projection = &root_;
+  ptr = internal::TcParser::ParseLoop(msg, ptr, &ctx, msg->GetTcParseTable());
+  // ctx has an explicit limit set (length of string_view).
+  return ptr != nullptr && ctx.EndedAtLimit();
+}
+
+bool ParseProjection::ParsePartialFromString(absl::string_view data,
+                                             MessageLite* msg) const {
+  msg->Clear();
+  return MergePartialFromString(data, msg);
+}
+
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
@@ -0,0 +1,135 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// ParseProjection restricts parsing to a subset of a message's fields.
+//
+// Readers that only need a handful of fields out of a wide message can use a
+// projection to skip everything else on the wire, instead of materializing
+// the whole message and then discarding most of it:
+//
+//   // Select field 1 and field 2 of the submessage in field 5.
+//   ParseProjection projection({{1}, {5, 2}});
+//   MyMessage msg;
+//   if (!projection.ParsePartialFromString(data, &msg)) { ... }
+//
+// Semantics:
+//   * Each path selects one field and everything beneath it. A shorter path
+//     subsumes any longer path that it is a prefix of.
+//   * Fields that are not selected are skipped and are NOT stored in the
+//     unknown field set. Selected fields that the message does not know about
+//     are stored as unknown fields as usual.
+//   * For map fields, the remainder of a path applies to the map's value
+//     message. Map keys are always parsed.
+//   * Lazy fields, and messages that do not use the table-driven parser, are
+//     parsed in full once they are selected.
+//   * Required fields are not checked, since a projection may legitimately
+//     omit them.
+//   * Projections over message_set_wire_format messages are not supported.
+//
+// For paths expressed as a FieldMask see
+// util::FieldMaskUtil::GetParseProjection().
+
+#ifndef GOOGLE_PROTOBUF_PARSE_PROJECTION_H__
+#define GOOGLE_PROTOBUF_PARSE_PROJECTION_H__
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+
+class MessageLite;
+
+namespace internal {
+
+// A node in the field-number tree of a ParseProjection. Each node lists the
+// fields selected at one level of nesting. Consulted by TcParser through
+// ParseContext::Data::projection.
+class PROTOBUF_EXPORT ParseProjectionNode {
+ public:
+  ParseProjectionNode() = default;
+  ParseProjectionNode(ParseProjectionNode&&) noexcept = default;
+  ParseProjectionNode& operator=(ParseProjectionNode&&) noexcept = default;
+
+  // Returns true if field `number` is selected. On success `*child` is set to
+  // the projection for the field's submessage, or nullptr if the entire field
+  // is selected.
+  bool Find(uint32_t number, const ParseProjectionNode** child) const {
+    if (number - 1 < 64 && (low_mask_ & (uint64_t{1} << (number - 1))) == 0) {
+      return false;
+    }
+    auto it = absl::c_lower_bound(
+        fields_, number,
+        [](const Field& field, uint32_t n) { return field.number < n; });
+    if (it == fields_.end() || it->number != number) return false;
+    *child = it->child.get();
+    return true;
+  }
+
+  // Adds `path`, which must be non-empty and contain only valid field numbers.
+  void AddPath(absl::Span<const int> path);
+
+  bool empty() const { return fields_.empty(); }
+
+ private:
+  struct Field {
+    uint32_t number;
+    // nullptr if the entire field is selected.
+    std::unique_ptr<ParseProjectionNode> child;
+  };
+
+  // Bit (n - 1) is set if field n is selected, for 1 <= n <= 64. Rejects most
+  // unselected fields without searching `fields_`.
+  uint64_t low_mask_ = 0;
+  std::vector<Field> fields_;  // Sorted by number.
+};
+
+}  // namespace internal
+
+class PROTOBUF_EXPORT ParseProjection {
+ public:
+  // An empty projection selects no fields.
+  ParseProjection() = default;
+  // Equivalent to calling AddPath() for each element of `paths`.
+  ParseProjection(std::initializer_list<std::initializer_list<int>> paths);
+
+  ParseProjection(ParseProjection&&) noexcept = default;
+  ParseProjection& operator=(ParseProjection&&) noexcept = default;
+
+  // Selects the field identified by the path of field numbers `path`. Returns
+  // false, leaving the projection unchanged, if `path` is empty or contains an
+  // invalid field number.
+  bool AddPath(absl::Span<const int> path);
+
+  bool empty() const { return root_.empty(); }
+
+  // Like MessageLite::MergePartialFromString(), but only parses the selected
+  // fields.
+  bool MergePartialFromString(absl::string_view data, MessageLite* msg) const;
+  // Like MessageLite::ParsePartialFromString(), but only parses the selected
+  // fields.
+  bool ParsePartialFromString(absl::string_view data, MessageLite* msg) const;
+
+ private:
+  internal::ParseProjectionNode root_;
+};
+
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_PARSE_PROJECTION_H__
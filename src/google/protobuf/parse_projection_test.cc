@@ -0,0 +1,209 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/parse_projection.h"
+
+#include <memory>
+#include <string>
+
+#include "google/protobuf/field_mask.pb.h"
+#include <gtest/gtest.h>
+#include "absl/strings/string_view.h"
+#include "google/protobuf/map_unittest.pb.h"
+#include "google/protobuf/unittest.pb.h"
+#include "google/protobuf/util/field_mask_util.h"
+
+namespace google {
+namespace protobuf {
+namespace {
+
+using ::proto2_unittest::TestAllTypes;
+using ::proto2_unittest::TestMap;
+
+TestAllTypes MakeTestAllTypes() {
+  TestAllTypes msg;
+  msg.set_optional_int32(1);
+  msg.set_optional_int64(2);
+  msg.set_optional_string("hello");
+  msg.mutable_optionalgroup()->set_a(17);
+  msg.mutable_optional_nested_message()->set_bb(18);
+  msg.mutable_optional_foreign_message()->set_c(19);
+  msg.mutable_optional_foreign_message()->set_d(20);
+  msg.add_repeated_int32(31);
+  msg.add_repeated_int32(32);
+  msg.add_repeated_nested_message()->set_bb(48);
+  return msg;
+}
+
+TEST(ParseProjectionTest, EmptyProjectionSelectsNothing) {
+  ParseProjection projection;
+  EXPECT_TRUE(projection.empty());
+  TestAllTypes msg;
+  ASSERT_TRUE(projection.ParsePartialFromString(
+      MakeTestAllTypes().SerializeAsString(), &msg));
+  EXPECT_EQ(msg.ByteSizeLong(), 0);
+}
+
+TEST(ParseProjectionTest, SkipsUnselectedFields) {
+  ParseProjection projection({{2}, {14}, {31}});
+  TestAllTypes msg;
+  ASSERT_TRUE(projection.ParsePartialFromString(
+      MakeTestAllTypes().SerializeAsString(), &msg));
+
+  TestAllTypes expected;
+  expected.set_optional_int64(2);
+  expected.set_optional_string("hello");
+  expected.add_repeated_int32(31);
+  expected.add_repeated_int32(32);
+  EXPECT_EQ(msg.SerializeAsString(), expected.SerializeAsString());
+  // Skipped fields are not preserved as unknown fields.
+  EXPECT_TRUE(msg.unknown_fields().empty());
+}
+
+TEST(ParseProjectionTest, NestedPaths) {
+  ParseProjection projection({{19, 2}, {48}, {16}});
+  TestAllTypes msg;
+  ASSERT_TRUE(projection.ParsePartialFromString(
+      MakeTestAllTypes().SerializeAsString(), &msg));
+
+  TestAllTypes expected;
+  expected.mutable_optionalgroup()->set_a(17);
+  expected.mutable_optional_foreign_message()->set_d(20);
+  expected.add_repeated_nested_message()->set_bb(48);
+  EXPECT_EQ(msg.SerializeAsString(), expected.SerializeAsString());
+}
+
+TEST(ParseProjectionTest, ShorterPathSubsumesLongerPath) {
+  ParseProjection projection;
+  ASSERT_TRUE(projection.AddPath({19, 2}));
+  ASSERT_TRUE(projection.AddPath({19}));
+  ASSERT_TRUE(projection.AddPath({19, 1}));
+  TestAllTypes msg;
+  ASSERT_TRUE(projection.ParsePartialFromString(
+      MakeTestAllTypes().SerializeAsString(), &msg));
+  EXPECT_EQ(msg.optional_foreign_message().c(), 19);
+  EXPECT_EQ(msg.optional_foreign_message().d(), 20);
+}
+
+TEST(ParseProjectionTest, MapPathAppliesToValue) {
+  TestMap src;
+  (*src.mutable_map_int32_int32())[1] = 2;
+  auto& value = (*src.mutable_map_int32_foreign_message())[3];
+  value.set_c(4);
+  value.set_d(5);
+
+  ParseProjection projection({{17, 1}});
+  TestMap msg;
+  ASSERT_TRUE(projection.ParsePartialFromString(src.SerializeAsString(), &msg));
+  EXPECT_TRUE(msg.map_int32_int32().empty());
+  ASSERT_EQ(msg.map_int32_foreign_message().size(), 1);
+  EXPECT_EQ(msg.map_int32_foreign_message().at(3).c(), 4);
+  EXPECT_FALSE(msg.map_int32_foreign_message().at(3).has_d());
+}
+
+TEST(ParseProjectionTest, SelectedUnknownFieldIsPreserved) {
+  // Field 1 (varint) = 1, field 1000 (varint) = 5, field 1001 (varint) = 6.
+  const std::string data("\x08\x01\xc0\x3e\x05\xc8\x3e\x06", 8);
+  ParseProjection projection({{1000}});
+  TestAllTypes msg;
+  ASSERT_TRUE(projection.ParsePartialFromString(data, &msg));
+  EXPECT_FALSE(msg.has_optional_int32());
+  EXPECT_EQ(msg.unknown_fields().size(), 1);
+  EXPECT_EQ(msg.unknown_fields().field(0).number(), 1000);
+}
+
+TEST(ParseProjectionTest, MergeKeepsExistingFields) {
+  ParseProjection projection({{1}});
+  TestAllTypes msg;
+  msg.set_optional_int64(7);
+  ASSERT_TRUE(projection.MergePartialFromString(
+      MakeTestAllTypes().SerializeAsString(), &msg));
+  EXPECT_EQ(msg.optional_int32(), 1);
+  EXPECT_EQ(msg.optional_int64(), 7);
+}
+
+TEST(ParseProjectionTest, RejectsMalformedInput) {
+  ParseProjection projection({{14}});
+  std::string data = MakeTestAllTypes().SerializeAsString();
+  TestAllTypes msg;
+  // Truncation inside a skipped field and inside a selected field.
+  for (size_t size = 1; size < data.size(); ++size) {
+    TestAllTypes full;
+    if (full.ParsePartialFromString(absl::string_view(data).substr(0, size))) {
+      continue;
+    }
+    EXPECT_FALSE(projection.ParsePartialFromString(
+        absl::string_view(data).substr(0, size), &msg))
+        << size;
+  }
+}
+
+TEST(ParseProjectionTest, RejectsInvalidPaths) {
+  ParseProjection projection;
+  EXPECT_FALSE(projection.AddPath({}));
+  EXPECT_FALSE(projection.AddPath({0}));
+  EXPECT_FALSE(projection.AddPath({1, 1 << 29}));
+  EXPECT_TRUE(projection.empty());
+}
+
+TEST(ParseProjectionTest, FromFieldMask) {
+  FieldMask mask;
+  util::FieldMaskUtil::FromString(
+      "optional_string,optional_foreign_message.d", &mask);
+  std::shared_ptr<const ParseProjection> projection =
+      util::FieldMaskUtil::GetParseProjection(mask, TestAllTypes::descriptor());
+  ASSERT_NE(projection, nullptr);
+  EXPECT_EQ(projection, util::FieldMaskUtil::GetParseProjection(
+                            mask, TestAllTypes::descriptor()));
+
+  TestAllTypes msg;
+  ASSERT_TRUE(projection->ParsePartialFromString(
+      MakeTestAllTypes().SerializeAsString(), &msg));
+  TestAllTypes expected;
+  expected.set_optional_string("hello");
+  expected.mutable_optional_foreign_message()->set_d(20);
+  EXPECT_EQ(msg.SerializeAsString(), expected.SerializeAsString());
+
+  util::FieldMaskUtil::FromString("no_such_field", &mask);
+  EXPECT_EQ(util::FieldMaskUtil::GetParseProjection(
+                mask, TestAllTypes::descriptor()),
+            nullptr);
+}
+
+TEST(ParseProjectionTest, FromFieldMaskOutlivesCacheEviction) {
+  FieldMask mask;
+  util::FieldMaskUtil::FromString("optional_string", &mask);
+  std::shared_ptr<const ParseProjection> projection =
+      util::FieldMaskUtil::GetParseProjection(mask, TestAllTypes::descriptor());
+  ASSERT_NE(projection, nullptr);
+
+  // Distinct subsets of these fields overflow the cache several times.
+  const char* const kFields[] = {
+      "optional_int32",    "optional_int64",    "optional_uint32",
+      "optional_uint64",   "optional_sint32",   "optional_sint64",
+      "optional_fixed32",  "optional_fixed64",  "optional_sfixed32",
+      "optional_sfixed64"};
+  for (int i = 1; i < 1024; ++i) {
+    FieldMask other;
+    for (int bit = 0; bit < 10; ++bit) {
+      if (i & (1 << bit)) other.add_paths(kFields[bit]);
+    }
+    EXPECT_NE(util::FieldMaskUtil::GetParseProjection(
+                  other, TestAllTypes::descriptor()),
+              nullptr);
+  }
+
+  TestAllTypes msg;
+  ASSERT_TRUE(projection->ParsePartialFromString(
+      MakeTestAllTypes().SerializeAsString(), &msg));
+  EXPECT_EQ(msg.optional_string(), "hello");
+  EXPECT_FALSE(msg.has_optional_int32());
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
@@ -68,7 +68,7 @@ constexpr SourceContext::ParseTableT_ SourceContext::InternalGenerateParseTable_
       65535, 65535
     }}, {{
       // string file_name = 1;
-      {PROTOBUF_FIELD_OFFSET(SourceContext, _impl_.file_name_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kUtf8String | ::_fl::kRepAString)},
+      {PROTOBUF_FIELD_OFFSET(SourceContext, _impl_.file_name_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kUtf8String | ::_fl::kRepAString | ::_fl::kHbHint)},
     }},
     // no aux_entries
     {{
@@ -19,6 +19,7 @@
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <limits>
 #include <memory>
@@ -30,6 +31,7 @@
 #include "absl/base/optimization.h"
 #include "absl/cleanup/cleanup.h"
 #include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/memory/memory.h"
@@ -46,6 +48,7 @@
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "google/protobuf/any.h"
@@ -716,31 +719,7 @@ class TextFormat::Parser::ParserImpl {
           field = descriptor->FindFieldByNumber(field_number);
         }
       } else {
-        field = descriptor->FindFieldByName(field_name);
-        // Group-like delimited fields will accept both the capitalized type
-        // names as well.
-        if (field == nullptr) {
-          std::string lower_field_name = field_name;
-          absl::AsciiStrToLower(&lower_field_name);
-          field = descriptor->FindFieldByName(lower_field_name);
-          // If the case-insensitive match worked but the field is NOT a group,
-          if (field != nullptr && !internal::cpp::IsGroupLike(*field)) {
-            field = nullptr;
-          }
-          if (field != nullptr && field->message_type()->name() != field_name) {
-            field = nullptr;
-          }
-        }
-
-        if (field == nullptr && allow_case_insensitive_field_) {
-          std::string lower_field_name = field_name;
-          absl::AsciiStrToLower(&lower_field_name);
-          field = descriptor->FindFieldByLowercaseName(lower_field_name);
-        }
-
-        if (field == nullptr) {
-          reserved_field = descriptor->IsReservedName(field_name);
-        }
+        field = FindFieldByTextName(descriptor, field_name, &reserved_field);
       }
       record_name_location(
           field, ParseLocationRange(ParseLocation(n_start_line, n_start_column),
@@ -1190,8 +1169,54 @@ class TextFormat::Parser::ParserImpl {
     return true;
   }
 
+  // Resolves a field name as written in the text format: the field's own
+  // name, the capitalized type name of a group-like field, or a
+  // case-insensitive match if allowed. Large inputs repeat the same few names
+  // many times, so results (including misses and reserved names) are cached
+  // per message type; this also avoids the lowercase copies the fallbacks
+  // need.
+  const FieldDescriptor* FindFieldByTextName(const Descriptor* descriptor,
+                                             const std::string& field_name,
+                                             bool* reserved_field) {
+    auto& names = field_name_cache_[descriptor];
+    auto it = names.find(field_name);
+    if (it != names.end()) {
+      *reserved_field = it->second.reserved;
+      return it->second.field;
+    }
+
+    const FieldDescriptor* field = descriptor->FindFieldByName(field_name);
+    // Group-like delimited fields will accept both the capitalized type
+    // names as well.
+    if (field == nullptr) {
+      std::string lower_field_name = field_name;
+      absl::AsciiStrToLower(&lower_field_name);
+      field = descriptor->FindFieldByName(lower_field_name);
+      // If the case-insensitive match worked but the field is NOT a group,
+      if (field != nullptr && !internal::cpp::IsGroupLike(*field)) {
+        field = nullptr;
+      }
+      if (field != nullptr && field->message_type()->name() != field_name) {
+        field = nullptr;
+      }
+    }
+
+    if (field == nullptr && allow_case_insensitive_field_) {
+      std::string lower_field_name = field_name;
+      absl::AsciiStrToLower(&lower_field_name);
+      field = descriptor->FindFieldByLowercaseName(lower_field_name);
+    }
+
+    if (field == nullptr) {
+      *reserved_field = descriptor->IsReservedName(field_name);
+    }
+
+    names.emplace(field_name, CachedFieldName{field, *reserved_field});
+    return field;
+  }
+
   // Returns true if the current token's text is equal to that specified.
-  bool LookingAt(const std::string& text) {
+  bool LookingAt(absl::string_view text) {
     return tokenizer_.current().text == text;
   }
 
@@ -1503,7 +1528,7 @@ class TextFormat::Parser::ParserImpl {
   // Consumes a token and confirms that it matches that specified in the
   // value parameter. Returns false if the token found does not match that
   // which was specified.
-  bool Consume(const std::string& value) {
+  bool Consume(absl::string_view value) {
     const std::string& current_value = tokenizer_.current().text;
 
     if (current_value != value) {
@@ -1519,7 +1544,7 @@ class TextFormat::Parser::ParserImpl {
 
   // Similar to `Consume`, but the following token may be tokenized as
   // TYPE_WHITESPACE.
-  bool ConsumeBeforeWhitespace(const std::string& value) {
+  bool ConsumeBeforeWhitespace(absl::string_view value) {
     // Report whitespace after this token, but only once.
     tokenizer_.set_report_whitespace(true);
     bool result = Consume(value);
@@ -1529,7 +1554,7 @@ class TextFormat::Parser::ParserImpl {
 
   // Attempts to consume the supplied value. Returns false if the token found
   // does not match the value specified.
-  bool TryConsume(const std::string& value) {
+  bool TryConsume(absl::string_view value) {
     if (tokenizer_.current().text == value) {
       tokenizer_.Next();
       return true;
@@ -1540,7 +1565,7 @@ class TextFormat::Parser::ParserImpl {
 
   // Similar to `TryConsume`, but the following token may be tokenized as
   // TYPE_WHITESPACE.
-  bool TryConsumeBeforeWhitespace(const std::string& value) {
+  bool TryConsumeBeforeWhitespace(absl::string_view value) {
     // Report whitespace after this token, but only once.
     tokenizer_.set_report_whitespace(true);
     bool result = TryConsume(value);
@@ -1551,8 +1576,10 @@ class TextFormat::Parser::ParserImpl {
   bool TryConsumeWhitespace() {
     had_silent_marker_ = false;
     if (LookingAtType(io::Tokenizer::TYPE_WHITESPACE)) {
-      if (tokenizer_.current().text ==
-          absl::StrCat(" ", internal::kDebugStringSilentMarkerForDetection)) {
+      // Compare against " " + marker without building the string each time.
+      absl::string_view text = tokenizer_.current().text;
+      if (absl::ConsumePrefix(&text, " ") &&
+          text == internal::kDebugStringSilentMarkerForDetection) {
         had_silent_marker_ = true;
       }
       tokenizer_.Next();
@@ -1602,6 +1629,13 @@ class TextFormat::Parser::ParserImpl {
   int recursion_limit_;
   bool had_silent_marker_;
   bool had_errors_;
+  struct CachedFieldName {
+    const FieldDescriptor* field;
+    bool reserved;
+  };
+  absl::flat_hash_map<const Descriptor*,
+                      absl::flat_hash_map<std::string, CachedFieldName>>
+      field_name_cache_;
   UnsetFieldsMetadata* no_op_fields_{};
 
 };
@@ -1668,18 +1702,18 @@ class TextFormat::Printer::TextGenerator
   void Print(const char* text, size_t size) override {
     if (indent_level_ > 0) {
       size_t pos = 0;  // The number of bytes we've written so far.
-      for (size_t i = 0; i < size; i++) {
-        if (text[i] == '\n') {
-          // Saw newline.  If there is more text, we may need to insert an
-          // indent here.  So, write what we have so far, including the '\n'.
-          Write(text + pos, i - pos + 1);
-          if (failed_) return;
-          pos = i + 1;
-
-          // Setting this true will cause the next Write() to insert an indent
-          // first.
-          at_start_of_line_ = true;
-        }
+      while (const char* newline = static_cast<const char*>(
+                 memchr(text + pos, '\n', size - pos))) {
+        // Saw newline.  If there is more text, we may need to insert an
+        // indent here.  So, write what we have so far, including the '\n'.
+        size_t i = newline - text;
+        Write(text + pos, i - pos + 1);
+        if (failed_) return;
+        pos = i + 1;
+
+        // Setting this true will cause the next Write() to insert an indent
+        // first.
+        at_start_of_line_ = true;
       }
       // Write the rest.
       Write(text + pos, size - pos);
@@ -2171,6 +2205,19 @@ std::string TextFormat::FieldValuePrinter::PrintMessageEnd(
 }
 #undef FORWARD_IMPL
 
+namespace {
+
+// Formats `val` into a stack buffer instead of going through a temporary
+// std::string; integers are by far the most common scalar values in dumps.
+template <typename T>
+void PrintInteger(T val, TextFormat::BaseTextGenerator* generator) {
+  char buffer[absl::numbers_internal::kFastToBufferSize];
+  char* end = absl::numbers_internal::FastIntToBuffer(val, buffer);
+  generator->Print(buffer, end - buffer);
+}
+
+}  // namespace
+
 TextFormat::FastFieldValuePrinter::FastFieldValuePrinter() = default;
 TextFormat::FastFieldValuePrinter::~FastFieldValuePrinter() = default;
 void TextFormat::FastFieldValuePrinter::PrintBool(
@@ -2183,19 +2230,19 @@ void TextFormat::FastFieldValuePrinter::PrintBool(
 }
 void TextFormat::FastFieldValuePrinter::PrintInt32(
     int32_t val, BaseTextGenerator* generator) const {
-  generator->PrintString(absl::StrCat(val));
+  PrintInteger(val, generator);
 }
 void TextFormat::FastFieldValuePrinter::PrintUInt32(
     uint32_t val, BaseTextGenerator* generator) const {
-  generator->PrintString(absl::StrCat(val));
+  PrintInteger(val, generator);
 }
 void TextFormat::FastFieldValuePrinter::PrintInt64(
     int64_t val, BaseTextGenerator* generator) const {
-  generator->PrintString(absl::StrCat(val));
+  PrintInteger(val, generator);
 }
 void TextFormat::FastFieldValuePrinter::PrintUInt64(
     uint64_t val, BaseTextGenerator* generator) const {
-  generator->PrintString(absl::StrCat(val));
+  PrintInteger(val, generator);
 }
 void TextFormat::FastFieldValuePrinter::PrintFloat(
     float val, BaseTextGenerator* generator) const {
@@ -2923,7 +2970,7 @@ void TextFormat::Printer::PrintFieldName(const Message& message,
   // if use_field_number_ is true, prints field number instead
   // of field name.
   if (use_field_number_) {
-    generator->PrintString(absl::StrCat(field->number()));
+    PrintInteger(field->number(), generator);
     return;
   }
 
@@ -3279,27 +3326,28 @@ TextFormat::RedactionState TextFormat::GetRedactionState(
 bool TextFormat::Printer::TryRedactFieldValue(
     const Message& message, const FieldDescriptor* field,
     BaseTextGenerator* generator, bool insert_value_separator) const {
+  // Only look up the (memoized, but mutex-guarded) redaction state when it can
+  // matter; this runs once per printed value.
+  if (!redact_debug_string_) return false;
   TextFormat::RedactionState redaction_state =
       DescriptorPool::MemoizeProjection(
           field, [](const FieldDescriptor* field) {
             return TextFormat::GetRedactionState(field);
           });
   if (redaction_state.redact) {
-    if (redact_debug_string_) {
-      IncrementRedactedFieldCounter();
-      if (insert_value_separator) {
-        generator->PrintMaybeWithMarker(MarkerToken(), ": ");
-      }
-      generator->PrintString(kFieldValueReplacement);
-      if (insert_value_separator) {
-        if (single_line_mode_) {
-          generator->PrintLiteral(" ");
-        } else {
-          generator->PrintLiteral("\n");
-        }
+    IncrementRedactedFieldCounter();
+    if (insert_value_separator) {
+      generator->PrintMaybeWithMarker(MarkerToken(), ": ");
+    }
+    generator->PrintString(kFieldValueReplacement);
+    if (insert_value_separator) {
+      if (single_line_mode_) {
+        generator->PrintLiteral(" ");
+      } else {
+        generator->PrintLiteral("\n");
       }
-      return true;
     }
+    return true;
   }
   return false;
 }
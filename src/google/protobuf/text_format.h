@@ -548,6 +548,8 @@ class PROTOBUF_EXPORT TextFormat {
 
     const FastFieldValuePrinter* GetFieldPrinter(
         const FieldDescriptor* field) const {
+      // Called for every printed value; most printers have no custom ones.
+      if (custom_printers_.empty()) return default_field_value_printer_.get();
       auto it = custom_printers_.find(field);
       return it == custom_printers_.end() ? default_field_value_printer_.get()
                                           : it->second.get();
@@ -2519,6 +2519,29 @@ TEST_F(TextFormatParserTest, GroupCapitalization) {
       1, 16);
 }
 
+TEST_F(TextFormatParserTest, RepeatedFieldNames) {
+  // Field name lookups are cached per message type; make sure repeated and
+  // capitalized group names resolve the same way every time.
+  unittest::TestAllTypes proto;
+  EXPECT_TRUE(parser_.ParseFromString(
+      "RepeatedGroup { a: 1 }\n"
+      "repeatedgroup { a: 2 }\n"
+      "RepeatedGroup { a: 3 }\n"
+      "repeated_nested_message { bb: 4 }\n"
+      "repeated_nested_message { bb: 5 }\n",
+      &proto));
+  ASSERT_EQ(proto.repeatedgroup_size(), 3);
+  EXPECT_EQ(proto.repeatedgroup(2).a(), 3);
+  ASSERT_EQ(proto.repeated_nested_message_size(), 2);
+  EXPECT_EQ(proto.repeated_nested_message(1).bb(), 5);
+
+  ExpectFailure(
+      "RepeatedGroup { a: 1 }\nREPEATEDGROUP { a: 2 }\n",
+      "Message type \"proto2_unittest.TestAllTypes\" has no field named "
+      "\"REPEATEDGROUP\".",
+      2, 15);
+}
+
 TEST_F(TextFormatParserTest, DelimitedCapitalization) {
   editions_unittest::TestDelimited proto;
   EXPECT_TRUE(parser_.ParseFromString("grouplike {\na: 1\n}\n", &proto));
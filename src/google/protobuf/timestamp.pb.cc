@@ -72,9 +72,9 @@ constexpr Timestamp::ParseTableT_ Timestamp::InternalGenerateParseTable_(const :
       65535, 65535
     }}, {{
       // int64 seconds = 1;
-      {PROTOBUF_FIELD_OFFSET(Timestamp, _impl_.seconds_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kInt64)},
+      {PROTOBUF_FIELD_OFFSET(Timestamp, _impl_.seconds_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kInt64 | ::_fl::kHbHint)},
       // int32 nanos = 2;
-      {PROTOBUF_FIELD_OFFSET(Timestamp, _impl_.nanos_), _Internal::kHasBitsOffset + 1, 0, (0 | ::_fl::kFcOptional | ::_fl::kInt32)},
+      {PROTOBUF_FIELD_OFFSET(Timestamp, _impl_.nanos_), _Internal::kHasBitsOffset + 1, 0, (0 | ::_fl::kFcOptional | ::_fl::kInt32 | ::_fl::kHbHint)},
     }},
     // no aux_entries
     {{
@@ -0,0 +1,189 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Runtime tests for the parser protoc emits for messages with
+// `features.(pb.cpp).unrolled_codegen`. TestUnrolledCodegen and
+// TestTableDrivenCodegen have identical fields, so every input must parse the
+// same way with both.
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/unittest_unrolled_codegen.pb.h"
+#include "google/protobuf/unknown_field_set.h"
+
+namespace google {
+namespace protobuf {
+namespace {
+
+using ::proto2_unittest::TestTableDrivenCodegen;
+using ::proto2_unittest::TestUnrolledCodegen;
+
+TestUnrolledCodegen MakeTestUnrolledCodegen() {
+  TestUnrolledCodegen msg;
+  msg.set_optional_int32(-1);
+  msg.set_optional_int64(std::numeric_limits<int64_t>::min());
+  msg.set_optional_uint32(std::numeric_limits<uint32_t>::max());
+  msg.set_optional_uint64(std::numeric_limits<uint64_t>::max());
+  msg.set_optional_sint32(std::numeric_limits<int32_t>::min());
+  msg.set_optional_sint64(-2);
+  msg.set_optional_bool(true);
+  msg.set_optional_fixed32(0x12345678);
+  msg.set_optional_fixed64(0x123456789abcdef0);
+  msg.set_optional_sfixed32(-3);
+  msg.set_optional_sfixed64(-4);
+  msg.set_optional_float(1.5f);
+  msg.set_optional_double(-2.25);
+  msg.set_optional_enum(proto2_unittest::UNROLLED_TWO);
+  msg.set_optional_string("not unrolled");
+  msg.add_repeated_int32(5);
+  return msg;
+}
+
+// Parses `input` with both parsers and checks that they agree, including on
+// unknown fields. Returns the result of the unrolled parser.
+TestUnrolledCodegen ParseBoth(const std::string& input, bool expect_success) {
+  TestUnrolledCodegen unrolled;
+  TestTableDrivenCodegen table_driven;
+  EXPECT_EQ(unrolled.ParseFromString(input), expect_success);
+  EXPECT_EQ(table_driven.ParseFromString(input), expect_success);
+  if (expect_success) {
+    EXPECT_EQ(unrolled.SerializeAsString(), table_driven.SerializeAsString());
+    const UnknownFieldSet& unrolled_unknown =
+        unrolled.GetReflection()->GetUnknownFields(unrolled);
+    const UnknownFieldSet& table_driven_unknown =
+        table_driven.GetReflection()->GetUnknownFields(table_driven);
+    EXPECT_EQ(unrolled_unknown.field_count(),
+              table_driven_unknown.field_count());
+  }
+  return unrolled;
+}
+
+TEST(UnrolledCodegenTest, RoundTrip) {
+  const TestUnrolledCodegen msg = MakeTestUnrolledCodegen();
+  const std::string input = msg.SerializeAsString();
+  TestUnrolledCodegen parsed = ParseBoth(input, true);
+  EXPECT_EQ(parsed.SerializeAsString(), input);
+  EXPECT_EQ(parsed.optional_int32(), -1);
+  EXPECT_EQ(parsed.optional_sint32(), std::numeric_limits<int32_t>::min());
+  EXPECT_EQ(parsed.optional_fixed64(), 0x123456789abcdef0);
+  EXPECT_EQ(parsed.optional_double(), -2.25);
+  EXPECT_EQ(parsed.optional_enum(), proto2_unittest::UNROLLED_TWO);
+}
+
+TEST(UnrolledCodegenTest, ZeroValuesSetHasBits) {
+  TestUnrolledCodegen msg;
+  msg.set_optional_int32(0);
+  msg.set_optional_bool(false);
+  msg.set_optional_double(0);
+  TestUnrolledCodegen parsed = ParseBoth(msg.SerializeAsString(), true);
+  EXPECT_TRUE(parsed.has_optional_int32());
+  EXPECT_TRUE(parsed.has_optional_bool());
+  EXPECT_TRUE(parsed.has_optional_double());
+  EXPECT_FALSE(parsed.has_optional_int64());
+}
+
+TEST(UnrolledCodegenTest, AnyFieldOrder) {
+  // The unrolled parser predicts fields in number order. Feed them in reverse
+  // and interleaved with fields it does not handle, so every prediction
+  // misses.
+  const TestUnrolledCodegen msg = MakeTestUnrolledCodegen();
+  const Reflection* reflection = msg.GetReflection();
+  std::vector<const FieldDescriptor*> fields;
+  reflection->ListFields(msg, &fields);
+  std::string reversed;
+  std::string interleaved;
+  for (auto it = fields.rbegin(); it != fields.rend(); ++it) {
+    TestUnrolledCodegen single = msg;
+    for (const FieldDescriptor* other : fields) {
+      if (other != *it) reflection->ClearField(&single, other);
+    }
+    absl::StrAppend(&reversed, single.SerializeAsString());
+    absl::StrAppend(&interleaved, single.SerializeAsString(),
+                    "\x7a\x01x");  // optional_string: "x"
+  }
+  EXPECT_EQ(ParseBoth(reversed, true).SerializeAsString(),
+            msg.SerializeAsString());
+  TestUnrolledCodegen parsed = ParseBoth(interleaved, true);
+  EXPECT_EQ(parsed.optional_string(), "x");
+  EXPECT_EQ(parsed.optional_int64(), msg.optional_int64());
+}
+
+TEST(UnrolledCodegenTest, LastValueWins) {
+  // optional_int32: 1, optional_int64: 2, optional_int32: 3
+  TestUnrolledCodegen parsed =
+      ParseBoth(std::string("\x08\x01\x10\x02\x08\x03", 6), true);
+  EXPECT_EQ(parsed.optional_int32(), 3);
+  EXPECT_EQ(parsed.optional_int64(), 2);
+}
+
+TEST(UnrolledCodegenTest, LongestValidVarint) {
+  // -1 as an int32 is sign-extended to ten bytes.
+  TestUnrolledCodegen parsed = ParseBoth(
+      absl::StrCat("\x08", std::string(9, '\xff'), "\x01"), true);
+  EXPECT_EQ(parsed.optional_int32(), -1);
+}
+
+TEST(UnrolledCodegenTest, MalformedVarintFails) {
+  // Eleven bytes.
+  ParseBoth(absl::StrCat("\x08", std::string(10, '\xff'), "\x01"), false);
+  // Truncated, alone and followed by another unrolled field's payload.
+  ParseBoth("\x08\xff", false);
+  ParseBoth(absl::StrCat("\x10\x01\x08", std::string(5, '\x80')), false);
+}
+
+TEST(UnrolledCodegenTest, TruncatedFixedFails) {
+  // optional_fixed64 with only four bytes of payload.
+  ParseBoth(std::string("\x49\x01\x02\x03\x04", 5), false);
+  // optional_float with two.
+  ParseBoth(std::string("\x08\x01\x65\x01\x02", 5), false);
+}
+
+TEST(UnrolledCodegenTest, WireTypeMismatchIsUnknown) {
+  // optional_int32 as fixed32, then optional_int64 as a varint.
+  TestUnrolledCodegen parsed =
+      ParseBoth(std::string("\x0d\x01\x00\x00\x00\x10\x05", 7), true);
+  EXPECT_FALSE(parsed.has_optional_int32());
+  EXPECT_EQ(parsed.optional_int64(), 5);
+  const UnknownFieldSet& unknown =
+      parsed.GetReflection()->GetUnknownFields(parsed);
+  ASSERT_EQ(unknown.field_count(), 1);
+  EXPECT_EQ(unknown.field(0).number(), 1);
+  EXPECT_EQ(unknown.field(0).type(), UnknownField::TYPE_FIXED32);
+
+  // optional_double as a varint, after a correctly typed field.
+  parsed = ParseBoth(std::string("\x08\x05\x68\x07", 4), true);
+  EXPECT_EQ(parsed.optional_int32(), 5);
+  EXPECT_FALSE(parsed.has_optional_double());
+  EXPECT_EQ(parsed.GetReflection()->GetUnknownFields(parsed).field_count(),
+            1);
+}
+
+TEST(UnrolledCodegenTest, OpenEnumKeepsUnknownValue) {
+  // optional_enum: 99, optional_bool: true
+  TestUnrolledCodegen parsed = ParseBoth(std::string("\x70\x63\x38\x01", 4),
+                                         true);
+  EXPECT_TRUE(parsed.has_optional_enum());
+  EXPECT_EQ(static_cast<int>(parsed.optional_enum()), 99);
+  EXPECT_TRUE(parsed.optional_bool());
+  EXPECT_EQ(parsed.GetReflection()->GetUnknownFields(parsed).field_count(), 0);
+
+  // Negative values are sign-extended to ten bytes.
+  parsed = ParseBoth(absl::StrCat("\x70", std::string(9, '\xff'), "\x01"),
+                     true);
+  EXPECT_EQ(static_cast<int>(parsed.optional_enum()), -1);
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
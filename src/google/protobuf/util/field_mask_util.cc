@@ -14,7 +14,9 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/no_destructor.h"
 #include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/log/die_if_null.h"
@@ -24,8 +26,10 @@
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
+#include "google/protobuf/parse_projection.h"
 
 // Must be included last.
 #include "google/protobuf/port_def.inc"
@@ -155,6 +159,55 @@ bool FieldMaskUtil::GetFieldDescriptors(
   return true;
 }
 
+bool FieldMaskUtil::ToParseProjection(const FieldMask& mask,
+                                      const Descriptor* descriptor,
+                                      ParseProjection* out) {
+  std::vector<const FieldDescriptor*> fields;
+  std::vector<int> numbers;
+  for (const auto& path : mask.paths()) {
+    if (!GetFieldDescriptors(descriptor, path, &fields)) return false;
+    numbers.clear();
+    for (const FieldDescriptor* field : fields) {
+      numbers.push_back(field->number());
+    }
+    if (!out->AddPath(numbers)) return false;
+  }
+  return true;
+}
+
+std::shared_ptr<const ParseProjection> FieldMaskUtil::GetParseProjection(
+    const FieldMask& mask, const Descriptor* descriptor) {
+  // Masks come from callers, so the number of distinct keys is unbounded.
+  // Dropping the whole cache once it is full keeps memory bounded while still
+  // serving the common case of a few masks used over and over.
+  static constexpr size_t kMaxCachedProjections = 256;
+  struct Cache {
+    absl::Mutex mu;
+    absl::flat_hash_map<std::pair<const Descriptor*, std::string>,
+                        std::shared_ptr<const ParseProjection>>
+        projections ABSL_GUARDED_BY(mu);
+  };
+  static absl::NoDestructor<Cache> cache;
+
+  std::pair<const Descriptor*, std::string> key(descriptor, ToString(mask));
+  {
+    absl::ReaderMutexLock lock(&cache->mu);
+    auto it = cache->projections.find(key);
+    if (it != cache->projections.end()) return it->second;
+  }
+
+  auto projection = std::make_shared<ParseProjection>();
+  if (!ToParseProjection(mask, descriptor, projection.get())) return nullptr;
+  absl::MutexLock lock(&cache->mu);
+  if (cache->projections.size() >= kMaxCachedProjections) {
+    cache->projections.clear();
+  }
+  // Another thread may have inserted the same key in the meantime; keep the
+  // first projection so that callers of the same mask share one instance.
+  return cache->projections.try_emplace(std::move(key), std::move(projection))
+      .first->second;
+}
+
 void FieldMaskUtil::GetFieldMaskForAllFields(const Descriptor* descriptor,
                                              FieldMask* out) {
   for (int i = 0; i < descriptor->field_count(); ++i) {
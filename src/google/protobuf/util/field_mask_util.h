@@ -18,6 +18,7 @@
 #include "absl/log/absl_check.h"
 #include "absl/strings/string_view.h"
 #include "google/protobuf/descriptor.h"
+#include "google/protobuf/parse_projection.h"
 
 // Must be included last.
 #include "google/protobuf/port_def.inc"
@@ -158,6 +159,23 @@ class PROTOBUF_EXPORT FieldMaskUtil {
   static bool TrimMessage(const FieldMask& mask, Message* message,
                           const TrimOptions& options);
 
+  // Converts a FieldMask into a ParseProjection for messages of type
+  // 'descriptor', so that parsing only materializes the fields in the mask.
+  // Returns false if any path is invalid for 'descriptor', in which case the
+  // content of 'out' is unspecified.
+  static bool ToParseProjection(const FieldMask& mask,
+                                const Descriptor* descriptor,
+                                ParseProjection* out);
+
+  // Same as ToParseProjection(), but shares the projection through a
+  // process-wide cache keyed by ('descriptor', 'mask'), so hot parse paths do
+  // not rebuild it on every call. The cache holds a bounded number of
+  // projections and drops them all once it is full; projections that were
+  // already returned stay valid for as long as the caller holds them.
+  // Returns nullptr if the mask is invalid. Thread-safe.
+  static std::shared_ptr<const ParseProjection> GetParseProjection(
+      const FieldMask& mask, const Descriptor* descriptor);
+
  private:
   friend class SnakeCaseCamelCaseTest;
   // Converts a field name from snake_case to camelCase:
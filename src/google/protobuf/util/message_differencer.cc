@@ -12,16 +12,20 @@
 #include "google/protobuf/util/message_differencer.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "google/protobuf/descriptor.pb.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/strings/escaping.h"
@@ -149,6 +153,11 @@ class MessageDifferencer::MultipleFieldsMapKeyComparator
     return true;
   }
 
+  const std::vector<std::vector<const FieldDescriptor*> >& key_field_paths()
+      const {
+    return key_field_paths_;
+  }
+
  private:
   bool IsMatchInternal(
       const Message& message1, const Message& message2, int unpacked_any,
@@ -365,6 +374,13 @@ MessageDifferencer::repeated_field_comparison() const {
   return repeated_field_comparison_;
 }
 
+void MessageDifferencer::set_parallel_runner(ParallelRunner runner,
+                                             int min_elements_per_task) {
+  ABSL_CHECK_GT(min_elements_per_task, 0);
+  parallel_runner_ = std::move(runner);
+  min_elements_per_task_ = min_elements_per_task;
+}
+
 void MessageDifferencer::CheckRepeatedFieldComparisons(
     const FieldDescriptor* field,
     const RepeatedFieldComparison& new_comparison) {
@@ -1270,7 +1286,20 @@ bool MessageDifferencer::CompareRepeatedRep(
   // At this point, we have already matched pairs of fields (with the reporting
   // to be done later). Now to check if the paired elements are different.
   int next_unmatched_index = 0;
-  for (int i = 0; i < count1; i++) {
+  int first_sequential_index = 0;
+  if (!smart_list && parallel_runner_ != nullptr &&
+      std::min(count1, count2) >= 2 * min_elements_per_task_ &&
+      CanCompareElementsInParallel(repeated_field)) {
+    const int count = simple_list ? std::min(count1, count2) : count1;
+    if (!CompareRepeatedElementsInParallel(
+            message1, message2, unpacked_any, repeated_field,
+            simple_list ? nullptr : &match_list1, count, parent_fields)) {
+      if (reporter_ == nullptr) return false;
+      fieldDifferent = true;
+    }
+    first_sequential_index = count1;
+  }
+  for (int i = first_sequential_index; i < count1; i++) {
     if (simple_list && i >= count2) {
       break;
     }
@@ -1315,25 +1344,13 @@ bool MessageDifferencer::CompareRepeatedRep(
         specific_field.new_index, parent_fields);
 
     // If we have found differences, either report them or terminate if
-    // no reporter is present. Note that ReportModified, ReportMoved, and
-    // ReportMatched are all mutually exclusive.
+    // no reporter is present.
     if (!result) {
       if (reporter_ == nullptr) return false;
-      parent_fields->push_back(specific_field);
-      reporter_->ReportModified(message1, message2, *parent_fields);
-      parent_fields->pop_back();
       fieldDifferent = true;
-    } else if (reporter_ != nullptr &&
-               specific_field.index != specific_field.new_index &&
-               !specific_field.field->is_map() && report_moves_) {
-      parent_fields->push_back(specific_field);
-      reporter_->ReportMoved(message1, message2, *parent_fields);
-      parent_fields->pop_back();
-    } else if (report_matches_ && reporter_ != nullptr) {
-      parent_fields->push_back(specific_field);
-      reporter_->ReportMatched(message1, message2, *parent_fields);
-      parent_fields->pop_back();
     }
+    ReportRepeatedElement(result, message1, message2, specific_field,
+                          parent_fields);
   }
 
   // Report any remaining additions or deletions.
@@ -1365,6 +1382,267 @@ bool MessageDifferencer::CompareRepeatedRep(
   return !fieldDifferent;
 }
 
+void MessageDifferencer::ReportRepeatedElement(
+    bool equal, const Message& message1, const Message& message2,
+    const SpecificField& specific_field,
+    std::vector<SpecificField>* parent_fields) {
+  if (reporter_ == nullptr) return;
+  // Note that ReportModified, ReportMoved, and ReportMatched are all mutually
+  // exclusive.
+  if (!equal) {
+    parent_fields->push_back(specific_field);
+    reporter_->ReportModified(message1, message2, *parent_fields);
+    parent_fields->pop_back();
+  } else if (specific_field.index != specific_field.new_index &&
+             !specific_field.field->is_map() && report_moves_) {
+    parent_fields->push_back(specific_field);
+    reporter_->ReportMoved(message1, message2, *parent_fields);
+    parent_fields->pop_back();
+  } else if (report_matches_) {
+    parent_fields->push_back(specific_field);
+    reporter_->ReportMatched(message1, message2, *parent_fields);
+    parent_fields->pop_back();
+  }
+}
+
+namespace {
+
+// Records the calls made to a Reporter so that they can be replayed later.
+class RecordingReporter : public MessageDifferencer::Reporter {
+ public:
+  using SpecificField = MessageDifferencer::SpecificField;
+
+  void ReportAdded(const Message& message1, const Message& message2,
+                   const std::vector<SpecificField>& field_path) override {
+    Record(&Reporter::ReportAdded, message1, message2, field_path);
+  }
+  void ReportDeleted(const Message& message1, const Message& message2,
+                     const std::vector<SpecificField>& field_path) override {
+    Record(&Reporter::ReportDeleted, message1, message2, field_path);
+  }
+  void ReportModified(const Message& message1, const Message& message2,
+                      const std::vector<SpecificField>& field_path) override {
+    Record(&Reporter::ReportModified, message1, message2, field_path);
+  }
+  void ReportMoved(const Message& message1, const Message& message2,
+                   const std::vector<SpecificField>& field_path) override {
+    Record(&Reporter::ReportMoved, message1, message2, field_path);
+  }
+  void ReportMatched(const Message& message1, const Message& message2,
+                     const std::vector<SpecificField>& field_path) override {
+    Record(&Reporter::ReportMatched, message1, message2, field_path);
+  }
+  void ReportIgnored(const Message& message1, const Message& message2,
+                     const std::vector<SpecificField>& field_path) override {
+    Record(&Reporter::ReportIgnored, message1, message2, field_path);
+  }
+  void ReportUnknownFieldIgnored(
+      const Message& message1, const Message& message2,
+      const std::vector<SpecificField>& field_path) override {
+    Record(&Reporter::ReportUnknownFieldIgnored, message1, message2,
+           field_path);
+  }
+
+  void ReplayTo(MessageDifferencer::Reporter* reporter) const {
+    for (const Report& report : reports_) {
+      (reporter->*report.method)(*report.message1, *report.message2,
+                                 report.field_path);
+    }
+  }
+
+ private:
+  using Method = void (Reporter::*)(const Message&, const Message&,
+                                    const std::vector<SpecificField>&);
+  struct Report {
+    Method method;
+    const Message* message1;
+    const Message* message2;
+    std::vector<SpecificField> field_path;
+  };
+
+  void Record(Method method, const Message& message1, const Message& message2,
+              const std::vector<SpecificField>& field_path) {
+    reports_.push_back({method, &message1, &message2, field_path});
+  }
+
+  std::vector<Report> reports_;
+};
+
+// Lets a task differencer use the ignore criteria of the differencer it was
+// created from, which keeps ownership.
+class ForwardingIgnoreCriteria : public MessageDifferencer::IgnoreCriteria {
+ public:
+  explicit ForwardingIgnoreCriteria(IgnoreCriteria* criteria)
+      : criteria_(criteria) {}
+
+  bool IsIgnored(const Message& message1, const Message& message2,
+                 const FieldDescriptor* field,
+                 const std::vector<MessageDifferencer::SpecificField>&
+                     parent_fields) override {
+    return criteria_->IsIgnored(message1, message2, field, parent_fields);
+  }
+  bool IsUnknownFieldIgnored(
+      const Message& message1, const Message& message2,
+      const MessageDifferencer::SpecificField& field,
+      const std::vector<MessageDifferencer::SpecificField>& parent_fields)
+      override {
+    return criteria_->IsUnknownFieldIgnored(message1, message2, field,
+                                            parent_fields);
+  }
+
+ private:
+  IgnoreCriteria* criteria_;
+};
+
+bool ContainsAny(const Descriptor* descriptor,
+                 absl::flat_hash_set<const Descriptor*>* visited) {
+  if (!visited->insert(descriptor).second) return false;
+  if (descriptor->full_name() == internal::kAnyFullTypeName) return true;
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const Descriptor* message_type = descriptor->field(i)->message_type();
+    if (message_type != nullptr && ContainsAny(message_type, visited)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+bool MessageDifferencer::CanCompareElementsInParallel(
+    const FieldDescriptor* repeated_field) {
+  if (repeated_field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+    return false;
+  }
+  // Task differencers recreate the key comparators owned by this differencer,
+  // but user-supplied ones may refer back to this differencer.
+  for (const auto& entry : map_field_key_comparator_) {
+    if (std::find(owned_key_comparators_.begin(), owned_key_comparators_.end(),
+                  entry.second) == owned_key_comparators_.end()) {
+      return false;
+    }
+  }
+  // Any payloads are unpacked into temporary messages, which would no longer
+  // exist when the recorded reports are replayed. Extensions are not
+  // considered, so they must not be Any either.
+  absl::flat_hash_set<const Descriptor*> visited;
+  return reporter_ == nullptr ||
+         !ContainsAny(repeated_field->message_type(), &visited);
+}
+
+std::unique_ptr<MessageDifferencer> MessageDifferencer::NewTaskDifferencer()
+    const {
+  auto differencer = std::make_unique<MessageDifferencer>();
+  differencer->message_field_comparison_ = message_field_comparison_;
+  differencer->scope_ = scope_;
+  differencer->force_compare_no_presence_fields_ =
+      force_compare_no_presence_fields_;
+  differencer->require_no_presence_fields_ = require_no_presence_fields_;
+  differencer->repeated_field_comparison_ = repeated_field_comparison_;
+  differencer->repeated_field_comparisons_ = repeated_field_comparisons_;
+  for (const auto& entry : map_field_key_comparator_) {
+    const auto* key_comparator =
+        static_cast<const MultipleFieldsMapKeyComparator*>(entry.second);
+    MapKeyComparator* copy = new MultipleFieldsMapKeyComparator(
+        differencer.get(), key_comparator->key_field_paths());
+    differencer->owned_key_comparators_.push_back(copy);
+    differencer->map_field_key_comparator_[entry.first] = copy;
+  }
+  for (const auto& criteria : ignore_criteria_) {
+    differencer->ignore_criteria_.push_back(
+        std::make_unique<ForwardingIgnoreCriteria>(criteria.get()));
+  }
+  differencer->ignored_fields_ = ignored_fields_;
+  differencer->field_comparator_ = field_comparator_;
+  differencer->field_comparator_kind_ = field_comparator_kind_;
+  differencer->report_matches_ = report_matches_;
+  differencer->report_moves_ = report_moves_;
+  differencer->report_ignores_ = report_ignores_;
+  differencer->force_compare_no_presence_ = force_compare_no_presence_;
+  differencer->match_indices_for_smart_list_callback_ =
+      match_indices_for_smart_list_callback_;
+  return differencer;
+}
+
+bool MessageDifferencer::CompareRepeatedElementsInParallel(
+    const Message& message1, const Message& message2, int unpacked_any,
+    const FieldDescriptor* repeated_field, const std::vector<int>* match_list1,
+    int count, std::vector<SpecificField>* parent_fields) {
+  std::vector<std::pair<int, int>> pairs;
+  pairs.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    const int j = match_list1 == nullptr ? i : (*match_list1)[i];
+    if (j >= 0) pairs.emplace_back(i, j);
+  }
+
+  struct TaskResult {
+    RecordingReporter reports;
+    bool equal = true;
+    absl::flat_hash_set<const FieldDescriptor*> no_presence_fields;
+    absl::flat_hash_set<std::string> failure_triggering_fields;
+  };
+  const size_t per_task = min_elements_per_task_;
+  const size_t num_tasks = (pairs.size() + per_task - 1) / per_task;
+  std::vector<TaskResult> results(num_tasks);
+  // Without a reporter, the first difference decides the result, so the
+  // other tasks can stop early.
+  const bool report = reporter_ != nullptr;
+  std::atomic<bool> found_difference{false};
+
+  std::vector<std::function<void()>> tasks;
+  tasks.reserve(num_tasks);
+  for (size_t t = 0; t < num_tasks; ++t) {
+    tasks.push_back([&, t] {
+      TaskResult& result = results[t];
+      std::unique_ptr<MessageDifferencer> differencer = NewTaskDifferencer();
+      if (report) differencer->reporter_ = &result.reports;
+      std::vector<SpecificField> fields = *parent_fields;
+      SpecificField specific_field;
+      specific_field.message1 = &message1;
+      specific_field.message2 = &message2;
+      specific_field.unpacked_any = unpacked_any;
+      specific_field.field = repeated_field;
+      const size_t end = std::min(pairs.size(), (t + 1) * per_task);
+      for (size_t k = t * per_task; k < end; ++k) {
+        if (!report && found_difference.load(std::memory_order_relaxed)) {
+          break;
+        }
+        const auto [i, j] = pairs[k];
+        AddSpecificIndex(&specific_field, message1, repeated_field, i);
+        AddSpecificNewIndex(&specific_field, message2, repeated_field, j);
+        const bool equal = differencer->CompareFieldValueUsingParentFields(
+            message1, message2, unpacked_any, repeated_field, i, j, &fields);
+        if (!equal) {
+          result.equal = false;
+          if (!report) {
+            found_difference.store(true, std::memory_order_relaxed);
+            break;
+          }
+        }
+        differencer->ReportRepeatedElement(equal, message1, message2,
+                                           specific_field, &fields);
+      }
+      result.no_presence_fields =
+          std::move(differencer->force_compare_no_presence_fields_);
+      result.failure_triggering_fields =
+          std::move(differencer->force_compare_failure_triggering_fields_);
+    });
+  }
+  parallel_runner_(tasks);
+
+  bool equal = true;
+  for (const TaskResult& result : results) {
+    if (report) result.reports.ReplayTo(reporter_);
+    equal = equal && result.equal;
+    force_compare_no_presence_fields_.insert(result.no_presence_fields.begin(),
+                                             result.no_presence_fields.end());
+    force_compare_failure_triggering_fields_.insert(
+        result.failure_triggering_fields.begin(),
+        result.failure_triggering_fields.end());
+  }
+  return equal;
+}
+
 bool MessageDifferencer::CompareFieldValue(const Message& message1,
                                            const Message& message2,
                                            int unpacked_any,
@@ -1883,6 +2161,10 @@ bool MaximumMatcher::FindArgumentPathDFS(int v, std::vector<bool>* visited) {
   return false;
 }
 
+// Below this many candidates, comparing elements pairwise is cheaper than
+// fingerprinting them.
+constexpr int kMinElementsToFingerprint = 8;
+
 }  // namespace
 
 bool MessageDifferencer::MatchRepeatedFieldIndices(
@@ -1971,6 +2253,16 @@ bool MessageDifferencer::MatchRepeatedFieldIndices(
         }
       }
     }
+    if (!is_treated_as_smart_set && !IsTreatedAsSmartList(repeated_field) &&
+        count2 - start_offset >= kMinElementsToFingerprint &&
+        CanFingerprintElements(key_comparator)) {
+      success = MatchRepeatedFieldIndicesByFingerprint(
+          message1, message2, unpacked_any, repeated_field, key_comparator,
+          parent_fields, start_offset, reporter != nullptr, match_list1,
+          match_list2);
+      if (!success && reporter == nullptr) return false;
+      start_offset = count1;  // All elements have been matched.
+    }
     for (int i = start_offset; i < count1; ++i) {
       // Indicates any matched elements for this repeated field.
       bool match = false;
@@ -2045,6 +2337,233 @@ bool MessageDifferencer::MatchRepeatedFieldIndices(
   return success;
 }
 
+bool MessageDifferencer::MatchRepeatedFieldIndicesByFingerprint(
+    const Message& message1, const Message& message2, int unpacked_any,
+    const FieldDescriptor* repeated_field,
+    const MapKeyComparator* key_comparator,
+    const std::vector<SpecificField>& parent_fields, int start_offset,
+    bool report_all, std::vector<int>* match_list1,
+    std::vector<int>* match_list2) {
+  const int count1 = static_cast<int>(match_list1->size());
+  const int count2 = static_cast<int>(match_list2->size());
+
+  // Candidates in message2 with the same fingerprint, in increasing index
+  // order. Elements before `first_unmatched` have all been matched already.
+  struct Bucket {
+    std::vector<int> indices;
+    size_t first_unmatched = 0;
+  };
+  absl::flat_hash_map<uint64_t, Bucket> buckets;
+  for (int j = start_offset; j < count2; ++j) {
+    buckets[FingerprintElement(message2, repeated_field, key_comparator, j)]
+        .indices.push_back(j);
+  }
+
+  bool success = true;
+  for (int i = start_offset; i < count1; ++i) {
+    int matched_j = -1;
+    auto it = buckets.find(
+        FingerprintElement(message1, repeated_field, key_comparator, i));
+    if (it != buckets.end()) {
+      Bucket& bucket = it->second;
+      while (bucket.first_unmatched < bucket.indices.size() &&
+             match_list2->at(bucket.indices[bucket.first_unmatched]) != -1) {
+        ++bucket.first_unmatched;
+      }
+      for (size_t k = bucket.first_unmatched; k < bucket.indices.size(); ++k) {
+        const int j = bucket.indices[k];
+        if (match_list2->at(j) != -1) continue;
+        if (IsMatch(repeated_field, key_comparator, &message1, &message2,
+                    unpacked_any, parent_fields, nullptr, i, j)) {
+          matched_j = j;
+          break;
+        }
+      }
+    }
+    if (matched_j != -1) {
+      match_list1->at(i) = matched_j;
+      match_list2->at(matched_j) = i;
+    } else {
+      if (!report_all) return false;
+      success = false;
+    }
+  }
+  return success;
+}
+
+bool MessageDifferencer::CanFingerprintElements(
+    const MapKeyComparator* key_comparator) const {
+  if (field_comparator_kind_ != kFCDefault || !ignore_criteria_.empty()) {
+    return false;
+  }
+  // Custom key comparators may match keys in arbitrary ways.
+  return key_comparator == nullptr ||
+         key_comparator == &map_entry_key_comparator_ ||
+         std::find(owned_key_comparators_.begin(), owned_key_comparators_.end(),
+                   key_comparator) != owned_key_comparators_.end();
+}
+
+uint64_t MessageDifferencer::FingerprintElement(
+    const Message& message, const FieldDescriptor* repeated_field,
+    const MapKeyComparator* key_comparator, int index) {
+  if (key_comparator == nullptr) {
+    return FingerprintFieldValue(message, repeated_field, index);
+  }
+  const Message& element = message.GetReflection()->GetRepeatedMessage(
+      message, repeated_field, index);
+  if (key_comparator == &map_entry_key_comparator_) {
+    const FieldDescriptor* key = element.GetDescriptor()->map_key();
+    // Entries are compared as a whole if the key is ignored.
+    if (ignored_fields_.contains(key)) return FingerprintMessage(element);
+    return FingerprintFieldValue(element, key, -1);
+  }
+  // Owned key comparators are always MultipleFieldsMapKeyComparator.
+  const auto* multiple_fields_comparator =
+      static_cast<const MultipleFieldsMapKeyComparator*>(key_comparator);
+  uint64_t fingerprint = 0;
+  for (const auto& path : multiple_fields_comparator->key_field_paths()) {
+    const Message* current = &element;
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+      // Intermediate messages only match if both are present or both absent.
+      if (!current->GetReflection()->HasField(*current, path[i])) {
+        current = nullptr;
+        break;
+      }
+      current = &current->GetReflection()->GetMessage(*current, path[i]);
+    }
+    uint64_t key_fingerprint = 0;
+    if (current != nullptr) {
+      const FieldDescriptor* key = path.back();
+      key_fingerprint = absl::HashOf(
+          true, key->is_repeated() ? FingerprintField(*current, key)
+                                   : FingerprintFieldValue(*current, key, -1));
+    }
+    fingerprint = absl::HashOf(fingerprint, key_fingerprint);
+  }
+  return fingerprint;
+}
+
+uint64_t MessageDifferencer::FingerprintMessage(const Message& message) {
+  const Descriptor* descriptor = message.GetDescriptor();
+  // Any payloads are compared after unpacking, so their serialized form says
+  // nothing about equality.
+  if (descriptor->full_name() == internal::kAnyFullTypeName) return 0;
+
+  std::vector<const FieldDescriptor*> fields;
+  message.GetReflection()->ListFields(message, &fields);
+  uint64_t fingerprint = 0;
+  for (const FieldDescriptor* field : fields) {
+    if (ignored_fields_.contains(field)) continue;
+    const uint64_t field_fingerprint = FingerprintField(message, field);
+    // Zero stands for "no information", e.g. an empty submessage or a field
+    // set to its default value. These must not contribute, since they compare
+    // equal to an unset field when comparing equivalence.
+    if (field_fingerprint == 0) continue;
+    fingerprint = absl::HashOf(fingerprint, field->number(), field_fingerprint);
+  }
+  return fingerprint;
+}
+
+uint64_t MessageDifferencer::FingerprintField(const Message& message,
+                                              const FieldDescriptor* field) {
+  if (!field->is_repeated()) {
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      return FingerprintFieldValue(message, field, -1);
+    }
+    // Leave out default values, which may or may not count as set.
+    const Reflection* reflection = message.GetReflection();
+    bool is_default = false;
+    switch (field->cpp_type()) {
+#define IS_DEFAULT(CPPTYPE, METHOD, DEFAULT)                      \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE:                        \
+    is_default = reflection->Get##METHOD(message, field) == DEFAULT; \
+    break;
+      IS_DEFAULT(INT32, Int32, field->default_value_int32());
+      IS_DEFAULT(INT64, Int64, field->default_value_int64());
+      IS_DEFAULT(UINT32, UInt32, field->default_value_uint32());
+      IS_DEFAULT(UINT64, UInt64, field->default_value_uint64());
+      IS_DEFAULT(FLOAT, Float, field->default_value_float());
+      IS_DEFAULT(DOUBLE, Double, field->default_value_double());
+      IS_DEFAULT(BOOL, Bool, field->default_value_bool());
+      IS_DEFAULT(ENUM, EnumValue, field->default_value_enum()->number());
+#undef IS_DEFAULT
+      case FieldDescriptor::CPPTYPE_STRING: {
+        std::string scratch;
+        is_default =
+            reflection->GetStringReference(message, field, &scratch) ==
+            field->default_value_string();
+        break;
+      }
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        break;
+    }
+    return is_default ? 0 : FingerprintFieldValue(message, field, -1);
+  }
+  // Maps and repeated fields that are not compared as lists are left out.
+  if (field->is_map() || GetMapKeyComparator(field) != nullptr ||
+      IsTreatedAsSet(field) || IsTreatedAsSmartSet(field) ||
+      IsTreatedAsSmartList(field)) {
+    return 0;
+  }
+  const int size = message.GetReflection()->FieldSize(message, field);
+  uint64_t fingerprint = absl::HashOf(size);
+  for (int i = 0; i < size; ++i) {
+    fingerprint =
+        absl::HashOf(fingerprint, FingerprintFieldValue(message, field, i));
+  }
+  return fingerprint;
+}
+
+uint64_t MessageDifferencer::FingerprintFieldValue(const Message& message,
+                                                   const FieldDescriptor* field,
+                                                   int index) {
+  const Reflection* reflection = message.GetReflection();
+  const bool exact_floats =
+      field_comparator_.default_impl->float_comparison() ==
+      DefaultFieldComparator::EXACT;
+  // Float values only contribute when compared exactly. -0.0 and 0.0 compare
+  // equal, and so do NaNs when treat_nan_as_equal is set.
+  auto float_fingerprint = [&](double value) -> uint64_t {
+    if (!exact_floats) return 0;
+    if (std::isnan(value)) return 1;
+    return absl::HashOf(value == 0 ? 0.0 : value);
+  };
+  switch (field->cpp_type()) {
+#define FINGERPRINT(CPPTYPE, METHOD)                                    \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE:                              \
+    return absl::HashOf(                                                \
+        index < 0 ? reflection->Get##METHOD(message, field)             \
+                  : reflection->GetRepeated##METHOD(message, field, index));
+    FINGERPRINT(INT32, Int32);
+    FINGERPRINT(INT64, Int64);
+    FINGERPRINT(UINT32, UInt32);
+    FINGERPRINT(UINT64, UInt64);
+    FINGERPRINT(BOOL, Bool);
+    FINGERPRINT(ENUM, EnumValue);
+#undef FINGERPRINT
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      return float_fingerprint(
+          index < 0 ? reflection->GetFloat(message, field)
+                    : reflection->GetRepeatedFloat(message, field, index));
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      return float_fingerprint(
+          index < 0 ? reflection->GetDouble(message, field)
+                    : reflection->GetRepeatedDouble(message, field, index));
+    case FieldDescriptor::CPPTYPE_STRING: {
+      std::string scratch;
+      return absl::HashOf(
+          index < 0 ? reflection->GetStringReference(message, field, &scratch)
+                    : reflection->GetRepeatedStringReference(message, field,
+                                                             index, &scratch));
+    }
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      return FingerprintMessage(
+          index < 0 ? reflection->GetMessage(message, field)
+                    : reflection->GetRepeatedMessage(message, field, index));
+  }
+  return 0;
+}
+
 FieldComparator::ComparisonResult MessageDifferencer::GetFieldComparisonResult(
     const Message& message1, const Message& message2,
     const FieldDescriptor* field, int index1, int index2,
@@ -20,6 +20,7 @@
 #ifndef GOOGLE_PROTOBUF_UTIL_MESSAGE_DIFFERENCER_H__
 #define GOOGLE_PROTOBUF_UTIL_MESSAGE_DIFFERENCER_H__
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -601,6 +602,30 @@ class PROTOBUF_EXPORT MessageDifferencer {
   // Returns the current repeated field comparison used by this differencer.
   RepeatedFieldComparison repeated_field_comparison() const;
 
+  // Runs every task in `tasks`, possibly concurrently, and returns once all of
+  // them have finished. Typically schedules the tasks on a thread pool and
+  // waits for them to complete.
+  using ParallelRunner =
+      std::function<void(std::vector<std::function<void()>>& tasks)>;
+
+  // Compares the elements of large repeated message fields in parallel. The
+  // element pairs of a field are split into groups of at least
+  // `min_elements_per_task` pairs, and each group is compared by a task passed
+  // to `runner`. Passing a null runner turns parallel comparison off.
+  //
+  // The result of Compare() and the calls made to the Reporter, including
+  // their order, are the same as for a sequential comparison. Reporter
+  // methods are only called from the thread that called Compare(). However,
+  // FieldComparators and IgnoreCriteria may be called concurrently from the
+  // tasks, so they must be thread-safe.
+  //
+  // Fields compared as SMART_LIST are always compared sequentially. Parallel
+  // comparison is also turned off entirely when a MapKeyComparator was
+  // supplied with TreatAsMapUsingKeyComparator(), and when reporting
+  // differences inside messages that contain google.protobuf.Any.
+  void set_parallel_runner(ParallelRunner runner,
+                           int min_elements_per_task = 1000);
+
   // Compares the two specified messages, returning true if they are the same,
   // false otherwise. If this method returns false, any changes between the
   // two messages will be reported if a Reporter was specified via
@@ -914,6 +939,62 @@ class PROTOBUF_EXPORT MessageDifferencer {
       const std::vector<SpecificField>& parent_fields,
       std::vector<int>* match_list1, std::vector<int>* match_list2);
 
+  // Like the greedy loop in MatchRepeatedFieldIndices(), but only compares
+  // elements whose fingerprints are equal, which makes matching large sets and
+  // maps roughly linear instead of quadratic. Produces the same matching as
+  // the greedy loop. Only valid when CanFingerprintElements() is true.
+  bool MatchRepeatedFieldIndicesByFingerprint(
+      const Message& message1, const Message& message2, int unpacked_any,
+      const FieldDescriptor* repeated_field,
+      const MapKeyComparator* key_comparator,
+      const std::vector<SpecificField>& parent_fields, int start_offset,
+      bool report_all, std::vector<int>* match_list1,
+      std::vector<int>* match_list2);
+
+  // Returns true if elements of a repeated field that is matched with
+  // `key_comparator` can be fingerprinted: the comparison must only depend on
+  // the default field comparator and on ignored fields, not on custom
+  // comparators or ignore criteria.
+  bool CanFingerprintElements(const MapKeyComparator* key_comparator) const;
+
+  // Fingerprints are a coarse hash of the parts of a value that take part in
+  // the comparison: values that compare as equal always have the same
+  // fingerprint, so different fingerprints imply a mismatch.
+  uint64_t FingerprintElement(const Message& message,
+                              const FieldDescriptor* repeated_field,
+                              const MapKeyComparator* key_comparator,
+                              int index);
+  uint64_t FingerprintMessage(const Message& message);
+  uint64_t FingerprintFieldValue(const Message& message,
+                                 const FieldDescriptor* field, int index);
+  uint64_t FingerprintField(const Message& message,
+                            const FieldDescriptor* field);
+
+  // Reports the result of comparing a pair of matched elements of a repeated
+  // field, described by `specific_field`.
+  void ReportRepeatedElement(bool equal, const Message& message1,
+                             const Message& message2,
+                             const SpecificField& specific_field,
+                             std::vector<SpecificField>* parent_fields);
+
+  // Returns true if the elements of `repeated_field` may be compared by
+  // parallel tasks.
+  bool CanCompareElementsInParallel(const FieldDescriptor* repeated_field);
+
+  // Compares the element pairs (i, match_list1[i]) for i in [0, count) using
+  // the parallel runner, then reports the results in order. If `match_list1`
+  // is null, element i is paired with element i. Returns true if all pairs
+  // are equal.
+  bool CompareRepeatedElementsInParallel(
+      const Message& message1, const Message& message2, int unpacked_any,
+      const FieldDescriptor* repeated_field,
+      const std::vector<int>* match_list1, int count,
+      std::vector<SpecificField>* parent_fields);
+
+  // Returns a differencer with the same configuration as this one, for use by
+  // a single parallel task. It does not have a reporter or a parallel runner.
+  std::unique_ptr<MessageDifferencer> NewTaskDifferencer() const;
+
   // Checks if index is equal to new_index in all the specific fields.
   static bool CheckPathChanged(const std::vector<SpecificField>& parent_fields);
 
@@ -975,6 +1056,9 @@ class PROTOBUF_EXPORT MessageDifferencer {
       match_indices_for_smart_list_callback_;
 
   MessageDifferencer::UnpackAnyField unpack_any_field_;
+
+  ParallelRunner parallel_runner_;
+  int min_elements_per_task_ = 1000;
 };
 
 // This class provides extra information to the FieldComparator::Compare
@@ -14,8 +14,12 @@
 #include "google/protobuf/util/message_differencer.h"
 
 #include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -2399,6 +2403,165 @@ TEST(MessageDifferencerTest, TreatRepeatedFieldAsSetWithIgnoredFields) {
   EXPECT_TRUE(differ.Compare(msg1, msg2));
 }
 
+// Ignores nothing, but having any ignore criteria turns off fingerprinting of
+// set and map elements, so matching falls back to pairwise comparisons.
+class NoOpIgnorer : public util::MessageDifferencer::IgnoreCriteria {
+ public:
+  bool IsIgnored(const Message& message1, const Message& message2,
+                 const FieldDescriptor* field,
+                 const std::vector<util::MessageDifferencer::SpecificField>&
+                     parent_fields) override {
+    return false;
+  }
+};
+
+TEST(MessageDifferencerTest, LargeSetsAndMapsMatchLikePairwiseComparison) {
+  proto2_unittest::TestDiffMessage msg1;
+  for (int i = 0; i < 200; ++i) {
+    proto2_unittest::TestField* rm = msg1.add_rm();
+    rm->set_a(i % 50);
+    rm->set_c(i);
+    rm->add_rc(i);
+    rm->mutable_m()->set_b(i % 3);
+    proto2_unittest::TestDiffMessage::Item* item = msg1.add_item();
+    item->set_a(i);
+    item->set_b(absl::StrCat("b", i % 7));
+    item->add_ra(i % 5);
+    (*item->mutable_mp())[absl::StrCat("k", i)] = i;
+  }
+  proto2_unittest::TestDiffMessage msg2 = msg1;
+  std::mt19937 rng(42);
+  std::shuffle(msg2.mutable_rm()->begin(), msg2.mutable_rm()->end(), rng);
+  std::shuffle(msg2.mutable_item()->begin(), msg2.mutable_item()->end(), rng);
+
+  using Configure = std::function<void(util::MessageDifferencer&)>;
+  auto compare = [&](bool fingerprint, const Configure& configure) {
+    util::MessageDifferencer differencer;
+    if (!fingerprint) {
+      differencer.AddIgnoreCriteria(std::make_unique<NoOpIgnorer>());
+    }
+    configure(differencer);
+    std::string report;
+    differencer.ReportDifferencesToString(&report);
+    differencer.Compare(msg1, msg2);
+    return report;
+  };
+  const Configure as_sets = [&](util::MessageDifferencer& differencer) {
+    differencer.TreatAsSet(GetFieldDescriptor(msg1, "rm"));
+    differencer.TreatAsSet(GetFieldDescriptor(msg1, "item"));
+  };
+  const Configure as_map = [&](util::MessageDifferencer& differencer) {
+    differencer.TreatAsMap(GetFieldDescriptor(msg1, "item"),
+                           GetFieldDescriptor(msg1, "item.a"));
+  };
+  const Configure as_multi_key_map =
+      [&](util::MessageDifferencer& differencer) {
+        differencer.TreatAsSet(GetFieldDescriptor(msg1, "rm"));
+        differencer.TreatAsMapWithMultipleFieldsAsKey(
+            GetFieldDescriptor(msg1, "item"),
+            {GetFieldDescriptor(msg1, "item.b"),
+             GetFieldDescriptor(msg1, "item.ra")});
+      };
+
+  util::MessageDifferencer equal;
+  as_sets(equal);
+  EXPECT_TRUE(equal.Compare(msg1, msg2));
+
+  // Introduce differences that make some elements unmatched or modified.
+  msg2.mutable_rm(3)->mutable_m()->set_b(7);
+  msg2.mutable_rm(10)->add_rc(1);
+  msg2.add_rm()->set_c(1000);
+  msg2.mutable_item(5)->set_b("x");
+  (*msg2.mutable_item(6)->mutable_mp())["k"] = 1;
+  msg2.mutable_item()->RemoveLast();
+
+  for (const Configure& configure : {as_sets, as_map, as_multi_key_map}) {
+    std::string report = compare(/*fingerprint=*/true, configure);
+    EXPECT_FALSE(report.empty());
+    EXPECT_EQ(report, compare(/*fingerprint=*/false, configure));
+  }
+}
+
+TEST(MessageDifferencerTest, LargeSetsRespectComparisonSettings) {
+  proto2_unittest::TestDiffMessage msg1, msg2;
+  for (int i = 0; i < 50; ++i) {
+    // Fields explicitly set to their default value.
+    proto2_unittest::TestField* rm = msg1.add_rm();
+    rm->set_c(i);
+    rm->set_a(0);
+    rm->set_b(i);
+    msg2.add_rm()->set_c(49 - i);
+  }
+  util::MessageDifferencer differencer;
+  differencer.TreatAsSet(GetFieldDescriptor(msg1, "rm"));
+  differencer.IgnoreField(GetFieldDescriptor(msg1, "rm.b"));
+  EXPECT_FALSE(differencer.Compare(msg1, msg2));
+  differencer.set_message_field_comparison(
+      util::MessageDifferencer::EQUIVALENT);
+  EXPECT_TRUE(differencer.Compare(msg1, msg2));
+
+  proto2_unittest::TestAllTypes floats1, floats2;
+  for (int i = 0; i < 50; ++i) {
+    floats1.add_repeated_double(1.0 + i);
+    floats2.add_repeated_double(std::nextafter(50.0 - i, 100.0));
+  }
+  util::MessageDifferencer float_differencer;
+  float_differencer.TreatAsSet(GetFieldDescriptor(floats1, "repeated_double"));
+  EXPECT_FALSE(float_differencer.Compare(floats1, floats2));
+  float_differencer.set_float_comparison(
+      util::MessageDifferencer::APPROXIMATE);
+  EXPECT_TRUE(float_differencer.Compare(floats1, floats2));
+}
+
+TEST(MessageDifferencerTest, ParallelComparisonMatchesSequential) {
+  proto2_unittest::TestDiffMessage msg1;
+  for (int i = 0; i < 100; ++i) {
+    proto2_unittest::TestField* rm = msg1.add_rm();
+    rm->set_a(i);
+    rm->add_rc(i);
+    rm->add_rm()->set_c(i % 4);
+  }
+  proto2_unittest::TestDiffMessage msg2 = msg1;
+  msg2.mutable_rm(7)->set_b(1);
+  msg2.mutable_rm(42)->mutable_rm(0)->set_c(10);
+  msg2.mutable_rm()->SwapElements(50, 60);
+  msg2.add_rm()->set_a(100);
+
+  int runs = 0;
+  auto runner = [&](std::vector<std::function<void()>>& tasks) {
+    std::vector<std::thread> threads;
+    for (auto& task : tasks) threads.emplace_back(task);
+    for (auto& thread : threads) thread.join();
+    ++runs;
+  };
+  auto compare = [&](bool parallel, bool as_set,
+                     const proto2_unittest::TestDiffMessage& other) {
+    util::MessageDifferencer differencer;
+    if (parallel) differencer.set_parallel_runner(runner, 10);
+    if (as_set) differencer.TreatAsSet(GetFieldDescriptor(msg1, "rm"));
+    differencer.IgnoreField(GetFieldDescriptor(msg1, "rm.b"));
+    std::string report;
+    differencer.ReportDifferencesToString(&report);
+    const bool equal = differencer.Compare(msg1, other);
+    return absl::StrCat(equal, "\n", report);
+  };
+
+  for (bool as_set : {false, true}) {
+    EXPECT_EQ(compare(true, as_set, msg2), compare(false, as_set, msg2));
+    EXPECT_THAT(compare(true, as_set, msg1), testing::StartsWith("1\n"));
+  }
+  EXPECT_GT(runs, 0);
+
+  // Without a reporter.
+  util::MessageDifferencer differencer;
+  differencer.set_parallel_runner(runner, 10);
+  EXPECT_FALSE(differencer.Compare(msg1, msg2));
+  msg2 = msg1;
+  msg2.mutable_rm(99)->set_b(1);
+  EXPECT_TRUE(differencer.Compare(msg1, msg1));
+  EXPECT_FALSE(differencer.Compare(msg1, msg2));
+}
+
 TEST(MessageDifferencerTest, TreatRepeatedFieldAsMapWithIgnoredKeyFields) {
   proto2_unittest::TestDiffMessage msg1;
   proto2_unittest::TestDiffMessage msg2;
@@ -84,7 +84,7 @@ constexpr UInt64Value::ParseTableT_ UInt64Value::InternalGenerateParseTable_(con
       65535, 65535
     }}, {{
       // uint64 value = 1;
-      {PROTOBUF_FIELD_OFFSET(UInt64Value, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kUInt64)},
+      {PROTOBUF_FIELD_OFFSET(UInt64Value, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kUInt64 | ::_fl::kHbHint)},
     }},
     // no aux_entries
     {{
@@ -192,7 +192,7 @@ constexpr UInt32Value::ParseTableT_ UInt32Value::InternalGenerateParseTable_(con
       65535, 65535
     }}, {{
       // uint32 value = 1;
-      {PROTOBUF_FIELD_OFFSET(UInt32Value, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kUInt32)},
+      {PROTOBUF_FIELD_OFFSET(UInt32Value, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kUInt32 | ::_fl::kHbHint)},
     }},
     // no aux_entries
     {{
@@ -300,7 +300,7 @@ constexpr StringValue::ParseTableT_ StringValue::InternalGenerateParseTable_(con
       65535, 65535
     }}, {{
       // string value = 1;
-      {PROTOBUF_FIELD_OFFSET(StringValue, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kUtf8String | ::_fl::kRepAString)},
+      {PROTOBUF_FIELD_OFFSET(StringValue, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kUtf8String | ::_fl::kRepAString | ::_fl::kHbHint)},
     }},
     // no aux_entries
     {{
@@ -413,7 +413,7 @@ constexpr Int64Value::ParseTableT_ Int64Value::InternalGenerateParseTable_(const
       65535, 65535
     }}, {{
       // int64 value = 1;
-      {PROTOBUF_FIELD_OFFSET(Int64Value, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kInt64)},
+      {PROTOBUF_FIELD_OFFSET(Int64Value, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kInt64 | ::_fl::kHbHint)},
     }},
     // no aux_entries
     {{
@@ -521,7 +521,7 @@ constexpr Int32Value::ParseTableT_ Int32Value::InternalGenerateParseTable_(const
       65535, 65535
     }}, {{
       // int32 value = 1;
-      {PROTOBUF_FIELD_OFFSET(Int32Value, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kInt32)},
+      {PROTOBUF_FIELD_OFFSET(Int32Value, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kInt32 | ::_fl::kHbHint)},
     }},
     // no aux_entries
     {{
@@ -629,7 +629,7 @@ constexpr FloatValue::ParseTableT_ FloatValue::InternalGenerateParseTable_(const
       65535, 65535
     }}, {{
       // float value = 1;
-      {PROTOBUF_FIELD_OFFSET(FloatValue, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kFloat)},
+      {PROTOBUF_FIELD_OFFSET(FloatValue, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kFloat | ::_fl::kHbHint)},
     }},
     // no aux_entries
     {{
@@ -737,7 +737,7 @@ constexpr DoubleValue::ParseTableT_ DoubleValue::InternalGenerateParseTable_(con
       65535, 65535
     }}, {{
       // double value = 1;
-      {PROTOBUF_FIELD_OFFSET(DoubleValue, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kDouble)},
+      {PROTOBUF_FIELD_OFFSET(DoubleValue, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kDouble | ::_fl::kHbHint)},
     }},
     // no aux_entries
     {{
@@ -845,7 +845,7 @@ constexpr BytesValue::ParseTableT_ BytesValue::InternalGenerateParseTable_(const
       65535, 65535
     }}, {{
       // bytes value = 1;
-      {PROTOBUF_FIELD_OFFSET(BytesValue, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kBytes | ::_fl::kRepAString)},
+      {PROTOBUF_FIELD_OFFSET(BytesValue, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kBytes | ::_fl::kRepAString | ::_fl::kHbHint)},
     }},
     // no aux_entries
     {{
@@ -955,7 +955,7 @@ constexpr BoolValue::ParseTableT_ BoolValue::InternalGenerateParseTable_(const :
       65535, 65535
     }}, {{
       // bool value = 1;
-      {PROTOBUF_FIELD_OFFSET(BoolValue, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kBool)},
+      {PROTOBUF_FIELD_OFFSET(BoolValue, _impl_.value_), _Internal::kHasBitsOffset + 0, 0, (0 | ::_fl::kFcOptional | ::_fl::kBool | ::_fl::kHbHint)},
     }},
     // no aux_entries
     {{
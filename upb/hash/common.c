@@ -8,7 +8,8 @@
 /*
  * upb_table Implementation
  *
- * Implementation is heavily inspired by Lua's ltable.c.
+ * An open-addressed table that probes a group of control bytes at a time, in
+ * the style of Abseil's SwissTable.
  */
 
 #include "upb/hash/common.h"
@@ -78,32 +79,150 @@ static lookupkey_t extkey(const void* ptr, uint32_t ext_num) {
   return (lookupkey_t){.ext = {ptr, ext_num}};
 }
 
-// Conceptually the hash and equal functions should only take the key, not the
-// value, but the extension table stores part of its logical key in the value
-// slot. This is a sign that we have outgrown the original architecture.
-typedef uint32_t hashfunc_t(upb_key key, upb_value val);
+// Conceptually the equal function should only take the key, not the value, but
+// the extension table stores part of its logical key in the value slot. This
+// is a sign that we have outgrown the original architecture.
 typedef bool eqlfunc_t(upb_key k1, upb_value v1, lookupkey_t k2);
 
+// Recomputes the hash of a stored entry.  Like eqlfunc_t, it takes the value
+// because the extension table keeps part of its key there.
+typedef uint32_t hashfunc_t(upb_key key, upb_value val);
+
 /* Base table (shared code) ***************************************************/
 
+// Control byte values.  A full entry stores the low 7 bits of its hash (H2),
+// while the remaining bits (H1) choose where probing starts.
+#define kUpb_Ctrl_Empty ((uint8_t)0x80)
+#define kUpb_Ctrl_Deleted ((uint8_t)0xfe)
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UPB_HASH_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define UPB_HASH_NEON
+#endif
+
+// A set of matching entries in a group.  Entry `i` of the group is at bit
+// `i << kUpb_GroupMaskShift`; no other bits are set.
+typedef uint64_t upb_groupmask;
+
+#ifdef UPB_HASH_NEON
+#define kUpb_GroupMaskShift 2
+#else
+#define kUpb_GroupMaskShift 0
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+UPB_INLINE int _upb_ctz64(uint64_t i) {
+  UPB_ASSERT(i != 0);
+#if UPB_HAS_BUILTIN(__builtin_ctzll) || defined(__GNUC__)
+  return __builtin_ctzll(i);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanForward64(&index, i);
+  return (int)index;
+#else
+  int count = 0;
+  while ((i & 1) == 0) {
+    count++;
+    i >>= 1;
+  }
+  return count;
+#endif
+}
+
+// Returns the entries of the group at `ctrl` whose control byte is `h`.
+UPB_FORCEINLINE
+upb_groupmask upb_group_match(const uint8_t* ctrl, uint8_t h) {
+#if defined(UPB_HASH_SSE2)
+  __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+  __m128i eq = _mm_cmpeq_epi8(group, _mm_set1_epi8((char)h));
+  return (uint16_t)_mm_movemask_epi8(eq);
+#elif defined(UPB_HASH_NEON)
+  // Narrow each byte of the comparison to a nibble.
+  uint8x16_t eq = vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(h));
+  uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+  return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) &
+         0x8888888888888888ULL;
+#else
+  upb_groupmask mask = 0;
+  for (int i = 0; i < kUpb_HashGroupWidth; i++) {
+    if (ctrl[i] == h) mask |= (upb_groupmask)1 << i;
+  }
+  return mask;
+#endif
+}
+
+// Returns the entries of the group at `ctrl` that are empty or deleted.
+UPB_FORCEINLINE
+upb_groupmask upb_group_matchfree(const uint8_t* ctrl) {
+#if defined(UPB_HASH_SSE2)
+  return (uint16_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)ctrl));
+#elif defined(UPB_HASH_NEON)
+  int8x16_t group = vreinterpretq_s8_u8(vld1q_u8(ctrl));
+  uint8x16_t avail = vreinterpretq_u8_s8(vshrq_n_s8(group, 7));
+  uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(avail), 4);
+  return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) &
+         0x8888888888888888ULL;
+#else
+  upb_groupmask mask = 0;
+  for (int i = 0; i < kUpb_HashGroupWidth; i++) {
+    if (ctrl[i] & 0x80) mask |= (upb_groupmask)1 << i;
+  }
+  return mask;
+#endif
+}
+
+// Removes the lowest entry from `*mask` and returns its index in the group.
+UPB_INLINE int upb_groupmask_next(upb_groupmask* mask) {
+  int i = _upb_ctz64(*mask) >> kUpb_GroupMaskShift;
+  *mask &= *mask - 1;
+  return i;
+}
+
+UPB_INLINE uint32_t upb_hash_h1(uint32_t hash) { return hash >> 7; }
+UPB_INLINE uint8_t upb_hash_h2(uint32_t hash) { return hash & 0x7f; }
+
+// Integer keys below this start probing at their own slot.
+#define kUpb_SmallIntKeyLimit 0x10000
+
 static uint32_t upb_inthash(uintptr_t key) {
   UPB_STATIC_ASSERT(sizeof(uintptr_t) == 4 || sizeof(uintptr_t) == 8,
                     "Pointers don't fit");
-  if (sizeof(uintptr_t) == 8) {
-    return (uint32_t)key ^ (uint32_t)((uint64_t)key >> 32);
-  } else {
-    return (uint32_t)key;
-  }
+  // A Fibonacci multiply moves every bit of the key into the high bits, which
+  // H1 and H2 are taken from.  Without it, pointer keys aligned to 8 or 16
+  // bytes would all start probing at the same few groups.
+  uint64_t mixed = (uint64_t)key * 0x9E3779B97F4A7C15ULL;
+  uint8_t h2 = (uint8_t)(mixed >> 57);
+  // Small integer keys, such as field numbers and enum values, keep their
+  // own slot as H1, which keeps them spread out and iterating in order.
+  uint32_t h1 =
+      key < kUpb_SmallIntKeyLimit ? (uint32_t)key : (uint32_t)(mixed >> 32);
+  return (h1 << 7) | h2;
 }
 
-static upb_tabent* upb_getentry(const upb_table* t, uint32_t hash) {
-  return t->entries + (hash & t->mask);
+// The maximum number of used (full or deleted) entries for a table of `size`
+// entries.  At least one entry is always kept empty so that probing for a
+// missing key terminates.
+static uint32_t upb_table_capacity(uint32_t size) {
+  return size - 1 - ((size - 1) >> 3);  // 0.875 load factor
 }
 
 static bool isfull(upb_table* t) {
-  uint32_t size = upb_table_size(t);
-  // 0.875 load factor
-  return t->count == (size - (size >> 3));
+  return t->count + t->deleted >= upb_table_capacity(upb_table_size(t));
+}
+
+// Returns the log2 size to rehash into when the table is full.  Tables that
+// are mostly deleted entries keep their size, and are rehashed in place.
+static uint8_t upb_table_growsize(upb_table* t) {
+  uint8_t size_lg2 = _upb_log2_table_size(t);
+  uint32_t capacity = upb_table_capacity(upb_table_size(t));
+  return t->count >= capacity / 2 ? size_lg2 + 1 : size_lg2;
 }
 
 static bool init(upb_table* t, uint8_t size_lg2, upb_Arena* a) {
@@ -111,50 +230,72 @@ static bool init(upb_table* t, uint8_t size_lg2, upb_Arena* a) {
     return false;
   }
   t->count = 0;
+  t->deleted = 0;
   uint32_t size = 1U << size_lg2;
   t->mask = size - 1;  // 0 mask if size_lg2 is 0
+  size_t entry_bytes;
   size_t bytes;
-  if (upb_MulOverflow(upb_table_size(t), sizeof(upb_tabent), &bytes)) {
+  if (upb_MulOverflow(upb_table_size(t), sizeof(upb_tabent), &entry_bytes) ||
+      upb_AddOverflow(entry_bytes, (size_t)size + kUpb_HashGroupWidth, &bytes)) {
     return false;
   }
-  if (bytes > 0) {
-    t->entries = upb_Arena_Malloc(a, bytes);
-    if (!t->entries) return false;
-    memset(t->entries, 0, bytes);
-  } else {
-    t->entries = NULL;
-  }
+  // Entries and control bytes share one allocation.  Entries are only read
+  // once their control byte is full, so they don't need to be cleared.
+  char* mem = upb_Arena_Malloc(a, bytes);
+  if (!mem) return false;
+  t->entries = (upb_tabent*)mem;
+  t->ctrl = (uint8_t*)mem + entry_bytes;
+  memset(t->ctrl, kUpb_Ctrl_Empty, size + kUpb_HashGroupWidth);
   return true;
 }
 
-static upb_tabent* emptyent(upb_table* t, upb_tabent* e) {
-  upb_tabent* begin = t->entries;
-  upb_tabent* end = begin + upb_table_size(t);
-  for (e = e + 1; e < end; e++) {
-    if (upb_tabent_isempty(e)) return e;
-  }
-  for (e = begin; e < end; e++) {
-    if (upb_tabent_isempty(e)) return e;
-  }
-  UPB_ASSERT(false);
-  return NULL;
+static void clear(upb_table* t) {
+  t->count = 0;
+  t->deleted = 0;
+  memset(t->ctrl, kUpb_Ctrl_Empty, upb_table_size(t) + kUpb_HashGroupWidth);
 }
 
-static upb_tabent* getentry_mutable(upb_table* t, uint32_t hash) {
-  return upb_getentry(t, hash);
+// Sets the control byte for entry `i`, and its mirrors past the end of the
+// table.  Tables smaller than a group are mirrored more than once.
+static void setctrl(upb_table* t, uint32_t i, uint8_t h) {
+  uint32_t size = upb_table_size(t);
+  t->ctrl[i] = h;
+  for (uint32_t j = size + i; j < size + kUpb_HashGroupWidth; j += size) {
+    t->ctrl[j] = h;
+  }
 }
 
-static upb_tabent* findentry(const upb_table* t, lookupkey_t key, uint32_t hash,
-                             eqlfunc_t* eql) {
-  upb_tabent* e;
+// Probing visits groups at triangular offsets from the start position, which
+// visits every group of a power-of-two sized table.
+#define UPB_PROBE_NEXT(t, pos, stride) \
+  ((stride) += kUpb_HashGroupWidth, (pos) = ((pos) + (stride)) & (t)->mask)
 
+UPB_FORCEINLINE
+upb_tabent* findentry(const upb_table* t, lookupkey_t key, uint32_t hash,
+                      eqlfunc_t* eql) {
   if (t->count == 0) return NULL;
-  e = upb_getentry(t, hash);
-  if (upb_tabent_isempty(e)) return NULL;
+  uint8_t h2 = upb_hash_h2(hash);
+  uint32_t pos = upb_hash_h1(hash) & t->mask;
+
+  // Most keys are in their home slot.  Checking it first lets the CPU load the
+  // control byte and the entry in parallel, instead of waiting for the group
+  // match to find the entry.  An empty home slot can only have been skipped by
+  // inserts that found it empty too, so the key is not in the table.
+  upb_tabent* home = &t->entries[pos];
+  uint8_t home_ctrl = t->ctrl[pos];
+  if (home_ctrl == h2 && eql(home->key, home->val, key)) return home;
+  if (home_ctrl == kUpb_Ctrl_Empty) return NULL;
+
+  uint32_t stride = 0;
   while (1) {
-    if (eql(e->key, e->val, key)) return e;
-    if (!upb_tabent_hasnext(e)) return NULL;
-    e = upb_tabent_next(e);
+    const uint8_t* group = t->ctrl + pos;
+    upb_groupmask match = upb_group_match(group, h2);
+    while (match) {
+      upb_tabent* e = &t->entries[(pos + upb_groupmask_next(&match)) & t->mask];
+      if (eql(e->key, e->val, key)) return e;
+    }
+    if (upb_group_match(group, kUpb_Ctrl_Empty)) return NULL;
+    UPB_PROBE_NEXT(t, pos, stride);
   }
 }
 
@@ -163,8 +304,9 @@ static upb_tabent* findentry_mutable(upb_table* t, lookupkey_t key,
   return findentry(t, key, hash, eql);
 }
 
-static bool lookup(const upb_table* t, lookupkey_t key, upb_value* v,
-                   uint32_t hash, eqlfunc_t* eql) {
+UPB_FORCEINLINE
+bool lookup(const upb_table* t, lookupkey_t key, upb_value* v, uint32_t hash,
+            eqlfunc_t* eql) {
   const upb_tabent* e = findentry(t, key, hash, eql);
   if (e) {
     if (v) *v = e->val;
@@ -174,118 +316,99 @@ static bool lookup(const upb_table* t, lookupkey_t key, upb_value* v,
   }
 }
 
-/* The given key must not already exist in the table. */
-static void insert(upb_table* t, lookupkey_t key, upb_key tabkey, upb_value val,
-                   uint32_t hash, hashfunc_t* hashfunc, eqlfunc_t* eql) {
-  upb_tabent* mainpos_e;
-  upb_tabent* our_e;
+// Returns the first empty or deleted entry in the probe sequence of `hash`.
+static uint32_t findfree(const upb_table* t, uint32_t hash) {
+  uint32_t pos = upb_hash_h1(hash) & t->mask;
+  uint32_t stride = 0;
+  upb_groupmask avail;
+  while (!(avail = upb_group_matchfree(t->ctrl + pos))) {
+    UPB_PROBE_NEXT(t, pos, stride);
+  }
+  return (pos + upb_groupmask_next(&avail)) & t->mask;
+}
 
+/* The given key must not already exist in the table, and the table must not be
+ * full. */
+static void insert(upb_table* t, lookupkey_t key, upb_key tabkey, upb_value val,
+                   uint32_t hash, eqlfunc_t* eql) {
   UPB_ASSERT(findentry(t, key, hash, eql) == NULL);
+  UPB_ASSERT(!isfull(t));
+  UPB_UNUSED(key);
+  UPB_UNUSED(eql);
 
+  uint32_t i = findfree(t, hash);
+  if (t->ctrl[i] == kUpb_Ctrl_Deleted) t->deleted--;
   t->count++;
-  mainpos_e = getentry_mutable(t, hash);
-  our_e = mainpos_e;
-
-  if (upb_tabent_isempty(mainpos_e)) {
-    /* Our main position is empty; use it. */
-    upb_tabent_clearnext(our_e);
-  } else {
-    /* Collision. */
-    upb_tabent* new_e = emptyent(t, mainpos_e);
-    /* Head of collider's chain. */
-    upb_tabent* chain =
-        getentry_mutable(t, hashfunc(mainpos_e->key, mainpos_e->val));
-    if (chain == mainpos_e) {
-      /* Existing ent is in its main position (it has the same hash as us, and
-       * is the head of our chain).  Insert to new ent and append to this chain.
-       */
-      if (upb_tabent_hasnext(mainpos_e)) {
-        upb_tabent_setnext(new_e, upb_tabent_next(mainpos_e));
-      } else {
-        upb_tabent_clearnext(new_e);
-      }
-      upb_tabent_setnext(mainpos_e, new_e);
-      our_e = new_e;
-    } else {
-      /* Existing ent is not in its main position (it is a node in some other
-       * chain).  This implies that no existing ent in the table has our hash.
-       * Evict it (updating its chain) and use its ent for head of our chain. */
-      new_e->key = mainpos_e->key;
-      new_e->val = mainpos_e->val;
-      if (upb_tabent_hasnext(mainpos_e)) {
-        upb_tabent_setnext(new_e, upb_tabent_next(mainpos_e));
-      } else {
-        upb_tabent_clearnext(new_e);
-      }
+  setctrl(t, i, upb_hash_h2(hash));
+  t->entries[i].key = tabkey;
+  t->entries[i].val = val;
+  UPB_ASSERT(findentry(t, key, hash, eql) == &t->entries[i]);
+}
 
-      while (upb_tabent_hasnext(chain) && upb_tabent_next(chain) != mainpos_e) {
-        chain = upb_tabent_next(chain);
-        UPB_ASSERT(chain);
-      }
-      upb_tabent_setnext(chain, new_e);
-      our_e = mainpos_e;
-      upb_tabent_clearnext(our_e);
-    }
-  }
-  our_e->key = tabkey;
-  our_e->val = val;
-  UPB_ASSERT(findentry(t, key, hash, eql) == our_e);
+static void rment(upb_table* t, upb_tabent* e) {
+  // A deleted entry keeps probe sequences that pass through it intact.
+  setctrl(t, e - t->entries, kUpb_Ctrl_Deleted);
+  t->count--;
+  t->deleted++;
 }
 
 static bool rm(upb_table* t, lookupkey_t key, upb_value* val, uint32_t hash,
                eqlfunc_t* eql) {
-  upb_tabent* chain = getentry_mutable(t, hash);
-  if (upb_tabent_isempty(chain)) return false;
-  if (eql(chain->key, chain->val, key)) {
-    /* Element to remove is at the head of its chain. */
-    t->count--;
-    if (val) *val = chain->val;
-    if (upb_tabent_hasnext(chain)) {
-      upb_tabent* move = upb_tabent_next(chain);
-      chain->key = move->key;
-      chain->val = move->val;
-      if (upb_tabent_hasnext(move)) {
-        upb_tabent_setnext(chain, upb_tabent_next(move));
-      } else {
-        upb_tabent_clearnext(chain);
-      }
+  upb_tabent* e = findentry_mutable(t, key, hash, eql);
+  if (!e) return false;
+  if (val) *val = e->val;
+  rment(t, e);
+  return true;
+}
 
-      upb_tabent_clear(move);
-    } else {
-      upb_tabent_clear(chain);
-    }
-    return true;
-  } else {
-    /* Element to remove is either in a non-head position or not in the
-     * table. */
-    while (
-        upb_tabent_hasnext(chain) &&
-        !eql(upb_tabent_next(chain)->key, upb_tabent_next(chain)->val, key)) {
-      chain = upb_tabent_next(chain);
+// Drops the deleted entries of `t` without reallocating it, so that a table
+// kept full by inserts and removes does not abandon its block in the arena
+// every time it runs out of empty entries.
+static void rehash_in_place(upb_table* t, hashfunc_t* hashfunc) {
+  uint32_t size = upb_table_size(t);
+  // Deleted entries become empty, and full entries are marked deleted until
+  // they have been placed again.
+  for (uint32_t i = 0; i < size; i++) {
+    t->ctrl[i] =
+        upb_table_hasentry(t, i) ? kUpb_Ctrl_Deleted : kUpb_Ctrl_Empty;
+  }
+  for (uint32_t i = size; i < size + kUpb_HashGroupWidth; i++) {
+    t->ctrl[i] = t->ctrl[i & t->mask];
+  }
+
+  uint32_t i = 0;
+  while (i < size) {
+    if (t->ctrl[i] != kUpb_Ctrl_Deleted) {
+      i++;
+      continue;
     }
-    if (upb_tabent_hasnext(chain)) {
-      /* Found element to remove. */
-      upb_tabent* rm = upb_tabent_next(chain);
-      t->count--;
-      if (val) *val = rm->val;
-      if (upb_tabent_hasnext(rm)) {
-        upb_tabent_setnext(chain, upb_tabent_next(rm));
-      } else {
-        upb_tabent_clearnext(chain);
-      }
-      upb_tabent_clear(rm);
-      return true;
+    upb_tabent* e = &t->entries[i];
+    uint32_t hash = hashfunc(e->key, e->val);
+    uint32_t dst = findfree(t, hash);
+    if (dst == i) {
+      setctrl(t, i, upb_hash_h2(hash));
+      i++;
+    } else if (t->ctrl[dst] == kUpb_Ctrl_Empty) {
+      t->entries[dst] = *e;
+      setctrl(t, dst, upb_hash_h2(hash));
+      setctrl(t, i, kUpb_Ctrl_Empty);
+      i++;
     } else {
-      /* Element to remove is not in the table. */
-      return false;
+      // `dst` holds an entry that has not been placed yet.  Swap the two, and
+      // place the one that is now at `i` next.
+      upb_tabent tmp = t->entries[dst];
+      t->entries[dst] = *e;
+      *e = tmp;
+      setctrl(t, dst, upb_hash_h2(hash));
     }
   }
+  t->deleted = 0;
 }
 
 static size_t next(const upb_table* t, size_t i) {
   do {
     if (++i >= upb_table_size(t)) return SIZE_MAX - 1; /* Distinct from -1. */
-  } while (upb_tabent_isempty(&t->entries[i]));
+  } while (!upb_table_hasentry(t, i));
 
   return i;
 }
@@ -308,56 +431,12 @@ bool _upb_table_done(const upb_table* t, intptr_t iter) {
   if (iter == INTPTR_MAX - 1 || (size_t)iter >= upb_table_size(t)) {
     return true;
   }
-  return upb_tabent_isempty(&t->entries[iter]);
+  return !upb_table_hasentry(t, iter);
 }
 
 static void removeiter(upb_table* t, intptr_t* iter) {
-  intptr_t i = *iter;
-  upb_tabent* ent = &t->entries[i];
-  upb_tabent* prev = NULL;
-
-  // Linear search, not great.
-  upb_tabent* end = &t->entries[upb_table_size(t)];
-  for (upb_tabent* e = t->entries; e != end; e++) {
-    if (!upb_tabent_isempty(e) && upb_tabent_hasnext(e) &&
-        upb_tabent_next(e) == ent) {
-      prev = e;
-      break;
-    }
-  }
-
-  if (prev) {
-    if (upb_tabent_hasnext(ent)) {
-      upb_tabent_setnext(prev, upb_tabent_next(ent));
-    } else {
-      upb_tabent_clearnext(prev);
-    }
-  } else {
-    // ent is the head of the chain, so we need to move its next element into
-    // its slot if there is one.
-    if (upb_tabent_hasnext(ent)) {
-      upb_tabent* move = upb_tabent_next(ent);
-      ent->key = move->key;
-      ent->val = move->val;
-      if (upb_tabent_hasnext(move)) {
-        upb_tabent_setnext(ent, upb_tabent_next(move));
-      } else {
-        upb_tabent_clearnext(ent);
-      }
-
-      // If we moved an element from a higher index to a lower index, then we've
-      // moved an element we haven't visited yet into the slot of the one that
-      // was just removed; decrement iter so that the iterator visits it.
-      if (move > ent) {
-        *iter = i - 1;
-      }
-
-      ent = move;
-    }
-  }
-
-  t->count--;
-  upb_tabent_clear(ent);
+  // Entries never move on removal, so the iterator stays valid.
+  rment(t, &t->entries[*iter]);
 }
 
 /* upb_strtable ***************************************************************/
@@ -393,10 +472,6 @@ static uint32_t UnalignedLoad32(const void* p) {
   return val;
 }
 
-#if defined(_MSC_VER) && defined(_M_X64)
-#include <intrin.h>
-#endif
-
 /* Computes a * b, returning the low 64 bits of the result and storing the high
  * 64 bits in |*high|. */
 static uint64_t upb_umul128(uint64_t v0, uint64_t v1, uint64_t* out_high) {
@@ -533,7 +608,8 @@ static uint32_t _upb_Hash_NoSeed(const char* p, size_t n) {
 
 static uint32_t strhash(upb_key key, upb_value val) {
   UPB_UNUSED(val);
-  return _upb_Hash_NoSeed(key.str->data, key.str->size);
+  upb_StringView s = upb_key_strview(key);
+  return _upb_Hash_NoSeed(s.data, s.size);
 }
 
 static bool streql(upb_key k1, upb_value v1, lookupkey_t k2) {
@@ -557,15 +633,19 @@ bool upb_strtable_init(upb_strtable* t, size_t expected_size, upb_Arena* a) {
   return init(&t->t, size_lg2, a);
 }
 
-void upb_strtable_clear(upb_strtable* t) {
-  size_t bytes = upb_table_size(&t->t) * sizeof(upb_tabent);
-  t->t.count = 0;
-  memset((char*)t->t.entries, 0, bytes);
-}
+void upb_strtable_clear(upb_strtable* t) { clear(&t->t); }
 
 bool upb_strtable_resize(upb_strtable* t, size_t size_lg2, upb_Arena* a) {
+  if (size_lg2 == _upb_log2_table_size(&t->t)) {
+    rehash_in_place(&t->t, &strhash);
+    return true;
+  }
+
   upb_strtable new_table;
   if (!init(&new_table.t, size_lg2, a)) return false;
+  if (t->t.count > upb_table_capacity(upb_table_size(&new_table.t))) {
+    return false;
+  }
 
   intptr_t iter = UPB_STRTABLE_BEGIN;
   upb_StringView sv;
@@ -584,7 +664,7 @@ bool upb_strtable_resize(upb_strtable* t, size_t size_lg2, upb_Arena* a) {
     lookupkey_t lookupkey = {.str = sv};
     upb_key tabkey = {.str = keystr};
     uint32_t hash = _upb_Hash_NoSeed(sv.data, sv.size);
-    insert(&new_table.t, lookupkey, tabkey, val, hash, &strhash, &streql);
+    insert(&new_table.t, lookupkey, tabkey, val, hash, &streql);
   }
   *t = new_table;
   return true;
@@ -593,8 +673,8 @@ bool upb_strtable_resize(upb_strtable* t, size_t size_lg2, upb_Arena* a) {
 bool upb_strtable_insert(upb_strtable* t, const char* k, size_t len,
                          upb_value v, upb_Arena* a) {
   if (isfull(&t->t)) {
-    /* Need to resize.  New table of double the size, add old elements to it. */
-    if (!upb_strtable_resize(t, _upb_log2_table_size(&t->t) + 1, a)) {
+    /* Need to rehash, usually into a table of double the size. */
+    if (!upb_strtable_resize(t, upb_table_growsize(&t->t), a)) {
       return false;
     }
   }
@@ -606,7 +686,7 @@ bool upb_strtable_insert(upb_strtable* t, const char* k, size_t len,
   lookupkey_t lookupkey = {.str = sv};
   upb_key key = {.str = size_prefix_string};
   uint32_t hash = _upb_Hash_NoSeed(k, len);
-  insert(&t->t, lookupkey, key, v, hash, &strhash, &streql);
+  insert(&t->t, lookupkey, key, v, hash, &streql);
   return true;
 }
 
@@ -705,13 +785,14 @@ bool upb_exttable_init(upb_exttable* t, size_t expected_size, upb_Arena* a) {
   return init(&t->t, size_lg2, a);
 }
 
-void upb_exttable_clear(upb_exttable* t) {
-  size_t bytes = upb_table_size(&t->t) * sizeof(upb_tabent);
-  t->t.count = 0;
-  memset((char*)t->t.entries, 0, bytes);
-}
+void upb_exttable_clear(upb_exttable* t) { clear(&t->t); }
 
 bool upb_exttable_resize(upb_exttable* t, size_t size_lg2, upb_Arena* a) {
+  if (size_lg2 == _upb_log2_table_size(&t->t)) {
+    rehash_in_place(&t->t, &exthash);
+    return true;
+  }
+
   upb_exttable new_table;
   if (!init(&new_table.t, size_lg2, a)) return false;
 
@@ -721,7 +802,7 @@ bool upb_exttable_resize(upb_exttable* t, size_t size_lg2, upb_Arena* a) {
     uint32_t hash = exthash(e->key, e->val);
     uint32_t ext_num = *(const uint32_t*)upb_value_getconstptr(e->val);
     lookupkey_t lookupkey = extkey((const void*)e->key.num, ext_num);
-    insert(&new_table.t, lookupkey, e->key, e->val, hash, &exthash, &exteql);
+    insert(&new_table.t, lookupkey, e->key, e->val, hash, &exteql);
   }
 
   *t = new_table;
@@ -735,7 +816,7 @@ bool upb_exttable_insert(upb_exttable* t, const void* k, const uint32_t* v,
   UPB_ASSERT(*v != 0);
 
   if (isfull(&t->t)) {
-    if (!upb_exttable_resize(t, _upb_log2_table_size(&t->t) + 1, a)) {
+    if (!upb_exttable_resize(t, upb_table_growsize(&t->t), a)) {
       return false;
     }
   }
@@ -744,7 +825,7 @@ bool upb_exttable_insert(upb_exttable* t, const void* k, const uint32_t* v,
   upb_key key = {.num = (uintptr_t)k};
   upb_value val = upb_value_constptr(v);
   uint32_t hash = _upb_exttable_hash(k, *v);
-  insert(&t->t, lookupkey, key, val, hash, &exthash, &exteql);
+  insert(&t->t, lookupkey, key, val, hash, &exteql);
   return true;
 }
 
@@ -816,25 +897,29 @@ bool upb_inttable_init(upb_inttable* t, upb_Arena* a) {
 bool upb_inttable_insert(upb_inttable* t, uintptr_t key, upb_value val,
                          upb_Arena* a) {
   if (isfull(&t->t)) {
-    upb_table new_table;
-
-    if (!init(&new_table, _upb_log2_table_size(&t->t) + 1, a)) {
-      return false;
-    }
+    uint8_t size_lg2 = upb_table_growsize(&t->t);
+    if (size_lg2 == _upb_log2_table_size(&t->t)) {
+      rehash_in_place(&t->t, &inthash);
+    } else {
+      upb_table new_table;
+      if (!init(&new_table, size_lg2, a)) {
+        return false;
+      }
 
-    for (size_t i = begin(&t->t); i < upb_table_size(&t->t);
-         i = next(&t->t, i)) {
-      const upb_tabent* e = &t->t.entries[i];
-      insert(&new_table, intkey(e->key.num), e->key, e->val,
-             inthash(e->key, e->val), &inthash, &inteql);
-    }
+      for (size_t i = begin(&t->t); i < upb_table_size(&t->t);
+           i = next(&t->t, i)) {
+        const upb_tabent* e = &t->t.entries[i];
+        insert(&new_table, intkey(e->key.num), e->key, e->val,
+               upb_inthash(e->key.num), &inteql);
+      }
 
-    UPB_ASSERT(t->t.count == new_table.count);
+      UPB_ASSERT(t->t.count == new_table.count);
 
-    t->t = new_table;
+      t->t = new_table;
+    }
   }
   upb_key tabkey = {.num = key};
-  insert(&t->t, intkey(key), tabkey, val, upb_inthash(key), &inthash, &inteql);
+  insert(&t->t, intkey(key), tabkey, val, upb_inthash(key), &inteql);
   check(t);
   return true;
 }
@@ -857,11 +942,7 @@ bool upb_inttable_remove(upb_inttable* t, uintptr_t key, upb_value* val) {
   return success;
 }
 
-void upb_inttable_clear(upb_inttable* t) {
-  size_t bytes = upb_table_size(&t->t) * sizeof(upb_tabent);
-  t->t.count = 0;
-  memset((char*)t->t.entries, 0, bytes);
-}
+void upb_inttable_clear(upb_inttable* t) { clear(&t->t); }
 
 bool upb_inttable_next(const upb_inttable* t, uintptr_t* key, upb_value* val,
                        intptr_t* iter) {
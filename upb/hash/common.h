@@ -12,9 +12,12 @@
  * This file defines very fast int->upb_value (inttable) and string->upb_value
  * (strtable) hash tables.
  *
- * The table uses chained scatter with Brent's variation (inspired by the Lua
- * implementation of hash tables).  The hash function for strings is Austin
- * Appleby's "MurmurHash."
+ * The table is an open-addressing "Swiss table": every entry has a one-byte
+ * control word that is either empty, deleted, or holds 7 bits of the entry's
+ * hash.  A lookup compares a whole group of 16 control bytes against the
+ * key's hash fragment at once (with SSE2 or NEON where available), and only
+ * compares keys for the entries that match.  The hash function for strings is
+ * Wyhash.
  *
  * The inttable uses uintptr_t as its key, which guarantees it can be used to
  * store pointers or integers of at least 32 bits (upb isn't really useful on
@@ -125,63 +128,37 @@ UPB_INLINE upb_StringView upb_key_strview(upb_key key) {
 typedef struct _upb_tabent {
   upb_value val;
   upb_key key;
-
-  /* Internal chaining and presence:
-   * - next == NULL: The entry is empty.
-   * - ent.next == kUpb_NoNextTabent indicating the entry is occupied but has no
-   *   successor.
-   * - otherwise: The entry is occupied, and next points to the next entry in
-   *   the collision chain. */
-  uintptr_t next;
 } upb_tabent;
 
+// The number of control bytes that are matched at once.
+#define kUpb_HashGroupWidth 16
+
 typedef struct {
   upb_tabent* entries;
-  /* Number of entries in the hash part. */
+
+  /* One control byte per entry, followed by kUpb_HashGroupWidth bytes that
+   * mirror the start of the table so that a group never wraps around.  Full
+   * entries have the high bit clear. */
+  uint8_t* ctrl;
+
+  /* Number of entries in the table. */
   uint32_t count;
 
   /* Mask to turn hash value -> bucket. The map's allocated size is mask + 1.*/
   uint32_t mask;
+
+  /* Number of entries that were removed but still occupy a slot. */
+  uint32_t deleted;
 } upb_table;
 
 UPB_INLINE size_t upb_table_size(const upb_table* t) { return t->mask + 1; }
 
 // Internal-only functions, in .h file only out of necessity.
 
-UPB_INLINE bool upb_tabent_isempty(const upb_tabent* e) { return e->next == 0; }
-
-#define kUpb_NoNextTabent ((uintptr_t)1)
-
-UPB_INLINE bool upb_tabent_hasnext(const upb_tabent* e) {
-  UPB_STATIC_ASSERT(UPB_ALIGN_OF(upb_tabent) > 1,
-                    "valid upb_tabent* can't reference address 1");
-  return e->next != kUpb_NoNextTabent;
-}
-
-UPB_INLINE void upb_tabent_clearnext(upb_tabent* e) {
-  e->next = kUpb_NoNextTabent;
-}
-
-UPB_INLINE void upb_tabent_clear(upb_tabent* e) {
-  e->next = 0;
-  UPB_ASSERT(upb_tabent_isempty(e));
-}
-
-UPB_INLINE upb_tabent* upb_tabent_next(const upb_tabent* e) {
-  UPB_ASSERT(upb_tabent_hasnext(e));
-  return (upb_tabent*)e->next;
-}
-
-UPB_INLINE void upb_tabent_setnext(upb_tabent* e, upb_tabent* next) {
-  UPB_ASSERT((uintptr_t)next != 0);
-  UPB_ASSERT(next != e);
-  UPB_ASSERT((uintptr_t)next != kUpb_NoNextTabent);
-  e->next = (uintptr_t)next;
-  UPB_ASSERT(upb_tabent_hasnext(e));
+UPB_INLINE bool upb_table_hasentry(const upb_table* t, size_t i) {
+  return (t->ctrl[i] & 0x80) == 0;
 }
 
-#undef kUpb_NoNextTabent
-
 uint32_t _upb_Hash(const void* p, size_t n, uint64_t seed);
 
 #ifdef __cplusplus
@@ -0,0 +1,211 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "absl/strings/str_cat.h"
+#include "upb/hash/common.h"
+#include "upb/hash/int_table.h"
+#include "upb/hash/str_table.h"
+#include "upb/mem/arena.h"
+#include "upb/mem/arena.hpp"
+
+namespace {
+
+// Benchmarks take (size_lg2, load percent) and insert enough keys to fill a
+// table of 2^size_lg2 entries to that load.  The loads are below the 0.875
+// maximum, so the table ends up at exactly that size.
+size_t KeyCount(const benchmark::State& state) {
+  return (size_t{1} << state.range(0)) * state.range(1) / 100;
+}
+
+void SetLoadCounter(benchmark::State& state, const upb_table* t) {
+  state.counters["load"] = static_cast<double>(t->count) / upb_table_size(t);
+}
+
+std::vector<std::string> MakeStringKeys(size_t n, const char* prefix) {
+  std::vector<std::string> keys;
+  keys.reserve(n);
+  for (size_t i = 0; i < n; i++) {
+    keys.push_back(absl::StrCat(prefix, ".Message", i, ".field_name"));
+  }
+  return keys;
+}
+
+std::vector<uintptr_t> MakeIntKeys(size_t n, uint32_t seed) {
+  std::mt19937_64 rng(seed);
+  std::vector<uintptr_t> keys;
+  keys.reserve(n);
+  for (size_t i = 0; i < n; i++) {
+    keys.push_back(static_cast<uintptr_t>(rng()));
+  }
+  return keys;
+}
+
+void FillStrTable(upb_strtable* t, const std::vector<std::string>& keys,
+                  upb_Arena* arena) {
+  if (!upb_strtable_init(t, 0, arena)) abort();
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (!upb_strtable_insert(t, keys[i].data(), keys[i].size(),
+                             upb_value_uintptr(i), arena)) {
+      abort();
+    }
+  }
+}
+
+void FillIntTable(upb_inttable* t, const std::vector<uintptr_t>& keys,
+                  upb_Arena* arena) {
+  if (!upb_inttable_init(t, arena)) abort();
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (!upb_inttable_insert(t, keys[i], upb_value_uintptr(i), arena)) abort();
+  }
+}
+
+void BM_StrTableLookupHit(benchmark::State& state) {
+  upb::Arena arena;
+  std::vector<std::string> keys = MakeStringKeys(KeyCount(state), "pkg");
+  upb_strtable t;
+  FillStrTable(&t, keys, arena.ptr());
+  size_t i = 0;
+  for (auto _ : state) {
+    const std::string& key = keys[i++ % keys.size()];
+    upb_value v;
+    bool found = upb_strtable_lookup2(&t, key.data(), key.size(), &v);
+    benchmark::DoNotOptimize(found);
+    benchmark::DoNotOptimize(v);
+  }
+  SetLoadCounter(state, &t.t);
+}
+
+void BM_StrTableLookupMiss(benchmark::State& state) {
+  upb::Arena arena;
+  size_t n = KeyCount(state);
+  upb_strtable t;
+  FillStrTable(&t, MakeStringKeys(n, "pkg"), arena.ptr());
+  std::vector<std::string> missing = MakeStringKeys(n, "other");
+  size_t i = 0;
+  for (auto _ : state) {
+    const std::string& key = missing[i++ % missing.size()];
+    upb_value v;
+    bool found = upb_strtable_lookup2(&t, key.data(), key.size(), &v);
+    benchmark::DoNotOptimize(found);
+  }
+  SetLoadCounter(state, &t.t);
+}
+
+void BM_StrTableInsert(benchmark::State& state) {
+  std::vector<std::string> keys = MakeStringKeys(KeyCount(state), "pkg");
+  for (auto _ : state) {
+    upb::Arena arena;
+    upb_strtable t;
+    FillStrTable(&t, keys, arena.ptr());
+    benchmark::DoNotOptimize(t);
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+void BM_IntTableLookupHit(benchmark::State& state) {
+  upb::Arena arena;
+  std::vector<uintptr_t> keys = MakeIntKeys(KeyCount(state), 1);
+  upb_inttable t;
+  FillIntTable(&t, keys, arena.ptr());
+  size_t i = 0;
+  for (auto _ : state) {
+    upb_value v;
+    bool found = upb_inttable_lookup(&t, keys[i++ % keys.size()], &v);
+    benchmark::DoNotOptimize(found);
+    benchmark::DoNotOptimize(v);
+  }
+  SetLoadCounter(state, &t.t);
+}
+
+void BM_IntTableLookupMiss(benchmark::State& state) {
+  upb::Arena arena;
+  size_t n = KeyCount(state);
+  upb_inttable t;
+  FillIntTable(&t, MakeIntKeys(n, 1), arena.ptr());
+  std::vector<uintptr_t> missing = MakeIntKeys(n, 2);
+  size_t i = 0;
+  for (auto _ : state) {
+    upb_value v;
+    bool found = upb_inttable_lookup(&t, missing[i++ % missing.size()], &v);
+    benchmark::DoNotOptimize(found);
+  }
+  SetLoadCounter(state, &t.t);
+}
+
+// Small sequential keys, as used for field and enum numbers.
+void BM_IntTableLookupDense(benchmark::State& state) {
+  upb::Arena arena;
+  std::vector<uintptr_t> keys(KeyCount(state));
+  for (size_t i = 0; i < keys.size(); i++) keys[i] = i + 1;
+  upb_inttable t;
+  FillIntTable(&t, keys, arena.ptr());
+  size_t i = 0;
+  for (auto _ : state) {
+    upb_value v;
+    bool found = upb_inttable_lookup(&t, keys[i++ % keys.size()], &v);
+    benchmark::DoNotOptimize(found);
+    benchmark::DoNotOptimize(v);
+  }
+  SetLoadCounter(state, &t.t);
+}
+
+// Aligned pointers, as used for MiniTable and def keys.
+void BM_IntTableLookupPointers(benchmark::State& state) {
+  upb::Arena arena;
+  std::vector<uintptr_t> keys(KeyCount(state));
+  for (size_t i = 0; i < keys.size(); i++) {
+    keys[i] = reinterpret_cast<uintptr_t>(upb_Arena_Malloc(arena.ptr(), 48));
+  }
+  upb_inttable t;
+  FillIntTable(&t, keys, arena.ptr());
+  size_t i = 0;
+  for (auto _ : state) {
+    upb_value v;
+    bool found = upb_inttable_lookup(&t, keys[i++ % keys.size()], &v);
+    benchmark::DoNotOptimize(found);
+    benchmark::DoNotOptimize(v);
+  }
+  SetLoadCounter(state, &t.t);
+}
+
+void BM_IntTableInsert(benchmark::State& state) {
+  std::vector<uintptr_t> keys = MakeIntKeys(KeyCount(state), 1);
+  for (auto _ : state) {
+    upb::Arena arena;
+    upb_inttable t;
+    FillIntTable(&t, keys, arena.ptr());
+    benchmark::DoNotOptimize(t);
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+void LoadFactors(benchmark::internal::Benchmark* b) {
+  for (int size_lg2 : {6, 10, 16}) {
+    for (int load : {45, 60, 85}) {
+      b->Args({size_lg2, load});
+    }
+  }
+}
+
+BENCHMARK(BM_StrTableLookupHit)->Apply(LoadFactors);
+BENCHMARK(BM_StrTableLookupMiss)->Apply(LoadFactors);
+BENCHMARK(BM_StrTableInsert)->Apply(LoadFactors);
+BENCHMARK(BM_IntTableLookupHit)->Apply(LoadFactors);
+BENCHMARK(BM_IntTableLookupMiss)->Apply(LoadFactors);
+BENCHMARK(BM_IntTableLookupDense)->Apply(LoadFactors);
+BENCHMARK(BM_IntTableLookupPointers)->Apply(LoadFactors);
+BENCHMARK(BM_IntTableInsert)->Apply(LoadFactors);
+
+}  // namespace
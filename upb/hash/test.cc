@@ -636,3 +636,127 @@ TEST(IntTableTest, RemoveIterHeadOfChainDemonstratesBug) {
   EXPECT_EQ(upb_inttable_count(&t), 1);
   EXPECT_TRUE(upb_inttable_lookup(&t, 9, &val));
 }
+
+TEST(IntTableTest, InsertRemoveChurn) {
+  // Removals leave deleted entries behind; make sure that repeated removes and
+  // inserts keep the table consistent and don't grow it without bound.
+  upb::Arena arena;
+  upb_inttable t;
+  EXPECT_TRUE(upb_inttable_init(&t, arena.ptr()));
+  std::set<uintptr_t> keys;
+  uint32_t rand = 1;
+  for (int i = 0; i < 100000; i++) {
+    rand = rand * 1103515245 + 12345;
+    uintptr_t key = (rand >> 8) % 512;
+    if (keys.count(key)) {
+      EXPECT_TRUE(upb_inttable_remove(&t, key, nullptr));
+      keys.erase(key);
+    } else {
+      EXPECT_TRUE(
+          upb_inttable_insert(&t, key, upb_value_uintptr(key), arena.ptr()));
+      keys.insert(key);
+    }
+    ASSERT_EQ(upb_inttable_count(&t), keys.size());
+  }
+  EXPECT_LE(upb_table_size(&t.t), 2048);
+
+  for (uintptr_t key = 0; key < 512; key++) {
+    upb_value val;
+    EXPECT_EQ(upb_inttable_lookup(&t, key, &val), keys.count(key) == 1);
+  }
+  intptr_t iter = UPB_INTTABLE_BEGIN;
+  uintptr_t key;
+  upb_value val;
+  size_t count = 0;
+  while (upb_inttable_next(&t, &key, &val, &iter)) {
+    EXPECT_EQ(upb_value_getuintptr(val), key);
+    EXPECT_EQ(keys.count(key), 1);
+    count++;
+  }
+  EXPECT_EQ(count, keys.size());
+}
+
+TEST(IntTableTest, ChurnDoesNotGrowArena) {
+  // A sliding window of keys keeps filling the table with deleted entries.
+  // Reclaiming them must reuse the table's block instead of allocating a new
+  // one each time.
+  upb::Arena arena;
+  upb_inttable t;
+  ASSERT_TRUE(upb_inttable_init(&t, arena.ptr()));
+  const uintptr_t kWindow = 100;
+  uintptr_t space = 0;
+  for (uintptr_t i = 0; i < 200000; i++) {
+    ASSERT_TRUE(
+        upb_inttable_insert(&t, i, upb_value_uintptr(i), arena.ptr()));
+    if (i >= kWindow) {
+      ASSERT_TRUE(upb_inttable_remove(&t, i - kWindow, nullptr));
+    }
+    if (i == 10 * kWindow) {
+      space = upb_Arena_SpaceAllocated(arena.ptr(), nullptr);
+    }
+  }
+  EXPECT_EQ(upb_Arena_SpaceAllocated(arena.ptr(), nullptr), space);
+  EXPECT_EQ(upb_inttable_count(&t), kWindow);
+  for (uintptr_t i = 200000 - 2 * kWindow; i < 200000; i++) {
+    upb_value val;
+    bool found = upb_inttable_lookup(&t, i, &val);
+    EXPECT_EQ(found, i >= 200000 - kWindow);
+    if (found) EXPECT_EQ(upb_value_getuintptr(val), i);
+  }
+}
+
+TEST(Table, StringTableChurnDoesNotGrowTable) {
+  // Inserts copy their key into the arena, but the table itself must not be
+  // reallocated while the number of live keys stays the same.
+  upb::Arena arena;
+  upb_strtable t;
+  ASSERT_TRUE(upb_strtable_init(&t, 0, arena.ptr()));
+  const int kWindow = 100;
+  const upb_tabent* entries = nullptr;
+  for (int i = 0; i < 20000; i++) {
+    std::string key = "key" + std::to_string(i);
+    ASSERT_TRUE(upb_strtable_insert(&t, key.data(), key.size(),
+                                    upb_value_int32(i), arena.ptr()));
+    if (i >= kWindow) {
+      std::string old = "key" + std::to_string(i - kWindow);
+      ASSERT_TRUE(upb_strtable_remove2(&t, old.data(), old.size(), nullptr));
+    }
+    if (i == 10 * kWindow) entries = t.t.entries;
+  }
+  EXPECT_EQ(t.t.entries, entries);
+  EXPECT_EQ(upb_strtable_count(&t), kWindow);
+  for (int i = 20000 - 2 * kWindow; i < 20000; i++) {
+    std::string key = "key" + std::to_string(i);
+    upb_value val;
+    bool found = upb_strtable_lookup2(&t, key.data(), key.size(), &val);
+    EXPECT_EQ(found, i >= 20000 - kWindow);
+    if (found) EXPECT_EQ(upb_value_getint32(val), i);
+  }
+}
+
+TEST(Table, StringTableCollidingHashFragments) {
+  // With this many keys, many entries share the same 7-bit hash fragment in
+  // the control bytes, so lookups must still compare the full key.
+  upb::Arena arena;
+  upb_strtable t;
+  EXPECT_TRUE(upb_strtable_init(&t, 0, arena.ptr()));
+  for (int i = 0; i < 5000; i++) {
+    std::string key = "key" + std::to_string(i);
+    EXPECT_TRUE(upb_strtable_insert(&t, key.data(), key.size(),
+                                    upb_value_int32(i), arena.ptr()));
+  }
+  for (int i = 0; i < 5000; i += 2) {
+    std::string key = "key" + std::to_string(i);
+    EXPECT_TRUE(upb_strtable_remove2(&t, key.data(), key.size(), nullptr));
+  }
+  EXPECT_EQ(upb_strtable_count(&t), 2500);
+  for (int i = 0; i < 5000; i++) {
+    std::string key = "key" + std::to_string(i);
+    upb_value val;
+    bool found = upb_strtable_lookup2(&t, key.data(), key.size(), &val);
+    EXPECT_EQ(found, i % 2 == 1);
+    if (found) EXPECT_EQ(upb_value_getint32(val), i);
+  }
+  upb_value val;
+  EXPECT_FALSE(upb_strtable_lookup2(&t, "key5000", 7, &val));
+}
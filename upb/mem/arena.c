@@ -86,6 +86,12 @@ typedef struct upb_ArenaInternal {
   // freed in an arena.
   upb_AllocCleanupFunc* upb_alloc_cleanup;
 
+  // The members below are the fuse state, which any thread may update when it
+  // fuses, frees, or refs an arena in the same fuse group.  A shared root is
+  // updated constantly, so keep it out of the cache line that holds
+  // upb_Arena.ptr, which the owning thread writes on every allocation.
+  char fuse_padding[UPB_ARENA_FUSE_PADDING];
+
   // When multiple arenas are fused together, each arena points to a parent
   // arena (root points to itself). The root tracks how many live arenas
   // reference it.
@@ -137,6 +143,10 @@ static const size_t kUpb_ArenaStateReserve =
 static const size_t kUpb_ArenaRefReserve =
     UPB_ALIGN_MALLOC(sizeof(upb_ArenaRef));
 
+UPB_STATIC_ASSERT(offsetof(upb_ArenaState, body.parent_or_count) >=
+                      sizeof(upb_Arena) + 63,
+                  "Fuse state must not share a cache line with upb_Arena");
+
 // Extracts the (upb_ArenaInternal*) from a (upb_Arena*)
 static upb_ArenaInternal* upb_Arena_Internal(const upb_Arena* a) {
   return &((upb_ArenaState*)a)->body;
@@ -266,6 +276,8 @@ static upb_ArenaRoot _upb_Arena_FindRoot(upb_ArenaInternal* ai) {
   // (LDA vs DMB ISH). Even though this is a reread, we know it must be a tagged
   // pointer because if this Arena isn't a root, it can't ever become one.
   poc = upb_Atomic_Load(&ai->parent_or_count, memory_order_acquire);
+  upb_ArenaInternal* const start = ai;
+  upb_ArenaInternal* const start_parent = _upb_Arena_PointerFromTagged(poc);
   do {
     upb_ArenaInternal* next = _upb_Arena_PointerFromTagged(poc);
     UPB_PRIVATE(upb_Xsan_AccessReadOnly)(UPB_XSAN(next));
@@ -283,6 +295,13 @@ static upb_ArenaRoot _upb_Arena_FindRoot(upb_ArenaInternal* ai) {
     }
     ai = next;
   } while (_upb_Arena_IsTaggedPointer(poc));
+  if (ai != start_parent) {
+    // Path splitting only moved `start` up by one level.  It is the arena the
+    // caller holds and will most likely look up again, so point it straight at
+    // the root; this is always safe because `ai` is an ancestor of `start`.
+    upb_Atomic_Store(&start->parent_or_count, _upb_Arena_TaggedFromPointer(ai),
+                     memory_order_release);
+  }
   return (upb_ArenaRoot){.root = ai, .tagged_count = poc};
 }
 
@@ -825,11 +844,14 @@ static upb_ArenaInternal* _upb_Arena_DoFuse(upb_ArenaInternal** ai1,
   // not lose track of these refs because we always add them to our overall
   // delta.
   uintptr_t r2_untagged_count = r2.tagged_count & ~1;
-  uintptr_t with_r2_refs = r1.tagged_count + r2_untagged_count;
-  if (!upb_Atomic_CompareExchangeStrong(
-          &r1.root->parent_or_count, &r1.tagged_count, with_r2_refs,
-          memory_order_release, memory_order_acquire)) {
-    return NULL;
+  while (!upb_Atomic_CompareExchangeWeak(
+      &r1.root->parent_or_count, &r1.tagged_count,
+      r1.tagged_count + r2_untagged_count, memory_order_release,
+      memory_order_acquire)) {
+    // A racing ref or unref changed the refcount of `r1`.  As long as `r1` is
+    // still a root, retrying with the new count is all that is needed, which
+    // saves walking both trees again when `r1` is a heavily shared root.
+    if (_upb_Arena_IsTaggedPointer(r1.tagged_count)) return NULL;
   }
 
   // Perform the actual fuse by removing the refs from `r2` and swapping in the
@@ -863,16 +885,19 @@ static bool _upb_Arena_FixupRefs(upb_ArenaInternal* new_root,
   // use-after-free anyway.
   uintptr_t poc =
       upb_Atomic_Load(&new_root->parent_or_count, memory_order_relaxed);
-  if (_upb_Arena_IsTaggedPointer(poc)) return false;
-  uintptr_t with_refs = poc - ref_delta;
-  UPB_ASSERT(!_upb_Arena_IsTaggedPointer(with_refs));
-  // Relaxed order on success is safe here, for the same reasons as the relaxed
-  // read above. Relaxed order is safe on failure because the updated value is
-  // stored in a local variable which goes immediately out of scope; the retry
-  // loop will reread what it needs with proper memory order.
-  return upb_Atomic_CompareExchangeStrong(&new_root->parent_or_count, &poc,
-                                          with_refs, memory_order_relaxed,
-                                          memory_order_relaxed);
+  do {
+    // If `new_root` was fused into another arena, the caller's retry loop
+    // will find the new root with proper memory order.
+    if (_upb_Arena_IsTaggedPointer(poc)) return false;
+    UPB_ASSERT(!_upb_Arena_IsTaggedPointer(poc - ref_delta));
+    // Relaxed order on success is safe here, for the same reasons as the
+    // relaxed read above. Relaxed order is safe on failure because the updated
+    // value is only checked for being a pointer, never dereferenced.
+  } while (!upb_Atomic_CompareExchangeWeak(&new_root->parent_or_count, &poc,
+                                           poc - ref_delta,
+                                           memory_order_relaxed,
+                                           memory_order_relaxed));
+  return true;
 }
 
 bool upb_Arena_Fuse(const upb_Arena* a1, const upb_Arena* a2) {
@@ -922,27 +947,25 @@ bool upb_Arena_IsFused(const upb_Arena* a, const upb_Arena* b) {
 bool upb_Arena_IncRefFor(const upb_Arena* a, const void* owner) {
   upb_ArenaInternal* ai = upb_Arena_Internal(a);
   if (_upb_ArenaInternal_HasInitialBlock(ai)) return false;
-  upb_ArenaRoot r;
-  r.root = ai;
-
-retry:
-  r = _upb_Arena_FindRoot(r.root);
-  if (upb_Atomic_CompareExchangeWeak(
-          &r.root->parent_or_count, &r.tagged_count,
-          _upb_Arena_TaggedFromRefcount(
-              _upb_Arena_RefCountFromTagged(r.tagged_count) + 1),
-          // Relaxed order is safe on success, incrementing the refcount
-          // need not perform any synchronization with the eventual free of the
-          // arena - that's provided by decrements.
-          memory_order_relaxed,
-          // Relaxed order is safe on failure as r.tagged_count is immediately
-          // overwritten by retrying the find root operation.
-          memory_order_relaxed)) {
-    // We incremented it successfully, so we are done.
-    return true;
+  upb_ArenaRoot r = _upb_Arena_FindRoot(ai);
+  while (!upb_Atomic_CompareExchangeWeak(
+      &r.root->parent_or_count, &r.tagged_count,
+      _upb_Arena_TaggedFromRefcount(
+          _upb_Arena_RefCountFromTagged(r.tagged_count) + 1),
+      // Relaxed order is safe on success, incrementing the refcount
+      // need not perform any synchronization with the eventual free of the
+      // arena - that's provided by decrements.
+      memory_order_relaxed,
+      // Relaxed order is safe on failure: a refcount is simply retried, and a
+      // pointer is reread with proper memory order by the find root operation.
+      memory_order_relaxed)) {
+    // A racing ref or unref only changed the count, so retry in place.  If the
+    // root was fused into another arena, we have to find the new root.
+    if (_upb_Arena_IsTaggedPointer(r.tagged_count)) {
+      r = _upb_Arena_FindRoot(r.root);
+    }
   }
-  // We failed update due to parent switching on the arena.
-  goto retry;
+  return true;
 }
 
 void upb_Arena_DecRefFor(const upb_Arena* a, const void* owner) {
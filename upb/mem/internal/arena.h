@@ -29,9 +29,13 @@
 #define UPB_ARENA_BASE_SIZE_HACK 9
 #endif
 
+// Bytes of padding in front of the fuse state of an arena, which keep it off
+// the cache line of upb_Arena.ptr (see arena.c).
+#define UPB_ARENA_FUSE_PADDING UPB_SIZE(40, 24)
+
 #define UPB_ARENA_SIZE_HACK                                                   \
   (sizeof(void*) * (UPB_ARENA_BASE_SIZE_HACK + (UPB_XSAN_STRUCT_SIZE * 2))) + \
-      (sizeof(uint32_t) * 2)
+      (sizeof(uint32_t) * 2) + UPB_ARENA_FUSE_PADDING
 
 // LINT.IfChange(upb_Arena)
 
@@ -87,6 +87,8 @@ const upb_MiniTable* SubsetMiniTable(const upb_MiniTable* src, uint64_t mask,
   new_mt->UPB_ONLYBITS(field_count) = (uint16_t)new_fields.size();
   new_mt->UPB_PRIVATE(dense_below) = 0;
   new_mt->UPB_PRIVATE(table_mask) = -1;
+  // The field index, if any, describes the layout of `src`.
+  new_mt->UPB_PRIVATE(field_index) = nullptr;
 
   return new_mt;
 }
@@ -308,6 +308,10 @@ bool upb_Message_ShallowCopy(upb_Message* dst, const upb_Message* src,
                              const upb_MiniTable* m, upb_Arena* arena) {
   UPB_ASSERT(!upb_Message_IsFrozen(dst));
   memcpy(dst, src, m->UPB_PRIVATE(size));
+  // The copy is mutable even if `src` is frozen, and it must not share the
+  // internal data of `src`; the loop below copies only the unknown fields and
+  // extensions, so a retained encoding is not inherited.
+  memset(dst, 0, sizeof(upb_Message));
 
   const upb_Message_Internal* in = UPB_PRIVATE(_upb_Message_GetInternal)(src);
   if (!in) return true;
@@ -350,3 +354,192 @@ upb_Message* upb_Message_ShallowClone(const upb_Message* msg,
   if (!upb_Message_ShallowCopy(clone, msg, m, arena)) return NULL;
   return clone;
 }
+
+static bool upb_CowClone_MessageValue(void* value, upb_CType value_type,
+                                      const upb_MiniTable* sub,
+                                      upb_Arena* arena) {
+  // Strings are never modified in place, so only mutable messages need to be
+  // cloned.
+  if (value_type != kUpb_CType_Message) return true;
+  UPB_ASSERT(sub);
+  const upb_Message* source = *(upb_Message**)value;
+  UPB_ASSERT(source);
+  if (upb_Message_IsFrozen(source)) return true;
+  upb_Message* clone = upb_Message_CowClone(source, sub, arena);
+  *(upb_Message**)value = clone;
+  return clone != NULL;
+}
+
+upb_Array* upb_Array_CowClone(const upb_Array* array, upb_CType value_type,
+                              const upb_MiniTable* sub, upb_Arena* arena) {
+  const size_t size = upb_Array_Size(array);
+  const int lg2 = UPB_PRIVATE(_upb_CType_SizeLg2)(value_type);
+  upb_Array* cloned_array = UPB_PRIVATE(_upb_Array_New)(arena, size, lg2);
+  if (!cloned_array) {
+    return NULL;
+  }
+  if (!UPB_PRIVATE(_upb_Array_ResizeUninitialized)(cloned_array, size, arena)) {
+    return NULL;
+  }
+  if (size == 0) return cloned_array;
+  memcpy(upb_Array_MutableDataPtr(cloned_array), upb_Array_DataPtr(array),
+         size << lg2);
+  if (value_type != kUpb_CType_Message) return cloned_array;
+
+  upb_Message** elems = (upb_Message**)upb_Array_MutableDataPtr(cloned_array);
+  for (size_t i = 0; i < size; ++i) {
+    if (!upb_CowClone_MessageValue(&elems[i], value_type, sub, arena)) {
+      return NULL;
+    }
+  }
+  return cloned_array;
+}
+
+upb_Map* upb_Map_CowClone(const upb_Map* map, upb_CType key_type,
+                          upb_CType value_type,
+                          const upb_MiniTable* map_entry_table,
+                          upb_Arena* arena) {
+  upb_Map* cloned_map = _upb_Map_New(arena, map->key_size, map->val_size);
+  if (cloned_map == NULL) {
+    return NULL;
+  }
+  const upb_MiniTableField* value_field =
+      upb_MiniTable_MapValue(map_entry_table);
+  const upb_MiniTable* value_sub =
+      value_type == kUpb_CType_Message
+          ? upb_MiniTable_GetSubMessageTable(value_field)
+          : NULL;
+  upb_MessageValue key, val;
+  size_t iter = kUpb_Map_Begin;
+  while (upb_Map_Next(map, &key, &val, &iter)) {
+    if (!upb_CowClone_MessageValue(&val, value_type, value_sub, arena)) {
+      return NULL;
+    }
+    if (!upb_Map_Set(cloned_map, key, val, arena)) {
+      return NULL;
+    }
+  }
+  return cloned_map;
+}
+
+static upb_Array* upb_Message_Array_CowClone(const upb_Array* array,
+                                             const upb_MiniTableField* f,
+                                             upb_Arena* arena) {
+  upb_CType value_type = upb_MiniTableField_CType(f);
+  return upb_Array_CowClone(array, value_type,
+                            value_type == kUpb_CType_Message
+                                ? upb_MiniTable_GetSubMessageTable(f)
+                                : NULL,
+                            arena);
+}
+
+static upb_Map* upb_Message_Map_CowClone(const upb_Map* map,
+                                         const upb_MiniTableField* f,
+                                         upb_Arena* arena) {
+  const upb_MiniTable* map_entry_table = upb_MiniTable_MapEntrySubMessage(f);
+  UPB_ASSERT(map_entry_table);
+  return upb_Map_CowClone(
+      map, upb_MiniTableField_CType(upb_MiniTable_MapKey(map_entry_table)),
+      upb_MiniTableField_CType(upb_MiniTable_MapValue(map_entry_table)),
+      map_entry_table, arena);
+}
+
+upb_Message* upb_Message_CowClone(const upb_Message* msg,
+                                  const upb_MiniTable* m, upb_Arena* arena) {
+  upb_Message* clone = upb_Message_ShallowClone(msg, m, arena);
+  if (!clone) return NULL;
+  // Everything reachable from a frozen message is frozen too, so the shallow
+  // clone can share all of it.
+  if (upb_Message_IsFrozen(msg)) return clone;
+
+  for (int i = 0; i < upb_MiniTable_FieldCount(m); ++i) {
+    const upb_MiniTableField* field = upb_MiniTable_GetFieldByIndex(m, i);
+    if (upb_MiniTableField_IsScalar(field)) {
+      if (upb_MiniTableField_CType(field) != kUpb_CType_Message) continue;
+      const upb_Message* sub_message = upb_Message_GetMessage(clone, field);
+      if (sub_message == NULL || upb_Message_IsFrozen(sub_message)) continue;
+      upb_Message* cloned_sub = upb_Message_CowClone(
+          sub_message, upb_MiniTable_GetSubMessageTable(field), arena);
+      if (!cloned_sub) return NULL;
+      upb_Message_SetBaseFieldMessage(clone, field, cloned_sub);
+    } else if (upb_MiniTableField_IsMap(field)) {
+      const upb_Map* map = upb_Message_GetMap(clone, field);
+      if (map == NULL || upb_Map_IsFrozen(map)) continue;
+      upb_Map* cloned_map = upb_Message_Map_CowClone(map, field, arena);
+      if (!cloned_map) return NULL;
+      upb_Message_SetBaseField(clone, field, &cloned_map);
+    } else {
+      const upb_Array* array = upb_Message_GetArray(clone, field);
+      if (array == NULL || upb_Array_IsFrozen(array)) continue;
+      upb_Array* cloned_array = upb_Message_Array_CowClone(array, field, arena);
+      if (!cloned_array) return NULL;
+      upb_Message_SetBaseField(clone, field, &cloned_array);
+    }
+  }
+
+  // The shallow clone made its own copy of each upb_Extension, so their values
+  // can be replaced in place.
+  upb_Message_Internal* in = UPB_PRIVATE(_upb_Message_GetInternal)(clone);
+  if (!in) return clone;
+
+  for (size_t i = 0; i < in->size; i++) {
+    upb_TaggedAuxPtr tagged_ptr = in->aux_data[i];
+    if (!upb_TaggedAuxPtr_IsExtension(tagged_ptr)) continue;
+    upb_Extension* ext = (upb_Extension*)upb_TaggedAuxPtr_Extension(tagged_ptr);
+    const upb_MiniTableField* field = &ext->ext->UPB_PRIVATE(field);
+    if (upb_MiniTableField_IsScalar(field)) {
+      if (!upb_CowClone_MessageValue(
+              &ext->data, upb_MiniTableExtension_CType(ext->ext),
+              upb_MiniTableExtension_GetSubMessage(ext->ext), arena)) {
+        return NULL;
+      }
+    } else if (!upb_Array_IsFrozen(ext->data.array_val)) {
+      upb_Array* cloned_array = upb_Array_CowClone(
+          ext->data.array_val, upb_MiniTableField_CType(field),
+          upb_MiniTableExtension_GetSubMessage(ext->ext), arena);
+      if (!cloned_array) return NULL;
+      ext->data.array_val = cloned_array;
+    }
+  }
+  return clone;
+}
+
+upb_Message* upb_Message_GetOrCloneMutableMessage(upb_Message* msg,
+                                                  const upb_MiniTableField* f,
+                                                  upb_Arena* arena) {
+  UPB_ASSERT(!upb_Message_IsFrozen(msg));
+  upb_Message* sub_message = upb_Message_GetMutableMessage(msg, f);
+  if (!sub_message) return upb_Message_GetOrCreateMutableMessage(msg, f, arena);
+  if (!upb_Message_IsFrozen(sub_message)) return sub_message;
+  sub_message = upb_Message_CowClone(
+      sub_message, upb_MiniTable_GetSubMessageTable(f), arena);
+  if (sub_message) upb_Message_SetBaseFieldMessage(msg, f, sub_message);
+  return sub_message;
+}
+
+upb_Array* upb_Message_GetOrCloneMutableArray(upb_Message* msg,
+                                              const upb_MiniTableField* f,
+                                              upb_Arena* arena) {
+  UPB_ASSERT(!upb_Message_IsFrozen(msg));
+  upb_Array* array = upb_Message_GetMutableArray(msg, f);
+  if (!array) return upb_Message_GetOrCreateMutableArray(msg, f, arena);
+  if (!upb_Array_IsFrozen(array)) return array;
+  array = upb_Message_Array_CowClone(array, f, arena);
+  if (array) upb_Message_SetBaseField(msg, f, &array);
+  return array;
+}
+
+upb_Map* upb_Message_GetOrCloneMutableMap(upb_Message* msg,
+                                          const upb_MiniTableField* f,
+                                          upb_Arena* arena) {
+  UPB_ASSERT(!upb_Message_IsFrozen(msg));
+  upb_Map* map = upb_Message_GetMutableMap(msg, f);
+  if (!map) {
+    return upb_Message_GetOrCreateMutableMap(
+        msg, upb_MiniTable_MapEntrySubMessage(f), f, arena);
+  }
+  if (!upb_Map_IsFrozen(map)) return map;
+  map = upb_Message_Map_CowClone(map, f, arena);
+  if (map) upb_Message_SetBaseField(msg, f, &map);
+  return map;
+}
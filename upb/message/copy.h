@@ -13,6 +13,7 @@
 #include "upb/message/array.h"
 #include "upb/message/map.h"
 #include "upb/message/message.h"
+#include "upb/mini_table/field.h"
 #include "upb/mini_table/message.h"
 
 // Must be last.
@@ -55,11 +56,59 @@ UPB_NODISCARD bool upb_Message_DeepCopy(upb_Message* dst,
 // Shallow copies the message from src to dst.
 // `src` must outlive `dst` since all strings, repeated fields, maps, and
 // unknown fields will alias the original message.
+//
+// `dst` is not frozen even if `src` is, but the repeated fields, maps, and
+// submessages it shares with a frozen `src` remain frozen.
 UPB_NODISCARD UPB_API bool upb_Message_ShallowCopy(upb_Message* dst,
                                                    const upb_Message* src,
                                                    const upb_MiniTable* m,
                                                    upb_Arena* arena);
 
+// Copy-on-write clones a message using the provided target arena.
+//
+// Frozen submessages, repeated fields, and maps are shared with `msg` rather
+// than copied, so cloning a frozen message costs the same as a shallow clone.
+// Mutable ones are cloned in the same way, recursively. Strings and unknown
+// fields are always shared. The returned message itself is never frozen.
+//
+// Since the clone aliases memory owned by `msg`, the arena that owns `msg`
+// must outlive `arena`, for example by calling upb_Arena_RefArena() from
+// `arena` to it, or by fusing the two arenas.
+//
+// To modify a field inside the shared parts of the clone, walk down to it with
+// the upb_Message_GetOrCloneMutable*() functions below: these only copy the
+// messages, arrays, and maps on that path.
+UPB_NODISCARD upb_Message* upb_Message_CowClone(const upb_Message* msg,
+                                                const upb_MiniTable* m,
+                                                upb_Arena* arena);
+
+// Copy-on-write clones array contents. The new array is never frozen.
+UPB_NODISCARD upb_Array* upb_Array_CowClone(const upb_Array* array,
+                                            upb_CType value_type,
+                                            const upb_MiniTable* sub,
+                                            upb_Arena* arena);
+
+// Copy-on-write clones map contents. The new map is never frozen.
+UPB_NODISCARD upb_Map* upb_Map_CowClone(const upb_Map* map, upb_CType key_type,
+                                        upb_CType value_type,
+                                        const upb_MiniTable* map_entry_table,
+                                        upb_Arena* arena);
+
+// Returns a mutable version of submessage field `f` of the mutable message
+// `msg`. If the submessage is frozen, it is replaced with a
+// upb_Message_CowClone() of itself first, and if it is not set, a new empty
+// submessage is created. Returns NULL on allocation failure.
+UPB_NODISCARD upb_Message* upb_Message_GetOrCloneMutableMessage(
+    upb_Message* msg, const upb_MiniTableField* f, upb_Arena* arena);
+
+// Like upb_Message_GetOrCloneMutableMessage(), for a repeated field.
+UPB_NODISCARD upb_Array* upb_Message_GetOrCloneMutableArray(
+    upb_Message* msg, const upb_MiniTableField* f, upb_Arena* arena);
+
+// Like upb_Message_GetOrCloneMutableMessage(), for a map field.
+UPB_NODISCARD upb_Map* upb_Message_GetOrCloneMutableMap(
+    upb_Message* msg, const upb_MiniTableField* f, upb_Arena* arena);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
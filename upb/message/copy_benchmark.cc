@@ -0,0 +1,111 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include "absl/log/absl_check.h"
+#include "absl/strings/str_cat.h"
+#include "upb/base/descriptor_constants.h"
+#include "upb/base/status.hpp"
+#include "upb/mem/arena.h"
+#include "upb/message/accessors.h"
+#include "upb/message/copy.h"
+#include "upb/message/message.h"
+#include "upb/mini_descriptor/decode.h"
+#include "upb/mini_descriptor/internal/encode.hpp"
+#include "upb/mini_descriptor/internal/modifiers.h"
+#include "upb/mini_descriptor/link.h"
+#include "upb/mini_table/message.h"
+#include "upb/wire/decode.h"
+#include "upb/wire/test_util/wire_message.h"
+
+// Must be last.
+#include "upb/port/def.inc"
+
+namespace upb {
+namespace test {
+
+namespace {
+
+// A "config" message: a few scalars, a singular child and a list of children.
+const upb_MiniTable* BuildConfigMiniTable(upb_Arena* arena) {
+  upb::MtDataEncoder e;
+  e.StartMessage(0);
+  e.PutField(kUpb_FieldType_Int32, 1, 0);
+  e.PutField(kUpb_FieldType_String, 2, 0);
+  e.PutField(kUpb_FieldType_Message, 3, 0);
+  e.PutField(kUpb_FieldType_Message, 4, kUpb_FieldModifier_IsRepeated);
+  upb::Status status;
+  upb_MiniTable* mt = upb_MiniTable_Build(e.data().data(), e.data().size(),
+                                          arena, status.ptr());
+  ABSL_CHECK(status.ok()) << status.error_message();
+  const upb_MiniTable* subs[] = {mt, mt};
+  ABSL_CHECK(upb_MiniTable_Link(mt, subs, 2, nullptr, 0));
+  return mt;
+}
+
+wire_types::WireMessage ConfigPayload(int depth, int id) {
+  wire_types::WireMessage msg{
+      {1, wire_types::Varint(id)},
+      {2, wire_types::Delimited(absl::StrCat("config value ", id))}};
+  if (depth == 0) return msg;
+  msg.push_back({3, wire_types::Delimited(
+                        ToBinaryPayload(ConfigPayload(depth - 1, id * 9)))});
+  for (int i = 1; i < 9; i++) {
+    msg.push_back({4, wire_types::Delimited(ToBinaryPayload(
+                          ConfigPayload(depth - 1, id * 9 + i)))});
+  }
+  return msg;
+}
+
+enum CloneMode { kDeepClone, kCowClone };
+
+// Clones a frozen config tree of about 800 messages and sets a field three
+// levels down, as a service does for each request that starts from a shared
+// parsed config.
+void BM_CloneAndModify(benchmark::State& state, CloneMode mode) {
+  upb_Arena* config_arena = upb_Arena_New();
+  const upb_MiniTable* mt = BuildConfigMiniTable(config_arena);
+  std::string payload = ToBinaryPayload(ConfigPayload(3, 1));
+  upb_Message* config = upb_Message_New(mt, config_arena);
+  upb_DecodeStatus result = upb_Decode(payload.data(), payload.size(), config,
+                                       mt, nullptr, 0, config_arena);
+  ABSL_CHECK(result == kUpb_DecodeStatus_Ok);
+  upb_Message_Freeze(config, mt);
+  const upb_MiniTableField* id_field = upb_MiniTable_FindFieldByNumber(mt, 1);
+  const upb_MiniTableField* child_field =
+      upb_MiniTable_FindFieldByNumber(mt, 3);
+
+  for (auto s : state) {
+    upb_Arena* arena = upb_Arena_New();
+    upb_Message* msg;
+    if (mode == kDeepClone) {
+      msg = upb_Message_DeepClone(config, mt, arena);
+    } else {
+      ABSL_CHECK(upb_Arena_RefArena(arena, config_arena));
+      msg = upb_Message_CowClone(config, mt, arena);
+    }
+    for (int i = 0; i < 3; i++) {
+      msg = upb_Message_GetOrCloneMutableMessage(msg, child_field, arena);
+    }
+    upb_Message_SetBaseFieldInt32(msg, id_field, 42);
+    benchmark::DoNotOptimize(msg);
+    upb_Arena_Free(arena);
+  }
+  state.SetBytesProcessed(state.iterations() * payload.size());
+  upb_Arena_Free(config_arena);
+}
+BENCHMARK_CAPTURE(BM_CloneAndModify, DeepClone, kDeepClone);
+BENCHMARK_CAPTURE(BM_CloneAndModify, CowClone, kCowClone);
+
+}  // namespace
+
+}  // namespace test
+}  // namespace upb
@@ -48,6 +48,8 @@ namespace {
 const uint32_t kFieldOptionalInt32 = 1;
 const uint32_t kFieldOptionalString = 14;
 const uint32_t kFieldOptionalNestedMessage = 18;
+const uint32_t kFieldRepeatedNestedMessage = 48;
+const uint32_t kFieldMapInt32NestedMessage = 103;
 
 const char kTestStr1[] = "Hello1";
 const char kTestStr2[] = "HelloWorld2";
@@ -599,6 +601,55 @@ TEST(GeneratedCode, ShallowCopyIncludesUnknowns) {
   upb_Arena_Free(arena);
 }
 
+TEST(GeneratedCode, ShallowCopyOfFrozenMessageIsMutable) {
+  upb_Arena* arena = upb_Arena_New();
+  protobuf_test_messages_proto2_TestAllTypesProto2* msg =
+      protobuf_test_messages_proto2_TestAllTypesProto2_new(arena);
+  protobuf_test_messages_proto2_TestAllTypesProto2_set_optional_int32(
+      msg, kTestInt32);
+  std::string_view unknown_data1 = "\x08\x01";
+  ASSERT_TRUE(UPB_PRIVATE(_upb_Message_AddUnknown)(
+      UPB_UPCAST(msg), unknown_data1.data(), unknown_data1.size(), arena,
+      kUpb_AddUnknown_Copy));
+  std::string_view encoding = "\x08\x01";
+  ASSERT_TRUE(UPB_PRIVATE(_upb_Message_SetEncoding)(
+      UPB_UPCAST(msg),
+      upb_StringView_FromDataAndSize(encoding.data(), encoding.size()),
+      arena));
+  upb_Message_Freeze(
+      UPB_UPCAST(msg),
+      &protobuf_0test_0messages__proto2__TestAllTypesProto2_msg_init);
+  ASSERT_NE(UPB_PRIVATE(_upb_Message_GetEncoding)(UPB_UPCAST(msg)), nullptr);
+
+  protobuf_test_messages_proto2_TestAllTypesProto2* dst =
+      protobuf_test_messages_proto2_TestAllTypesProto2_new(arena);
+  EXPECT_TRUE(upb_Message_ShallowCopy(
+      UPB_UPCAST(dst), UPB_UPCAST(msg),
+      &protobuf_0test_0messages__proto2__TestAllTypesProto2_msg_init, arena));
+
+  // The frozen bit and the internal data of `msg` are not copied; the unknown
+  // fields are, but the retained encoding is not.
+  EXPECT_FALSE(upb_Message_IsFrozen(UPB_UPCAST(dst)));
+  EXPECT_EQ(
+      protobuf_test_messages_proto2_TestAllTypesProto2_optional_int32(dst),
+      kTestInt32);
+  std::vector<std::string_view> only_unknown_data1 = {unknown_data1};
+  EXPECT_EQ(GetUnknownFields(UPB_UPCAST(dst)), only_unknown_data1);
+
+  std::string_view unknown_data2 = "\x10\x02";
+  ASSERT_TRUE(UPB_PRIVATE(_upb_Message_AddUnknown)(
+      UPB_UPCAST(dst), unknown_data2.data(), unknown_data2.size(), arena,
+      kUpb_AddUnknown_Copy));
+  EXPECT_EQ(GetUnknownFields(UPB_UPCAST(msg)), only_unknown_data1);
+
+  upb_Message_Freeze(
+      UPB_UPCAST(dst),
+      &protobuf_0test_0messages__proto2__TestAllTypesProto2_msg_init);
+  EXPECT_EQ(UPB_PRIVATE(_upb_Message_GetEncoding)(UPB_UPCAST(dst)), nullptr);
+
+  upb_Arena_Free(arena);
+}
+
 TEST(GeneratedCode, ShallowCloneMessage) {
   upb_Arena* arena = upb_Arena_New();
   protobuf_test_messages_proto2_TestAllTypesProto2* msg =
@@ -667,6 +718,207 @@ TEST(GeneratedCode, DeepCloneMessageNonCanonicalExtensions) {
   upb_Arena_Free(arena);
 }
 
+// Returns a message with a submessage, a repeated submessage, and a map of
+// submessages, all of them set.
+protobuf_test_messages_proto2_TestAllTypesProto2* NewCowTestMessage(
+    upb_Arena* arena) {
+  protobuf_test_messages_proto2_TestAllTypesProto2* msg =
+      protobuf_test_messages_proto2_TestAllTypesProto2_new(arena);
+  protobuf_test_messages_proto2_TestAllTypesProto2_set_optional_int32(
+      msg, kTestInt32);
+  protobuf_test_messages_proto2_TestAllTypesProto2_NestedMessage_set_a(
+      protobuf_test_messages_proto2_TestAllTypesProto2_mutable_optional_nested_message(
+          msg, arena),
+      kTestNestedInt32);
+  for (int32_t i = 0; i < 3; i++) {
+    protobuf_test_messages_proto2_TestAllTypesProto2_NestedMessage_set_a(
+        protobuf_test_messages_proto2_TestAllTypesProto2_add_repeated_nested_message(
+            msg, arena),
+        i);
+  }
+  protobuf_test_messages_proto2_TestAllTypesProto2_NestedMessage* value =
+      protobuf_test_messages_proto2_TestAllTypesProto2_NestedMessage_new(arena);
+  protobuf_test_messages_proto2_TestAllTypesProto2_NestedMessage_set_a(
+      value, kTestNestedInt32);
+  EXPECT_TRUE(
+      protobuf_test_messages_proto2_TestAllTypesProto2_map_int32_nested_message_set(
+          msg, 1, value, arena));
+  return msg;
+}
+
+std::string Serialize(const upb_Message* msg) {
+  upb_Arena* arena = upb_Arena_New();
+  char* buf;
+  size_t size;
+  upb_EncodeStatus status = upb_Encode(
+      msg, &protobuf_0test_0messages__proto2__TestAllTypesProto2_msg_init,
+      kUpb_EncodeOption_Deterministic, arena, &buf, &size);
+  EXPECT_EQ(status, kUpb_EncodeStatus_Ok);
+  std::string ret(buf, size);
+  upb_Arena_Free(arena);
+  return ret;
+}
+
+TEST(GeneratedCode, CowCloneSharesFrozenMessage) {
+  const upb_MiniTable* mt =
+      &protobuf_0test_0messages__proto2__TestAllTypesProto2_msg_init;
+  upb_Arena* source_arena = upb_Arena_New();
+  protobuf_test_messages_proto2_TestAllTypesProto2* msg =
+      NewCowTestMessage(source_arena);
+  upb_Message_Freeze(UPB_UPCAST(msg), mt);
+
+  upb_Arena* arena = upb_Arena_New();
+  ASSERT_TRUE(upb_Arena_RefArena(arena, source_arena));
+  upb_Message* clone = upb_Message_CowClone(UPB_UPCAST(msg), mt, arena);
+  ASSERT_NE(clone, nullptr);
+  upb_Arena_Free(source_arena);
+
+  EXPECT_FALSE(upb_Message_IsFrozen(clone));
+  EXPECT_EQ(Serialize(clone), Serialize(UPB_UPCAST(msg)));
+  const upb_MiniTableField* nested_field =
+      find_proto2_field(kFieldOptionalNestedMessage);
+  EXPECT_EQ(upb_Message_GetMessage(clone, nested_field),
+            upb_Message_GetMessage(UPB_UPCAST(msg), nested_field));
+  const upb_MiniTableField* array_field =
+      find_proto2_field(kFieldRepeatedNestedMessage);
+  EXPECT_EQ(upb_Message_GetArray(clone, array_field),
+            upb_Message_GetArray(UPB_UPCAST(msg), array_field));
+  const upb_MiniTableField* map_field =
+      find_proto2_field(kFieldMapInt32NestedMessage);
+  EXPECT_EQ(upb_Message_GetMap(clone, map_field),
+            upb_Message_GetMap(UPB_UPCAST(msg), map_field));
+  upb_Arena_Free(arena);
+}
+
+TEST(GeneratedCode, CowCloneCopiesMutatedPath) {
+  const upb_MiniTable* mt =
+      &protobuf_0test_0messages__proto2__TestAllTypesProto2_msg_init;
+  upb_Arena* source_arena = upb_Arena_New();
+  protobuf_test_messages_proto2_TestAllTypesProto2* msg =
+      NewCowTestMessage(source_arena);
+  upb_Message_Freeze(UPB_UPCAST(msg), mt);
+  std::string serialized = Serialize(UPB_UPCAST(msg));
+
+  upb_Arena* arena = upb_Arena_New();
+  ASSERT_TRUE(upb_Arena_RefArena(arena, source_arena));
+  upb_Message* clone = upb_Message_CowClone(UPB_UPCAST(msg), mt, arena);
+  ASSERT_NE(clone, nullptr);
+
+  // Submessage.
+  const upb_MiniTableField* nested_field =
+      find_proto2_field(kFieldOptionalNestedMessage);
+  upb_Message* nested =
+      upb_Message_GetOrCloneMutableMessage(clone, nested_field, arena);
+  ASSERT_NE(nested, nullptr);
+  EXPECT_FALSE(upb_Message_IsFrozen(nested));
+  EXPECT_NE(nested, upb_Message_GetMessage(UPB_UPCAST(msg), nested_field));
+  EXPECT_EQ(upb_Message_GetOrCloneMutableMessage(clone, nested_field, arena),
+            nested);
+  protobuf_test_messages_proto2_TestAllTypesProto2_NestedMessage_set_a(
+      (protobuf_test_messages_proto2_TestAllTypesProto2_NestedMessage*)nested,
+      kTestInt32);
+
+  // Repeated field: the array is copied, but not its elements.
+  const upb_MiniTableField* array_field =
+      find_proto2_field(kFieldRepeatedNestedMessage);
+  upb_Array* array =
+      upb_Message_GetOrCloneMutableArray(clone, array_field, arena);
+  ASSERT_NE(array, nullptr);
+  const upb_Array* source_array =
+      upb_Message_GetArray(UPB_UPCAST(msg), array_field);
+  EXPECT_NE(array, source_array);
+  ASSERT_EQ(upb_Array_Size(array), 3u);
+  EXPECT_EQ(upb_Array_Get(array, 2).msg_val,
+            upb_Array_Get(source_array, 2).msg_val);
+  upb_Message* elem = upb_Message_CowClone(
+      upb_Array_Get(array, 2).msg_val,
+      upb_MiniTable_GetSubMessageTable(array_field), arena);
+  ASSERT_NE(elem, nullptr);
+  upb_MessageValue elem_val;
+  elem_val.msg_val = elem;
+  upb_Array_Set(array, 2, elem_val);
+  protobuf_test_messages_proto2_TestAllTypesProto2_NestedMessage_set_a(
+      (protobuf_test_messages_proto2_TestAllTypesProto2_NestedMessage*)elem,
+      kTestInt32);
+
+  // Map.
+  const upb_MiniTableField* map_field =
+      find_proto2_field(kFieldMapInt32NestedMessage);
+  upb_Map* map = upb_Message_GetOrCloneMutableMap(clone, map_field, arena);
+  ASSERT_NE(map, nullptr);
+  EXPECT_NE(map, upb_Message_GetMap(UPB_UPCAST(msg), map_field));
+  upb_MessageValue key;
+  key.int32_val = 2;
+  EXPECT_TRUE(upb_Map_Set(map, key, elem_val, arena));
+
+  // The source is unchanged.
+  EXPECT_EQ(Serialize(UPB_UPCAST(msg)), serialized);
+  upb_Arena_Free(source_arena);
+
+  auto* cloned = (protobuf_test_messages_proto2_TestAllTypesProto2*)clone;
+  EXPECT_EQ(protobuf_test_messages_proto2_TestAllTypesProto2_NestedMessage_a(
+                protobuf_test_messages_proto2_TestAllTypesProto2_optional_nested_message(
+                    cloned)),
+            kTestInt32);
+  size_t size;
+  const protobuf_test_messages_proto2_TestAllTypesProto2_NestedMessage* const*
+      elems =
+          protobuf_test_messages_proto2_TestAllTypesProto2_repeated_nested_message(
+              cloned, &size);
+  ASSERT_EQ(size, 3u);
+  EXPECT_EQ(
+      protobuf_test_messages_proto2_TestAllTypesProto2_NestedMessage_a(elems[1]),
+      1);
+  EXPECT_EQ(
+      protobuf_test_messages_proto2_TestAllTypesProto2_NestedMessage_a(elems[2]),
+      kTestInt32);
+  EXPECT_EQ(
+      protobuf_test_messages_proto2_TestAllTypesProto2_map_int32_nested_message_size(
+          cloned),
+      2u);
+  upb_Arena_Free(arena);
+}
+
+TEST(GeneratedCode, CowCloneCopiesMutableMessage) {
+  const upb_MiniTable* mt =
+      &protobuf_0test_0messages__proto2__TestAllTypesProto2_msg_init;
+  upb_Arena* arena = upb_Arena_New();
+  protobuf_test_messages_proto2_TestAllTypesProto2* msg =
+      NewCowTestMessage(arena);
+  std::string serialized = Serialize(UPB_UPCAST(msg));
+
+  upb_Message* clone = upb_Message_CowClone(UPB_UPCAST(msg), mt, arena);
+  ASSERT_NE(clone, nullptr);
+  EXPECT_EQ(Serialize(clone), serialized);
+
+  // Nothing mutable is shared, so the clone can be modified directly.
+  const upb_MiniTableField* nested_field =
+      find_proto2_field(kFieldOptionalNestedMessage);
+  upb_Message* nested = upb_Message_GetMutableMessage(clone, nested_field);
+  EXPECT_NE(nested, upb_Message_GetMessage(UPB_UPCAST(msg), nested_field));
+  EXPECT_EQ(upb_Message_GetOrCloneMutableMessage(clone, nested_field, arena),
+            nested);
+  const upb_MiniTableField* array_field =
+      find_proto2_field(kFieldRepeatedNestedMessage);
+  upb_Array* array = upb_Message_GetMutableArray(clone, array_field);
+  const upb_Array* source_array =
+      upb_Message_GetArray(UPB_UPCAST(msg), array_field);
+  EXPECT_NE(array, source_array);
+  EXPECT_NE(upb_Array_Get(array, 0).msg_val,
+            upb_Array_Get(source_array, 0).msg_val);
+  const upb_MiniTableField* map_field =
+      find_proto2_field(kFieldMapInt32NestedMessage);
+  EXPECT_NE(upb_Message_GetMap(clone, map_field),
+            upb_Message_GetMap(UPB_UPCAST(msg), map_field));
+
+  protobuf_test_messages_proto2_TestAllTypesProto2_NestedMessage_set_a(
+      (protobuf_test_messages_proto2_TestAllTypesProto2_NestedMessage*)nested,
+      kTestInt32);
+  EXPECT_EQ(Serialize(UPB_UPCAST(msg)), serialized);
+  EXPECT_NE(Serialize(clone), serialized);
+  upb_Arena_Free(arena);
+}
+
 }  // namespace
 
 #include "upb/port/undef.inc"
@@ -44,6 +44,11 @@ struct upb_Map {
   bool UPB_PRIVATE(is_strtable);
 
   union upb_Map_Table t;
+
+  // Table entries in deterministic (sorted) order, as cached by
+  // upb_Map_CacheSortedKeys(). NULL if there is no cached order; any
+  // insertion, deletion or clear drops it.
+  const void** UPB_PRIVATE(sorted);
 };
 
 #ifdef __cplusplus
@@ -131,6 +136,7 @@ UPB_INLINE bool _upb_map_next(const struct upb_Map* map, size_t* iter) {
 
 UPB_INLINE void _upb_Map_Clear(struct upb_Map* map) {
   UPB_ASSERT(!upb_Map_IsFrozen(map));
+  map->UPB_PRIVATE(sorted) = NULL;
 
   if (map->UPB_PRIVATE(is_strtable)) {
     upb_strtable_clear(&map->t.strtable);
@@ -142,6 +148,7 @@ UPB_INLINE void _upb_Map_Clear(struct upb_Map* map) {
 UPB_INLINE bool _upb_Map_Delete(struct upb_Map* map, const void* key,
                                 size_t key_size, upb_value* val) {
   UPB_ASSERT(!upb_Map_IsFrozen(map));
+  map->UPB_PRIVATE(sorted) = NULL;
 
   if (map->UPB_PRIVATE(is_strtable)) {
     upb_StringView k = _upb_map_tokey(key, key_size);
@@ -181,6 +188,9 @@ UPB_INLINE upb_MapInsertStatus _upb_Map_Insert(struct upb_Map* map,
     return kUpb_MapInsertStatus_OutOfMemory;
   }
 
+  // Even replacing a value may move the key's table entry.
+  map->UPB_PRIVATE(sorted) = NULL;
+
   bool removed;
   if (map->UPB_PRIVATE(is_strtable)) {
     upb_StringView strkey = _upb_map_tokey(key, key_size);
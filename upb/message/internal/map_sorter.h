@@ -89,6 +89,11 @@ UPB_INLINE void _upb_mapsorter_popmap(_upb_mapsorter* s,
 bool _upb_mapsorter_pushmap(_upb_mapsorter* s, upb_FieldType key_type,
                             const struct upb_Map* map, _upb_sortedmap* sorted);
 
+// Writes pointers to the map's table entries to |entries|, which must have
+// room for all of them, sorted by key.
+void _upb_mapsorter_sortentries(const struct upb_Map* map, upb_CType key_type,
+                                const void** entries);
+
 // Pushes canonical extensions from the given message onto the sorter.
 bool _upb_mapsorter_pushexts(_upb_mapsorter* s, const upb_Message_Internal* in,
                              _upb_sortedmap* sorted);
@@ -13,6 +13,7 @@
 #include <string.h>
 
 #include "upb/base/internal/log2.h"
+#include "upb/base/string_view.h"
 #include "upb/mem/arena.h"
 #include "upb/message/internal/types.h"
 
@@ -85,6 +86,31 @@ bool UPB_PRIVATE(_upb_Message_ReserveSlot)(struct upb_Message* msg,
   return true;
 }
 
+bool UPB_PRIVATE(_upb_Message_SetEncoding)(struct upb_Message* msg,
+                                           upb_StringView encoding,
+                                           upb_Arena* a) {
+  UPB_ASSERT(!upb_Message_IsFrozen(msg));
+  UPB_ASSERT(encoding.data);
+  upb_StringView* sv = upb_Arena_Malloc(a, sizeof(*sv));
+  if (!sv) return false;
+  *sv = encoding;
+  upb_Message_Internal* in = UPB_PRIVATE(_upb_Message_GetInternal)(msg);
+  if (!in) {
+    // Most parsed messages have no unknown fields or extensions, so only
+    // reserve the slot for the encoding.
+    in = upb_Arena_Malloc(a, _upb_Message_SizeOfInternal(1));
+    if (!in) return false;
+    in->size = 0;
+    in->capacity = 1;
+    UPB_PRIVATE(_upb_Message_SetInternal)(msg, in);
+  } else {
+    if (!UPB_PRIVATE(_upb_Message_ReserveSlot)(msg, a)) return false;
+    in = UPB_PRIVATE(_upb_Message_GetInternal)(msg);
+  }
+  in->aux_data[in->size++] = upb_TaggedAuxPtr_MakeRetainedEncoding(sv);
+  return true;
+}
+
 #ifdef UPB_TRACING_ENABLED
 static void (*_message_trace_handler)(const upb_MiniTable*, const upb_Arena*);
 
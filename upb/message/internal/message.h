@@ -49,6 +49,7 @@ typedef struct upb_TaggedAuxPtr {
   // 100 - aliased unknown data (upb_StringView*)
   // 001 - non-canonical extension (upb_Extension*)
   // 011 - canonical extension (upb_Extension*)
+  // 110 - retained encoding of the whole message (upb_StringView*)
   //
   // Bit 0 (lowest bit): Represents the data format in memory (1 for parsed
   //   form, 0 for serialized form).
@@ -80,6 +81,10 @@ typedef struct upb_TaggedAuxPtr {
   // For a non-canonical extension, its schema is known but not
   // the one expected by the message, so it should be treated like an unknown
   // field, but is stored as an extension to lazily defer serialization.
+  //
+  // A retained encoding is the span of the input the message was parsed from
+  // (see kUpb_DecodeOption_RetainEncoding). It is not a field, so it is
+  // tagged as semantically known and skipped by everything but the encoder.
   uintptr_t ptr;
 } upb_TaggedAuxPtr;
 
@@ -116,7 +121,11 @@ UPB_INLINE bool upb_TaggedAuxPtr_IsUnknownStringView(upb_TaggedAuxPtr ptr) {
 }
 
 UPB_INLINE bool upb_TaggedAuxPtr_IsUnknownAliased(upb_TaggedAuxPtr ptr) {
-  return !upb_TaggedAuxPtr_IsNull(ptr) && ((ptr.ptr & 5) == 4);
+  return !upb_TaggedAuxPtr_IsNull(ptr) && ((ptr.ptr & 7) == 4);
+}
+
+UPB_INLINE bool upb_TaggedAuxPtr_IsRetainedEncoding(upb_TaggedAuxPtr ptr) {
+  return (ptr.ptr & 7) == kUpb_TaggedAuxType_RetainedEncoding;
 }
 
 UPB_INLINE upb_Extension* upb_TaggedAuxPtr_CanonicalExtension(
@@ -154,6 +163,12 @@ UPB_INLINE upb_StringView* upb_TaggedPtrAux_StringViewRepr(
   return (upb_StringView*)(ptr.ptr & ~7ULL);
 }
 
+UPB_INLINE const upb_StringView* upb_TaggedAuxPtr_RetainedEncoding(
+    upb_TaggedAuxPtr ptr) {
+  UPB_ASSERT(upb_TaggedAuxPtr_IsRetainedEncoding(ptr));
+  return (const upb_StringView*)(ptr.ptr & ~7ULL);
+}
+
 // LINT.ThenChange(//depot/google3/third_party/upb/bits/golang/message.go:tagged_aux_type)
 
 typedef union {
@@ -223,6 +238,14 @@ upb_TaggedAuxPtr_MakeUnknownDataAliased(const upb_StringView* sv) {
   return ptr;
 }
 
+UPB_INLINE upb_TaggedAuxPtr
+upb_TaggedAuxPtr_MakeRetainedEncoding(const upb_StringView* sv) {
+  UPB_ASSERT(((uintptr_t)sv & 7) == 0);
+  upb_TaggedAuxPtr ptr;
+  ptr.ptr = (uintptr_t)sv | kUpb_TaggedAuxType_RetainedEncoding;
+  return ptr;
+}
+
 typedef struct upb_Message_Internal {
   // Total number of entries set in aux_data
   uint32_t size;
@@ -391,6 +414,41 @@ UPB_NODISCARD bool UPB_PRIVATE(_upb_Message_AddUnknownV)(
     struct upb_Message* msg, upb_Arena* arena, upb_StringView data[],
     size_t count);
 
+// Records `encoding` as the wire encoding of `msg`, which the encoder may emit
+// verbatim once `msg` is frozen. Returns false on allocation failure.
+// _upb_Message_ClearEncoding() forgets it again.
+UPB_NODISCARD bool UPB_PRIVATE(_upb_Message_SetEncoding)(
+    struct upb_Message* msg, upb_StringView encoding, upb_Arena* arena);
+
+UPB_INLINE void UPB_PRIVATE(_upb_Message_ClearEncoding)(
+    struct upb_Message* msg) {
+  UPB_ASSERT(!upb_Message_IsFrozen(msg));
+  upb_Message_Internal* in = UPB_PRIVATE(_upb_Message_GetInternal)(msg);
+  if (!in) return;
+  for (uint32_t i = 0; i < in->size; i++) {
+    if (upb_TaggedAuxPtr_IsRetainedEncoding(in->aux_data[i])) {
+      in->aux_data[i] = upb_TaggedAuxPtr_Null();
+    }
+  }
+}
+
+// Returns the retained wire encoding of `msg`, or NULL if there is none or the
+// message is not frozen (and may thus have been modified since it was parsed).
+UPB_INLINE const upb_StringView* UPB_PRIVATE(_upb_Message_GetEncoding)(
+    const struct upb_Message* msg) {
+  if (!upb_Message_IsFrozen(msg)) return NULL;
+  const upb_Message_Internal* in = UPB_PRIVATE(_upb_Message_GetInternal)(msg);
+  if (!in) return NULL;
+  // The encoding is recorded after the message is parsed, so it is normally
+  // the last entry.
+  for (uint32_t i = in->size; i > 0; i--) {
+    if (upb_TaggedAuxPtr_IsRetainedEncoding(in->aux_data[i - 1])) {
+      return upb_TaggedAuxPtr_RetainedEncoding(in->aux_data[i - 1]);
+    }
+  }
+  return NULL;
+}
+
 // Ensures at least one slot is available in the aux_data of this message.
 // Returns false if a reallocation is needed to satisfy the request, and fails.
 UPB_NODISCARD bool UPB_PRIVATE(_upb_Message_ReserveSlot)(
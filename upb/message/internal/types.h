@@ -19,7 +19,8 @@ typedef enum {
   kUpb_TaggedAuxType_Unknown = 0,                // tag 000
   kUpb_TaggedAuxType_NonCanonicalExtension = 1,  // tag 001
   kUpb_TaggedAuxType_CanonicalExtension = 3,     // tag 011
-  kUpb_TaggedAuxType_AliasedUnknown = 4          // tag 100
+  kUpb_TaggedAuxType_AliasedUnknown = 4,         // tag 100
+  kUpb_TaggedAuxType_RetainedEncoding = 6        // tag 110
 } upb_TaggedAuxType;
 
 struct upb_Message {
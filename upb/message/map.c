@@ -17,6 +17,7 @@
 #include "upb/hash/str_table.h"
 #include "upb/mem/arena.h"
 #include "upb/message/internal/map.h"
+#include "upb/message/internal/map_sorter.h"
 #include "upb/message/internal/types.h"
 #include "upb/message/map.h"
 #include "upb/message/message.h"
@@ -160,6 +161,17 @@ upb_MessageValue upb_MapIterator_Value(const upb_Map* map, size_t iter) {
   return ret;
 }
 
+bool upb_Map_CacheSortedKeys(upb_Map* map, upb_CType key_type,
+                             upb_Arena* a) {
+  UPB_ASSERT(!upb_Map_IsFrozen(map));
+  size_t size = _upb_Map_Size(map);
+  const void** sorted = upb_Arena_Malloc(a, UPB_MAX(size, 1) * sizeof(void*));
+  if (!sorted) return false;
+  _upb_mapsorter_sortentries(map, key_type, sorted);
+  map->UPB_PRIVATE(sorted) = sorted;
+  return true;
+}
+
 void upb_Map_Freeze(upb_Map* map, const upb_MiniTable* m) {
   if (upb_Map_IsFrozen(map)) return;
   UPB_PRIVATE(_upb_Map_ShallowFreeze)(map);
@@ -190,6 +202,7 @@ upb_Map* _upb_Map_New(upb_Arena* a, size_t key_size, size_t value_size) {
   map->key_size = key_size;
   map->val_size = value_size;
   map->UPB_PRIVATE(is_frozen) = false;
+  map->UPB_PRIVATE(sorted) = NULL;
 
   return map;
 }
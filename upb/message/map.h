@@ -116,6 +116,17 @@ UPB_API bool upb_MapIterator_Done(const upb_Map* map, size_t iter);
 UPB_API upb_MessageValue upb_MapIterator_Key(const upb_Map* map, size_t iter);
 UPB_API upb_MessageValue upb_MapIterator_Value(const upb_Map* map, size_t iter);
 
+// Sorts the map's keys once and caches the order on the map, so that
+// deterministic serialization (kUpb_EncodeOption_Deterministic and the text
+// and JSON encoders) copies the cached order instead of sorting the map again
+// on every call. |key_type| must be the key type the map was created with and
+// |a| must outlive the map. Any later insertion, deletion or clear drops the
+// cache; call this again after mutating the map. Must not be called on a
+// frozen map, but the cache survives freezing. Returns false if memory
+// allocation failed.
+UPB_API bool upb_Map_CacheSortedKeys(upb_Map* map, upb_CType key_type,
+                                     upb_Arena* a);
+
 // Mark a map and all of its descendents as frozen/immutable.
 // If the map values are messages then |m| must point to the minitable for
 // those messages. Otherwise |m| must be NULL.
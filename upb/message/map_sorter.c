@@ -82,26 +82,17 @@ static int _upb_mapsorter_cmpstr(const void* _a, const void* _b) {
   return a.size < b.size ? -1 : a.size > b.size;
 }
 
-static int (*const compar[kUpb_FieldType_SizeOf])(const void*, const void*) = {
-    [kUpb_FieldType_Int64] = _upb_mapsorter_cmpi64,
-    [kUpb_FieldType_SFixed64] = _upb_mapsorter_cmpi64,
-    [kUpb_FieldType_SInt64] = _upb_mapsorter_cmpi64,
-
-    [kUpb_FieldType_UInt64] = _upb_mapsorter_cmpu64,
-    [kUpb_FieldType_Fixed64] = _upb_mapsorter_cmpu64,
-
-    [kUpb_FieldType_Int32] = _upb_mapsorter_cmpi32,
-    [kUpb_FieldType_SInt32] = _upb_mapsorter_cmpi32,
-    [kUpb_FieldType_SFixed32] = _upb_mapsorter_cmpi32,
-    [kUpb_FieldType_Enum] = _upb_mapsorter_cmpi32,
-
-    [kUpb_FieldType_UInt32] = _upb_mapsorter_cmpu32,
-    [kUpb_FieldType_Fixed32] = _upb_mapsorter_cmpu32,
-
-    [kUpb_FieldType_Bool] = _upb_mapsorter_cmpbool,
-
-    [kUpb_FieldType_String] = _upb_mapsorter_cmpstr,
-    [kUpb_FieldType_Bytes] = _upb_mapsorter_cmpstr,
+// Indexed by key CType; every field type with the same CType sorts the same
+// way, which lets upb_Map_CacheSortedKeys() work from the map's CType.
+static int (*const compar[kUpb_CType_Bytes + 1])(const void*, const void*) = {
+    [kUpb_CType_Int64] = _upb_mapsorter_cmpi64,
+    [kUpb_CType_UInt64] = _upb_mapsorter_cmpu64,
+    [kUpb_CType_Int32] = _upb_mapsorter_cmpi32,
+    [kUpb_CType_Enum] = _upb_mapsorter_cmpi32,
+    [kUpb_CType_UInt32] = _upb_mapsorter_cmpu32,
+    [kUpb_CType_Bool] = _upb_mapsorter_cmpbool,
+    [kUpb_CType_String] = _upb_mapsorter_cmpstr,
+    [kUpb_CType_Bytes] = _upb_mapsorter_cmpstr,
 };
 
 static bool _upb_mapsorter_resize(_upb_mapsorter* s, _upb_sortedmap* sorted,
@@ -122,35 +113,41 @@ static bool _upb_mapsorter_resize(_upb_mapsorter* s, _upb_sortedmap* sorted,
   return true;
 }
 
+void _upb_mapsorter_sortentries(const upb_Map* map, upb_CType key_type,
+                                const void** entries) {
+  // Copy non-empty entries from the table to entries.
+  const void** dst = entries;
+  const upb_table* t = map->UPB_PRIVATE(is_strtable) ? &map->t.strtable.t
+                                                     : &map->t.inttable.t;
+  for (size_t i = 0, n = upb_table_size(t); i < n; i++) {
+    if (upb_table_hasentry(t, i)) {
+      *dst = &t->entries[i];
+      dst++;
+    }
+  }
+  size_t map_size = dst - entries;
+  UPB_ASSERT(map_size == _upb_Map_Size(map));
+
+  // Sort entries according to the key type.
+  qsort(entries, map_size, sizeof(*entries),
+        map->UPB_PRIVATE(is_strtable) ? compar[key_type]
+                                      : _upb_mapsorter_intkeys);
+}
+
 bool _upb_mapsorter_pushmap(_upb_mapsorter* s, upb_FieldType key_type,
                             const upb_Map* map, _upb_sortedmap* sorted) {
   int map_size = _upb_Map_Size(map);
 
   if (!_upb_mapsorter_resize(s, sorted, map_size)) return false;
 
-  // Copy non-empty entries from the table to s->entries.
-  const void** dst = &s->entries[sorted->start];
-  const upb_tabent* src;
-  const upb_tabent* end;
-  if (map->UPB_PRIVATE(is_strtable)) {
-    src = map->t.strtable.t.entries;
-    end = src + upb_table_size(&map->t.strtable.t);
+  if (map->UPB_PRIVATE(sorted)) {
+    // The order was cached by upb_Map_CacheSortedKeys().
+    memcpy(&s->entries[sorted->start], map->UPB_PRIVATE(sorted),
+           map_size * sizeof(*s->entries));
   } else {
-    src = map->t.inttable.t.entries;
-    end = src + upb_table_size(&map->t.inttable.t);
-  }
-  for (; src < end; src++) {
-    if (!upb_tabent_isempty(src)) {
-      *dst = src;
-      dst++;
-    }
+    _upb_mapsorter_sortentries(map, upb_FieldType_CType(key_type),
+                               &s->entries[sorted->start]);
   }
-  UPB_ASSERT(dst == &s->entries[sorted->end]);
-
-  // Sort entries according to the key type.
-  qsort(&s->entries[sorted->start], map_size, sizeof(*s->entries),
-        map->UPB_PRIVATE(is_strtable) ? compar[key_type]
-                                      : _upb_mapsorter_intkeys);
   return true;
 }
 
@@ -7,9 +7,19 @@
 
 #include "upb/message/map.h"
 
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
+#include "upb/base/descriptor_constants.h"
 #include "upb/base/string_view.h"
 #include "upb/mem/arena.hpp"
+#include "upb/message/internal/map_entry.h"
+#include "upb/message/internal/map_sorter.h"
 
 TEST(MapTest, DeleteRegression) {
   upb::Arena arena;
@@ -31,3 +41,77 @@ TEST(MapTest, DeleteRegression) {
   EXPECT_TRUE(
       upb_StringView_IsEqual(insert_value.str_val, delete_value.str_val));
 }
+
+// Returns the keys of `map` in deterministic serialization order.
+template <typename T>
+std::vector<T> SortedKeys(const upb_Map* map, upb_FieldType key_type) {
+  _upb_mapsorter sorter;
+  _upb_mapsorter_init(&sorter);
+  _upb_sortedmap sorted;
+  EXPECT_TRUE(_upb_mapsorter_pushmap(&sorter, key_type, map, &sorted));
+  std::vector<T> keys;
+  upb_MapEntry ent;
+  while (_upb_sortedmap_next(&sorter, map, &sorted, &ent)) {
+    T key;
+    memcpy(&key, &ent.k, sizeof(key));
+    keys.push_back(key);
+  }
+  _upb_mapsorter_popmap(&sorter, &sorted);
+  _upb_mapsorter_destroy(&sorter);
+  return keys;
+}
+
+TEST(MapTest, CacheSortedKeys) {
+  upb::Arena arena;
+  upb_Map* map = upb_Map_New(arena.ptr(), kUpb_CType_Int64, kUpb_CType_Bool);
+  upb_MessageValue key, val;
+  val.bool_val = true;
+  for (int i = 0; i < 1000; i++) {
+    key.int64_val = (i * 7919) % 1000 - 500;
+    ASSERT_TRUE(upb_Map_Set(map, key, val, arena.ptr()));
+  }
+  std::vector<int64_t> expected =
+      SortedKeys<int64_t>(map, kUpb_FieldType_SInt64);
+  ASSERT_EQ(expected.size(), 1000);
+
+  ASSERT_TRUE(upb_Map_CacheSortedKeys(map, kUpb_CType_Int64, arena.ptr()));
+  EXPECT_EQ(expected, SortedKeys<int64_t>(map, kUpb_FieldType_SInt64));
+
+  // Mutations drop the cached order.
+  key.int64_val = 1000;
+  ASSERT_TRUE(upb_Map_Set(map, key, val, arena.ptr()));
+  std::vector<int64_t> keys = SortedKeys<int64_t>(map, kUpb_FieldType_SInt64);
+  EXPECT_EQ(keys.size(), 1001);
+  EXPECT_NE(std::find(keys.begin(), keys.end(), 1000), keys.end());
+
+  ASSERT_TRUE(upb_Map_CacheSortedKeys(map, kUpb_CType_Int64, arena.ptr()));
+  EXPECT_TRUE(upb_Map_Delete(map, key, nullptr));
+  EXPECT_EQ(expected, SortedKeys<int64_t>(map, kUpb_FieldType_SInt64));
+
+  ASSERT_TRUE(upb_Map_CacheSortedKeys(map, kUpb_CType_Int64, arena.ptr()));
+  upb_Map_Clear(map);
+  EXPECT_TRUE(SortedKeys<int64_t>(map, kUpb_FieldType_SInt64).empty());
+}
+
+TEST(MapTest, CacheSortedStringKeys) {
+  upb::Arena arena;
+  upb_Map* map = upb_Map_New(arena.ptr(), kUpb_CType_String, kUpb_CType_Bool);
+  std::vector<std::string> strings;
+  for (int i = 0; i < 100; i++) strings.push_back(std::to_string(i * 31 % 97));
+  upb_MessageValue key, val;
+  val.bool_val = true;
+  for (const std::string& str : strings) {
+    key.str_val = upb_StringView_FromDataAndSize(str.data(), str.size());
+    ASSERT_TRUE(upb_Map_Set(map, key, val, arena.ptr()));
+  }
+  std::vector<upb_StringView> expected =
+      SortedKeys<upb_StringView>(map, kUpb_FieldType_String);
+
+  ASSERT_TRUE(upb_Map_CacheSortedKeys(map, kUpb_CType_String, arena.ptr()));
+  std::vector<upb_StringView> cached =
+      SortedKeys<upb_StringView>(map, kUpb_FieldType_Bytes);
+  ASSERT_EQ(expected.size(), cached.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_TRUE(upb_StringView_IsEqual(expected[i], cached[i]));
+  }
+}
@@ -27,6 +27,7 @@
 #include "upb/mini_table/extension.h"
 #include "upb/mini_table/field.h"
 #include "upb/mini_table/internal/field.h"
+#include "upb/mini_table/internal/field_index.h"
 #include "upb/mini_table/internal/message.h"
 #include "upb/mini_table/internal/sub.h"
 #include "upb/mini_table/message.h"
@@ -705,6 +706,38 @@ static void upb_MtDecoder_AssignOffsets(upb_MtDecoder* d) {
       UPB_ALIGN_UP(d->table.UPB_PRIVATE(size), kUpb_Message_Align);
 }
 
+static void upb_MtDecoder_BuildFieldIndex(upb_MtDecoder* d) {
+  const size_t data_size =
+      UPB_PRIVATE(_upb_MiniTableFieldIndex_DataSize)(&d->table);
+  if (data_size == 0) return;
+
+  // The oneof buffer is no longer needed, so use it as scratch space.
+  const size_t scratch_size =
+      UPB_PRIVATE(_upb_MiniTableFieldIndex_ScratchSize)(&d->table);
+  const size_t scratch_bytes = (data_size + scratch_size) * sizeof(uint16_t);
+  if (scratch_bytes > d->oneofs.buf_capacity_bytes) {
+    d->oneofs.data = upb_grealloc(d->oneofs.data, d->oneofs.buf_capacity_bytes,
+                                  scratch_bytes);
+    upb_MdDecoder_CheckOutOfMemory(&d->base, d->oneofs.data);
+    d->oneofs.buf_capacity_bytes = scratch_bytes;
+  }
+  uint16_t* data = (uint16_t*)d->oneofs.data;
+  upb_MiniTableFieldIndex index;
+  if (!UPB_PRIVATE(_upb_MiniTableFieldIndex_Build)(&d->table, data,
+                                                   data + data_size, &index)) {
+    return;  // Lookups fall back to a binary search.
+  }
+
+  const size_t data_bytes = data_size * sizeof(uint16_t);
+  upb_MiniTableFieldIndex* ret =
+      upb_Arena_Malloc(d->arena, sizeof(*ret) + data_bytes);
+  upb_MdDecoder_CheckOutOfMemory(&d->base, ret);
+  *ret = index;
+  memcpy(ret + 1, data, data_bytes);
+  ret->UPB_PRIVATE(data) = (const uint16_t*)(ret + 1);
+  d->table.UPB_PRIVATE(field_index) = ret;
+}
+
 static void upb_MtDecoder_ValidateEntryField(upb_MtDecoder* d,
                                              const upb_MiniTableField* f,
                                              uint32_t expected_num) {
@@ -777,6 +810,7 @@ static void upb_MtDecoder_ParseMessageSet(upb_MtDecoder* d, const char* data,
   ret->UPB_PRIVATE(dense_below) = 0;
   ret->UPB_PRIVATE(table_mask) = -1;
   ret->UPB_PRIVATE(required_count) = 0;
+  ret->UPB_PRIVATE(field_index) = NULL;
 }
 
 static upb_MiniTable* upb_MtDecoder_DoBuildMiniTableWithBuf(
@@ -788,6 +822,7 @@ static upb_MiniTable* upb_MtDecoder_DoBuildMiniTableWithBuf(
   decoder->table.UPB_PRIVATE(dense_below) = 0;
   decoder->table.UPB_PRIVATE(table_mask) = -1;
   decoder->table.UPB_PRIVATE(required_count) = 0;
+  decoder->table.UPB_PRIVATE(field_index) = NULL;
 #ifdef UPB_TRACING_ENABLED
   // MiniTables built from MiniDescriptors will not be able to vend the message
   // name unless it is explicitly set with upb_MiniTable_SetFullName().
@@ -808,6 +843,7 @@ static upb_MiniTable* upb_MtDecoder_DoBuildMiniTableWithBuf(
       upb_MtDecoder_AssignHasbits(decoder);
       upb_MtDecoder_CalculateAlignments(decoder);
       upb_MtDecoder_AssignOffsets(decoder);
+      upb_MtDecoder_BuildFieldIndex(decoder);
       break;
 
     case kUpb_EncodedVersion_MessageSetV1:
@@ -125,6 +125,53 @@ TEST_P(MiniTableTest, Skips) {
   EXPECT_EQ(0, table->UPB_PRIVATE(required_count));
 }
 
+TEST_P(MiniTableTest, SparseFieldsAreIndexed) {
+  upb::Arena arena;
+  upb::MtDataEncoder e;
+  ASSERT_TRUE(e.StartMessage(0));
+  std::vector<uint32_t> field_numbers;
+  for (uint32_t i = 1; i <= 4; i++) field_numbers.push_back(i);
+  for (uint32_t i = 1; i <= 300; i++) field_numbers.push_back(i * i * 37 + 10);
+  for (uint32_t field_number : field_numbers) {
+    ASSERT_TRUE(e.PutField(kUpb_FieldType_Int32, field_number, 0));
+  }
+  upb::Status status;
+  upb_MiniTable* table = _upb_MiniTable_Build(
+      e.data().data(), e.data().size(), GetParam(), arena.ptr(), status.ptr());
+  ASSERT_NE(nullptr, table) << status.error_message();
+  EXPECT_EQ(4, table->UPB_PRIVATE(dense_below));
+  ASSERT_NE(nullptr, table->UPB_PRIVATE(field_index));
+
+  for (size_t i = 0; i < field_numbers.size(); i++) {
+    EXPECT_EQ(&table->UPB_PRIVATE(fields)[i],
+              upb_MiniTable_FindFieldByNumber(table, field_numbers[i]));
+  }
+  for (size_t i = 4; i < field_numbers.size(); i++) {
+    EXPECT_EQ(nullptr,
+              upb_MiniTable_FindFieldByNumber(table, field_numbers[i] + 1));
+    EXPECT_EQ(nullptr,
+              upb_MiniTable_FindFieldByNumber(table, field_numbers[i] - 1));
+  }
+  EXPECT_EQ(nullptr, upb_MiniTable_FindFieldByNumber(table, 0));
+  EXPECT_EQ(nullptr, upb_MiniTable_FindFieldByNumber(table, (1 << 29) - 1));
+}
+
+TEST_P(MiniTableTest, FewSparseFieldsAreNotIndexed) {
+  upb::Arena arena;
+  upb::MtDataEncoder e;
+  ASSERT_TRUE(e.StartMessage(0));
+  for (uint32_t i = 1; i <= 8; i++) {
+    ASSERT_TRUE(e.PutField(kUpb_FieldType_Int32, i * 1000, 0));
+  }
+  upb::Status status;
+  upb_MiniTable* table = _upb_MiniTable_Build(
+      e.data().data(), e.data().size(), GetParam(), arena.ptr(), status.ptr());
+  ASSERT_NE(nullptr, table) << status.error_message();
+  EXPECT_EQ(nullptr, table->UPB_PRIVATE(field_index));
+  EXPECT_NE(nullptr, upb_MiniTable_FindFieldByNumber(table, 3000));
+  EXPECT_EQ(nullptr, upb_MiniTable_FindFieldByNumber(table, 3001));
+}
+
 TEST_P(MiniTableTest, AllScalarTypesOneof) {
   upb::Arena arena;
   upb::MtDataEncoder e;
@@ -58,10 +58,10 @@ bool upb_MiniTable_SetSubMessage(upb_MiniTable* table,
             kUpb_FieldMode_Map;
 
 #if UPB_FASTTABLE
-        // The fasttable decoder cannot decode maps. Unfortunately we do not
-        // know until this moment that the field is a map, so we have to
-        // overwrite the fasttable entry (if any) that we built for this field
-        // previously.
+        // Unfortunately we do not know until this moment that the field is a
+        // map, so we have to overwrite the fasttable entry (if any) that we
+        // built for this field previously. A repeated message parser becomes
+        // the corresponding map parser, which uses the same field data.
         int size = table->UPB_PRIVATE(table_mask) == 0xff
                        ? 0
                        : ((table->UPB_PRIVATE(table_mask) >> 3) + 1);
@@ -69,7 +69,16 @@ bool upb_MiniTable_SetSubMessage(upb_MiniTable* table,
           _upb_FastTable_Entry* entry = &table->UPB_PRIVATE(fasttable)[i];
           uint32_t field_number = (((int)entry->field_data >> 3) & 0xf) |
                                   (((int)entry->field_data >> 4) & 0x7f0);
-          if (field_number == upb_MiniTableField_Number(field)) {
+          if (field_number != upb_MiniTableField_Number(field)) continue;
+          if (entry->field_parser ==
+              &UPB_DECODEFAST_FUNCNAME(Message, Repeated, Tag1Byte)) {
+            entry->field_parser =
+                &UPB_DECODEFAST_FUNCNAME(Map, Repeated, Tag1Byte);
+          } else if (entry->field_parser ==
+                     &UPB_DECODEFAST_FUNCNAME(Message, Repeated, Tag2Byte)) {
+            entry->field_parser =
+                &UPB_DECODEFAST_FUNCNAME(Map, Repeated, Tag2Byte);
+          } else {
             entry->field_parser = &_upb_FastDecoder_DecodeGeneric;
             entry->field_data = 0;
           }
@@ -0,0 +1,201 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "upb/mini_table/internal/field_index.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "upb/base/internal/log2.h"
+#include "upb/mini_table/internal/field.h"
+#include "upb/mini_table/internal/message.h"
+
+// Must be last.
+#include "upb/port/def.inc"
+
+// The index is a "hash and displace" perfect hash.  Each field number is
+// hashed with a single multiply; the top bits of the product pick a bucket and
+// bits [16, 32) pick a starting slot.  Buckets are placed largest first, and
+// each bucket gets the smallest displacement that moves all of its fields into
+// free slots.  There are twice as many slots as fields (rounded up to a power
+// of two), and on average 2-4 fields per bucket, so this almost always
+// succeeds with the first multiplier.
+
+enum {
+  // Slot indexes and displacements must fit in a uint16_t.
+  kUpb_FieldIndex_MaxSlotsLg2 = 16,
+
+  // Number of multipliers to try before giving up on an index.
+  kUpb_FieldIndex_MaxAttempts = 16,
+};
+
+typedef struct {
+  uint32_t lo;  // First indexed field (dense_below).
+  uint32_t n;   // Number of indexed fields.
+  int slots_lg2;
+  int buckets_lg2;
+} upb_FieldIndexShape;
+
+static bool upb_FieldIndex_GetShape(const struct upb_MiniTable* m,
+                                    upb_FieldIndexShape* shape) {
+  shape->lo = m->UPB_PRIVATE(dense_below);
+  shape->n = m->UPB_ONLYBITS(field_count) - shape->lo;
+  if (shape->n < kUpb_FieldIndex_MinFields) return false;
+  int lg2 = upb_Log2Ceiling(shape->n);
+  shape->slots_lg2 = lg2 + 1;
+  shape->buckets_lg2 = lg2 - 1;
+  return shape->slots_lg2 <= kUpb_FieldIndex_MaxSlotsLg2;
+}
+
+size_t UPB_PRIVATE(_upb_MiniTableFieldIndex_DataSize)(
+    const struct upb_MiniTable* m) {
+  upb_FieldIndexShape shape;
+  if (!upb_FieldIndex_GetShape(m, &shape)) return 0;
+  return ((size_t)1 << shape.buckets_lg2) + ((size_t)1 << shape.slots_lg2);
+}
+
+size_t UPB_PRIVATE(_upb_MiniTableFieldIndex_ScratchSize)(
+    const struct upb_MiniTable* m) {
+  upb_FieldIndexShape shape;
+  if (!upb_FieldIndex_GetShape(m, &shape)) return 0;
+  // The fields grouped by bucket, and the start of each bucket in that list.
+  return shape.n + ((size_t)1 << shape.buckets_lg2) + 1;
+}
+
+// Deterministic, so that generated code is stable across runs (splitmix64).
+static uint64_t upb_FieldIndex_Multiplier(int attempt) {
+  uint64_t z = (uint64_t)(attempt + 1) * 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return (z ^ (z >> 31)) | 1;
+}
+
+typedef struct {
+  const struct upb_MiniTable* m;
+  upb_FieldIndexShape shape;
+  uint64_t mul;
+  uint16_t* disp;
+  uint16_t* slots;
+  uint16_t* keys;
+  uint16_t* starts;
+} upb_FieldIndexBuilder;
+
+static uint64_t upb_FieldIndexBuilder_Hash(const upb_FieldIndexBuilder* b,
+                                           uint16_t field) {
+  return b->m->UPB_ONLYBITS(fields)[field].UPB_ONLYBITS(number) * b->mul;
+}
+
+static uint32_t upb_FieldIndexBuilder_Bucket(const upb_FieldIndexBuilder* b,
+                                             uint16_t field) {
+  return (uint32_t)(upb_FieldIndexBuilder_Hash(b, field) >>
+                    (64 - b->shape.buckets_lg2));
+}
+
+static uint32_t upb_FieldIndexBuilder_Pos(const upb_FieldIndexBuilder* b,
+                                          uint16_t field) {
+  return (uint32_t)(upb_FieldIndexBuilder_Hash(b, field) >> 16);
+}
+
+// Groups the fields by bucket into `keys`, and returns the largest bucket.
+static uint32_t upb_FieldIndexBuilder_GroupFields(upb_FieldIndexBuilder* b) {
+  const uint32_t buckets = 1 << b->shape.buckets_lg2;
+  const uint32_t lo = b->shape.lo;
+  const uint32_t hi = lo + b->shape.n;
+  memset(b->starts, 0, (buckets + 1) * sizeof(*b->starts));
+  for (uint32_t i = lo; i < hi; i++) {
+    b->starts[upb_FieldIndexBuilder_Bucket(b, i) + 1]++;
+  }
+  uint32_t max = 0;
+  for (uint32_t i = 0; i < buckets; i++) {
+    max = UPB_MAX(max, b->starts[i + 1]);
+    b->starts[i + 1] += b->starts[i];
+  }
+  // The displacements are not computed yet, so use them as fill cursors.
+  memcpy(b->disp, b->starts, buckets * sizeof(*b->disp));
+  for (uint32_t i = lo; i < hi; i++) {
+    b->keys[b->disp[upb_FieldIndexBuilder_Bucket(b, i)]++] = i;
+  }
+  return max;
+}
+
+// Finds the smallest displacement that moves every field in `bucket` into a
+// free slot, and claims those slots.
+static bool upb_FieldIndexBuilder_Place(upb_FieldIndexBuilder* b,
+                                        uint32_t bucket) {
+  const uint16_t* keys = &b->keys[b->starts[bucket]];
+  const uint32_t count = b->starts[bucket + 1] - b->starts[bucket];
+  const uint32_t mask = (1 << b->shape.slots_lg2) - 1;
+
+  // Fields with the same starting slot can never be separated.
+  for (uint32_t i = 0; i < count; i++) {
+    for (uint32_t j = 0; j < i; j++) {
+      if (((upb_FieldIndexBuilder_Pos(b, keys[i]) ^
+            upb_FieldIndexBuilder_Pos(b, keys[j])) &
+           mask) == 0) {
+        return false;
+      }
+    }
+  }
+
+  for (uint32_t d = 0; d <= mask; d++) {
+    uint32_t i;
+    for (i = 0; i < count; i++) {
+      uint32_t slot = (upb_FieldIndexBuilder_Pos(b, keys[i]) + d) & mask;
+      if (b->slots[slot] != kUpb_FieldIndex_EmptySlot) break;
+    }
+    if (i < count) continue;
+    for (i = 0; i < count; i++) {
+      uint32_t slot = (upb_FieldIndexBuilder_Pos(b, keys[i]) + d) & mask;
+      b->slots[slot] = keys[i];
+    }
+    b->disp[bucket] = d;
+    return true;
+  }
+  return false;
+}
+
+static bool upb_FieldIndexBuilder_TryBuild(upb_FieldIndexBuilder* b) {
+  const uint32_t buckets = 1 << b->shape.buckets_lg2;
+  const uint32_t max = upb_FieldIndexBuilder_GroupFields(b);
+  memset(b->disp, 0, buckets * sizeof(*b->disp));
+  memset(b->slots, 0xff, (1 << b->shape.slots_lg2) * sizeof(*b->slots));
+  UPB_STATIC_ASSERT(kUpb_FieldIndex_EmptySlot == 0xffff, "memset above");
+
+  for (uint32_t size = max; size > 0; size--) {
+    for (uint32_t i = 0; i < buckets; i++) {
+      if (b->starts[i + 1] - b->starts[i] != size) continue;
+      if (!upb_FieldIndexBuilder_Place(b, i)) return false;
+    }
+  }
+  return true;
+}
+
+bool UPB_PRIVATE(_upb_MiniTableFieldIndex_Build)(
+    const struct upb_MiniTable* m, uint16_t* data, uint16_t* scratch,
+    struct upb_MiniTableFieldIndex* index) {
+  upb_FieldIndexBuilder b;
+  if (!upb_FieldIndex_GetShape(m, &b.shape)) return false;
+  const uint32_t buckets = 1 << b.shape.buckets_lg2;
+  b.m = m;
+  b.disp = data;
+  b.slots = data + buckets;
+  b.keys = scratch;
+  b.starts = scratch + b.shape.n;
+
+  for (int attempt = 0; attempt < kUpb_FieldIndex_MaxAttempts; attempt++) {
+    b.mul = upb_FieldIndex_Multiplier(attempt);
+    if (!upb_FieldIndexBuilder_TryBuild(&b)) continue;
+    index->UPB_PRIVATE(data) = data;
+    index->UPB_PRIVATE(mul) = b.mul;
+    index->UPB_PRIVATE(bucket_count) = buckets;
+    index->UPB_PRIVATE(slot_mask) = (1 << b.shape.slots_lg2) - 1;
+    index->UPB_PRIVATE(bucket_shift) = 64 - b.shape.buckets_lg2;
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,57 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef UPB_MINI_TABLE_INTERNAL_FIELD_INDEX_H_
+#define UPB_MINI_TABLE_INTERNAL_FIELD_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "upb/mini_table/internal/message.h"
+
+// Must be last.
+#include "upb/port/def.inc"
+
+// Builds the optional upb_MiniTableFieldIndex for a MiniTable.  This is used
+// both by upb_MiniTable_Build() and by the MiniTable code generator, so the
+// result depends only on the field numbers and never on the platform.
+
+enum {
+  // Below this many fields above `dense_below`, a binary search is at least as
+  // fast as a hash lookup, so no index is built.
+  kUpb_FieldIndex_MinFields = 16,
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Returns the number of uint16_t entries of index data that `m` needs, or 0 if
+// `m` should not have an index.
+size_t UPB_PRIVATE(_upb_MiniTableFieldIndex_DataSize)(
+    const struct upb_MiniTable* m);
+
+// Returns the number of uint16_t entries of scratch space needed to build the
+// index for `m`.
+size_t UPB_PRIVATE(_upb_MiniTableFieldIndex_ScratchSize)(
+    const struct upb_MiniTable* m);
+
+// Builds an index for `m` into `data` and `index`, using `scratch` as working
+// space.  `data` and `scratch` must be sized as above, and `index->data` is set
+// to `data`.  Returns false if no collision-free index was found, in which case
+// `m` should be left without one.
+bool UPB_PRIVATE(_upb_MiniTableFieldIndex_Build)(
+    const struct upb_MiniTable* m, uint16_t* data, uint16_t* scratch,
+    struct upb_MiniTableFieldIndex* index);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#include "upb/port/undef.inc"
+
+#endif /* UPB_MINI_TABLE_INTERNAL_FIELD_INDEX_H_ */
@@ -26,4 +26,5 @@ const struct upb_MiniTable UPB_PRIVATE(_kUpb_MiniTable_StaticallyTreeShaken) = {
     .UPB_PRIVATE(dense_below) = 0,
     .UPB_PRIVATE(table_mask) = -1,
     .UPB_PRIVATE(required_count) = 0,
+    .UPB_PRIVATE(field_index) = NULL,
 };
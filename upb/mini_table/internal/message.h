@@ -63,6 +63,29 @@ enum {
   kUpb_Message_Align = 8,
 };
 
+// An optional perfect-hash index over the fields of a MiniTable that are not
+// covered by `dense_below`.  Messages with many sparsely numbered fields use it
+// instead of a binary search.
+//
+// Lookups hash the field number once.  The top bits select a bucket, whose
+// displacement is added to the low bits to select a slot; every field in the
+// index lands in a different slot.  See field_index.c for how it is built.
+struct upb_MiniTableFieldIndex {
+  // `bucket_count` displacements followed by `slot_mask + 1` slots.  A slot
+  // holds an index into the MiniTable's fields, or kUpb_FieldIndex_EmptySlot.
+  const uint16_t* UPB_PRIVATE(data);
+  uint64_t UPB_PRIVATE(mul);
+  uint16_t UPB_PRIVATE(bucket_count);
+  uint16_t UPB_PRIVATE(slot_mask);
+  uint8_t UPB_PRIVATE(bucket_shift);  // 64 - lg2(bucket_count)
+};
+
+typedef struct upb_MiniTableFieldIndex upb_MiniTableFieldIndex;
+
+enum {
+  kUpb_FieldIndex_EmptySlot = 0xffff,
+};
+
 // upb_MiniTable represents the memory layout of a given upb_MessageDef.
 // The members are public so generated code can initialize them,
 // but users MUST NOT directly read or write any of its members.
@@ -82,6 +105,9 @@ struct upb_MiniTable {
   uint8_t UPB_PRIVATE(table_mask);
   uint8_t UPB_PRIVATE(required_count);  // Required fields have the low hasbits.
 
+  // Optional; NULL if lookups above `dense_below` use a binary search.
+  const struct upb_MiniTableFieldIndex* UPB_PRIVATE(field_index);
+
 #ifdef UPB_TRACING_ENABLED
   const char* UPB_PRIVATE(full_name);
 #endif
@@ -285,6 +311,21 @@ UPB_FORCEINLINE const struct upb_MiniTableField* UPB_PRIVATE(
 #endif
 }
 
+UPB_FORCEINLINE const struct upb_MiniTableField* UPB_PRIVATE(
+    upb_MiniTable_IndexLookup)(const struct upb_MiniTable* m,
+                               const struct upb_MiniTableFieldIndex* index,
+                               uint32_t number) {
+  const uint64_t h = number * index->UPB_PRIVATE(mul);
+  const uint16_t* data = index->UPB_PRIVATE(data);
+  const uint32_t disp = data[h >> index->UPB_PRIVATE(bucket_shift)];
+  const uint32_t slot =
+      ((uint32_t)(h >> 16) + disp) & index->UPB_PRIVATE(slot_mask);
+  const uint16_t i = data[index->UPB_PRIVATE(bucket_count) + slot];
+  if (i == kUpb_FieldIndex_EmptySlot) return NULL;
+  const struct upb_MiniTableField* f = &m->UPB_ONLYBITS(fields)[i];
+  return f->UPB_ONLYBITS(number) == number ? f : NULL;
+}
+
 UPB_API_INLINE
 const struct upb_MiniTableField* upb_MiniTable_FindFieldByNumber(
     const struct upb_MiniTable* m, uint32_t number) {
@@ -296,6 +337,12 @@ const struct upb_MiniTableField* upb_MiniTable_FindFieldByNumber(
     return &m->UPB_ONLYBITS(fields)[i];
   }
 
+  // Sparse messages may have a perfect-hash index for the remaining fields.
+  const struct upb_MiniTableFieldIndex* index = m->UPB_PRIVATE(field_index);
+  if (index) {
+    return UPB_PRIVATE(upb_MiniTable_IndexLookup)(m, index, number);
+  }
+
   // Early exit if the field number is out of range.
   uint32_t hi = m->UPB_ONLYBITS(field_count);
   uint32_t lo = m->UPB_PRIVATE(dense_below);
@@ -1,14 +1,29 @@
 #include <cstdint>
 #include <random>
+#include <string>
 
 #include <benchmark/benchmark.h>
 #include "absl/random/random.h"
+#include "upb/mem/arena.hpp"
+#include "upb/message/message.h"
 #include "upb/mini_table/field.h"
+#include "upb/mini_table/internal/message.h"
 #include "upb/mini_table/message.h"
 #include "upb/mini_table/message_benchmark.upb_minitable.h"
+#include "upb/wire/decode.h"
 #include "upb/port/def.inc"
 
 namespace {
+
+// Returns a copy of `mt` that looks up fields by binary search, to compare
+// against the perfect-hash index.  The fasttable is not copied.
+upb_MiniTable WithoutFieldIndex(const upb_MiniTable* mt) {
+  upb_MiniTable ret = *mt;
+  ret.UPB_PRIVATE(field_index) = nullptr;
+  ret.UPB_PRIVATE(table_mask) = (uint8_t)-1;
+  return ret;
+}
+
 static void BM_FindFieldByNumber(benchmark::State& state) {
   uint32_t min, max;
   switch (state.range(0)) {
@@ -25,8 +40,12 @@ static void BM_FindFieldByNumber(benchmark::State& state) {
       max = 570;  // some unknowns
       break;
   }
+  upb_MiniTable no_index = WithoutFieldIndex(
+      &third_0party_0upb_0upb_0mini_0table__TestManyFields_msg_init);
   const upb_MiniTable* ptr =
-      &third_0party_0upb_0upb_0mini_0table__TestManyFields_msg_init;
+      state.range(1)
+          ? &third_0party_0upb_0upb_0mini_0table__TestManyFields_msg_init
+          : &no_index;
   std::seed_seq seq{1, 2, 3};
   benchmark::DoNotOptimize(seq);
   absl::BitGen bitgen(seq);
@@ -44,6 +63,62 @@ static void BM_FindFieldByNumber(benchmark::State& state) {
     }
   }
 }
-BENCHMARK(BM_FindFieldByNumber)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK(BM_FindFieldByNumber)
+    ->ArgsProduct({{0, 1, 2}, {0, 1}})
+    ->ArgNames({"range", "index"});
+
+static void BM_FindFieldByNumberSparse(benchmark::State& state) {
+  const upb_MiniTable* mt =
+      &third_0party_0upb_0upb_0mini_0table__TestSparseFields_msg_init;
+  upb_MiniTable no_index = WithoutFieldIndex(mt);
+  const upb_MiniTable* ptr = state.range(0) ? mt : &no_index;
+  std::seed_seq seq{1, 2, 3};
+  absl::BitGen bitgen(seq);
+  uint32_t search[1024];
+  for (auto& s : search) {
+    int i = absl::Uniform(bitgen, 0, upb_MiniTable_FieldCount(mt));
+    s = upb_MiniTableField_Number(upb_MiniTable_GetFieldByIndex(mt, i));
+  }
+  uint32_t i = 0;
+  for (auto _ : state) {
+    const upb_MiniTableField* field =
+        upb_MiniTable_FindFieldByNumber(ptr, search[(i++ % 1024)]);
+    benchmark::DoNotOptimize(field);
+  }
+}
+BENCHMARK(BM_FindFieldByNumberSparse)->Arg(0)->Arg(1)->ArgName("index");
+
+void AppendVarint(std::string* out, uint64_t val) {
+  do {
+    uint8_t byte = val & 0x7f;
+    val >>= 7;
+    out->push_back(static_cast<char>(val ? byte | 0x80 : byte));
+  } while (val);
+}
+
+// Decodes a payload that sets every field of a sparsely numbered message, none
+// of which can be handled by the fasttable.
+static void BM_DecodeSparse(benchmark::State& state) {
+  const upb_MiniTable* mt =
+      &third_0party_0upb_0upb_0mini_0table__TestSparseFields_msg_init;
+  upb_MiniTable no_index = WithoutFieldIndex(mt);
+  const upb_MiniTable* ptr = state.range(0) ? mt : &no_index;
+  std::string payload;
+  for (int i = 0; i < upb_MiniTable_FieldCount(mt); i++) {
+    const upb_MiniTableField* f = upb_MiniTable_GetFieldByIndex(mt, i);
+    AppendVarint(&payload, upb_MiniTableField_Number(f) << 3);
+    AppendVarint(&payload, i);
+  }
+  for (auto _ : state) {
+    upb::Arena arena;
+    upb_Message* msg = upb_Message_New(ptr, arena.ptr());
+    upb_DecodeStatus status =
+        upb_Decode(payload.data(), payload.size(), msg, ptr, nullptr, 0,
+                   arena.ptr());
+    if (status != kUpb_DecodeStatus_Ok) state.SkipWithError("decode failed");
+  }
+  state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK(BM_DecodeSparse)->Arg(0)->Arg(1)->ArgName("index");
 
 }  // namespace
@@ -29,6 +29,7 @@ static const google__protobuf__FileDescriptorSet_msg_init_Fields google_protobuf
 const upb_MiniTable google__protobuf__FileDescriptorSet_msg_init = {
   &google_protobuf_FileDescriptorSet__fields.fields[0],
   16, 1, kUpb_ExtMode_Extendable, 1, UPB_FASTTABLE_MASK(8), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.FileDescriptorSet",
 #endif
@@ -72,6 +73,7 @@ static const google__protobuf__FileDescriptorProto_msg_init_Fields google_protob
 const upb_MiniTable google__protobuf__FileDescriptorProto_msg_init = {
   &google_protobuf_FileDescriptorProto__fields.fields[0],
   UPB_SIZE(80, 144), 14, kUpb_ExtMode_NonExtendable, 12, UPB_FASTTABLE_MASK(120), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.FileDescriptorProto",
 #endif
@@ -128,6 +130,7 @@ static const google__protobuf__DescriptorProto_msg_init_Fields google_protobuf_D
 const upb_MiniTable google__protobuf__DescriptorProto_msg_init = {
   &google_protobuf_DescriptorProto__fields.fields[0],
   UPB_SIZE(64, 104), 11, kUpb_ExtMode_NonExtendable, 11, UPB_FASTTABLE_MASK(120), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.DescriptorProto",
 #endif
@@ -168,6 +171,7 @@ static const google__protobuf__DescriptorProto__ExtensionRange_msg_init_Fields g
 const upb_MiniTable google__protobuf__DescriptorProto__ExtensionRange_msg_init = {
   &google_protobuf_DescriptorProto_ExtensionRange__fields.fields[0],
   UPB_SIZE(24, 32), 3, kUpb_ExtMode_NonExtendable, 3, UPB_FASTTABLE_MASK(24), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.DescriptorProto.ExtensionRange",
 #endif
@@ -191,6 +195,7 @@ static const google__protobuf__DescriptorProto__ReservedRange_msg_init_Fields go
 const upb_MiniTable google__protobuf__DescriptorProto__ReservedRange_msg_init = {
   &google_protobuf_DescriptorProto_ReservedRange__fields.fields[0],
   24, 2, kUpb_ExtMode_NonExtendable, 2, UPB_FASTTABLE_MASK(24), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.DescriptorProto.ReservedRange",
 #endif
@@ -223,6 +228,7 @@ static const google__protobuf__ExtensionRangeOptions_msg_init_Fields google_prot
 const upb_MiniTable google__protobuf__ExtensionRangeOptions_msg_init = {
   &google_protobuf_ExtensionRangeOptions__fields.fields[0],
   UPB_SIZE(32, 40), 4, kUpb_ExtMode_Extendable, 0, UPB_FASTTABLE_MASK(248), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.ExtensionRangeOptions",
 #endif
@@ -277,6 +283,7 @@ static const google__protobuf__ExtensionRangeOptions__Declaration_msg_init_Field
 const upb_MiniTable google__protobuf__ExtensionRangeOptions__Declaration_msg_init = {
   &google_protobuf_ExtensionRangeOptions_Declaration__fields.fields[0],
   UPB_SIZE(32, 48), 5, kUpb_ExtMode_NonExtendable, 3, UPB_FASTTABLE_MASK(56), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.ExtensionRangeOptions.Declaration",
 #endif
@@ -319,6 +326,7 @@ static const google__protobuf__FieldDescriptorProto_msg_init_Fields google_proto
 const upb_MiniTable google__protobuf__FieldDescriptorProto_msg_init = {
   &google_protobuf_FieldDescriptorProto__fields.fields[0],
   UPB_SIZE(72, 120), 11, kUpb_ExtMode_NonExtendable, 10, UPB_FASTTABLE_MASK(248), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.FieldDescriptorProto",
 #endif
@@ -374,6 +382,7 @@ static const google__protobuf__OneofDescriptorProto_msg_init_Fields google_proto
 const upb_MiniTable google__protobuf__OneofDescriptorProto_msg_init = {
   &google_protobuf_OneofDescriptorProto__fields.fields[0],
   UPB_SIZE(24, 40), 2, kUpb_ExtMode_NonExtendable, 2, UPB_FASTTABLE_MASK(24), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.OneofDescriptorProto",
 #endif
@@ -408,6 +417,7 @@ static const google__protobuf__EnumDescriptorProto_msg_init_Fields google_protob
 const upb_MiniTable google__protobuf__EnumDescriptorProto_msg_init = {
   &google_protobuf_EnumDescriptorProto__fields.fields[0],
   UPB_SIZE(40, 64), 6, kUpb_ExtMode_NonExtendable, 6, UPB_FASTTABLE_MASK(56), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.EnumDescriptorProto",
 #endif
@@ -435,6 +445,7 @@ static const google__protobuf__EnumDescriptorProto__EnumReservedRange_msg_init_F
 const upb_MiniTable google__protobuf__EnumDescriptorProto__EnumReservedRange_msg_init = {
   &google_protobuf_EnumDescriptorProto_EnumReservedRange__fields.fields[0],
   24, 2, kUpb_ExtMode_NonExtendable, 2, UPB_FASTTABLE_MASK(24), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.EnumDescriptorProto.EnumReservedRange",
 #endif
@@ -463,6 +474,7 @@ static const google__protobuf__EnumValueDescriptorProto_msg_init_Fields google_p
 const upb_MiniTable google__protobuf__EnumValueDescriptorProto_msg_init = {
   &google_protobuf_EnumValueDescriptorProto__fields.fields[0],
   UPB_SIZE(32, 40), 3, kUpb_ExtMode_NonExtendable, 3, UPB_FASTTABLE_MASK(24), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.EnumValueDescriptorProto",
 #endif
@@ -492,6 +504,7 @@ static const google__protobuf__ServiceDescriptorProto_msg_init_Fields google_pro
 const upb_MiniTable google__protobuf__ServiceDescriptorProto_msg_init = {
   &google_protobuf_ServiceDescriptorProto__fields.fields[0],
   UPB_SIZE(32, 48), 3, kUpb_ExtMode_NonExtendable, 3, UPB_FASTTABLE_MASK(24), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.ServiceDescriptorProto",
 #endif
@@ -523,6 +536,7 @@ static const google__protobuf__MethodDescriptorProto_msg_init_Fields google_prot
 const upb_MiniTable google__protobuf__MethodDescriptorProto_msg_init = {
   &google_protobuf_MethodDescriptorProto__fields.fields[0],
   UPB_SIZE(40, 72), 6, kUpb_ExtMode_NonExtendable, 6, UPB_FASTTABLE_MASK(56), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.MethodDescriptorProto",
 #endif
@@ -572,9 +586,27 @@ static const google__protobuf__FileOptions_msg_init_Fields google_protobuf_FileO
   {.UPB_PRIVATE(submsg) = &google__protobuf__UninterpretedOption_msg_init},
 }};
 
+static const uint16_t google_protobuf_FileOptions__field_index_data[80] = {
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+  0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x0010, 0xffff, 0x0004,
+  0xffff, 0xffff, 0x000e, 0xffff, 0x0002, 0x0014, 0x000d, 0xffff,
+  0xffff, 0xffff, 0x0013, 0xffff, 0x0008, 0xffff, 0xffff, 0xffff,
+  0x0007, 0xffff, 0xffff, 0x000b, 0x0005, 0xffff, 0xffff, 0x0011,
+  0xffff, 0xffff, 0xffff, 0xffff, 0x000a, 0xffff, 0xffff, 0xffff,
+  0x000f, 0xffff, 0x0003, 0xffff, 0xffff, 0x0009, 0x0001, 0xffff,
+  0x000c, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+  0xffff, 0xffff, 0x0006, 0xffff, 0xffff, 0x0012, 0xffff, 0xffff,
+};
+
+static const upb_MiniTableFieldIndex google_protobuf_FileOptions__field_index = {
+  &google_protobuf_FileOptions__field_index_data[0], UINT64_C(0xe220a8397b1dcdaf), 16, 63, 60,
+};
+
 const upb_MiniTable google__protobuf__FileOptions_msg_init = {
   &google_protobuf_FileOptions__fields.fields[0],
   UPB_SIZE(112, 200), 21, kUpb_ExtMode_Extendable, 1, UPB_FASTTABLE_MASK(248), 0,
+  &google_protobuf_FileOptions__field_index,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.FileOptions",
 #endif
@@ -636,6 +668,7 @@ static const google__protobuf__MessageOptions_msg_init_Fields google_protobuf_Me
 const upb_MiniTable google__protobuf__MessageOptions_msg_init = {
   &google_protobuf_MessageOptions__fields.fields[0],
   UPB_SIZE(24, 32), 7, kUpb_ExtMode_Extendable, 3, UPB_FASTTABLE_MASK(248), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.MessageOptions",
 #endif
@@ -710,6 +743,7 @@ static const google__protobuf__FieldOptions_msg_init_Fields google_protobuf_Fiel
 const upb_MiniTable google__protobuf__FieldOptions_msg_init = {
   &google_protobuf_FieldOptions__fields.fields[0],
   UPB_SIZE(48, 72), 14, kUpb_ExtMode_Extendable, 3, UPB_FASTTABLE_MASK(248), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.FieldOptions",
 #endif
@@ -765,6 +799,7 @@ static const google__protobuf__FieldOptions__EditionDefault_msg_init_Fields goog
 const upb_MiniTable google__protobuf__FieldOptions__EditionDefault_msg_init = {
   &google_protobuf_FieldOptions_EditionDefault__fields.fields[0],
   UPB_SIZE(24, 32), 2, kUpb_ExtMode_NonExtendable, 0, UPB_FASTTABLE_MASK(24), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.FieldOptions.EditionDefault",
 #endif
@@ -797,6 +832,7 @@ static const google__protobuf__FieldOptions__FeatureSupport_msg_init_Fields goog
 const upb_MiniTable google__protobuf__FieldOptions__FeatureSupport_msg_init = {
   &google_protobuf_FieldOptions_FeatureSupport__fields.fields[0],
   UPB_SIZE(40, 56), 5, kUpb_ExtMode_NonExtendable, 5, UPB_FASTTABLE_MASK(56), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.FieldOptions.FeatureSupport",
 #endif
@@ -829,6 +865,7 @@ static const google__protobuf__OneofOptions_msg_init_Fields google_protobuf_Oneo
 const upb_MiniTable google__protobuf__OneofOptions_msg_init = {
   &google_protobuf_OneofOptions__fields.fields[0],
   UPB_SIZE(24, 32), 2, kUpb_ExtMode_Extendable, 1, UPB_FASTTABLE_MASK(248), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.OneofOptions",
 #endif
@@ -888,6 +925,7 @@ static const google__protobuf__EnumOptions_msg_init_Fields google_protobuf_EnumO
 const upb_MiniTable google__protobuf__EnumOptions_msg_init = {
   &google_protobuf_EnumOptions__fields.fields[0],
   UPB_SIZE(24, 32), 5, kUpb_ExtMode_Extendable, 0, UPB_FASTTABLE_MASK(248), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.EnumOptions",
 #endif
@@ -948,6 +986,7 @@ static const google__protobuf__EnumValueOptions_msg_init_Fields google_protobuf_
 const upb_MiniTable google__protobuf__EnumValueOptions_msg_init = {
   &google_protobuf_EnumValueOptions__fields.fields[0],
   UPB_SIZE(24, 40), 5, kUpb_ExtMode_Extendable, 4, UPB_FASTTABLE_MASK(248), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.EnumValueOptions",
 #endif
@@ -1005,6 +1044,7 @@ static const google__protobuf__ServiceOptions_msg_init_Fields google_protobuf_Se
 const upb_MiniTable google__protobuf__ServiceOptions_msg_init = {
   &google_protobuf_ServiceOptions__fields.fields[0],
   UPB_SIZE(24, 32), 3, kUpb_ExtMode_Extendable, 0, UPB_FASTTABLE_MASK(248), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.ServiceOptions",
 #endif
@@ -1064,6 +1104,7 @@ static const google__protobuf__MethodOptions_msg_init_Fields google_protobuf_Met
 const upb_MiniTable google__protobuf__MethodOptions_msg_init = {
   &google_protobuf_MethodOptions__fields.fields[0],
   UPB_SIZE(24, 32), 4, kUpb_ExtMode_Extendable, 0, UPB_FASTTABLE_MASK(248), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.MethodOptions",
 #endif
@@ -1124,6 +1165,7 @@ static const google__protobuf__UninterpretedOption_msg_init_Fields google_protob
 const upb_MiniTable google__protobuf__UninterpretedOption_msg_init = {
   &google_protobuf_UninterpretedOption__fields.fields[0],
   UPB_SIZE(64, 96), 7, kUpb_ExtMode_NonExtendable, 0, UPB_FASTTABLE_MASK(120), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.UninterpretedOption",
 #endif
@@ -1159,6 +1201,7 @@ static const google__protobuf__UninterpretedOption__NamePart_msg_init_Fields goo
 const upb_MiniTable google__protobuf__UninterpretedOption__NamePart_msg_init = {
   &google_protobuf_UninterpretedOption_NamePart__fields.fields[0],
   UPB_SIZE(24, 32), 2, kUpb_ExtMode_NonExtendable, 2, UPB_FASTTABLE_MASK(24), 2,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.UninterpretedOption.NamePart",
 #endif
@@ -1201,6 +1244,7 @@ static const google__protobuf__FeatureSet_msg_init_Fields google_protobuf_Featur
 const upb_MiniTable google__protobuf__FeatureSet_msg_init = {
   &google_protobuf_FeatureSet__fields.fields[0],
   48, 9, kUpb_ExtMode_Extendable, 9, UPB_FASTTABLE_MASK(120), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.FeatureSet",
 #endif
@@ -1227,6 +1271,7 @@ const upb_MiniTable google__protobuf__FeatureSet_msg_init = {
 const upb_MiniTable google__protobuf__FeatureSet__VisibilityFeature_msg_init = {
   NULL,
   8, 0, kUpb_ExtMode_NonExtendable, 0, UPB_FASTTABLE_MASK(255), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.FeatureSet.VisibilityFeature",
 #endif
@@ -1235,6 +1280,7 @@ const upb_MiniTable google__protobuf__FeatureSet__VisibilityFeature_msg_init = {
 const upb_MiniTable google__protobuf__FeatureSet__ProtoLimitsFeature_msg_init = {
   NULL,
   8, 0, kUpb_ExtMode_NonExtendable, 0, UPB_FASTTABLE_MASK(255), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.FeatureSet.ProtoLimitsFeature",
 #endif
@@ -1259,6 +1305,7 @@ static const google__protobuf__FeatureSetDefaults_msg_init_Fields google_protobu
 const upb_MiniTable google__protobuf__FeatureSetDefaults_msg_init = {
   &google_protobuf_FeatureSetDefaults__fields.fields[0],
   UPB_SIZE(24, 32), 3, kUpb_ExtMode_NonExtendable, 1, UPB_FASTTABLE_MASK(56), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.FeatureSetDefaults",
 #endif
@@ -1293,6 +1340,7 @@ static const google__protobuf__FeatureSetDefaults__FeatureSetEditionDefault_msg_
 const upb_MiniTable google__protobuf__FeatureSetDefaults__FeatureSetEditionDefault_msg_init = {
   &google_protobuf_FeatureSetDefaults_FeatureSetEditionDefault__fields.fields[0],
   UPB_SIZE(24, 32), 3, kUpb_ExtMode_NonExtendable, 0, UPB_FASTTABLE_MASK(56), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.FeatureSetDefaults.FeatureSetEditionDefault",
 #endif
@@ -1323,6 +1371,7 @@ static const google__protobuf__SourceCodeInfo_msg_init_Fields google_protobuf_So
 const upb_MiniTable google__protobuf__SourceCodeInfo_msg_init = {
   &google_protobuf_SourceCodeInfo__fields.fields[0],
   16, 1, kUpb_ExtMode_Extendable, 1, UPB_FASTTABLE_MASK(8), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.SourceCodeInfo",
 #endif
@@ -1347,6 +1396,7 @@ static const google__protobuf__SourceCodeInfo__Location_msg_init_Fields google_p
 const upb_MiniTable google__protobuf__SourceCodeInfo__Location_msg_init = {
   &google_protobuf_SourceCodeInfo_Location__fields.fields[0],
   UPB_SIZE(40, 72), 5, kUpb_ExtMode_NonExtendable, 4, UPB_FASTTABLE_MASK(56), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.SourceCodeInfo.Location",
 #endif
@@ -1377,6 +1427,7 @@ static const google__protobuf__GeneratedCodeInfo_msg_init_Fields google_protobuf
 const upb_MiniTable google__protobuf__GeneratedCodeInfo_msg_init = {
   &google_protobuf_GeneratedCodeInfo__fields.fields[0],
   16, 1, kUpb_ExtMode_NonExtendable, 1, UPB_FASTTABLE_MASK(8), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.GeneratedCodeInfo",
 #endif
@@ -1405,6 +1456,7 @@ static const google__protobuf__GeneratedCodeInfo__Annotation_msg_init_Fields goo
 const upb_MiniTable google__protobuf__GeneratedCodeInfo__Annotation_msg_init = {
   &google_protobuf_GeneratedCodeInfo_Annotation__fields.fields[0],
   UPB_SIZE(40, 48), 5, kUpb_ExtMode_NonExtendable, 5, UPB_FASTTABLE_MASK(56), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.GeneratedCodeInfo.Annotation",
 #endif
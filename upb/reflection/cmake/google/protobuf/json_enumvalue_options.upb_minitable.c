@@ -26,6 +26,7 @@ static const pb__enumvalue__JsonEnumValueOptions_msg_init_Fields pb_enumvalue_Js
 const upb_MiniTable pb__enumvalue__JsonEnumValueOptions_msg_init = {
   &pb_enumvalue_JsonEnumValueOptions__fields.fields[0],
   UPB_SIZE(24, 32), 1, kUpb_ExtMode_NonExtendable, 1, UPB_FASTTABLE_MASK(8), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "pb.enumvalue.JsonEnumValueOptions",
 #endif
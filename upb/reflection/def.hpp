@@ -576,6 +576,11 @@ class DefPool {
         ptr_.get(), sym.data(), sym.size()));
   }
 
+  // Returns the message whose MiniTable is `mt`. This is a linear scan.
+  MessageDefPtr FindMessageByMiniTable(const upb_MiniTable* mt) const {
+    return MessageDefPtr(upb_DefPool_FindMessageByMiniTable(ptr_.get(), mt));
+  }
+
   EnumDefPtr FindEnumByName(absl::string_view sym) const {
     return EnumDefPtr(
         upb_DefPool_FindEnumByNameWithSize(ptr_.get(), sym.data(), sym.size()));
@@ -238,6 +238,19 @@ const upb_MessageDef* upb_DefPool_FindMessageByNameWithSize(
   return _upb_DefPool_Unpack(s, sym, len, UPB_DEFTYPE_MSG);
 }
 
+const upb_MessageDef* upb_DefPool_FindMessageByMiniTable(
+    const upb_DefPool* s, const upb_MiniTable* mt) {
+  intptr_t iter = UPB_INTTABLE_BEGIN;
+  upb_StringView key;
+  upb_value val;
+  while (upb_strtable_next2(&s->syms, &key, &val, &iter)) {
+    if (_upb_DefType_Type(val) != UPB_DEFTYPE_MSG) continue;
+    const upb_MessageDef* m = _upb_DefType_Unpack(val, UPB_DEFTYPE_MSG);
+    if (upb_MessageDef_MiniTable(m) == mt) return m;
+  }
+  return NULL;
+}
+
 const upb_EnumDef* upb_DefPool_FindEnumByName(const upb_DefPool* s,
                                               const char* sym) {
   return upb_DefPool_FindEnumByNameWithSize(s, sym, strlen(sym));
@@ -16,6 +16,7 @@
 #include "upb/base/status.h"
 #include "upb/mini_table/extension.h"
 #include "upb/mini_table/extension_registry.h"
+#include "upb/mini_table/message.h"
 #include "upb/reflection/common.h"
 
 // Must be last.
@@ -42,6 +43,12 @@ UPB_API const upb_MessageDef* upb_DefPool_FindMessageByName(
 const upb_MessageDef* upb_DefPool_FindMessageByNameWithSize(
     const upb_DefPool* s, const char* sym, size_t len);
 
+// Returns the message whose MiniTable is `mt`, or NULL if there is none. This
+// scans every symbol in the pool, so it is meant for offline tooling, such as
+// naming the per-message counts of a upb_DecodeStats.
+UPB_API const upb_MessageDef* upb_DefPool_FindMessageByMiniTable(
+    const upb_DefPool* s, const upb_MiniTable* mt);
+
 UPB_API const upb_EnumDef* upb_DefPool_FindEnumByName(const upb_DefPool* s,
                                                       const char* sym);
 
@@ -357,6 +357,23 @@ TEST(ReflectionTest, FindEnumByName) {
             enum_def);
 }
 
+TEST(ReflectionTest, FindMessageByMiniTable) {
+  upb::DefPool defpool;
+  ASSERT_TRUE(_upb_DefPool_LoadDefInit(
+      defpool.ptr(), &google_protobuf_unittest_proto_upbdefinit));
+  const upb_MessageDef* m = upb_DefPool_FindMessageByName(
+      defpool.ptr(), "proto2_unittest.TestAllTypes.NestedMessage");
+  ASSERT_THAT(m, NotNull());
+  EXPECT_EQ(upb_DefPool_FindMessageByMiniTable(defpool.ptr(),
+                                               upb_MessageDef_MiniTable(m)),
+            m);
+
+  // descriptor.proto was not loaded into this pool.
+  EXPECT_EQ(upb_DefPool_FindMessageByMiniTable(
+                defpool.ptr(), &google__protobuf__FileDescriptorProto_msg_init),
+            nullptr);
+}
+
 TEST(ReflectionTest, FindEnumValueByName) {
   upb::Arena arena;
   upb::DefPool defpool;
@@ -9,10 +9,10 @@
 
 #include <stddef.h>
 
-#include "upb/mem/arena.h"
 #include "upb/message/message.h"
 #include "upb/mini_table/message.h"
 #include "upb/wire/encode.h"
+#include "upb/wire/internal/encoder.h"
 
 // Must be last.
 #include "upb/port/def.inc"
@@ -21,15 +21,12 @@
 extern "C" {
 #endif
 
+// Sizes the message without encoding it, using the first pass of
+// upb_EncodeToSink().
 size_t upb_ByteSize(const upb_Message* msg, const upb_MiniTable* mt) {
-  upb_Arena* arena = upb_Arena_New();
-  char* buf;
-  size_t res = 0;
-
-  (void)upb_Encode(msg, mt, 0, arena, &buf, &res);
-
-  upb_Arena_Free(arena);
-  return res;
+  size_t size;
+  upb_EncodeStatus status = UPB_PRIVATE(_upb_Encode_Size)(msg, mt, 0, &size);
+  return status == kUpb_EncodeStatus_Ok ? size : 0;
 }
 
 #ifdef __cplusplus
@@ -18,6 +18,7 @@
 #include "upb/base/internal/endian.h"
 #include "upb/base/string_view.h"
 #include "upb/hash/common.h"
+#include "upb/mem/alloc.h"
 #include "upb/mem/arena.h"
 #include "upb/message/array.h"
 #include "upb/message/internal/accessors.h"
@@ -38,9 +39,12 @@
 #include "upb/mini_table/message.h"
 #include "upb/wire/eps_copy_input_stream.h"
 #include "upb/wire/internal/constants.h"
+#include "upb/wire/internal/decode_projection.h"
+#include "upb/wire/internal/decode_stats.h"
 #include "upb/wire/internal/decoder.h"
 #include "upb/wire/internal/encoder.h"
 #include "upb/wire/reader.h"
+#include "utf8_range.h"
 
 // Our awkward dance for including fasttable only when it is enabled.
 #include "upb/port/def.inc"
@@ -217,6 +221,21 @@ const char* _upb_Decoder_DecodeSubMessage(upb_Decoder* d, const char* ptr,
   return ptr;
 }
 
+// Decodes a freshly created submessage and records the input it was parsed
+// from (see kUpb_DecodeOption_RetainEncoding).
+UPB_NOINLINE
+static const char* _upb_Decoder_DecodeRetainedSubMessage(
+    upb_Decoder* d, const char* ptr, upb_Message* submsg,
+    const upb_MiniTableField* field, size_t size) {
+  upb_StringView encoding = upb_StringView_FromDataAndSize(
+      UPB_PRIVATE(upb_EpsCopyInputStream_GetInputPtr)(&d->input, ptr), size);
+  ptr = _upb_Decoder_DecodeSubMessage(d, ptr, submsg, field, size);
+  if (!UPB_PRIVATE(_upb_Message_SetEncoding)(submsg, encoding, &d->arena)) {
+    upb_ErrorHandler_ThrowError(d->err, kUpb_DecodeStatus_OutOfMemory);
+  }
+  return ptr;
+}
+
 UPB_FORCEINLINE
 const char* _upb_Decoder_DecodeGroup(upb_Decoder* d, const char* ptr,
                                      upb_Message* submsg,
@@ -412,6 +431,9 @@ static const char* _upb_Decoder_DecodeToArray(upb_Decoder* d, const char* ptr,
       if (UPB_UNLIKELY(field->UPB_PRIVATE(descriptortype) ==
                        kUpb_FieldType_Group)) {
         return _upb_Decoder_DecodeKnownGroup(d, ptr, submsg, field);
+      } else if (UPB_UNLIKELY(d->options & kUpb_DecodeOption_RetainEncoding)) {
+        return _upb_Decoder_DecodeRetainedSubMessage(d, ptr, submsg, field,
+                                                     val->size);
       } else {
         return _upb_Decoder_DecodeSubMessage(d, ptr, submsg, field, val->size);
       }
@@ -494,6 +516,16 @@ static const char* _upb_Decoder_DecodeToMap(upb_Decoder* d, const char* ptr,
   // Parse map entry.
   memset(&ent, 0, sizeof(ent));
 
+  // A projection below a map field applies to the map's value message, so
+  // wrap it in one that selects the entry's key and value.
+  const upb_DecodeProjection* value_projection = d->projection;
+  upb_DecodeProjection_Entry entry_fields[2] = {{1, NULL}, {2, NULL}};
+  upb_DecodeProjection entry_projection = {0x3, entry_fields, 2, 2};
+  if (UPB_UNLIKELY(value_projection)) {
+    entry_fields[1].child = (upb_DecodeProjection*)value_projection;
+    d->projection = &entry_projection;
+  }
+
   bool value_is_message =
       entry->UPB_PRIVATE(fields)[1].UPB_PRIVATE(descriptortype) ==
           kUpb_FieldType_Message ||
@@ -512,6 +544,7 @@ static const char* _upb_Decoder_DecodeToMap(upb_Decoder* d, const char* ptr,
   }
 
   ptr = _upb_Decoder_DecodeSubMessage(d, ptr, &ent.message, field, val->size);
+  d->projection = value_projection;
 
   if (sub_msg && sub_table->UPB_PRIVATE(required_count)) {
     // If the map entry did not contain a value on the wire, `sub_msg` is an
@@ -561,9 +594,21 @@ static const char* _upb_Decoder_DecodeToSubMessage(
     case kUpb_DecodeOp_SubMessage: {
       upb_Message** submsgp = mem;
       upb_Message* submsg = *submsgp;
-      if (!submsg) submsg = _upb_Decoder_NewSubMessage(d, field, submsgp);
+      bool is_new = !submsg;
+      if (is_new) submsg = _upb_Decoder_NewSubMessage(d, field, submsgp);
       if (UPB_UNLIKELY(type == kUpb_FieldType_Group)) {
         ptr = _upb_Decoder_DecodeKnownGroup(d, ptr, submsg, field);
+      } else if (UPB_UNLIKELY(d->options & kUpb_DecodeOption_RetainEncoding)) {
+        if (is_new) {
+          ptr = _upb_Decoder_DecodeRetainedSubMessage(d, ptr, submsg, field,
+                                                      val->size);
+        } else {
+          // The submessage is merged from several spans of the input, so no
+          // single span encodes it.
+          UPB_PRIVATE(_upb_Message_ClearEncoding)(submsg);
+          ptr =
+              _upb_Decoder_DecodeSubMessage(d, ptr, submsg, field, val->size);
+        }
       } else {
         ptr = _upb_Decoder_DecodeSubMessage(d, ptr, submsg, field, val->size);
       }
@@ -1042,7 +1087,9 @@ static const char* _upb_Decoder_DecodeUnknowns(
   bool has_gap = UPB_PRIVATE(_upb_MiniTable_FindUnknownGap)(mt, field_number,
                                                             &gap_lo, &gap_hi);
 
-  if (has_gap) {
+  // While projecting, each unknown field has to be checked against the
+  // projection individually, so subsequent fields are not coalesced.
+  if (has_gap && !d->projection) {
     bool is_extendable =
         (UPB_UNLIKELY(UPB_PRIVATE(_upb_MiniTable_IsExtendable)(mt)) ||
          UPB_UNLIKELY(upb_MiniTable_IsMessageSet(mt))) &&
@@ -1118,11 +1165,73 @@ const char* _upb_Decoder_DecodeFieldData(
   }
 }
 
+UPB_NOINLINE
+static const char* _upb_Decoder_DecodeProjectedField(
+    upb_Decoder* d, const char* ptr, upb_Message* msg, const upb_MiniTable* mt,
+    uint32_t field_number, uint32_t wire_type, const char* start) {
+  const upb_DecodeProjection* projection = d->projection;
+  const upb_DecodeProjection* child;
+  if (!UPB_PRIVATE(_upb_DecodeProjection_Find)(projection, field_number,
+                                                &child)) {
+    // Unselected fields are skipped without being preserved as unknown.
+    return _upb_WireReader_SkipValue(ptr, (field_number << 3) | wire_type,
+                                     d->depth, EPS(d));
+  }
+
+  int op;
+  wireval val;
+  const upb_MiniTableField* field =
+      _upb_Decoder_FindField(d, mt, field_number, wire_type);
+  ptr = _upb_Decoder_DecodeWireValue(d, ptr, mt, field, wire_type, &val, &op);
+
+  switch (op) {
+    case kUpb_DecodeOp_UnknownField:
+      return _upb_Decoder_DecodeUnknowns(d, ptr, msg, mt, field_number,
+                                         wire_type, val, start);
+    case kUpb_DecodeOp_MessageSetItem:
+      return upb_Decoder_DecodeMessageSetItem(d, ptr, msg, mt);
+    default:
+      UPB_ASSERT(op >= 0);
+      d->projection = child;
+      ptr = _upb_Decoder_DecodeKnownField(d, ptr, msg, field, op, &val);
+      d->projection = projection;
+      return ptr;
+  }
+}
+
 static const char* _upb_Decoder_EndMessage(upb_Decoder* d, const char* ptr) {
   d->message_is_done = true;
   return ptr;
 }
 
+// Returns true if the tag at `ptr` has a slot in the fasttable of `mt`, which
+// means that the fasttable decoder would parse the field without falling back.
+static bool _upb_Decoder_HasFastSlot(const upb_MiniTable* mt, const char* ptr) {
+#if UPB_FASTTABLE
+  uint8_t mask = mt->UPB_PRIVATE(table_mask);
+  if (mask == (unsigned char)-1) return false;
+  uint16_t tag;
+  memcpy(&tag, ptr, 2);
+  const _upb_FastTable_Entry* ent =
+      &mt->UPB_PRIVATE(fasttable)[(tag & mask) >> 3];
+  uint16_t expected = ent->field_data;
+  // Entries that don't parse a field have no expected tag, and never match.
+  if (tag & 0x80) return expected == tag;  // Two-byte tag.
+  return (uint8_t)expected == (uint8_t)tag && expected != 0;
+#else
+  return false;
+#endif
+}
+
+static void _upb_Decoder_RecordStats(upb_Decoder* d, const upb_MiniTable* mt,
+                                     uint32_t field_number, const char* tag) {
+  bool fast = _upb_Decoder_HasFastSlot(mt, tag);
+  if (!UPB_PRIVATE(_upb_DecodeStats_Record)(d->stats, mt, field_number,
+                                            fast)) {
+    upb_ErrorHandler_ThrowError(d->err, kUpb_DecodeStatus_OutOfMemory);
+  }
+}
+
 UPB_FORCEINLINE
 const char* _upb_Decoder_DecodeFieldNoFast(upb_Decoder* d, const char* ptr,
                                            upb_Message* msg,
@@ -1138,6 +1247,17 @@ const char* _upb_Decoder_DecodeFieldNoFast(upb_Decoder* d, const char* ptr,
     return _upb_Decoder_EndMessage(d, ptr);
   }
 
+  // Projections and stats are rare, so a single check guards both.
+  if (UPB_UNLIKELY((uintptr_t)d->projection | (uintptr_t)d->stats)) {
+    if (d->stats) _upb_Decoder_RecordStats(d, mt, field_number, start);
+    if (d->projection) {
+      ptr = _upb_Decoder_DecodeProjectedField(d, ptr, msg, mt, field_number,
+                                              wire_type, start);
+      _upb_Decoder_Trace(d, 'M');
+      return ptr;
+    }
+  }
+
   ptr = _upb_Decoder_DecodeFieldData(d, ptr, msg, mt, field_number, wire_type,
                                      start);
   _upb_Decoder_Trace(d, 'M');
@@ -1152,8 +1272,9 @@ bool _upb_Decoder_TryDecodeMessageFast(upb_Decoder* d, const char** ptr,
                                        uint64_t data) {
 #if UPB_FASTTABLE
   if (mt->UPB_PRIVATE(table_mask) == (unsigned char)-1 ||
-      (d->options & kUpb_DecodeOption_DisableFastTable)) {
-    // Fast table is unavailable or disabled.
+      (d->options & kUpb_DecodeOption_DisableFastTable) || d->projection) {
+    // Fast table is unavailable or disabled, or we are projecting and every
+    // field must be checked against the projection.
     return false;
   }
 
@@ -1261,7 +1382,8 @@ const char* _upb_Decoder_DecodeMessage(upb_Decoder* d, const char* ptr,
 
   if (UPB_UNLIKELY(upb_MiniTable_FieldCount(mt) == 0 &&
                    UPB_PRIVATE(_upb_MiniTable_ExtModeBase)(mt) ==
-                       kUpb_ExtMode_NonExtendable)) {
+                       kUpb_ExtMode_NonExtendable &&
+                   !d->projection)) {
     return _upb_Decoder_DecodeEmptyMessage(d, ptr, msg);
   }
 
@@ -1285,17 +1407,82 @@ static upb_DecodeStatus _upb_Decoder_DecodeTop(struct upb_Decoder* d,
   return kUpb_DecodeStatus_Ok;
 }
 
-static upb_DecodeStatus upb_Decoder_Decode(upb_Decoder* const decoder,
-                                           const char* const buf,
-                                           upb_Message* const msg,
-                                           const upb_MiniTable* const m,
-                                           upb_Arena* const arena) {
+static void _upb_Decoder_FreezeSubMessage(upb_MessageValue val,
+                                          const upb_MiniTableField* f,
+                                          const upb_MiniTable* subm) {
+  if (upb_MiniTableField_IsArray(f)) {
+    const upb_Array* arr = val.array_val;
+    size_t n = arr ? upb_Array_Size(arr) : 0;
+    for (size_t i = 0; i < n; i++) {
+      upb_Message_Freeze((upb_Message*)upb_Array_Get(arr, i).msg_val, subm);
+    }
+  } else if (val.msg_val) {
+    upb_Message_Freeze((upb_Message*)val.msg_val, subm);
+  }
+}
+
+// Deep-freezes the submessages of `msg` after a kUpb_DecodeOption_RetainEncoding
+// parse, which is what allows the encoder to trust their retained encodings.
+// `msg` itself and its repeated and map fields are left mutable.
+static void _upb_Decoder_FreezeRetained(upb_Message* msg,
+                                        const upb_MiniTable* m) {
+  const size_t field_count = upb_MiniTable_FieldCount(m);
+  for (size_t i = 0; i < field_count; i++) {
+    const upb_MiniTableField* f = upb_MiniTable_GetFieldByIndex(m, i);
+    if (!upb_MiniTableField_IsSubMessage(f) || upb_MiniTableField_IsMap(f)) {
+      continue;
+    }
+    upb_MessageValue val;
+    if (upb_MiniTableField_IsArray(f)) {
+      val.array_val = upb_Message_GetArray(msg, f);
+    } else {
+      val.msg_val = upb_Message_GetMessage(msg, f);
+    }
+    _upb_Decoder_FreezeSubMessage(val, f, upb_MiniTable_SubMessage(f));
+  }
+
+  upb_Message_Internal* in = UPB_PRIVATE(_upb_Message_GetInternal)(msg);
+  uint32_t size = in ? in->size : 0;
+  for (uint32_t i = 0; i < size; i++) {
+    const upb_Extension* ext =
+        upb_TaggedAuxPtr_TryGetExtension(in->aux_data[i]);
+    if (!ext) continue;
+    const upb_MiniTableField* f = &ext->ext->UPB_PRIVATE(field);
+    if (!upb_MiniTableField_IsSubMessage(f)) continue;
+    upb_MessageValue val;
+    memcpy(&val, &ext->data, sizeof(upb_MessageValue));
+    _upb_Decoder_FreezeSubMessage(
+        val, f, upb_MiniTableExtension_GetSubMessage(ext->ext));
+  }
+}
+
+// Decodes one top-level message, leaving the arena swapped in.
+static upb_DecodeStatus upb_Decoder_DecodeOne(upb_Decoder* const decoder,
+                                             const char* const buf,
+                                             upb_Message* const msg,
+                                             const upb_MiniTable* const m) {
   if (UPB_SETJMP(decoder->err->buf) == 0) {
     decoder->err->code = _upb_Decoder_DecodeTop(decoder, buf, msg, m);
   } else {
     UPB_ASSERT(decoder->err->code != kUpb_DecodeStatus_Ok);
   }
 
+  // A failed parse may leave submessages half-decoded, so nothing is frozen
+  // and no retained encoding is trusted.
+  if (decoder->err->code == kUpb_DecodeStatus_Ok &&
+      (decoder->options & kUpb_DecodeOption_RetainEncoding)) {
+    _upb_Decoder_FreezeRetained(msg, m);
+  }
+
+  return (upb_DecodeStatus)decoder->err->code;
+}
+
+static upb_DecodeStatus upb_Decoder_Decode(upb_Decoder* const decoder,
+                                           const char* const buf,
+                                           upb_Message* const msg,
+                                           const upb_MiniTable* const m,
+                                           upb_Arena* const arena) {
+  upb_Decoder_DecodeOne(decoder, buf, msg, m);
   return upb_Decoder_Destroy(decoder, arena);
 }
 
@@ -1337,24 +1524,60 @@ upb_DecodeStatus upb_DecodeWithTrace(const char* buf, size_t size,
   return upb_Decoder_Decode(&decoder, buf, msg, mt, arena);
 }
 
-upb_DecodeStatus upb_DecodeLengthPrefixed(const char* buf, size_t size,
-                                          upb_Message* msg,
-                                          size_t* num_bytes_read,
-                                          const upb_MiniTable* mt,
-                                          const upb_ExtensionRegistry* extreg,
-                                          int options, upb_Arena* arena) {
+upb_DecodeStatus upb_DecodeWithProjection(
+    const char* buf, size_t size, upb_Message* msg, const upb_MiniTable* mt,
+    const upb_ExtensionRegistry* extreg,
+    const upb_DecodeProjection* projection, int options, upb_Arena* arena) {
+  UPB_ASSERT(!upb_Message_IsFrozen(msg));
+  UPB_ASSERT(projection);
+  upb_Decoder decoder;
+  upb_ErrorHandler err;
+  upb_ErrorHandler_Init(&err);
+  buf = upb_Decoder_Init(&decoder, buf, size, extreg, options, arena, &err,
+                         NULL, 0);
+  decoder.projection = projection;
+
+  return upb_Decoder_Decode(&decoder, buf, msg, mt, arena);
+}
+
+upb_DecodeStatus upb_DecodeWithStats(const char* buf, size_t size,
+                                     upb_Message* msg, const upb_MiniTable* mt,
+                                     const upb_ExtensionRegistry* extreg,
+                                     int options, upb_Arena* arena,
+                                     upb_DecodeStats* stats) {
+  UPB_ASSERT(!upb_Message_IsFrozen(msg));
+  UPB_ASSERT(stats);
+  bool sampled = UPB_PRIVATE(_upb_DecodeStats_StartDecode)(stats);
+  // Sampled decodes see every field in the MiniTable decoder.
+  if (sampled) options |= kUpb_DecodeOption_DisableFastTable;
+  upb_Decoder decoder;
+  upb_ErrorHandler err;
+  upb_ErrorHandler_Init(&err);
+  buf = upb_Decoder_Init(&decoder, buf, size, extreg, options, arena, &err,
+                         NULL, 0);
+  if (sampled) {
+    decoder.stats = stats;
+    if (stats->arena == arena) stats->alloc = &decoder.arena;
+  }
+
+  upb_DecodeStatus status = upb_Decoder_Decode(&decoder, buf, msg, mt, arena);
+  stats->alloc = stats->arena;
+  return status;
+}
+
+// Reads the varint length that prefixes a message. Returns false if it is
+// malformed, or if the message would extend past the end of the input.
+static bool upb_Decoder_ReadLengthPrefix(const char* buf, size_t size,
+                                         size_t* prefix_len, size_t* msg_len) {
   // To avoid needing to make a Decoder just to decode the initial length,
   // hand-decode the leading varint for the message length here.
-  uint64_t msg_len = 0;
+  uint64_t len = 0;
   for (size_t i = 0;; ++i) {
-    if (i >= size || i > 9) {
-      return kUpb_DecodeStatus_Malformed;
-    }
-    uint64_t b = *buf;
-    buf++;
-    msg_len += (b & 0x7f) << (i * 7);
+    if (i >= size || i > 9) return false;
+    uint64_t b = buf[i];
+    len += (b & 0x7f) << (i * 7);
     if ((b & 0x80) == 0) {
-      *num_bytes_read = i + 1 + msg_len;
+      *prefix_len = i + 1;
       break;
     }
   }
@@ -1362,14 +1585,754 @@ upb_DecodeStatus upb_DecodeLengthPrefixed(const char* buf, size_t size,
   // If the total number of bytes we would read (= the bytes from the varint
   // plus however many bytes that varint says we should read) is larger then the
   // input buffer then error as malformed.
-  if (*num_bytes_read > size) {
+  if (len > INT32_MAX || len > size - *prefix_len) return false;
+  *msg_len = len;
+  return true;
+}
+
+upb_DecodeStatus upb_DecodeLengthPrefixed(const char* buf, size_t size,
+                                          upb_Message* msg,
+                                          size_t* num_bytes_read,
+                                          const upb_MiniTable* mt,
+                                          const upb_ExtensionRegistry* extreg,
+                                          int options, upb_Arena* arena) {
+  size_t prefix_len, msg_len;
+  if (!upb_Decoder_ReadLengthPrefix(buf, size, &prefix_len, &msg_len)) {
     return kUpb_DecodeStatus_Malformed;
   }
-  if (msg_len > INT32_MAX) {
-    return kUpb_DecodeStatus_Malformed;
+  *num_bytes_read = prefix_len + msg_len;
+  return upb_Decode(buf + prefix_len, msg_len, msg, mt, extreg, options,
+                    arena);
+}
+
+#if UPB_HAS_BUILTIN(__builtin_prefetch) || defined(__GNUC__)
+#define UPB_DECODE_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define UPB_DECODE_PREFETCH(addr)
+#endif
+
+// Batch decodes reuse one decoder, which upb_Decoder_Init() sets up once.  For
+// each message only the input stream and the per-message state are reset.
+static int upb_Decoder_BatchOptions(const upb_Decoder* d, int options) {
+  // upb_Decoder_Init() may have added options, which upb_Decoder_Reset() would
+  // otherwise drop.  The depth limit lives above the 16 bits of d->options.
+  return (options & ~0xffff) | d->options;
+}
+
+static const char* upb_Decoder_StartBatchItem(upb_Decoder* d, const char* buf,
+                                              size_t size, int options,
+                                              upb_Message* msg) {
+  UPB_ASSERT(!upb_Message_IsFrozen(msg));
+  upb_EpsCopyInputStream_InitWithErrorHandler(&d->input, &buf, size, d->err);
+  upb_Decoder_Reset(d, options, msg);
+  d->err->code = kUpb_DecodeStatus_Ok;
+  return buf;
+}
+
+upb_DecodeStatus upb_DecodeBatch(const upb_DecodeBatchItem* items,
+                                 size_t count, const upb_MiniTable* mt,
+                                 const upb_ExtensionRegistry* extreg,
+                                 int options, upb_Arena* arena,
+                                 size_t* num_decoded) {
+  *num_decoded = 0;
+  if (count == 0) return kUpb_DecodeStatus_Ok;
+
+  upb_Decoder decoder;
+  upb_ErrorHandler err;
+  upb_ErrorHandler_Init(&err);
+  upb_Decoder_Init(&decoder, items[0].buf, items[0].size, extreg, options,
+                   arena, &err, NULL, 0);
+  const int batch_options = upb_Decoder_BatchOptions(&decoder, options);
+
+  upb_DecodeStatus status = kUpb_DecodeStatus_Ok;
+  size_t i;
+  for (i = 0; i < count; i++) {
+    if (i + 1 < count) {
+      UPB_DECODE_PREFETCH(items[i + 1].buf);
+      UPB_DECODE_PREFETCH(items[i + 1].msg);
+    }
+    const char* ptr = upb_Decoder_StartBatchItem(
+        &decoder, items[i].buf, items[i].size, batch_options, items[i].msg);
+    status = upb_Decoder_DecodeOne(&decoder, ptr, items[i].msg, mt);
+    if (status != kUpb_DecodeStatus_Ok) break;
+  }
+
+  *num_decoded = i;
+  upb_Decoder_Destroy(&decoder, arena);
+  return status;
+}
+
+upb_DecodeStatus upb_DecodeBatchLengthPrefixed(
+    const char* buf, size_t size, upb_Message** msgs, size_t max_msgs,
+    size_t* num_msgs, size_t* num_bytes_read, const upb_MiniTable* mt,
+    const upb_ExtensionRegistry* extreg, int options, upb_Arena* arena) {
+  *num_msgs = 0;
+  *num_bytes_read = 0;
+  if (size == 0 || max_msgs == 0) return kUpb_DecodeStatus_Ok;
+
+  upb_Decoder decoder;
+  upb_ErrorHandler err;
+  upb_ErrorHandler_Init(&err);
+  upb_Decoder_Init(&decoder, buf, size, extreg, options, arena, &err, NULL, 0);
+  const int batch_options = upb_Decoder_BatchOptions(&decoder, options);
+
+  upb_DecodeStatus status = kUpb_DecodeStatus_Ok;
+  size_t ofs = 0;
+  size_t n = 0;
+  while (n < max_msgs && ofs < size) {
+    size_t prefix_len, msg_len;
+    if (!upb_Decoder_ReadLengthPrefix(buf + ofs, size - ofs, &prefix_len,
+                                      &msg_len)) {
+      status = kUpb_DecodeStatus_Malformed;
+      break;
+    }
+    const size_t next = ofs + prefix_len + msg_len;
+    if (next < size) UPB_DECODE_PREFETCH(buf + next);
+
+    // The arena is swapped into the decoder until we are done.
+    upb_Message* msg = upb_Message_New(mt, &decoder.arena);
+    if (!msg) {
+      status = kUpb_DecodeStatus_OutOfMemory;
+      break;
+    }
+    const char* ptr = upb_Decoder_StartBatchItem(
+        &decoder, buf + ofs + prefix_len, msg_len, batch_options, msg);
+    status = upb_Decoder_DecodeOne(&decoder, ptr, msg, mt);
+    if (status != kUpb_DecodeStatus_Ok) break;
+    msgs[n++] = msg;
+    ofs = next;
   }
 
-  return upb_Decode(buf, msg_len, msg, mt, extreg, options, arena);
+  *num_msgs = n;
+  *num_bytes_read = ofs;
+  upb_Decoder_Destroy(&decoder, arena);
+  return status;
+}
+
+#undef UPB_DECODE_PREFETCH
+
+// Streaming decoding.
+//
+// The input is cut into runs of complete fields of the innermost open
+// (sub)message, and each run is decoded into that message with a regular
+// decoder. Since decoding concatenated inputs merges them, this gives the
+// same result as decoding the whole input at once. Bytes are counted in
+// `offset` from the start of the input, and each open message records the
+// offset at which it ends.
+//
+// The decoder's own buffers (the frame stack and the pending bytes of an
+// incomplete field) are heap memory that it reuses and frees, since growing
+// them in the message's arena would leave every old copy there until the
+// arena dies. Incomplete string and bytes fields skip the pending buffer
+// entirely and are copied straight into their final location in the arena.
+
+typedef struct {
+  upb_Message* msg;
+  const upb_MiniTable* mt;
+  uint64_t end;           // Offset just past the message, or UINT64_MAX.
+  uint32_t group_number;  // For groups, else DECODE_NOGROUP.
+} upb_StreamDecoderFrame;
+
+struct upb_StreamDecoder {
+  upb_Arena* arena;
+  const upb_ExtensionRegistry* extreg;
+  int options;
+  int max_depth;
+  upb_DecodeStatus status;
+  bool check_required;
+  bool missing_required;
+  uint64_t offset;  // Input bytes consumed so far, not counting `pending`.
+
+  // frames[0] is the top-level message, frames[depth] the innermost one.
+  upb_StreamDecoderFrame* frames;
+  int depth;
+  int frames_cap;
+
+  // The start of an incomplete field, carried over from earlier input.
+  char* pending;
+  size_t pending_size;
+  size_t pending_cap;
+
+  // An incomplete string or bytes field of the innermost message, whose data
+  // is being copied into the arena as it arrives.
+  const upb_MiniTableField* string_field;
+  char* string_data;
+  size_t string_size;
+  size_t string_filled;
+};
+
+enum {
+  // Enough bytes for any tag and length prefix.
+  kUpb_StreamDecoder_MaxHeaderSize = 15,
+  kUpb_StreamDecoder_InitialFrames = 8,
+};
+
+typedef enum {
+  kUpb_StreamScan_Complete,
+  kUpb_StreamScan_Incomplete,
+  kUpb_StreamScan_EndGroup,
+  kUpb_StreamScan_Malformed,
+} upb_StreamScanResult;
+
+typedef struct {
+  uint32_t number;
+  uint32_t wire_type;
+  size_t header_size;  // Tag and length prefix, or 0 if not yet available.
+  uint64_t size;       // Total size of the field, or 0 if not yet known.
+} upb_StreamField;
+
+// Reads a varint from `ptr[0..size)`. Returns its size, 0 if the input ends
+// before it does, or -1 if it is too long.
+static int upb_StreamDecoder_ReadVarint(const char* ptr, size_t size,
+                                        uint64_t* val) {
+  uint64_t ret = 0;
+  for (int i = 0; i < 10; i++) {
+    if ((size_t)i >= size) return 0;
+    uint64_t byte = (uint8_t)ptr[i];
+    ret |= (byte & 0x7f) << (i * 7);
+    if ((byte & 0x80) == 0) {
+      *val = ret;
+      return i + 1;
+    }
+  }
+  return -1;
+}
+
+// Finds the end of the group that starts at `ptr`, after its start tag.
+static upb_StreamScanResult upb_StreamDecoder_ScanGroup(const char* ptr,
+                                                        size_t size,
+                                                        uint64_t* group_size) {
+  size_t pos = 0;
+  uint64_t depth = 1;
+  while (true) {
+    uint64_t tag, val;
+    int n = upb_StreamDecoder_ReadVarint(ptr + pos, size - pos, &tag);
+    if (n <= 0) {
+      return n ? kUpb_StreamScan_Malformed : kUpb_StreamScan_Incomplete;
+    }
+    pos += n;
+    switch (tag & 7) {
+      case kUpb_WireType_Varint:
+        n = upb_StreamDecoder_ReadVarint(ptr + pos, size - pos, &val);
+        if (n <= 0) {
+          return n ? kUpb_StreamScan_Malformed : kUpb_StreamScan_Incomplete;
+        }
+        pos += n;
+        break;
+      case kUpb_WireType_64Bit:
+        pos += 8;
+        break;
+      case kUpb_WireType_32Bit:
+        pos += 4;
+        break;
+      case kUpb_WireType_Delimited:
+        n = upb_StreamDecoder_ReadVarint(ptr + pos, size - pos, &val);
+        if (n <= 0) {
+          return n ? kUpb_StreamScan_Malformed : kUpb_StreamScan_Incomplete;
+        }
+        if (val > INT32_MAX) return kUpb_StreamScan_Malformed;
+        pos += n + val;
+        break;
+      case kUpb_WireType_StartGroup:
+        depth++;
+        break;
+      case kUpb_WireType_EndGroup:
+        if (--depth == 0) {
+          *group_size = pos;
+          return kUpb_StreamScan_Complete;
+        }
+        break;
+      default:
+        return kUpb_StreamScan_Malformed;
+    }
+    if (pos > size) return kUpb_StreamScan_Incomplete;
+  }
+}
+
+// Finds the extent of the field at `ptr`. The decoder validates the field's
+// contents later; this only needs to be strict enough to find its end.
+static upb_StreamScanResult upb_StreamDecoder_ScanField(const char* ptr,
+                                                        size_t size,
+                                                        upb_StreamField* f) {
+  uint64_t tag, val;
+  f->header_size = 0;
+  f->size = 0;
+  int n = upb_StreamDecoder_ReadVarint(ptr, size, &tag);
+  if (n <= 0) {
+    return n ? kUpb_StreamScan_Malformed : kUpb_StreamScan_Incomplete;
+  }
+  if (tag > UINT32_MAX || (tag >> 3) == 0) return kUpb_StreamScan_Malformed;
+  f->number = (uint32_t)(tag >> 3);
+  f->wire_type = tag & 7;
+  switch (f->wire_type) {
+    case kUpb_WireType_Varint: {
+      int m = upb_StreamDecoder_ReadVarint(ptr + n, size - n, &val);
+      if (m < 0) return kUpb_StreamScan_Malformed;
+      f->header_size = n;
+      if (m) f->size = n + m;
+      break;
+    }
+    case kUpb_WireType_64Bit:
+      f->header_size = n;
+      f->size = n + 8;
+      break;
+    case kUpb_WireType_32Bit:
+      f->header_size = n;
+      f->size = n + 4;
+      break;
+    case kUpb_WireType_Delimited: {
+      int m = upb_StreamDecoder_ReadVarint(ptr + n, size - n, &val);
+      if (m < 0 || (m > 0 && val > INT32_MAX)) {
+        return kUpb_StreamScan_Malformed;
+      }
+      if (m) {
+        f->header_size = n + m;
+        f->size = n + m + val;
+      }
+      break;
+    }
+    case kUpb_WireType_StartGroup: {
+      uint64_t group_size;
+      f->header_size = n;
+      upb_StreamScanResult r =
+          upb_StreamDecoder_ScanGroup(ptr + n, size - n, &group_size);
+      if (r != kUpb_StreamScan_Complete) return r;
+      f->size = n + group_size;
+      break;
+    }
+    case kUpb_WireType_EndGroup:
+      f->header_size = n;
+      f->size = n;
+      return kUpb_StreamScan_EndGroup;
+    default:
+      return kUpb_StreamScan_Malformed;
+  }
+  return f->size && f->size <= size ? kUpb_StreamScan_Complete
+                                    : kUpb_StreamScan_Incomplete;
+}
+
+static upb_DecodeStatus upb_StreamDecoder_SetError(upb_StreamDecoder* d,
+                                                  upb_DecodeStatus status) {
+  d->status = status;
+  return status;
+}
+
+// Decodes a run of complete fields into `msg`. Unlike _upb_Decoder_DecodeTop(),
+// this does not check the required fields of `msg` itself, since more of its
+// fields may follow in a later run.
+static upb_DecodeStatus _upb_Decoder_DecodeRun(upb_Decoder* d, const char* ptr,
+                                               upb_Message* msg,
+                                               const upb_MiniTable* mt) {
+  do {
+    ptr = _upb_Decoder_DecodeField(d, ptr, msg, mt, 0, 0);
+  } while (!d->message_is_done);
+  if (d->end_group != DECODE_NOGROUP) return kUpb_DecodeStatus_Malformed;
+  return kUpb_DecodeStatus_Ok;
+}
+
+static upb_DecodeStatus upb_StreamDecoder_DecodeRun(upb_StreamDecoder* d,
+                                                    const char* buf,
+                                                    size_t size) {
+  const upb_StreamDecoderFrame* f = &d->frames[d->depth];
+  upb_Decoder decoder;
+  upb_ErrorHandler err;
+  upb_ErrorHandler_Init(&err);
+  int options = upb_Decode_LimitDepth(d->options, d->max_depth - d->depth);
+  buf = upb_Decoder_Init(&decoder, buf, size, d->extreg, options, d->arena,
+                         &err, NULL, 0);
+  decoder.original_msg = f->msg;
+  if (UPB_SETJMP(err.buf) == 0) {
+    err.code = _upb_Decoder_DecodeRun(&decoder, buf, f->msg, f->mt);
+  }
+  d->missing_required |= decoder.missing_required;
+  return upb_Decoder_Destroy(&decoder, d->arena);
+}
+
+static void upb_StreamDecoder_CheckRequired(upb_StreamDecoder* d,
+                                            const upb_StreamDecoderFrame* f) {
+  if (d->check_required && f->mt->UPB_PRIVATE(required_count) &&
+      !UPB_PRIVATE(_upb_Message_IsInitializedShallow)(f->msg, f->mt)) {
+    d->missing_required = true;
+  }
+}
+
+static void upb_StreamDecoder_PopFrame(upb_StreamDecoder* d) {
+  upb_StreamDecoder_CheckRequired(d, &d->frames[d->depth]);
+  d->depth--;
+}
+
+// Returns the MiniTable of the submessage that field `f` of the innermost
+// message starts, if it is one that we can decode incrementally.
+static const upb_MiniTable* upb_StreamDecoder_SubMessage(
+    const upb_StreamDecoder* d, const upb_StreamField* f,
+    const upb_MiniTableField** field) {
+  // Leave room for the submessage's own submessages.
+  if (d->depth + 1 >= d->max_depth) return NULL;
+  *field = upb_MiniTable_FindFieldByNumber(d->frames[d->depth].mt, f->number);
+  if (!*field || upb_MiniTableField_IsMap(*field)) return NULL;
+  upb_FieldType type = upb_MiniTableField_Type(*field);
+  if (!(type == kUpb_FieldType_Message &&
+        f->wire_type == kUpb_WireType_Delimited) &&
+      !(type == kUpb_FieldType_Group &&
+        f->wire_type == kUpb_WireType_StartGroup)) {
+    return NULL;
+  }
+  return upb_MiniTable_SubMessage(*field);
+}
+
+static upb_DecodeStatus upb_StreamDecoder_PushFrame(
+    upb_StreamDecoder* d, const upb_StreamField* f,
+    const upb_MiniTableField* field, const upb_MiniTable* sub_mt) {
+  const upb_StreamDecoderFrame* parent = &d->frames[d->depth];
+  uint64_t end = parent->end;
+  if (f->wire_type == kUpb_WireType_Delimited) {
+    end = d->offset + f->size;
+    if (end > parent->end) return kUpb_DecodeStatus_Malformed;
+  }
+
+  if (d->depth + 1 == d->frames_cap) {
+    int cap = d->frames_cap * 2;
+    upb_StreamDecoderFrame* frames =
+        upb_grealloc(d->frames, d->frames_cap * sizeof(*frames),
+                     cap * sizeof(*frames));
+    if (!frames) return kUpb_DecodeStatus_OutOfMemory;
+    d->frames = frames;
+    d->frames_cap = cap;
+    parent = &d->frames[d->depth];
+  }
+
+  upb_Message* sub;
+  if (upb_MiniTableField_IsArray(field)) {
+    upb_Array* arr =
+        upb_Message_GetOrCreateMutableArray(parent->msg, field, d->arena);
+    sub = upb_Message_New(sub_mt, d->arena);
+    if (!arr || !sub ||
+        !upb_Array_Append(arr, (upb_MessageValue){.msg_val = sub}, d->arena)) {
+      return kUpb_DecodeStatus_OutOfMemory;
+    }
+  } else {
+    sub = upb_Message_GetOrCreateMutableMessage(parent->msg, field, d->arena);
+    if (!sub) return kUpb_DecodeStatus_OutOfMemory;
+  }
+
+  upb_StreamDecoderFrame* frame = &d->frames[++d->depth];
+  frame->msg = sub;
+  frame->mt = sub_mt;
+  frame->end = end;
+  frame->group_number = f->wire_type == kUpb_WireType_StartGroup
+                            ? f->number
+                            : DECODE_NOGROUP;
+  d->offset += f->header_size;
+  return kUpb_DecodeStatus_Ok;
+}
+
+// Returns the string or bytes field of the innermost message that field `f`
+// is, if any.
+static const upb_MiniTableField* upb_StreamDecoder_StringField(
+    const upb_StreamDecoder* d, const upb_StreamField* f) {
+  if (f->wire_type != kUpb_WireType_Delimited) return NULL;
+  const upb_MiniTableField* field =
+      upb_MiniTable_FindFieldByNumber(d->frames[d->depth].mt, f->number);
+  if (!field || upb_MiniTableField_IsMap(field)) return NULL;
+  upb_FieldType type = upb_MiniTableField_Type(field);
+  if (type != kUpb_FieldType_String && type != kUpb_FieldType_Bytes) {
+    return NULL;
+  }
+  return field;
+}
+
+// Matches _upb_Decoder_FieldRequiresUtf8Validation().
+static bool upb_StreamDecoder_RequiresUtf8Validation(
+    const upb_StreamDecoder* d, const upb_MiniTableField* field) {
+  if (field->UPB_PRIVATE(descriptortype) == kUpb_FieldType_String) return true;
+  return field->UPB_PRIVATE(descriptortype) == kUpb_FieldType_Bytes &&
+         (field->UPB_ONLYBITS(mode) & kUpb_LabelFlags_IsAlternate) &&
+         (d->options & kUpb_DecodeOption_AlwaysValidateUtf8);
+}
+
+static upb_DecodeStatus upb_StreamDecoder_StartString(
+    upb_StreamDecoder* d, const upb_StreamField* f,
+    const upb_MiniTableField* field) {
+  size_t size = f->size - f->header_size;
+  d->string_data = upb_Arena_Malloc(d->arena, size);
+  if (!d->string_data) return kUpb_DecodeStatus_OutOfMemory;
+  d->string_field = field;
+  d->string_size = size;
+  d->string_filled = 0;
+  d->offset += f->header_size;
+  return kUpb_DecodeStatus_Ok;
+}
+
+// Stores the completed string into the innermost message.
+static upb_DecodeStatus upb_StreamDecoder_EndString(upb_StreamDecoder* d) {
+  const upb_MiniTableField* field = d->string_field;
+  upb_Message* msg = d->frames[d->depth].msg;
+  upb_StringView sv = upb_StringView_FromDataAndSize(d->string_data,
+                                                     d->string_size);
+  d->string_field = NULL;
+  if (upb_StreamDecoder_RequiresUtf8Validation(d, field) &&
+      !utf8_range_IsValid(sv.data, sv.size)) {
+    return kUpb_DecodeStatus_BadUtf8;
+  }
+  if (upb_MiniTableField_IsArray(field)) {
+    upb_Array* arr = upb_Message_GetOrCreateMutableArray(msg, field, d->arena);
+    if (!arr ||
+        !upb_Array_Append(arr, (upb_MessageValue){.str_val = sv}, d->arena)) {
+      return kUpb_DecodeStatus_OutOfMemory;
+    }
+  } else {
+    upb_Message_SetBaseFieldString(msg, field, sv);
+  }
+  return kUpb_DecodeStatus_Ok;
+}
+
+// Copies as much of `buf` as belongs to the pending string, and returns the
+// number of bytes used.
+static size_t upb_StreamDecoder_FillString(upb_StreamDecoder* d,
+                                           const char* buf, size_t size) {
+  size_t n = UPB_MIN(size, d->string_size - d->string_filled);
+  memcpy(d->string_data + d->string_filled, buf, n);
+  d->string_filled += n;
+  d->offset += n;
+  if (d->string_filled == d->string_size) {
+    upb_DecodeStatus status = upb_StreamDecoder_EndString(d);
+    if (status != kUpb_DecodeStatus_Ok) upb_StreamDecoder_SetError(d, status);
+  }
+  return n;
+}
+
+// Decodes as much of `buf` as possible, entering and leaving submessages as
+// needed, and returns the number of bytes used. Stops early only at a field
+// that is incomplete, or on error.
+static size_t upb_StreamDecoder_Consume(upb_StreamDecoder* d, const char* buf,
+                                        size_t size) {
+  size_t used = 0;
+  while (true) {
+    const upb_StreamDecoderFrame* frame = &d->frames[d->depth];
+    if (d->offset == frame->end) {
+      // A group must be closed by its end tag before its parent ends.
+      if (frame->group_number != DECODE_NOGROUP) {
+        upb_StreamDecoder_SetError(d, kUpb_DecodeStatus_Malformed);
+        return used;
+      }
+      upb_StreamDecoder_PopFrame(d);
+      continue;
+    }
+
+    const char* ptr = buf + used;
+    size_t avail = UPB_MIN(size - used, frame->end - d->offset);
+    size_t run = 0;
+    upb_StreamField f;
+    upb_StreamScanResult r = kUpb_StreamScan_Complete;
+    while (run < avail) {
+      r = upb_StreamDecoder_ScanField(ptr + run, avail - run, &f);
+      if (r != kUpb_StreamScan_Complete) break;
+      run += f.size;
+    }
+
+    if (run) {
+      upb_DecodeStatus status = upb_StreamDecoder_DecodeRun(d, ptr, run);
+      if (status != kUpb_DecodeStatus_Ok) {
+        upb_StreamDecoder_SetError(d, status);
+        return used;
+      }
+      used += run;
+      d->offset += run;
+    }
+
+    switch (r) {
+      case kUpb_StreamScan_Complete:
+        // All of the available input was decoded.
+        if (d->offset == frame->end) continue;
+        return used;
+      case kUpb_StreamScan_EndGroup:
+        if (f.number != frame->group_number) {
+          upb_StreamDecoder_SetError(d, kUpb_DecodeStatus_Malformed);
+          return used;
+        }
+        used += f.header_size;
+        d->offset += f.header_size;
+        upb_StreamDecoder_PopFrame(d);
+        continue;
+      case kUpb_StreamScan_Malformed:
+        upb_StreamDecoder_SetError(d, kUpb_DecodeStatus_Malformed);
+        return used;
+      case kUpb_StreamScan_Incomplete:
+        break;
+    }
+
+    // The next field is incomplete. If the message ends within the input we
+    // have, or the field would extend past its end, the input is malformed.
+    if (d->offset + (size - used) >= frame->end ||
+        (f.size && d->offset + f.size > frame->end)) {
+      upb_StreamDecoder_SetError(d, kUpb_DecodeStatus_Malformed);
+      return used;
+    }
+    const upb_MiniTableField* field;
+    if (!f.header_size) return used;
+    const upb_MiniTable* sub_mt = upb_StreamDecoder_SubMessage(d, &f, &field);
+    if (!sub_mt) {
+      field = upb_StreamDecoder_StringField(d, &f);
+      if (!field) return used;
+      upb_DecodeStatus status = upb_StreamDecoder_StartString(d, &f, field);
+      if (status != kUpb_DecodeStatus_Ok) {
+        upb_StreamDecoder_SetError(d, status);
+        return used;
+      }
+      used += f.header_size;
+      // The rest of the input is all part of the string.
+      return used + upb_StreamDecoder_FillString(d, buf + used, size - used);
+    }
+    upb_DecodeStatus status = upb_StreamDecoder_PushFrame(d, &f, field, sub_mt);
+    if (status != kUpb_DecodeStatus_Ok) {
+      upb_StreamDecoder_SetError(d, status);
+      return used;
+    }
+    used += f.header_size;
+  }
+}
+
+static bool upb_StreamDecoder_AppendPending(upb_StreamDecoder* d,
+                                            const char* buf, size_t size) {
+  if (size == 0) return true;
+  if (d->pending_cap - d->pending_size < size) {
+    size_t cap = UPB_MAX(d->pending_cap * 2, d->pending_size + size);
+    cap = UPB_MAX(cap, 64);
+    char* pending = upb_grealloc(d->pending, d->pending_cap, cap);
+    if (!pending) return false;
+    d->pending = pending;
+    d->pending_cap = cap;
+  }
+  memcpy(d->pending + d->pending_size, buf, size);
+  d->pending_size += size;
+  return true;
+}
+
+// Moves input into the pending buffer until the pending field is complete or
+// can be entered as a submessage or string. Returns the number of bytes moved.
+static size_t upb_StreamDecoder_FillPending(upb_StreamDecoder* d,
+                                            const char* buf, size_t size) {
+  const upb_StreamDecoderFrame* frame = &d->frames[d->depth];
+  size_t taken = 0;
+  while (taken < size) {
+    upb_StreamField f;
+    upb_StreamScanResult r =
+        upb_StreamDecoder_ScanField(d->pending, d->pending_size, &f);
+    if (r != kUpb_StreamScan_Incomplete) break;
+
+    const upb_MiniTableField* field;
+    if (f.header_size && (upb_StreamDecoder_SubMessage(d, &f, &field) ||
+                          upb_StreamDecoder_StringField(d, &f))) {
+      break;
+    }
+
+    // Take exactly the rest of the field when we know its size. Otherwise,
+    // take enough for its header, or everything for an unknown group.
+    size_t want;
+    if (f.size) {
+      want = f.size - d->pending_size;
+    } else if (f.header_size && f.wire_type == kUpb_WireType_StartGroup) {
+      want = size - taken;
+    } else {
+      want = kUpb_StreamDecoder_MaxHeaderSize;
+    }
+    // Never take input that lies past the end of the current message.
+    want = UPB_MIN(want, size - taken);
+    want = UPB_MIN(want, frame->end - d->offset - d->pending_size);
+    if (want == 0) break;
+    if (!upb_StreamDecoder_AppendPending(d, buf + taken, want)) {
+      upb_StreamDecoder_SetError(d, kUpb_DecodeStatus_OutOfMemory);
+      break;
+    }
+    taken += want;
+  }
+  return taken;
+}
+
+upb_StreamDecoder* upb_StreamDecoder_New(upb_Message* msg,
+                                         const upb_MiniTable* mt,
+                                         const upb_ExtensionRegistry* extreg,
+                                         int options, upb_Arena* arena) {
+  UPB_ASSERT(!upb_Message_IsFrozen(msg));
+  upb_StreamDecoder* d = upb_gmalloc(sizeof(*d));
+  if (!d) return NULL;
+  d->frames =
+      upb_gmalloc(kUpb_StreamDecoder_InitialFrames * sizeof(*d->frames));
+  if (!d->frames) {
+    upb_gfree(d);
+    return NULL;
+  }
+  d->arena = arena;
+  d->extreg = extreg;
+  d->options = options & ~(kUpb_DecodeOption_AliasString |
+                           kUpb_DecodeOption_RetainEncoding);
+  d->max_depth = upb_DecodeOptions_GetEffectiveMaxDepth(options);
+  d->status = kUpb_DecodeStatus_Ok;
+  d->check_required = options & kUpb_DecodeOption_CheckRequired;
+  d->missing_required = false;
+  d->offset = 0;
+  d->frames[0].msg = msg;
+  d->frames[0].mt = mt;
+  d->frames[0].end = UINT64_MAX;
+  d->frames[0].group_number = DECODE_NOGROUP;
+  d->depth = 0;
+  d->frames_cap = kUpb_StreamDecoder_InitialFrames;
+  d->pending = NULL;
+  d->pending_size = 0;
+  d->pending_cap = 0;
+  d->string_field = NULL;
+  d->string_data = NULL;
+  d->string_size = 0;
+  d->string_filled = 0;
+  return d;
+}
+
+void upb_StreamDecoder_Free(upb_StreamDecoder* d) {
+  upb_gfree(d->pending);
+  upb_gfree(d->frames);
+  upb_gfree(d);
+}
+
+upb_DecodeStatus upb_StreamDecoder_Feed(upb_StreamDecoder* d, const char* buf,
+                                        size_t size) {
+  while (size > 0 && d->status == kUpb_DecodeStatus_Ok) {
+    if (d->string_field) {
+      size_t taken = upb_StreamDecoder_FillString(d, buf, size);
+      buf += taken;
+      size -= taken;
+      // Leave any messages that end with the string.
+      if (!d->string_field) upb_StreamDecoder_Consume(d, buf, 0);
+    } else if (d->pending_size) {
+      size_t taken = upb_StreamDecoder_FillPending(d, buf, size);
+      buf += taken;
+      size -= taken;
+      if (d->status != kUpb_DecodeStatus_Ok) break;
+      size_t used = upb_StreamDecoder_Consume(d, d->pending, d->pending_size);
+      d->pending_size -= used;
+      memmove(d->pending, d->pending + used, d->pending_size);
+    } else {
+      size_t used = upb_StreamDecoder_Consume(d, buf, size);
+      if (d->status != kUpb_DecodeStatus_Ok) break;
+      if (!upb_StreamDecoder_AppendPending(d, buf + used, size - used)) {
+        upb_StreamDecoder_SetError(d, kUpb_DecodeStatus_OutOfMemory);
+      }
+      size = 0;
+    }
+  }
+  if (d->status != kUpb_DecodeStatus_Ok) return d->status;
+  return d->pending_size || d->depth || d->string_field
+             ? kUpb_DecodeStatus_NeedMoreInput
+             : kUpb_DecodeStatus_Ok;
+}
+
+upb_DecodeStatus upb_StreamDecoder_Finish(upb_StreamDecoder* d) {
+  if (d->status != kUpb_DecodeStatus_Ok) return d->status;
+  if (d->pending_size || d->depth || d->string_field) {
+    return upb_StreamDecoder_SetError(d, kUpb_DecodeStatus_Malformed);
+  }
+  upb_StreamDecoder_CheckRequired(d, &d->frames[0]);
+  return d->missing_required ? kUpb_DecodeStatus_MissingRequired
+                             : kUpb_DecodeStatus_Ok;
 }
 
 const char* upb_DecodeStatus_String(upb_DecodeStatus status) {
@@ -1386,6 +2349,8 @@ const char* upb_DecodeStatus_String(upb_DecodeStatus status) {
       return "Exceeded upb_DecodeOptions_MaxDepth";
     case kUpb_DecodeStatus_MissingRequired:
       return "Missing required field";
+    case kUpb_DecodeStatus_NeedMoreInput:
+      return "Need more input";
     default:
       return "Unknown decode status";
   }
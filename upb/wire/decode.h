@@ -65,6 +65,29 @@ enum {
    *
    * If set, the fasttable decoder will not be used. */
   kUpb_DecodeOption_DisableFastTable = 16,
+
+  /* EXPERIMENTAL:
+   *
+   * If set, every length-delimited submessage that is created by the parse
+   * remembers the span of the input buffer it was parsed from. Once the whole
+   * top-level parse has succeeded, these submessages are frozen (the
+   * top-level message is not); if the parse fails, nothing is frozen. When a
+   * message is later encoded, such submessages are emitted by copying the
+   * retained bytes instead of being re-encoded field by field. Since frozen
+   * messages cannot be modified, the retained bytes are always up to date.
+   *
+   * This makes "parse, modify a few fields, serialize" cheap: to change a
+   * field inside a retained submessage, replace the submessage on the path to
+   * it with a mutable upb_Message_ShallowClone(); only the cloned messages
+   * are re-encoded.
+   *
+   * As with kUpb_DecodeOption_AliasString, the input buffer must outlive the
+   * message. Submessages that appear more than once on the wire and are
+   * merged, groups, and map values are decoded as usual and do not retain
+   * their encoding. The retained bytes are not used when encoding with
+   * kUpb_EncodeOption_Deterministic, kUpb_EncodeOption_SkipUnknown, or
+   * kUpb_EncodeOption_CheckRequired. */
+  kUpb_DecodeOption_RetainEncoding = 32,
 };
 // LINT.ThenChange(//depot/google3/third_party/upb/rust/wire.rs:decode_status)
 
@@ -97,6 +120,10 @@ typedef enum {
   // kUpb_DecodeOption_CheckRequired failed (see above), but the parse otherwise
   // succeeded.
   kUpb_DecodeStatus_MissingRequired = 11,
+
+  // Only returned by upb_StreamDecoder_Feed(): the input so far ends in the
+  // middle of a field or submessage.
+  kUpb_DecodeStatus_NeedMoreInput = 12,
 } upb_DecodeStatus;
 // LINT.ThenChange(//depot/google3/third_party/upb/rust/sys/wire/wire.rs:decode_status)
 
@@ -118,6 +145,206 @@ UPB_NODISCARD UPB_API upb_DecodeStatus upb_DecodeWithTrace(
     const upb_ExtensionRegistry* extreg, int options, upb_Arena* arena,
     char* trace_buf, size_t trace_size);
 
+// Batch decoding, for workloads that decode many small messages of one type
+// into a single arena. This gives the same results as calling upb_Decode()
+// on each input in turn, but the decoder and arena setup is done once per
+// batch instead of once per message, and the next input is prefetched while
+// the current one is being decoded.
+//
+//   upb_DecodeBatchItem items[n] = ...;  // Caller-created messages.
+//   size_t done;
+//   upb_DecodeStatus status =
+//       upb_DecodeBatch(items, n, mt, NULL, 0, arena, &done);
+//
+// Both functions stop at the first input that fails to decode and return its
+// status; on success they return kUpb_DecodeStatus_Ok. The failed message may
+// be partially populated, and the caller can skip it and continue with the
+// inputs that follow.
+typedef struct {
+  const char* buf;
+  size_t size;
+  upb_Message* msg;  // Must be a mutable message of the batch's MiniTable.
+} upb_DecodeBatchItem;
+
+// Decodes `items[0..count)`. `*num_decoded` is set to the number of items
+// that were decoded successfully, which is `count` on success.
+UPB_NODISCARD UPB_API upb_DecodeStatus upb_DecodeBatch(
+    const upb_DecodeBatchItem* items, size_t count, const upb_MiniTable* mt,
+    const upb_ExtensionRegistry* extreg, int options, upb_Arena* arena,
+    size_t* num_decoded);
+
+// Decodes a stream of varint length-prefixed messages, as written by
+// upb_EncodeLengthPrefixed(). Up to `max_msgs` messages are created in `arena`
+// and stored in `msgs`; decoding stops at the end of the input or when `msgs`
+// is full. `*num_msgs` is set to the number of messages decoded successfully,
+// and `*num_bytes_read` to the number of input bytes they occupied, so that a
+// caller can resume a longer stream from `buf + *num_bytes_read`.
+UPB_NODISCARD UPB_API upb_DecodeStatus upb_DecodeBatchLengthPrefixed(
+    const char* buf, size_t size, upb_Message** msgs, size_t max_msgs,
+    size_t* num_msgs, size_t* num_bytes_read, const upb_MiniTable* mt,
+    const upb_ExtensionRegistry* extreg, int options, upb_Arena* arena);
+
+// Streaming decoding, for messages that arrive in pieces (for example from a
+// socket) and are too large to buffer whole before decoding:
+//
+//   upb_StreamDecoder* sd =
+//       upb_StreamDecoder_New(msg, mt, NULL, options, arena);
+//   while (read(fd, buf, sizeof(buf)) > 0) {
+//     status = upb_StreamDecoder_Feed(sd, buf, n);
+//     if (status != kUpb_DecodeStatus_Ok &&
+//         status != kUpb_DecodeStatus_NeedMoreInput) {
+//       break;
+//     }
+//   }
+//   status = upb_StreamDecoder_Finish(sd);
+//   upb_StreamDecoder_Free(sd);
+//
+// Each chunk is decoded as far as the last complete field in it, and only the
+// incomplete tail is copied and kept for the next chunk. A length-delimited
+// submessage or group that is still incomplete is entered instead, so that
+// its own complete fields can be decoded, and this repeats at any depth. An
+// incomplete string or bytes field is copied straight into the arena as it
+// arrives. Otherwise the decoder only ever holds on to part of a single field
+// (a packed array, an unknown field, ...), so a large message can be decoded
+// with little more memory than the parsed message itself. Map entries are
+// always buffered whole.
+//
+// The result is the same as upb_Decode() on the concatenated input, except
+// that kUpb_DecodeOption_AliasString and kUpb_DecodeOption_RetainEncoding
+// are ignored, since chunks do not outlive the call that feeds them.
+typedef struct upb_StreamDecoder upb_StreamDecoder;
+
+// Creates a decoder that merges into `msg`, allocating the message data from
+// `arena`, which must outlive the decoder. The decoder's own buffers are heap
+// memory that is released by upb_StreamDecoder_Free(). Returns NULL on
+// allocation failure.
+UPB_API upb_StreamDecoder* upb_StreamDecoder_New(
+    upb_Message* msg, const upb_MiniTable* mt,
+    const upb_ExtensionRegistry* extreg, int options, upb_Arena* arena);
+
+// Decodes the next `size` bytes of input, which need not outlive the call.
+// Returns kUpb_DecodeStatus_Ok if the input so far ends at a field boundary
+// of the top-level message, kUpb_DecodeStatus_NeedMoreInput if it ends in the
+// middle of a field or submessage, or an error. Errors are sticky: once an
+// error is returned, every later call returns it too.
+UPB_NODISCARD UPB_API upb_DecodeStatus upb_StreamDecoder_Feed(
+    upb_StreamDecoder* d, const char* buf, size_t size);
+
+// Signals the end of the input. Returns kUpb_DecodeStatus_Malformed if the
+// input was truncated, and otherwise the final status of the decode, which
+// includes the kUpb_DecodeOption_CheckRequired result.
+UPB_NODISCARD UPB_API upb_DecodeStatus
+upb_StreamDecoder_Finish(upb_StreamDecoder* d);
+
+// Frees the decoder. The decoded message is unaffected.
+UPB_API void upb_StreamDecoder_Free(upb_StreamDecoder* d);
+
+// A projection restricts decoding to a subset of a message's fields, which lets
+// callers that only read a handful of fields out of a wide message avoid the
+// cost of materializing the rest.
+//
+// A projection is built from field-number paths, each of which selects one
+// field and everything beneath it:
+//
+//   uint32_t name[] = {1};         // Selects field 1.
+//   uint32_t nested_id[] = {5, 2}; // Selects field 2 of the message in field 5.
+//
+// Fields that are not selected are skipped on the wire and are NOT preserved
+// as unknown fields. Selected fields that are not in the MiniTable are stored
+// as unknown fields as usual. For map fields, the remainder of a path applies
+// to the map's value message; keys are always decoded. A shorter path subsumes
+// any longer paths that it is a prefix of.
+//
+// Because unselected fields are dropped, the decoded message is only a view
+// of the input; kUpb_DecodeOption_CheckRequired should not be combined with a
+// projection that omits required fields.
+typedef struct upb_DecodeProjection upb_DecodeProjection;
+
+// Creates an empty projection, which selects no fields. Returns NULL on
+// allocation failure.
+UPB_API upb_DecodeProjection* upb_DecodeProjection_New(upb_Arena* arena);
+
+// Adds the field-number path `path[0..len)` to the projection. Returns false
+// on allocation failure or if a field number is out of range, in which case
+// the projection may have been partially updated.
+UPB_API bool upb_DecodeProjection_AddPath(upb_DecodeProjection* p,
+                                          const uint32_t* path, size_t len,
+                                          upb_Arena* arena);
+
+// Same as upb_Decode, but only decodes the fields selected by `projection`.
+// The projection is not modified and may be shared by concurrent decodes.
+UPB_NODISCARD UPB_API upb_DecodeStatus upb_DecodeWithProjection(
+    const char* buf, size_t size, upb_Message* msg, const upb_MiniTable* mt,
+    const upb_ExtensionRegistry* extreg,
+    const upb_DecodeProjection* projection, int options, upb_Arena* arena);
+
+// Decode statistics, for tuning the fasttable decoder.
+//
+// upb_DecodeWithStats() decodes as usual, but every `sample_rate`-th call is a
+// sampled decode: it runs on the MiniTable decoder and records, for every
+// known field it parses, the message type and field number, and whether the
+// field's tag has a slot in the message's fasttable. From these counts we get
+// the fast-path hit rate, and a profile of which fields are hot:
+//
+//   upb_DecodeStats* stats = upb_DecodeStats_New(100, arena);
+//   for (...) upb_DecodeWithStats(buf, size, msg, mt, NULL, 0, arena, stats);
+//
+//   const upb_MiniTable* m;
+//   uint32_t number;
+//   uint64_t count;
+//   size_t iter = 0;
+//   while (upb_DecodeStats_NextField(stats, &m, &number, &count, &iter)) {
+//     const upb_MessageDef* def = upb_DefPool_FindMessageByMiniTable(pool, m);
+//     // Write "<full name of def> <number> <count>" to a profile file.
+//   }
+//
+// The stats only know MiniTables; upb_DefPool_FindMessageByMiniTable() maps
+// them back to the message names that the profile is keyed by. For generated
+// code, `pool` must be the one that the `.upbdefs.h` getters loaded into.
+//
+// The profile can be passed to the upb_minitable code generator with the
+// `fasttable_profile=<file>` parameter, so that hot fields win fasttable
+// slots over colder ones with colliding tags.
+//
+// Sampled decodes are slower than normal ones; decodes that are not sampled
+// cost one extra counter update. A upb_DecodeStats is not thread-safe.
+typedef struct upb_DecodeStats upb_DecodeStats;
+
+// Creates a stats object that samples one in every `sample_rate` decodes, or
+// every decode if `sample_rate` is 0 or 1. Returns NULL on allocation failure.
+// Per-field counts are allocated from `arena`, which must outlive `stats`.
+UPB_API upb_DecodeStats* upb_DecodeStats_New(uint32_t sample_rate,
+                                             upb_Arena* arena);
+
+// Same as upb_Decode, but records statistics into `stats`.
+UPB_NODISCARD UPB_API upb_DecodeStatus upb_DecodeWithStats(
+    const char* buf, size_t size, upb_Message* msg, const upb_MiniTable* mt,
+    const upb_ExtensionRegistry* extreg, int options, upb_Arena* arena,
+    upb_DecodeStats* stats);
+
+// Returns the number of upb_DecodeWithStats() calls, and how many of them
+// were sampled.
+UPB_API uint64_t upb_DecodeStats_Decodes(const upb_DecodeStats* stats);
+UPB_API uint64_t upb_DecodeStats_SampledDecodes(const upb_DecodeStats* stats);
+
+// Returns the number of known fields parsed by sampled decodes, and how many
+// of them had a fasttable slot. The ratio is the fast-path hit rate; it is
+// always 0 if fasttable is not compiled in.
+UPB_API uint64_t upb_DecodeStats_Fields(const upb_DecodeStats* stats);
+UPB_API uint64_t upb_DecodeStats_FastFields(const upb_DecodeStats* stats);
+
+// Returns how many times field `number` of `mt` was parsed by sampled decodes.
+UPB_API uint64_t upb_DecodeStats_FieldCount(const upb_DecodeStats* stats,
+                                            const upb_MiniTable* mt,
+                                            uint32_t number);
+
+// Iterates over the non-zero per-field counts, in no particular order. `*iter`
+// must be 0 for the first call.
+UPB_API bool upb_DecodeStats_NextField(const upb_DecodeStats* stats,
+                                       const upb_MiniTable** mt,
+                                       uint32_t* number, uint64_t* count,
+                                       size_t* iter);
+
 // Utility function for wrapper languages to get an error string from a
 // upb_DecodeStatus.
 UPB_API const char* upb_DecodeStatus_String(upb_DecodeStatus status);
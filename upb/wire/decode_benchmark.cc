@@ -5,18 +5,29 @@
 // license that can be found in the LICENSE file or at
 // https://developers.google.com/open-source/licenses/bsd
 
+#include <algorithm>
 #include <cstddef>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 #include "absl/container/flat_hash_set.h"
+#include "absl/log/absl_check.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "upb/base/descriptor_constants.h"
+#include "upb/base/status.hpp"
 #include "upb/mem/alloc.h"
 #include "upb/mem/arena.h"
 #include "upb/message/message.h"
+#include "upb/mini_descriptor/decode.h"
+#include "upb/mini_descriptor/internal/encode.hpp"
+#include "upb/mini_descriptor/link.h"
 #include "upb/mini_table/message.h"
+#include "upb/test/test.upb_minitable.h"
 #include "upb/wire/decode.h"
 #include "upb/wire/decode_fast/combinations.h"
 #include "upb/wire/test_util/field_types.h"
@@ -78,6 +89,229 @@ void BM_Decode(benchmark::State& state, const upb_MiniTable* mt,
   return arena;
 }();
 
+// Map-heavy messages: every entry is a small sub-message, so the per-entry
+// overhead of the map parser dominates.
+std::string MapEntry(wire_types::WireValue key, wire_types::WireValue val) {
+  return ToBinaryPayload(wire_types::WireMessage{{1, key}, {2, val}});
+}
+
+[[maybe_unused]] bool map_benchmark_registration = [] {
+  const upb_MiniTable* mt = &upb_0test__ModelWithMaps_msg_init;
+  std::vector<size_t> counts{8, 64, 512};
+  for (size_t count : counts) {
+    wire_types::WireMessage ss, ii, im;
+    for (size_t i = 0; i < count; i++) {
+      ss.push_back({3, wire_types::Delimited(
+                           MapEntry(wire_types::Delimited(absl::StrCat("k", i)),
+                                    wire_types::Delimited("value")))});
+      ii.push_back({4, wire_types::Delimited(MapEntry(
+                           wire_types::Varint(i), wire_types::Varint(i * 7)))});
+      std::string sub = ToBinaryPayload(wire_types::WireMessage{
+          {3, wire_types::Varint(i)}, {4, wire_types::Delimited("name")}});
+      im.push_back({5, wire_types::Delimited(MapEntry(
+                           wire_types::Varint(i), wire_types::Delimited(sub)))});
+    }
+    const std::pair<const char*, wire_types::WireMessage*> cases[] = {
+        {"StringString", &ss}, {"Int32Int32", &ii}, {"Int32Message", &im}};
+    for (const auto& [name, msg] : cases) {
+      ::benchmark::RegisterBenchmark(
+          absl::StrFormat("BM_DecodeMap/%s/%zu", name, count).c_str(),
+          BM_Decode, mt, ToBinaryPayload(*msg), false, false);
+    }
+  }
+  return true;
+}();
+
+[[maybe_unused]] upb_Arena* group_benchmark_registration = [] {
+  upb_Arena* arena = upb_Arena_New();
+  auto [sub_mt, sub_field] = MiniTable::MakeSingleFieldTable<field_types::Int32>(
+      1, kUpb_DecodeFast_Scalar, arena);
+  auto [mt, field] = MiniTable::MakeSingleFieldTable<field_types::Group>(
+      1, kUpb_DecodeFast_Repeated, arena);
+  const upb_MiniTable* subs[1] = {sub_mt};
+  bool linked =
+      upb_MiniTable_Link(const_cast<upb_MiniTable*>(mt), subs, 1, nullptr, 0);
+  ABSL_CHECK(linked);
+  std::vector<size_t> counts{8, 64, 512};
+  for (size_t count : counts) {
+    wire_types::WireMessage groups;
+    for (size_t i = 0; i < count; i++) {
+      groups.push_back({1, wire_types::Group{{1, wire_types::Varint(i)}}});
+    }
+    ::benchmark::RegisterBenchmark(
+        absl::StrFormat("BM_DecodeGroup/%zu", count).c_str(), BM_Decode, mt,
+        ToBinaryPayload(groups), false, false);
+  }
+  return arena;
+}();
+
+// A message with hundreds of optional fields, all of them set, so most of the
+// hasbits do not fit in the fasttable's hasbit accumulator.
+[[maybe_unused]] upb_Arena* wide_benchmark_registration = [] {
+  upb_Arena* arena = upb_Arena_New();
+  std::vector<size_t> counts{32, 128, 512};
+  for (size_t count : counts) {
+    upb::MtDataEncoder e;
+    e.StartMessage(0);
+    wire_types::WireMessage wire;
+    for (uint32_t i = 1; i <= count; i++) {
+      e.PutField(kUpb_FieldType_Int32, i, 0);
+      wire.push_back({i, wire_types::Varint(i)});
+    }
+    upb::Status status;
+    const upb_MiniTable* mt = upb_MiniTable_Build(
+        e.data().data(), e.data().size(), arena, status.ptr());
+    ABSL_CHECK(status.ok()) << status.error_message();
+    ::benchmark::RegisterBenchmark(
+        absl::StrFormat("BM_DecodeWide/%zu", count).c_str(), BM_Decode, mt,
+        ToBinaryPayload(wire), false, false);
+  }
+  return arena;
+}();
+
+// Many small messages of the same type, decoded one call at a time or as a
+// batch.  The per-call decoder setup is a large part of the cost here.
+enum SmallMessageMode { kSmallLoop, kSmallBatch, kSmallLengthPrefixed };
+
+void BM_DecodeSmallMessages(benchmark::State& state, const upb_MiniTable* mt,
+                            std::vector<std::string> payloads,
+                            SmallMessageMode mode) {
+  std::string stream;
+  size_t bytes = 0;
+  for (const std::string& payload : payloads) {
+    stream.push_back(static_cast<char>(payload.size()));
+    stream.append(payload);
+    bytes += payload.size();
+  }
+  std::vector<upb_DecodeBatchItem> items(payloads.size());
+  std::vector<upb_Message*> msgs(payloads.size());
+  for (auto s : state) {
+    upb_Arena* arena = upb_Arena_New();
+    upb_DecodeStatus result = kUpb_DecodeStatus_Ok;
+    switch (mode) {
+      case kSmallLoop:
+        for (const std::string& payload : payloads) {
+          upb_Message* msg = upb_Message_New(mt, arena);
+          result = upb_Decode(payload.data(), payload.size(), msg, mt, nullptr,
+                              0, arena);
+          if (result != kUpb_DecodeStatus_Ok) break;
+        }
+        break;
+      case kSmallBatch: {
+        for (size_t i = 0; i < payloads.size(); i++) {
+          items[i] = {payloads[i].data(), payloads[i].size(),
+                      upb_Message_New(mt, arena)};
+        }
+        size_t decoded;
+        result = upb_DecodeBatch(items.data(), items.size(), mt, nullptr, 0,
+                                 arena, &decoded);
+        break;
+      }
+      case kSmallLengthPrefixed: {
+        size_t num_msgs, num_bytes;
+        result = upb_DecodeBatchLengthPrefixed(
+            stream.data(), stream.size(), msgs.data(), msgs.size(), &num_msgs,
+            &num_bytes, mt, nullptr, 0, arena);
+        break;
+      }
+    }
+    ASSERT_EQ(result, kUpb_DecodeStatus_Ok) << upb_DecodeStatus_String(result);
+    upb_Arena_Free(arena);
+  }
+  state.SetItemsProcessed(state.iterations() * payloads.size());
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+[[maybe_unused]] upb_Arena* small_message_benchmark_registration = [] {
+  upb_Arena* arena = upb_Arena_New();
+  upb::MtDataEncoder e;
+  e.StartMessage(0);
+  e.PutField(kUpb_FieldType_Int64, 1, 0);
+  e.PutField(kUpb_FieldType_Int32, 2, 0);
+  e.PutField(kUpb_FieldType_String, 3, 0);
+  upb::Status status;
+  const upb_MiniTable* mt = upb_MiniTable_Build(
+      e.data().data(), e.data().size(), arena, status.ptr());
+  ABSL_CHECK(status.ok()) << status.error_message();
+  std::vector<size_t> counts{16, 256};
+  for (size_t count : counts) {
+    std::vector<std::string> payloads;
+    for (size_t i = 0; i < count; i++) {
+      payloads.push_back(ToBinaryPayload(wire_types::WireMessage{
+          {1, wire_types::Varint(i * 1000)},
+          {2, wire_types::Varint(i)},
+          {3, wire_types::Delimited("id")}}));
+    }
+    const std::pair<const char*, SmallMessageMode> modes[] = {
+        {"Loop", kSmallLoop},
+        {"Batch", kSmallBatch},
+        {"LengthPrefixed", kSmallLengthPrefixed}};
+    for (const auto& [name, mode] : modes) {
+      ::benchmark::RegisterBenchmark(
+          absl::StrFormat("BM_DecodeSmallMessages/%s/%zu", name, count)
+              .c_str(),
+          BM_DecodeSmallMessages, mt, payloads, mode);
+    }
+  }
+  return arena;
+}();
+
+// A large message made of many small submessages, decoded whole or fed to a
+// upb_StreamDecoder in chunks of the given size.
+void BM_DecodeStream(benchmark::State& state, const upb_MiniTable* mt,
+                     std::string payload, size_t chunk_size) {
+  for (auto s : state) {
+    upb_Arena* arena = upb_Arena_New();
+    upb_Message* msg = upb_Message_New(mt, arena);
+    upb_DecodeStatus result;
+    if (chunk_size == 0) {
+      result = upb_Decode(payload.data(), payload.size(), msg, mt, nullptr, 0,
+                          arena);
+    } else {
+      upb_StreamDecoder* d =
+          upb_StreamDecoder_New(msg, mt, nullptr, 0, arena);
+      for (size_t i = 0; i < payload.size(); i += chunk_size) {
+        size_t n = std::min(chunk_size, payload.size() - i);
+        result = upb_StreamDecoder_Feed(d, payload.data() + i, n);
+        if (result != kUpb_DecodeStatus_NeedMoreInput) {
+          ASSERT_EQ(result, kUpb_DecodeStatus_Ok)
+              << upb_DecodeStatus_String(result);
+        }
+      }
+      result = upb_StreamDecoder_Finish(d);
+      upb_StreamDecoder_Free(d);
+    }
+    ASSERT_EQ(result, kUpb_DecodeStatus_Ok) << upb_DecodeStatus_String(result);
+    upb_Arena_Free(arena);
+  }
+  state.SetBytesProcessed(state.iterations() * payload.size());
+}
+
+[[maybe_unused]] upb_Arena* stream_benchmark_registration = [] {
+  upb_Arena* arena = upb_Arena_New();
+  auto [sub_mt, sub_field] = MiniTable::MakeSingleFieldTable<field_types::Int32>(
+      1, kUpb_DecodeFast_Scalar, arena);
+  auto [mt, field] = MiniTable::MakeSingleFieldTable<field_types::Message>(
+      1, kUpb_DecodeFast_Repeated, arena);
+  const upb_MiniTable* subs[1] = {sub_mt};
+  bool linked =
+      upb_MiniTable_Link(const_cast<upb_MiniTable*>(mt), subs, 1, nullptr, 0);
+  ABSL_CHECK(linked);
+  wire_types::WireMessage wire;
+  for (size_t i = 0; i < 100000; i++) {
+    std::string sub =
+        ToBinaryPayload(wire_types::WireMessage{{1, wire_types::Varint(i)}});
+    wire.push_back({1, wire_types::Delimited(sub)});
+  }
+  std::string payload = ToBinaryPayload(wire);
+  for (size_t chunk_size : {0, 512, 65536}) {
+    ::benchmark::RegisterBenchmark(
+        absl::StrFormat("BM_DecodeStream/%zu", chunk_size).c_str(),
+        BM_DecodeStream, mt, payload, chunk_size);
+  }
+  return arena;
+}();
+
 }  // namespace
 
 }  // namespace test
@@ -161,8 +161,16 @@ upb_DecodeFast_Unreachable(UPB_PARSE_PARAMS) {
                                  upb_DecodeFast_Unreachable)
 
 UPB_FORCEINLINE
-uint64_t upb_DecodeFast_LoadHasbits(upb_Message* msg) {
-  return *(uint32_t*)&msg[1];
+void upb_DecodeFast_SetHasbit(upb_Message* msg, uint64_t* hasbits,
+                              uint8_t presence) {
+  if (UPB_LIKELY(presence <= kUpb_DecodeFast_NoHasbit)) {
+    *hasbits |= 1ull << presence;
+  } else {
+    // Hasbits past the accumulator are set directly in the message.
+    uint32_t index = presence - 1;
+    char* bytes = (char*)&msg[1];
+    bytes[index / 8] |= 1 << (index % 8);
+  }
 }
 
 /* Error function that will abort decoding with longjmp(). We can't declare this
@@ -221,7 +229,9 @@ bool upb_DecodeFast_TryFlipPacked(upb_DecodeFast_Type type,
                                   upb_DecodeFast_Cardinality card,
                                   upb_DecodeFast_TagSize tagsize,
                                   uint64_t* data, uint64_t data2) {
-  if (!upb_DecodeFast_IsRepeated(card)) return false;
+  if (!upb_DecodeFast_IsRepeated(card) || !upb_DecodeFast_IsPackable(type)) {
+    return false;
+  }
   *data ^= kUpb_WireType_Delimited ^ upb_DecodeFast_WireType(type);
   uint16_t expected = upb_DecodeFastData_GetExpectedTag(*data);
   uint16_t actual = upb_DecodeFastData2_GetOriginalTag(data2);
@@ -251,8 +261,8 @@ bool upb_DecodeFast_GetScalarField(upb_Decoder* d, const char* ptr,
     case kUpb_DecodeFast_Scalar: {
       // Set hasbit and return pointer to scalar field.
       *dst = UPB_PTR_AT(msg, upb_DecodeFastData_GetOffset(data), char);
-      uint8_t hasbit_index = upb_DecodeFastData_GetPresence(data);
-      *hasbits |= 1ull << hasbit_index;
+      upb_DecodeFast_SetHasbit(msg, hasbits,
+                               upb_DecodeFastData_GetPresence(data));
       return true;
     }
     case kUpb_DecodeFast_Oneof: {
@@ -260,7 +270,8 @@ bool upb_DecodeFast_GetScalarField(upb_Decoder* d, const char* ptr,
       uint16_t case_ofs = upb_DecodeFastData_GetCaseOffset(data);
       uint32_t* oneof_case = UPB_PTR_AT(msg, case_ofs, uint32_t);
       uint8_t field_number = upb_DecodeFastData_GetPresence(data);
-      if (type == kUpb_DecodeFast_Message && *oneof_case != field_number) {
+      if ((type == kUpb_DecodeFast_Message || type == kUpb_DecodeFast_Group) &&
+          *oneof_case != field_number) {
         memset(*dst, 0, sizeof(void*));
       }
       *oneof_case = field_number;
@@ -20,9 +20,10 @@
 // These macros enumerate all possibilities for each of these three dimensions.
 //
 // These can be generated in any combination, except that non-primitive types
-// cannot be packed.  So we have:
+// cannot be packed and maps are always repeated.  So we have:
 //   {1bt,2bt} x {s,o,r,p} x {b,v32,v64,z32,z64,f32,f64,ce}  // Primitive
-//   {1bt,2bt} x {s,o,r}   x {s,b,m}                         // Non-primitive
+//   {1bt,2bt} x {s,o,r}   x {s,b,m,g}                       // Non-primitive
+//   {1bt,2bt} x {r}       x {map}                           // Map
 
 #define UPB_DECODEFAST_CARDINALITIES(F, ...) \
   F(__VA_ARGS__, Scalar)                     \
@@ -41,7 +42,9 @@
   F(__VA_ARGS__, String)             \
   F(__VA_ARGS__, Bytes)              \
   F(__VA_ARGS__, Message)            \
-  F(__VA_ARGS__, ClosedEnum)
+  F(__VA_ARGS__, ClosedEnum)         \
+  F(__VA_ARGS__, Group)              \
+  F(__VA_ARGS__, Map)
 
 #define UPB_DECODEFAST_TAGSIZES(F, ...) \
   F(__VA_ARGS__, Tag1Byte)              \
@@ -99,6 +102,8 @@ UPB_INLINE int upb_DecodeFast_ValueBytes(upb_DecodeFast_Type type) {
     case kUpb_DecodeFast_ZigZag64:
     case kUpb_DecodeFast_Fixed64:
     case kUpb_DecodeFast_Message:
+    case kUpb_DecodeFast_Group:
+    case kUpb_DecodeFast_Map:
       return 8;
     case kUpb_DecodeFast_ClosedEnum:
       return 4;
@@ -126,7 +131,10 @@ UPB_INLINE upb_WireType upb_DecodeFast_WireType(upb_DecodeFast_Type type) {
     case kUpb_DecodeFast_Message:
     case kUpb_DecodeFast_String:
     case kUpb_DecodeFast_Bytes:
+    case kUpb_DecodeFast_Map:
       return kUpb_WireType_Delimited;
+    case kUpb_DecodeFast_Group:
+      return kUpb_WireType_StartGroup;
     default:
       UPB_UNREACHABLE();
   }
@@ -140,6 +148,20 @@ UPB_INLINE bool upb_DecodeFast_IsRepeated(upb_DecodeFast_Cardinality card) {
   return card == kUpb_DecodeFast_Repeated || card == kUpb_DecodeFast_Packed;
 }
 
+// Returns true if the type can use the packed encoding.
+UPB_INLINE bool upb_DecodeFast_IsPackable(upb_DecodeFast_Type type) {
+  switch (type) {
+    case kUpb_DecodeFast_String:
+    case kUpb_DecodeFast_Bytes:
+    case kUpb_DecodeFast_Message:
+    case kUpb_DecodeFast_Group:
+    case kUpb_DecodeFast_Map:
+      return false;
+    default:
+      return true;
+  }
+}
+
 UPB_INLINE bool upb_DecodeFast_IsZigZag(upb_DecodeFast_Type type) {
   switch (type) {
     case kUpb_DecodeFast_ZigZag32:
@@ -155,9 +177,9 @@ UPB_INLINE bool upb_DecodeFast_IsZigZag(upb_DecodeFast_Type type) {
 // cardinality, type, and tag size enums.
 //
 // This ordering generates some combinations that are not actually used (like
-// packed strings or messages), but it's simpler than trying to avoid them.
-// There are only 14 impossible combinations out of 120 total, so it's not
-// worth optimizing for.
+// packed strings or messages, or non-repeated maps), but it's simpler than
+// trying to avoid them. There are only 14 impossible combinations out of 104
+// total, so it's not worth optimizing for.
 #define UPB_DECODEFAST_FUNCTIONS(F) \
   UPB_DECODEFAST_TYPES(UPB_DECODEFAST_CARDINALITIES, UPB_DECODEFAST_TAGSIZES, F)
 
@@ -200,16 +222,16 @@ UPB_INLINE upb_DecodeFast_Type upb_DecodeFast_GetType(uint32_t function_idx) {
 // since we use it when initializing the fastdecode function array.
 //
 // This function only applies to field types that have been assigned a function
-// index.  Some field types (eg. groups) do not even have a function index at
-// the moment, and so will be rejected by upb_DecodeFast_TryFillEntry() before
-// we even get here.
-#define UPB_DECODEFAST_COMBINATION_IS_ENABLED(type, card, size)              \
-  (type == kUpb_DecodeFast_Fixed32 || type == kUpb_DecodeFast_Fixed64 ||     \
-   ((type == kUpb_DecodeFast_Varint32 || type == kUpb_DecodeFast_Varint64 || \
-     type == kUpb_DecodeFast_ZigZag32 || type == kUpb_DecodeFast_ZigZag64 || \
-     type == kUpb_DecodeFast_Bool || type == kUpb_DecodeFast_Bytes ||        \
-     type == kUpb_DecodeFast_String || type == kUpb_DecodeFast_Message ||    \
-     type == kUpb_DecodeFast_ClosedEnum)))
+// index.  Field types without one are rejected by upb_DecodeFast_TryFillEntry()
+// before we even get here.
+#define UPB_DECODEFAST_COMBINATION_IS_ENABLED(type, card, size)               \
+  (type == kUpb_DecodeFast_Fixed32 || type == kUpb_DecodeFast_Fixed64 ||      \
+   ((type == kUpb_DecodeFast_Varint32 || type == kUpb_DecodeFast_Varint64 ||  \
+     type == kUpb_DecodeFast_ZigZag32 || type == kUpb_DecodeFast_ZigZag64 ||  \
+     type == kUpb_DecodeFast_Bool || type == kUpb_DecodeFast_Bytes ||         \
+     type == kUpb_DecodeFast_String || type == kUpb_DecodeFast_Message ||     \
+     type == kUpb_DecodeFast_ClosedEnum || type == kUpb_DecodeFast_Group)) || \
+   (type == kUpb_DecodeFast_Map && card == kUpb_DecodeFast_Repeated))
 
 #ifdef UPB_DECODEFAST_DISABLE_FUNCTIONS_ABOVE
 #define UPB_DECODEFAST_ISENABLED(type, card, size)            \
@@ -24,11 +24,18 @@
 // - `offset` is the offset of the field in the message struct.
 // - `case_offset` is the offset of the oneof selector for a oneof field
 //   (or 0 if not a oneof field).
-// - `presence` is either hasbit index or field number for oneofs.
+// - `presence` is either hasbit index or field number for oneofs. Hasbits
+//   below kUpb_DecodeFast_NoHasbit are accumulated in a register while
+//   parsing. kUpb_DecodeFast_NoHasbit itself marks a field without a hasbit,
+//   and larger values are `hasbit index + 1`, set directly in the message.
 // - `subofs` is the 8 byte shifted submessage offset from the fields array
 //    start into the subs array (or 0 if no sub).
 // - `expected_tag` is the expected value of the tag for this field.
 
+// Presence value for fields without a hasbit. It is also the bit in the
+// hasbits accumulator that such fields set, which is never stored back.
+#define kUpb_DecodeFast_NoHasbit 63
+
 UPB_INLINE bool upb_DecodeFast_MakeData(uint64_t offset, uint64_t case_offset,
                                         uint64_t presence, uint64_t subofs,
                                         uint64_t expected_tag,
@@ -87,8 +87,10 @@ upb_DecodeFast_Dispatch(UPB_PARSE_PARAMS) {
 
 UPB_FORCEINLINE
 void upb_DecodeFast_SetHasbits(upb_Message* msg, uint64_t hasbits) {
+  hasbits &= ~(1ull << kUpb_DecodeFast_NoHasbit);
+  // Messages with no hasbits may be too small for the 8-byte store.
   // TODO: Can we use `=` instead of` |=`?
-  *(uint32_t*)&msg[1] |= hasbits;
+  if (hasbits) *(uint64_t*)&msg[1] |= hasbits;
 }
 
 #include "upb/port/undef.inc"
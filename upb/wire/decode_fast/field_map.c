@@ -0,0 +1,386 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Fast parsers for map fields.
+//
+// The generic decoder parses every map entry as a upb_MapEntry message with
+// the MiniTable decoder and then copies the key and value into the map. Here
+// we instead read the key and value straight out of the input buffer and
+// insert them into the map's table, specializing the loop for the most common
+// key/value combinations.
+//
+// Only entries that lie entirely within the current buffer, and whose contents
+// are exactly an optional key followed by an optional value, are handled. Any
+// other entry (fields out of order, unknown fields, a missing message value,
+// etc.) falls back to the MiniTable decoder before any of its input is
+// consumed.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "upb/base/descriptor_constants.h"
+#include "upb/base/string_view.h"
+#include "upb/message/internal/map.h"
+#include "upb/message/internal/message.h"
+#include "upb/message/map.h"
+#include "upb/message/message.h"
+#include "upb/mini_table/field.h"
+#include "upb/mini_table/internal/field.h"
+#include "upb/mini_table/internal/message.h"
+#include "upb/mini_table/internal/sub.h"
+#include "upb/mini_table/message.h"
+#include "upb/wire/decode.h"
+#include "upb/wire/decode_fast/cardinality.h"
+#include "upb/wire/decode_fast/combinations.h"
+#include "upb/wire/decode_fast/data.h"
+#include "upb/wire/decode_fast/dispatch.h"
+#include "upb/wire/decode_fast/field_parsers.h"
+#include "upb/wire/eps_copy_input_stream.h"
+#include "upb/wire/internal/decoder.h"
+#include "upb/wire/reader.h"
+#include "upb/wire/types.h"
+
+// Must be last.
+#include "upb/port/def.inc"
+
+// The representations of map keys and values that the fast parser supports.
+typedef enum {
+  kUpb_DecodeFast_MapUnsupported = 0,
+  kUpb_DecodeFast_MapVarint32,
+  kUpb_DecodeFast_MapVarint64,
+  kUpb_DecodeFast_MapBool,
+  kUpb_DecodeFast_MapString,  // Validated UTF-8.
+  kUpb_DecodeFast_MapBytes,
+  kUpb_DecodeFast_MapMessage,
+} upb_DecodeFast_MapKind;
+
+typedef union {
+  upb_StringView str;
+  uint64_t u64;
+  uint32_t u32;
+  bool b;
+  upb_Message* msg;
+} upb_DecodeFast_MapValue;
+
+typedef struct {
+  const upb_MiniTable* table;
+  upb_Message* msg;
+} upb_DecodeFast_MapMessageValue;
+
+UPB_FORCEINLINE
+upb_DecodeFast_MapKind upb_DecodeFast_GetMapKind(const upb_MiniTableField* f) {
+  // As in select.c, we rely on the munging of descriptortype: open enums are
+  // Int32, and strings that do not need validation are Bytes.
+  switch (f->UPB_PRIVATE(descriptortype)) {
+    case kUpb_FieldType_Int32:
+    case kUpb_FieldType_UInt32:
+      return kUpb_DecodeFast_MapVarint32;
+    case kUpb_FieldType_Int64:
+    case kUpb_FieldType_UInt64:
+      return kUpb_DecodeFast_MapVarint64;
+    case kUpb_FieldType_Bool:
+      return kUpb_DecodeFast_MapBool;
+    case kUpb_FieldType_String:
+      return kUpb_DecodeFast_MapString;
+    case kUpb_FieldType_Bytes:
+      return kUpb_DecodeFast_MapBytes;
+    case kUpb_FieldType_Message:
+      return kUpb_DecodeFast_MapMessage;
+    default:
+      return kUpb_DecodeFast_MapUnsupported;
+  }
+}
+
+UPB_FORCEINLINE
+size_t upb_DecodeFast_MapSize(upb_DecodeFast_MapKind kind) {
+  switch (kind) {
+    case kUpb_DecodeFast_MapVarint32:
+      return 4;
+    case kUpb_DecodeFast_MapVarint64:
+      return 8;
+    case kUpb_DecodeFast_MapBool:
+      return 1;
+    case kUpb_DecodeFast_MapString:
+    case kUpb_DecodeFast_MapBytes:
+      return UPB_MAPTYPE_STRING;
+    case kUpb_DecodeFast_MapMessage:
+      return sizeof(upb_Message*);
+    default:
+      UPB_UNREACHABLE();
+  }
+}
+
+UPB_FORCEINLINE
+uint8_t upb_DecodeFast_MapTag(uint32_t number, upb_DecodeFast_MapKind kind) {
+  bool delimited = kind == kUpb_DecodeFast_MapString ||
+                   kind == kUpb_DecodeFast_MapBytes ||
+                   kind == kUpb_DecodeFast_MapMessage;
+  return (number << 3) |
+         (delimited ? kUpb_WireType_Delimited : kUpb_WireType_Varint);
+}
+
+// Reads a scalar key or value that must end at or before `end`. Returns false
+// with `*next` unchanged if the entry must be handed to the MiniTable decoder.
+UPB_FORCEINLINE
+bool upb_DecodeFast_MapScalar(upb_Decoder* d, const char** ptr,
+                              const char* end, upb_DecodeFast_MapKind kind,
+                              upb_DecodeFast_MapValue* out,
+                              upb_DecodeFastNext* next) {
+  const char* p = *ptr;
+  switch (kind) {
+    case kUpb_DecodeFast_MapVarint32:
+    case kUpb_DecodeFast_MapVarint64:
+    case kUpb_DecodeFast_MapBool: {
+      uint64_t val;
+      p = upb_WireReader_ReadVarint(p, &val, EPS(d));
+      if (UPB_UNLIKELY(p == NULL || p > end)) return false;
+      if (kind == kUpb_DecodeFast_MapVarint32) {
+        out->u32 = (uint32_t)val;
+      } else if (kind == kUpb_DecodeFast_MapVarint64) {
+        out->u64 = val;
+      } else {
+        out->b = val != 0;
+      }
+      break;
+    }
+    case kUpb_DecodeFast_MapString:
+    case kUpb_DecodeFast_MapBytes: {
+      int size;
+      if (!upb_DecodeFast_DecodeSize(d, &p, &size, next)) return false;
+      if (UPB_UNLIKELY(size > end - p)) return false;
+      if (!_upb_Decoder_ReadString(d, &p, size, &out->str,
+                                   kind == kUpb_DecodeFast_MapString)) {
+        return UPB_DECODEFAST_ERROR(d, kUpb_DecodeStatus_OutOfMemory, next);
+      }
+      break;
+    }
+    default:
+      UPB_UNREACHABLE();
+  }
+  *ptr = p;
+  return true;
+}
+
+static const char* upb_DecodeFast_MapValueData(upb_EpsCopyInputStream* st,
+                                               const char* ptr, int size,
+                                               void* ctx) {
+  upb_Decoder* d = (upb_Decoder*)st;
+  const upb_MiniTable* table = ((upb_DecodeFast_MapMessageValue*)ctx)->table;
+  upb_Message* msg = ((upb_DecodeFast_MapMessageValue*)ctx)->msg;
+  ptr = _upb_Decoder_DecodeMessage(d, ptr, msg, table);
+  if (d->end_group != DECODE_NOGROUP) {
+    _upb_FastDecoder_ErrorJmp(d, kUpb_DecodeStatus_Malformed);
+  }
+  return ptr;
+}
+
+// Parses one map entry into `map`. `*ptr` points to the entry's length.
+//
+// Returns false if the entry could not be parsed; `*next` then says whether
+// that is an error or the entry should be parsed by the MiniTable decoder, in
+// which case nothing has been inserted and the caller's pointer is left at the
+// entry's tag.
+UPB_FORCEINLINE
+bool upb_DecodeFast_MapEntry(upb_Decoder* d, const char** ptr, upb_Map* map,
+                             const upb_MiniTable* entry,
+                             upb_DecodeFast_MapKind key_kind,
+                             upb_DecodeFast_MapKind val_kind,
+                             upb_DecodeFastNext* next) {
+  const char* p = *ptr;
+  int size;
+  if (!upb_DecodeFast_DecodeSize(d, &p, &size, next)) return false;
+
+  // Requiring the whole entry to be in the current buffer lets us bounds check
+  // against `end` instead of pushing a limit.
+  if (UPB_UNLIKELY(size > d->input.limit_ptr - p)) {
+    return UPB_DECODEFAST_EXIT(kUpb_DecodeFastNext_FallbackToMiniTable, next);
+  }
+  const char* end = p + size;
+
+  upb_DecodeFast_MapValue key = {{NULL, 0}};
+  upb_DecodeFast_MapValue val = {{NULL, 0}};
+
+  if (p < end && (uint8_t)*p == upb_DecodeFast_MapTag(1, key_kind)) {
+    p++;
+    if (!upb_DecodeFast_MapScalar(d, &p, end, key_kind, &key, next)) {
+      goto fallback;
+    }
+  }
+
+  if (p == end || (uint8_t)*p != upb_DecodeFast_MapTag(2, val_kind)) {
+    // The MiniTable decoder creates an empty message for a missing value.
+    if (p != end || val_kind == kUpb_DecodeFast_MapMessage) goto fallback;
+  } else if (val_kind == kUpb_DecodeFast_MapMessage) {
+    const upb_MiniTable* val_table =
+        upb_MiniTable_SubMessage(&entry->UPB_PRIVATE(fields)[1]);
+    const char* val_start = p + 1;
+    int val_size;
+    if (!upb_DecodeFast_DecodeSize(d, &val_start, &val_size, next)) {
+      return false;
+    }
+    if (val_table == NULL || val_start + val_size != end) goto fallback;
+
+    // From here on the entry is ours: the value is parsed in place.
+    p++;
+    val.msg = _upb_Message_New(val_table, &d->arena);
+    if (val.msg == NULL) {
+      return UPB_DECODEFAST_ERROR(d, kUpb_DecodeStatus_OutOfMemory, next);
+    }
+    if (--d->depth < 0) {
+      return UPB_DECODEFAST_ERROR(d, kUpb_DecodeStatus_MaxDepthExceeded, next);
+    }
+    upb_DecodeFast_MapMessageValue ctx = {val_table, val.msg};
+    if (!upb_DecodeFast_Delimited(d, &p, &upb_DecodeFast_MapValueData, next,
+                                  &ctx)) {
+      *ptr = p;
+      return false;
+    }
+    d->depth++;
+  } else {
+    p++;
+    if (!upb_DecodeFast_MapScalar(d, &p, end, val_kind, &val, next) ||
+        p != end) {
+      goto fallback;
+    }
+  }
+
+  if (_upb_Map_Insert(map, &key, upb_DecodeFast_MapSize(key_kind), &val,
+                      upb_DecodeFast_MapSize(val_kind),
+                      &d->arena) == kUpb_MapInsertStatus_OutOfMemory) {
+    return UPB_DECODEFAST_ERROR(d, kUpb_DecodeStatus_OutOfMemory, next);
+  }
+
+  *ptr = p;
+  return true;
+
+fallback:
+  // Strings that were already copied into the arena are simply abandoned.
+  return UPB_DECODEFAST_EXIT(kUpb_DecodeFastNext_FallbackToMiniTable, next);
+}
+
+UPB_FORCEINLINE
+void upb_DecodeFast_MapEntries(upb_Decoder* d, const char** ptr,
+                               upb_Message* msg, uint64_t data,
+                               upb_DecodeFastNext* ret,
+                               upb_DecodeFast_TagSize tagsize,
+                               const upb_MiniTable* entry,
+                               upb_DecodeFast_MapKind key_kind,
+                               upb_DecodeFast_MapKind val_kind) {
+  upb_Map** map_p = UPB_PTR_AT(msg, upb_DecodeFastData_GetOffset(data), upb_Map*);
+  upb_Map* map = *map_p;
+
+  if (UPB_UNLIKELY(map == NULL)) {
+    map = _upb_Map_New(&d->arena, upb_DecodeFast_MapSize(key_kind),
+                       upb_DecodeFast_MapSize(val_kind));
+    if (map == NULL) {
+      UPB_DECODEFAST_ERROR(d, kUpb_DecodeStatus_OutOfMemory, ret);
+      return;
+    }
+    *map_p = map;
+  }
+
+  uint16_t expected = upb_DecodeFastData_GetExpectedTag(data);
+  const char* p = *ptr + upb_DecodeFast_TagSizeBytes(tagsize);
+
+  // Each entry is a (trivial) sub-message, so it counts towards the depth
+  // limit just like it does in the MiniTable decoder.
+  if (--d->depth < 0) {
+    UPB_DECODEFAST_ERROR(d, kUpb_DecodeStatus_MaxDepthExceeded, ret);
+    return;
+  }
+
+  while (upb_DecodeFast_MapEntry(d, &p, map, entry, key_kind, val_kind, ret)) {
+    *ptr = p;
+    _upb_Decoder_Trace(d, 'F');
+    if (!upb_DecodeFast_TryMatchTag(d, p, expected, ret, tagsize)) break;
+    p += upb_DecodeFast_TagSizeBytes(tagsize);
+  }
+
+  d->depth++;
+}
+
+UPB_FORCEINLINE
+void upb_DecodeFast_Map(upb_Decoder* d, const char** ptr, upb_Message* msg,
+                        const upb_MiniTable* table, uint64_t data,
+                        upb_DecodeFastNext* ret, upb_DecodeFast_TagSize tagsize,
+                        uint64_t data2) {
+  uint16_t expected = upb_DecodeFastData_GetExpectedTag(data);
+  uint16_t actual = upb_DecodeFastData2_GetOriginalTag(data2);
+  if (UPB_UNLIKELY(!upb_DecodeFast_TagMatches(expected, actual, tagsize))) {
+    UPB_DECODEFAST_EXIT(kUpb_DecodeFastNext_FallbackMismatchedSlot, ret);
+    return;
+  }
+
+  uint32_t submsg_ofs = upb_DecodeFastData_GetSubofs(data) * 8;
+  const upb_MiniTableSubInternal* sub = UPB_PTR_AT(
+      table->UPB_ONLYBITS(fields), submsg_ofs, upb_MiniTableSubInternal);
+  const upb_MiniTable* entry = sub->UPB_PRIVATE(submsg);
+
+  // The entry's layout is only known once the field is linked, so we look up
+  // the key and value kinds here rather than when building the table.
+  if (UPB_UNLIKELY(entry == NULL)) {
+    UPB_DECODEFAST_EXIT(kUpb_DecodeFastNext_FallbackToMiniTable, ret);
+    return;
+  }
+  upb_DecodeFast_MapKind key_kind =
+      upb_DecodeFast_GetMapKind(&entry->UPB_PRIVATE(fields)[0]);
+  upb_DecodeFast_MapKind val_kind =
+      upb_DecodeFast_GetMapKind(&entry->UPB_PRIVATE(fields)[1]);
+
+#define CASE(k, v)                                                           \
+  case (kUpb_DecodeFast_Map##k << 8) | kUpb_DecodeFast_Map##v:               \
+    upb_DecodeFast_MapEntries(d, ptr, msg, data, ret, tagsize, entry,        \
+                              kUpb_DecodeFast_Map##k, kUpb_DecodeFast_Map##v); \
+    return;
+
+  // Specialize the most common combinations, so that the key and value
+  // handling is resolved at compile time. Proto2 string fields skip UTF-8
+  // validation and show up here as bytes.
+  switch ((key_kind << 8) | val_kind) {
+    CASE(String, String)
+    CASE(String, Bytes)
+    CASE(Bytes, Bytes)
+    CASE(Bytes, Message)
+    CASE(String, Message)
+    CASE(String, Varint64)
+    CASE(Varint32, Varint32)
+    CASE(Varint64, Varint64)
+    default:
+      break;
+  }
+
+#undef CASE
+
+  if (key_kind == kUpb_DecodeFast_MapUnsupported ||
+      key_kind == kUpb_DecodeFast_MapMessage ||
+      val_kind == kUpb_DecodeFast_MapUnsupported) {
+    // Closed enums, zigzag and fixed-width types, and group values.
+    UPB_DECODEFAST_EXIT(kUpb_DecodeFastNext_FallbackToMiniTable, ret);
+    return;
+  }
+
+  upb_DecodeFast_MapEntries(d, ptr, msg, data, ret, tagsize, entry, key_kind,
+                            val_kind);
+}
+
+#define F(type, card, tagsize)                                           \
+  upb_FastDecoder_Return UPB_PRESERVE_NONE UPB_DECODEFAST_FUNCNAME(      \
+      type, card, tagsize)(UPB_PARSE_PARAMS) {                           \
+    upb_DecodeFastNext next = kUpb_DecodeFastNext_Dispatch;              \
+    upb_DecodeFast_Map(d, &ptr, msg, table, data, &next,                 \
+                       kUpb_DecodeFast_##tagsize, data2);                \
+    UPB_DECODEFAST_NEXT(next);                                           \
+  }
+
+// Maps are always repeated, so only the Repeated functions are ever selected;
+// the others exist only to fill out the function array.
+UPB_DECODEFAST_CARDINALITIES(UPB_DECODEFAST_TAGSIZES, F, Map)
+
+#undef F
+
+#include "upb/port/undef.inc"
@@ -18,6 +18,7 @@
 #include "upb/wire/decode_fast/combinations.h"
 #include "upb/wire/decode_fast/data.h"
 #include "upb/wire/decode_fast/dispatch.h"
+#include "upb/wire/decode_fast/field_helpers.h"
 #include "upb/wire/decode_fast/field_parsers.h"
 #include "upb/wire/eps_copy_input_stream.h"
 #include "upb/wire/internal/decoder.h"
@@ -28,6 +29,7 @@
 typedef struct {
   const upb_MiniTable* table;
   bool is_repeated;
+  uint32_t number;  // Field number, for matching the END_GROUP tag of groups.
   upb_Message* msg;
 } upb_DecodeFast_MessageContext;
 
@@ -44,10 +46,8 @@ const char* upb_DecodeFast_MessageData(upb_EpsCopyInputStream* st,
 }
 
 UPB_FORCEINLINE
-bool upb_DecodeFast_SingleMessage(upb_Decoder* d, const char** ptr, void* dst,
-                                  upb_DecodeFast_Type type,
-                                  upb_DecodeFastNext* next, void* ctx) {
-  upb_DecodeFast_MessageContext* c = ctx;
+void upb_DecodeFast_GetSubMessage(upb_Decoder* d, void* dst,
+                                  upb_DecodeFast_MessageContext* c) {
   void** submsg_dst = dst;
 
   if (c->is_repeated || UPB_LIKELY(*submsg_dst == NULL)) {
@@ -58,10 +58,38 @@ bool upb_DecodeFast_SingleMessage(upb_Decoder* d, const char** ptr, void* dst,
   } else {
     c->msg = *submsg_dst;  // Reusing non-repeated message.
   }
+}
 
+UPB_FORCEINLINE
+bool upb_DecodeFast_SingleMessage(upb_Decoder* d, const char** ptr, void* dst,
+                                  upb_DecodeFast_Type type,
+                                  upb_DecodeFastNext* next, void* ctx) {
+  upb_DecodeFast_MessageContext* c = ctx;
+  upb_DecodeFast_GetSubMessage(d, dst, c);
   return upb_DecodeFast_Delimited(d, ptr, &upb_DecodeFast_MessageData, next, c);
 }
 
+// Groups are not length-prefixed, so unlike messages they are parsed under the
+// enclosing limit until the sub-parse stops at the matching END_GROUP tag.
+UPB_FORCEINLINE
+bool upb_DecodeFast_SingleGroup(upb_Decoder* d, const char** ptr, void* dst,
+                                upb_DecodeFast_Type type,
+                                upb_DecodeFastNext* next, void* ctx) {
+  upb_DecodeFast_MessageContext* c = ctx;
+  upb_DecodeFast_GetSubMessage(d, dst, c);
+
+  if (upb_DecodeFast_IsDone(d, ptr)) {
+    return UPB_DECODEFAST_ERROR(d, kUpb_DecodeStatus_Malformed, next);
+  }
+
+  *ptr = _upb_Decoder_DecodeMessage(d, *ptr, c->msg, c->table);
+  if (d->end_group != c->number) {
+    return UPB_DECODEFAST_ERROR(d, kUpb_DecodeStatus_Malformed, next);
+  }
+  d->end_group = DECODE_NOGROUP;
+  return true;
+}
+
 UPB_FORCEINLINE
 void upb_DecodeFast_Message(upb_Decoder* d, const char** ptr, upb_Message* msg,
                             const upb_MiniTable* table, uint64_t* hasbits,
@@ -75,8 +103,12 @@ void upb_DecodeFast_Message(upb_Decoder* d, const char** ptr, upb_Message* msg,
       table->UPB_ONLYBITS(fields), submsg_ofs, upb_MiniTableSubInternal);
   const upb_MiniTable* subtablep = sub->UPB_PRIVATE(submsg);
 
-  upb_DecodeFast_MessageContext ctx = {subtablep,
-                                       card == kUpb_DecodeFast_Repeated};
+  uint16_t expected_tag = upb_DecodeFastData_GetExpectedTag(*data);
+  upb_DecodeFast_MessageContext ctx = {
+      subtablep, card == kUpb_DecodeFast_Repeated,
+      tagsize == kUpb_DecodeFast_Tag1Byte
+          ? (uint8_t)expected_tag >> 3
+          : _upb_DecodeFast_Tag2FieldNumber(expected_tag)};
 
   if (subtablep == NULL) {
     // Unlinked messages are treated as unknown fields. Go straight to unknown
@@ -107,7 +139,10 @@ void upb_DecodeFast_Message(upb_Decoder* d, const char** ptr, upb_Message* msg,
   }
 
   upb_DecodeFast_Unpacked(d, ptr, msg, data, hasbits, ret, type, card, tagsize,
-                          &upb_DecodeFast_SingleMessage, &ctx, data2);
+                          type == kUpb_DecodeFast_Group
+                              ? &upb_DecodeFast_SingleGroup
+                              : &upb_DecodeFast_SingleMessage,
+                          &ctx, data2);
 
   d->depth++;
 }
@@ -123,6 +158,7 @@ void upb_DecodeFast_Message(upb_Decoder* d, const char** ptr, upb_Message* msg,
   }
 
 UPB_DECODEFAST_CARDINALITIES(UPB_DECODEFAST_TAGSIZES, F, Message)
+UPB_DECODEFAST_CARDINALITIES(UPB_DECODEFAST_TAGSIZES, F, Group)
 
 #undef F
 #undef FASTDECODE_SUBMSG
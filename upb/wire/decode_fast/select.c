@@ -78,7 +78,8 @@ static bool upb_DecodeFast_GetFieldCardinality(
     upb_DecodeFast_Cardinality* out_cardinality) {
   switch (UPB_PRIVATE(_upb_MiniTableField_Mode)(field)) {
     case kUpb_FieldMode_Map:
-      return false;  // Can't parse maps with fast decode.
+      *out_cardinality = kUpb_DecodeFast_Repeated;
+      return true;
     case kUpb_FieldMode_Array:
       *out_cardinality = upb_MiniTableField_IsPacked(field)
                              ? kUpb_DecodeFast_Packed
@@ -103,8 +104,9 @@ static bool upb_DecodeFast_GetFieldType(const upb_MiniTable* m,
   //  - kUpb_FieldType_Enum -> kUpb_FieldType_Int32 if the enum is open.
   upb_FieldType type = field->UPB_PRIVATE(descriptortype);
 
-  if (type == kUpb_FieldType_Group) {
-    return false;  // Currently not supported.
+  if (upb_MiniTableField_IsMap(field)) {
+    *out_type = kUpb_DecodeFast_Map;
+    return true;
   }
 
   if (upb_MiniTableField_IsClosedEnum(field)) {
@@ -130,6 +132,7 @@ static bool upb_DecodeFast_GetFieldType(const upb_MiniTable* m,
       [kUpb_FieldType_String] = kUpb_DecodeFast_String,
       [kUpb_FieldType_Bytes] = kUpb_DecodeFast_Bytes,
       [kUpb_FieldType_Message] = kUpb_DecodeFast_Message,
+      [kUpb_FieldType_Group] = kUpb_DecodeFast_Group,
   };
 
   UPB_ASSERT(type < UPB_ARRAY_SIZE(types));
@@ -156,12 +159,15 @@ static uint64_t upb_DecodeFast_GetPresence(const upb_MiniTableField* field,
     *out_data = upb_MiniTableField_Number(field);
     return true;
   } else if (UPB_PRIVATE(_upb_MiniTableField_HasHasbit)(field)) {
-    *out_data = field->presence - 64;
-    return *out_data < 32;  // We use uint32_t for hasbits currently.
+    // The first hasbits are accumulated in a uint64_t while parsing; the rest
+    // are offset by one to step over kUpb_DecodeFast_NoHasbit.
+    uint64_t index = field->presence - 64;
+    *out_data = index < kUpb_DecodeFast_NoHasbit ? index : index + 1;
+    return *out_data <= 0xff;
   } else {
-    // We only store 32 bits of hasbits back to the message, so for fields that
-    // don't have a hasbit, we just set the high bit which won't be stored.
-    *out_data = 63;
+    // Fields that don't have a hasbit set a bit that is never stored back to
+    // the message.
+    *out_data = kUpb_DecodeFast_NoHasbit;
     return true;
   }
 }
@@ -226,11 +232,21 @@ static bool upb_DecodeFast_TryFillEntry(const upb_MiniTable* m,
 
 int upb_DecodeFast_BuildTable(const upb_MiniTable* m,
                               upb_DecodeFast_TableEntry table[32]) {
+  return upb_DecodeFast_BuildTableWithProfile(m, NULL, table);
+}
+
+int upb_DecodeFast_BuildTableWithProfile(const upb_MiniTable* m,
+                                         const uint64_t* field_weights,
+                                         upb_DecodeFast_TableEntry table[32]) {
   if (m->UPB_PRIVATE(ext) & kUpb_ExtMode_IsMapEntry) return 0;
 
+  // The weight of the field currently assigned to each slot.
+  uint64_t slot_weights[32];
+
   for (size_t i = 0; i < 32; i++) {
     table[i].function_idx = UINT32_MAX;
     table[i].function_data = 0;
+    slot_weights[i] = 0;
   }
 
   // Fasttable only handles fields with tag size of 1 or 2 bytes. If all known
@@ -255,10 +271,18 @@ int upb_DecodeFast_BuildTable(const upb_MiniTable* m,
       continue;
     }
     int slot = upb_DecodeFastData_GetTableSlot(entry.function_data);
+    uint64_t weight = field_weights ? field_weights[i] : 0;
     if (table[slot].function_idx == UINT32_MAX) {
       table[slot] = entry;
+      slot_weights[slot] = weight;
       max = UPB_MAX(max, slot);
     } else {
+      // Fields are visited in field number order, so on a tie we keep the
+      // existing field.
+      if (weight > slot_weights[slot]) {
+        table[slot] = entry;
+        slot_weights[slot] = weight;
+      }
       all_fields_assigned_unique_slots = false;
     }
   }
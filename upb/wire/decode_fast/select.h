@@ -41,11 +41,20 @@ typedef struct {
 // less than 32).
 //
 // This function will assume that the lower a field number, the hotter the field
-// is.  If at some point we get access to more information about field usage,
-// we should consider using that instead.
+// is.  Use upb_DecodeFast_BuildTableWithProfile() if the actual field usage is
+// known.
 int upb_DecodeFast_BuildTable(const upb_MiniTable* m,
                               upb_DecodeFast_TableEntry table[32]);
 
+// Same as upb_DecodeFast_BuildTable(), but when several fields compete for the
+// same slot, the one with the highest weight gets it (ties go to the lower
+// field number).  `field_weights` is indexed like the fields of `m`, and would
+// usually hold the per-field counts from upb_DecodeStats.  If it is NULL, this
+// is the same as upb_DecodeFast_BuildTable().
+int upb_DecodeFast_BuildTableWithProfile(const upb_MiniTable* m,
+                                         const uint64_t* field_weights,
+                                         upb_DecodeFast_TableEntry table[32]);
+
 // Returns the mask that should be placed into the table_mask field of the
 // mini table for the given table size.
 uint8_t upb_DecodeFast_GetTableMask(int table_size);
@@ -14,9 +14,15 @@
 
 #include <gtest/gtest.h>
 #include "absl/base/macros.h"
+#include "upb/base/descriptor_constants.h"
+#include "upb/base/status.h"
 #include "upb/mem/arena.hpp"
+#include "upb/mini_descriptor/decode.h"
+#include "upb/mini_descriptor/internal/encode.hpp"
 #include "upb/mini_table/internal/message.h"
+#include "upb/mini_table/message.h"
 #include "upb/wire/decode_fast/combinations.h"
+#include "upb/wire/decode_fast/data.h"
 #include "upb/wire/test_util/field_types.h"
 #include "upb/wire/test_util/make_mini_table.h"
 
@@ -62,6 +68,43 @@ TEST(SelectTest, UnknownSlotsAssignedForNonExtendable) {
   EXPECT_NE(mt->UPB_PRIVATE(ext) & kUpb_ExtMode_AllFastFieldsAssigned, 0);
 }
 
+TEST(SelectTest, ProfileBreaksSlotCollisions) {
+  // Fields 16 and 32 have two-byte tags that both map to slot 16.
+  upb::Arena mt_arena;
+  upb::MtDataEncoder e;
+  e.StartMessage(0);
+  e.PutField(kUpb_FieldType_Int32, 16, 0);
+  e.PutField(kUpb_FieldType_Int32, 32, 0);
+  upb_Status status;
+  upb_Status_Clear(&status);
+  const upb_MiniTable* mt = upb_MiniTable_Build(
+      e.data().data(), e.data().size(), mt_arena.ptr(), &status);
+  ASSERT_TRUE(upb_Status_IsOk(&status)) << upb_Status_ErrorMessage(&status);
+
+  // Without a profile, the lower field number wins.
+  upb_DecodeFast_TableEntry table[32];
+  int size = upb_DecodeFast_BuildTable(mt, table);
+  EXPECT_EQ(size, 32);
+  EXPECT_EQ(upb_DecodeFastData_GetExpectedTag(table[16].function_data),
+            0x0180);  // Field 16: 0x80, 0x01
+
+  // Equal weights keep the lower field number.
+  const uint64_t tied[] = {5, 5};
+  size = upb_DecodeFast_BuildTableWithProfile(mt, tied, table);
+  EXPECT_EQ(upb_DecodeFastData_GetExpectedTag(table[16].function_data),
+            0x0180);
+
+  // A hotter field 32 takes the slot.
+  const uint64_t weights[] = {1, 100};
+  size = upb_DecodeFast_BuildTableWithProfile(mt, weights, table);
+  EXPECT_EQ(size, 32);
+  EXPECT_EQ(upb_DecodeFastData_GetExpectedTag(table[16].function_data),
+            0x0280);  // Field 32: 0x80, 0x02
+
+  // The collision means not every field has a slot.
+  EXPECT_EQ(mt->UPB_PRIVATE(ext) & kUpb_ExtMode_AllFastFieldsAssigned, 0);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace upb
\ No newline at end of file
@@ -0,0 +1,89 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "upb/mem/arena.h"
+#include "upb/wire/decode.h"
+#include "upb/wire/internal/decode_projection.h"
+
+// Must be last.
+#include "upb/port/def.inc"
+
+upb_DecodeProjection* upb_DecodeProjection_New(upb_Arena* arena) {
+  upb_DecodeProjection* p = upb_Arena_Malloc(arena, sizeof(*p));
+  if (!p) return NULL;
+  memset(p, 0, sizeof(*p));
+  return p;
+}
+
+// Returns the entry for `number`, inserting a new (whole-field) entry if none
+// exists yet. `*inserted` reports whether the entry was newly created.
+static upb_DecodeProjection_Entry* _upb_DecodeProjection_GetOrInsert(
+    upb_DecodeProjection* p, uint32_t number, bool* inserted,
+    upb_Arena* arena) {
+  uint32_t i = 0;
+  while (i < p->size && p->entries[i].number < number) i++;
+  if (i < p->size && p->entries[i].number == number) {
+    *inserted = false;
+    return &p->entries[i];
+  }
+
+  if (p->size == p->capacity) {
+    uint32_t new_cap = p->capacity ? p->capacity * 2 : 4;
+    void* entries = upb_Arena_Realloc(arena, p->entries,
+                                      p->capacity * sizeof(*p->entries),
+                                      new_cap * sizeof(*p->entries));
+    if (!entries) return NULL;
+    p->entries = entries;
+    p->capacity = new_cap;
+  }
+
+  memmove(&p->entries[i + 1], &p->entries[i],
+          (p->size - i) * sizeof(*p->entries));
+  p->entries[i].number = number;
+  p->entries[i].child = NULL;
+  p->size++;
+  if (number <= 64) p->low_mask |= 1ULL << (number - 1);
+  *inserted = true;
+  return &p->entries[i];
+}
+
+bool upb_DecodeProjection_AddPath(upb_DecodeProjection* p,
+                                  const uint32_t* path, size_t len,
+                                  upb_Arena* arena) {
+  UPB_ASSERT(len > 0);
+  for (size_t i = 0; i < len; i++) {
+    uint32_t number = path[i];
+    if (number == 0 || number > (1 << 29) - 1) return false;
+
+    bool inserted;
+    upb_DecodeProjection_Entry* e =
+        _upb_DecodeProjection_GetOrInsert(p, number, &inserted, arena);
+    if (!e) return false;
+
+    // An existing whole-field selection already covers this path.
+    if (!inserted && !e->child) return true;
+
+    if (i == len - 1) {
+      // This path selects the whole field, which subsumes any longer paths
+      // that were previously added beneath it.
+      e->child = NULL;
+      return true;
+    }
+
+    if (!e->child) {
+      e->child = upb_DecodeProjection_New(arena);
+      if (!e->child) return false;
+    }
+    p = e->child;
+  }
+  UPB_UNREACHABLE();
+}
@@ -0,0 +1,134 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "upb/hash/common.h"
+#include "upb/hash/int_table.h"
+#include "upb/mem/arena.h"
+#include "upb/mini_table/field.h"
+#include "upb/mini_table/message.h"
+#include "upb/wire/decode.h"
+#include "upb/wire/internal/decode_stats.h"
+
+// Must be last.
+#include "upb/port/def.inc"
+
+upb_DecodeStats* upb_DecodeStats_New(uint32_t sample_rate, upb_Arena* arena) {
+  upb_DecodeStats* s = upb_Arena_Malloc(arena, sizeof(*s));
+  if (!s) return NULL;
+  memset(s, 0, sizeof(*s));
+  if (!upb_inttable_init(&s->by_table, arena)) return NULL;
+  s->arena = arena;
+  s->alloc = arena;
+  s->sample_rate = sample_rate ? sample_rate : 1;
+  s->countdown = s->sample_rate;
+  return s;
+}
+
+static upb_DecodeStats_Message* _upb_DecodeStats_Find(
+    const upb_DecodeStats* s, const upb_MiniTable* mt) {
+  if (s->last && s->last->mt == mt) return s->last;
+  upb_value v;
+  if (!upb_inttable_lookup(&s->by_table, (uintptr_t)mt, &v)) return NULL;
+  return upb_value_getptr(v);
+}
+
+static upb_DecodeStats_Message* _upb_DecodeStats_Insert(
+    upb_DecodeStats* s, const upb_MiniTable* mt) {
+  if (s->size == s->capacity) {
+    uint32_t new_cap = s->capacity ? s->capacity * 2 : 8;
+    void* messages = upb_Arena_Realloc(s->alloc, s->messages,
+                                       s->capacity * sizeof(*s->messages),
+                                       new_cap * sizeof(*s->messages));
+    if (!messages) return NULL;
+    s->messages = messages;
+    s->capacity = new_cap;
+  }
+
+  int field_count = upb_MiniTable_FieldCount(mt);
+  size_t size =
+      sizeof(upb_DecodeStats_Message) + field_count * sizeof(uint64_t);
+  upb_DecodeStats_Message* m = upb_Arena_Malloc(s->alloc, size);
+  if (!m) return NULL;
+  memset(m, 0, size);
+  m->mt = mt;
+
+  if (!upb_inttable_insert(&s->by_table, (uintptr_t)mt, upb_value_ptr(m),
+                           s->alloc)) {
+    return NULL;
+  }
+  s->messages[s->size++] = m;
+  return m;
+}
+
+bool UPB_PRIVATE(_upb_DecodeStats_Record)(upb_DecodeStats* s,
+                                         const upb_MiniTable* mt,
+                                         uint32_t number, bool has_fast_slot) {
+  const upb_MiniTableField* f = upb_MiniTable_FindFieldByNumber(mt, number);
+  if (!f) return true;  // Unknown fields are not part of the profile.
+
+  upb_DecodeStats_Message* m = _upb_DecodeStats_Find(s, mt);
+  if (!m) {
+    m = _upb_DecodeStats_Insert(s, mt);
+    if (!m) return false;
+  }
+  s->last = m;
+
+  s->fields++;
+  if (has_fast_slot) s->fast_fields++;
+  m->counts[f - upb_MiniTable_GetFieldByIndex(mt, 0)]++;
+  return true;
+}
+
+uint64_t upb_DecodeStats_Decodes(const upb_DecodeStats* s) {
+  return s->decodes;
+}
+
+uint64_t upb_DecodeStats_SampledDecodes(const upb_DecodeStats* s) {
+  return s->sampled_decodes;
+}
+
+uint64_t upb_DecodeStats_Fields(const upb_DecodeStats* s) { return s->fields; }
+
+uint64_t upb_DecodeStats_FastFields(const upb_DecodeStats* s) {
+  return s->fast_fields;
+}
+
+uint64_t upb_DecodeStats_FieldCount(const upb_DecodeStats* s,
+                                    const upb_MiniTable* mt, uint32_t number) {
+  const upb_MiniTableField* f = upb_MiniTable_FindFieldByNumber(mt, number);
+  const upb_DecodeStats_Message* m = _upb_DecodeStats_Find(s, mt);
+  if (!f || !m) return 0;
+  return m->counts[f - upb_MiniTable_GetFieldByIndex(mt, 0)];
+}
+
+bool upb_DecodeStats_NextField(const upb_DecodeStats* s,
+                               const upb_MiniTable** mt, uint32_t* number,
+                               uint64_t* count, size_t* iter) {
+  // The iterator is the index of the next field to visit, across all messages
+  // in insertion order: the message index is in the high bits, and the field
+  // index in the low 16 bits.
+  for (size_t i = *iter >> 16, j = *iter & 0xffff; i < s->size; i++, j = 0) {
+    const upb_DecodeStats_Message* m = s->messages[i];
+    int field_count = upb_MiniTable_FieldCount(m->mt);
+    for (; j < (size_t)field_count; j++) {
+      if (m->counts[j] == 0) continue;
+      *mt = m->mt;
+      *number =
+          upb_MiniTableField_Number(upb_MiniTable_GetFieldByIndex(m->mt, j));
+      *count = m->counts[j];
+      *iter = (i << 16) | (j + 1);
+      return true;
+    }
+  }
+  *iter = (size_t)s->size << 16;
+  return false;
+}
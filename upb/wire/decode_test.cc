@@ -29,12 +29,14 @@
 #include "upb/message/accessors.h"
 #include "upb/message/accessors.hpp"
 #include "upb/message/array.h"
+#include "upb/message/copy.h"
 #include "upb/message/internal/accessors.h"
 #include "upb/message/internal/message.h"
 #include "upb/message/message.h"
 #include "upb/message/unknown_fields.h"
 #include "upb/mini_descriptor/decode.h"
 #include "upb/mini_descriptor/internal/encode.hpp"
+#include "upb/mini_descriptor/internal/modifiers.h"
 #include "upb/mini_descriptor/link.h"
 #include "upb/mini_table/extension.h"
 #include "upb/mini_table/extension_registry.h"
@@ -974,6 +976,994 @@ TEST(DecodeTest, UnlinkedSubMessageFastTableSlotCollision) {
   }
 }
 
+TEST(DecodeTest, WideMessageHasbits) {
+  Arena mt_arena;
+
+  // More than 64 optional fields, so that hasbits go past the fasttable's
+  // hasbit accumulator. Field 200 gets hasbit 188 and a fasttable slot, since
+  // we skip the lower fields that would collide with it.
+  std::vector<uint32_t> numbers;
+  for (uint32_t i = 1; i < 200; i++) {
+    if (i >= 16 && i % 16 == 8) continue;
+    numbers.push_back(i);
+  }
+  numbers.push_back(200);
+
+  upb::MtDataEncoder e;
+  e.StartMessage(0);
+  for (uint32_t number : numbers) {
+    e.PutField(kUpb_FieldType_Int32, number, 0);
+  }
+  upb_Status status;
+  upb_Status_Clear(&status);
+  const upb_MiniTable* mt = upb_MiniTable_Build(
+      e.data().data(), e.data().size(), mt_arena.ptr(), &status);
+  ASSERT_TRUE(upb_Status_IsOk(&status)) << upb_Status_ErrorMessage(&status);
+
+#if UPB_FASTTABLE
+  EXPECT_TRUE(MiniTable::HasFastTableEntry(
+      mt, upb_MiniTable_FindFieldByNumber(mt, 200)));
+#endif
+
+  // Set every other field, to check that no neighbouring hasbits are set.
+  wire_types::WireMessage wire;
+  for (size_t i = 0; i < numbers.size(); i += 2) {
+    wire.push_back({numbers[i], wire_types::Varint(numbers[i])});
+  }
+  wire.push_back({200, wire_types::Varint(200)});
+  std::string payload = ToBinaryPayload(wire);
+
+  for (int options : GetDecodeOptionsToTest()) {
+    Arena msg_arena;
+    upb_Message* msg = upb_Message_New(mt, msg_arena.ptr());
+    upb_DecodeStatus result =
+        upb_Decode(payload.data(), payload.size(), msg, mt, nullptr, options,
+                   msg_arena.ptr());
+    ASSERT_EQ(result, kUpb_DecodeStatus_Ok) << upb_DecodeStatus_String(result);
+    for (size_t i = 0; i < numbers.size(); i++) {
+      const upb_MiniTableField* field =
+          upb_MiniTable_FindFieldByNumber(mt, numbers[i]);
+      bool expect_set = i % 2 == 0 || numbers[i] == 200;
+      EXPECT_EQ(upb_Message_HasBaseField(msg, field), expect_set)
+          << numbers[i];
+      EXPECT_EQ(upb_Message_GetInt32(msg, field, 0),
+                expect_set ? static_cast<int32_t>(numbers[i]) : 0)
+          << numbers[i];
+    }
+  }
+}
+
+upb_test_ModelWithMaps* ParseModelWithMaps(absl::string_view payload,
+                                           int options, upb_Arena* arena,
+                                           upb_DecodeStatus* status) {
+  upb_test_ModelWithMaps* msg = upb_test_ModelWithMaps_new(arena);
+  *status = upb_Decode(payload.data(), payload.size(), UPB_UPCAST(msg),
+                       &upb_0test__ModelWithMaps_msg_init, nullptr, options,
+                       arena);
+  return msg;
+}
+
+std::string GetMapString(const upb_test_ModelWithMaps* msg,
+                         absl::string_view key) {
+  upb_StringView val;
+  if (!upb_test_ModelWithMaps_map_ss_get(
+          msg, upb_StringView_FromDataAndSize(key.data(), key.size()), &val)) {
+    return "<missing>";
+  }
+  return std::string(val.data, val.size);
+}
+
+TEST(MapFieldTest, RoundTrip) {
+  Arena arena;
+  upb_test_ModelWithMaps* src = upb_test_ModelWithMaps_new(arena.ptr());
+  for (int i = 0; i < 50; i++) {
+    std::string key = absl::StrCat("key", i);
+    std::string val = absl::StrCat("value", i);
+    upb_StringView k = upb_StringView_FromDataAndSize(
+        upb_Arena_Strdup(arena.ptr(), key.c_str()), key.size());
+    upb_StringView v = upb_StringView_FromDataAndSize(
+        upb_Arena_Strdup(arena.ptr(), val.c_str()), val.size());
+    ASSERT_TRUE(upb_test_ModelWithMaps_map_ss_set(src, k, v, arena.ptr()));
+    ASSERT_TRUE(upb_test_ModelWithMaps_map_sb_set(src, k, v, arena.ptr()));
+    ASSERT_TRUE(
+        upb_test_ModelWithMaps_map_ii_set(src, i - 25, i * 1000, arena.ptr()));
+    upb_test_ModelWithExtensions* m =
+        upb_test_ModelWithExtensions_new(arena.ptr());
+    upb_test_ModelWithExtensions_set_random_int32(m, i);
+    upb_test_ModelWithExtensions_set_random_name(m, v);
+    ASSERT_TRUE(upb_test_ModelWithMaps_map_im_set(src, i, m, arena.ptr()));
+  }
+
+  size_t size;
+  char* buf = upb_test_ModelWithMaps_serialize(src, arena.ptr(), &size);
+  ASSERT_NE(buf, nullptr);
+
+  for (int options : GetDecodeOptionsToTest()) {
+    Arena msg_arena;
+    upb_DecodeStatus status;
+    upb_test_ModelWithMaps* dst = ParseModelWithMaps(
+        absl::string_view(buf, size), options, msg_arena.ptr(), &status);
+    ASSERT_EQ(status, kUpb_DecodeStatus_Ok) << upb_DecodeStatus_String(status);
+    EXPECT_EQ(upb_test_ModelWithMaps_map_ss_size(dst), 50);
+    EXPECT_EQ(upb_test_ModelWithMaps_map_sb_size(dst), 50);
+    EXPECT_EQ(upb_test_ModelWithMaps_map_ii_size(dst), 50);
+    EXPECT_EQ(upb_test_ModelWithMaps_map_im_size(dst), 50);
+    for (int i = 0; i < 50; i++) {
+      EXPECT_EQ(GetMapString(dst, absl::StrCat("key", i)),
+                absl::StrCat("value", i));
+      int32_t ival;
+      ASSERT_TRUE(upb_test_ModelWithMaps_map_ii_get(dst, i - 25, &ival));
+      EXPECT_EQ(ival, i * 1000);
+      upb_test_ModelWithExtensions* m;
+      ASSERT_TRUE(upb_test_ModelWithMaps_map_im_get(dst, i, &m));
+      EXPECT_EQ(upb_test_ModelWithExtensions_random_int32(m), i);
+    }
+    EXPECT_FALSE(upb_Message_HasUnknown(UPB_UPCAST(dst)));
+  }
+}
+
+TEST(MapFieldTest, UnusualEntries) {
+  // Field 3 is map<string, string>; entries are {1: key, 2: value}.
+  std::string payload(
+      // "a" -> "x"
+      "\x1a\x06\x0a\x01" "a" "\x12\x01" "x"
+      // Duplicate key replaces the previous value: "a" -> "y"
+      "\x1a\x06\x0a\x01" "a" "\x12\x01" "y"
+      // Value before key: "b" -> "z"
+      "\x1a\x06\x12\x01" "z" "\x0a\x01" "b"
+      // Missing key: "" -> "w"
+      "\x1a\x03\x12\x01" "w"
+      // Missing value: "c" -> ""
+      "\x1a\x03\x0a\x01" "c"
+      // Unknown field in the entry: preserved as an unknown field.
+      "\x1a\x08\x0a\x01" "d" "\x18\x01\x12\x01" "v"
+      // And a normal entry after all of the above: "e" -> "u"
+      "\x1a\x06\x0a\x01" "e" "\x12\x01" "u",
+      52);
+
+  for (int options : GetDecodeOptionsToTest()) {
+    Arena arena;
+    upb_DecodeStatus status;
+    upb_test_ModelWithMaps* msg =
+        ParseModelWithMaps(payload, options, arena.ptr(), &status);
+    ASSERT_EQ(status, kUpb_DecodeStatus_Ok) << upb_DecodeStatus_String(status);
+    EXPECT_EQ(upb_test_ModelWithMaps_map_ss_size(msg), 5);
+    EXPECT_EQ(GetMapString(msg, "a"), "y");
+    EXPECT_EQ(GetMapString(msg, "b"), "z");
+    EXPECT_EQ(GetMapString(msg, ""), "w");
+    EXPECT_EQ(GetMapString(msg, "c"), "");
+    EXPECT_EQ(GetMapString(msg, "d"), "<missing>");
+    EXPECT_EQ(GetMapString(msg, "e"), "u");
+    EXPECT_TRUE(upb_Message_HasUnknown(UPB_UPCAST(msg)));
+  }
+}
+
+TEST(MapFieldTest, MissingMessageValue) {
+  // Field 5 is map<int32, ModelWithExtensions>: 7 -> {}.
+  std::string payload("\x2a\x02\x08\x07", 4);
+  for (int options : GetDecodeOptionsToTest()) {
+    Arena arena;
+    upb_DecodeStatus status;
+    upb_test_ModelWithMaps* msg =
+        ParseModelWithMaps(payload, options, arena.ptr(), &status);
+    ASSERT_EQ(status, kUpb_DecodeStatus_Ok) << upb_DecodeStatus_String(status);
+    upb_test_ModelWithExtensions* val;
+    ASSERT_TRUE(upb_test_ModelWithMaps_map_im_get(msg, 7, &val));
+    ASSERT_NE(val, nullptr);
+    EXPECT_FALSE(upb_test_ModelWithExtensions_has_random_int32(val));
+  }
+}
+
+TEST(MapFieldTest, TruncatedEntry) {
+  std::string payloads[] = {
+      // Entry length past the end of the input.
+      std::string("\x1a\x06\x0a\x01" "a" "\x12\x01", 7),
+      // String value longer than the entry.
+      std::string("\x1a\x05\x0a\x01" "a" "\x12\x02" "xy", 9),
+      // Varint value running past the end of the entry.
+      std::string("\x22\x03\x08\x01\x10\x80\x01", 7),
+  };
+  for (const std::string& payload : payloads) {
+    for (int options : GetDecodeOptionsToTest()) {
+      Arena arena;
+      upb_DecodeStatus status;
+      ParseModelWithMaps(payload, options, arena.ptr(), &status);
+      EXPECT_EQ(status, kUpb_DecodeStatus_Malformed)
+          << upb_DecodeStatus_String(status);
+    }
+  }
+}
+
+TEST(GroupFieldTest, DecodeGroups) {
+  Arena mt_arena;
+
+  auto [sub_mt, sub_field] =
+      test::MiniTable::MakeSingleFieldTable<test::field_types::Int32>(
+          1, kUpb_DecodeFast_Scalar, mt_arena.ptr());
+
+  for (upb_DecodeFast_Cardinality card :
+       {kUpb_DecodeFast_Scalar, kUpb_DecodeFast_Repeated}) {
+    auto [mt, field] =
+        test::MiniTable::MakeSingleFieldTable<test::field_types::Group>(
+            1, card, mt_arena.ptr());
+    const upb_MiniTable* subs[1] = {sub_mt};
+    ASSERT_TRUE(upb_MiniTable_Link(const_cast<upb_MiniTable*>(mt), subs, 1,
+                                   nullptr, 0));
+
+    // Two groups: {1: 5} and {1: 6}.
+    std::string payload("\x0b\x08\x05\x0c\x0b\x08\x06\x0c", 8);
+    for (int options : GetDecodeOptionsToTest()) {
+      Arena msg_arena;
+      upb_Message* msg = upb_Message_New(mt, msg_arena.ptr());
+      upb_DecodeStatus result =
+          upb_Decode(payload.data(), payload.size(), msg, mt, nullptr, options,
+                     msg_arena.ptr());
+      ASSERT_EQ(result, kUpb_DecodeStatus_Ok)
+          << upb_DecodeStatus_String(result);
+      EXPECT_FALSE(upb_Message_HasUnknown(msg));
+
+      if (card == kUpb_DecodeFast_Scalar) {
+        // The second group is merged into the first.
+        const upb_Message* sub = upb_Message_GetMessage(msg, field);
+        ASSERT_NE(sub, nullptr);
+        EXPECT_EQ(upb_Message_GetInt32(sub, sub_field, 0), 6);
+      } else {
+        const upb_Array* arr = upb_Message_GetArray(msg, field);
+        ASSERT_NE(arr, nullptr);
+        ASSERT_EQ(upb_Array_Size(arr), 2u);
+        EXPECT_EQ(upb_Message_GetInt32(upb_Array_Get(arr, 0).msg_val,
+                                       sub_field, 0),
+                  5);
+        EXPECT_EQ(upb_Message_GetInt32(upb_Array_Get(arr, 1).msg_val,
+                                       sub_field, 0),
+                  6);
+      }
+    }
+
+    std::string bad_payloads[] = {
+        // END_GROUP for the wrong field number.
+        std::string("\x0b\x08\x05\x14", 4),
+        // Missing END_GROUP.
+        std::string("\x0b\x08\x05", 3),
+    };
+    for (const std::string& bad : bad_payloads) {
+      for (int options : GetDecodeOptionsToTest()) {
+        Arena msg_arena;
+        upb_Message* msg = upb_Message_New(mt, msg_arena.ptr());
+        upb_DecodeStatus result =
+            upb_Decode(bad.data(), bad.size(), msg, mt, nullptr, options,
+                       msg_arena.ptr());
+        EXPECT_EQ(result, kUpb_DecodeStatus_Malformed)
+            << upb_DecodeStatus_String(result);
+      }
+    }
+  }
+}
+
+TEST(DecodeProjectionTest, SkipsUnselectedFields) {
+  Arena arena;
+  upb_test_ModelWithSubMessages* src =
+      upb_test_ModelWithSubMessages_new(arena.ptr());
+  upb_test_ModelWithSubMessages_set_id(src, 1);
+  upb_test_ModelWithExtensions* child =
+      upb_test_ModelWithSubMessages_mutable_optional_child(src, arena.ptr());
+  upb_test_ModelWithExtensions_set_random_int32(child, 2);
+  upb_test_ModelWithExtensions_set_random_name(
+      child, upb_StringView_FromString("child"));
+  upb_test_ModelWithExtensions* item =
+      upb_test_ModelWithSubMessages_add_items(src, arena.ptr());
+  upb_test_ModelWithExtensions_set_random_int32(item, 3);
+  upb_test_ModelWithExtensions_set_random_name(
+      item, upb_StringView_FromString("item"));
+
+  size_t size;
+  char* buf = upb_test_ModelWithSubMessages_serialize(src, arena.ptr(), &size);
+  ASSERT_NE(buf, nullptr);
+
+  upb_DecodeProjection* projection = upb_DecodeProjection_New(arena.ptr());
+  ASSERT_NE(projection, nullptr);
+  const uint32_t child_name[] = {5, 4};
+  const uint32_t items[] = {6};
+  ASSERT_TRUE(
+      upb_DecodeProjection_AddPath(projection, child_name, 2, arena.ptr()));
+  ASSERT_TRUE(upb_DecodeProjection_AddPath(projection, items, 1, arena.ptr()));
+
+  for (int options : GetDecodeOptionsToTest()) {
+    upb_test_ModelWithSubMessages* dst =
+        upb_test_ModelWithSubMessages_new(arena.ptr());
+    upb_DecodeStatus result = upb_DecodeWithProjection(
+        buf, size, UPB_UPCAST(dst), &upb_0test__ModelWithSubMessages_msg_init,
+        nullptr, projection, options, arena.ptr());
+    ASSERT_EQ(result, kUpb_DecodeStatus_Ok) << upb_DecodeStatus_String(result);
+
+    EXPECT_FALSE(upb_test_ModelWithSubMessages_has_id(dst));
+    ASSERT_TRUE(upb_test_ModelWithSubMessages_has_optional_child(dst));
+    const upb_test_ModelWithExtensions* dst_child =
+        upb_test_ModelWithSubMessages_optional_child(dst);
+    EXPECT_FALSE(upb_test_ModelWithExtensions_has_random_int32(dst_child));
+    EXPECT_TRUE(upb_StringView_IsEqual(
+        upb_test_ModelWithExtensions_random_name(dst_child),
+        upb_StringView_FromString("child")));
+
+    size_t items_size;
+    const upb_test_ModelWithExtensions* const* dst_items =
+        upb_test_ModelWithSubMessages_items(dst, &items_size);
+    ASSERT_EQ(items_size, 1);
+    EXPECT_EQ(upb_test_ModelWithExtensions_random_int32(dst_items[0]), 3);
+    EXPECT_TRUE(upb_StringView_IsEqual(
+        upb_test_ModelWithExtensions_random_name(dst_items[0]),
+        upb_StringView_FromString("item")));
+
+    // Skipped fields must not be preserved as unknown fields.
+    EXPECT_FALSE(upb_Message_HasUnknown(UPB_UPCAST(dst)));
+    EXPECT_FALSE(upb_Message_HasUnknown(UPB_UPCAST(dst_child)));
+  }
+}
+
+TEST(DecodeProjectionTest, SelectedUnknownFieldIsPreserved) {
+  Arena arena;
+  // Field 1 (varint) = 1, field 100 (varint) = 5, field 101 (varint) = 6.
+  std::string payload("\x08\x01\xa0\x06\x05\xa8\x06\x06");
+
+  upb_DecodeProjection* projection = upb_DecodeProjection_New(arena.ptr());
+  const uint32_t path[] = {100};
+  ASSERT_TRUE(upb_DecodeProjection_AddPath(projection, path, 1, arena.ptr()));
+
+  upb_Message* msg = upb_Message_New(
+      &upb_0test__ModelWithSubMessages_msg_init, arena.ptr());
+  upb_DecodeStatus result = upb_DecodeWithProjection(
+      payload.data(), payload.size(), msg,
+      &upb_0test__ModelWithSubMessages_msg_init, nullptr, projection, 0,
+      arena.ptr());
+  ASSERT_EQ(result, kUpb_DecodeStatus_Ok) << upb_DecodeStatus_String(result);
+
+  uintptr_t iter = kUpb_Message_UnknownBegin;
+  upb_StringView data;
+  ASSERT_TRUE(upb_Message_NextUnknown(msg, &data, &iter));
+  EXPECT_EQ(absl::string_view(data.data, data.size), "\xa0\x06\x05");
+  EXPECT_FALSE(upb_Message_NextUnknown(msg, &data, &iter));
+}
+
+TEST(DecodeProjectionTest, MapPathAppliesToValue) {
+  Arena arena;
+  upb_test_ModelWithMaps* src = upb_test_ModelWithMaps_new(arena.ptr());
+  upb_test_ModelWithMaps_set_id(src, 1);
+  upb_test_ModelWithExtensions* val =
+      upb_test_ModelWithExtensions_new(arena.ptr());
+  upb_test_ModelWithExtensions_set_random_int32(val, 2);
+  upb_test_ModelWithExtensions_set_random_name(
+      val, upb_StringView_FromString("value"));
+  ASSERT_TRUE(upb_test_ModelWithMaps_map_im_set(src, 7, val, arena.ptr()));
+  ASSERT_TRUE(upb_test_ModelWithMaps_map_ii_set(src, 8, 9, arena.ptr()));
+
+  size_t size;
+  char* buf = upb_test_ModelWithMaps_serialize(src, arena.ptr(), &size);
+  ASSERT_NE(buf, nullptr);
+
+  upb_DecodeProjection* projection = upb_DecodeProjection_New(arena.ptr());
+  const uint32_t path[] = {5, 3};
+  ASSERT_TRUE(upb_DecodeProjection_AddPath(projection, path, 2, arena.ptr()));
+
+  upb_test_ModelWithMaps* dst = upb_test_ModelWithMaps_new(arena.ptr());
+  upb_DecodeStatus result = upb_DecodeWithProjection(
+      buf, size, UPB_UPCAST(dst), &upb_0test__ModelWithMaps_msg_init, nullptr,
+      projection, 0, arena.ptr());
+  ASSERT_EQ(result, kUpb_DecodeStatus_Ok) << upb_DecodeStatus_String(result);
+
+  EXPECT_FALSE(upb_test_ModelWithMaps_has_id(dst));
+  EXPECT_EQ(upb_test_ModelWithMaps_map_ii_size(dst), 0);
+  ASSERT_EQ(upb_test_ModelWithMaps_map_im_size(dst), 1);
+  upb_test_ModelWithExtensions* dst_val;
+  ASSERT_TRUE(upb_test_ModelWithMaps_map_im_get(dst, 7, &dst_val));
+  EXPECT_EQ(upb_test_ModelWithExtensions_random_int32(dst_val), 2);
+  EXPECT_FALSE(upb_test_ModelWithExtensions_has_random_name(dst_val));
+}
+
+TEST(DecodeProjectionTest, ShorterPathSubsumesLongerPath) {
+  Arena arena;
+  upb_test_ModelWithSubMessages* src =
+      upb_test_ModelWithSubMessages_new(arena.ptr());
+  upb_test_ModelWithExtensions* child =
+      upb_test_ModelWithSubMessages_mutable_optional_child(src, arena.ptr());
+  upb_test_ModelWithExtensions_set_random_int32(child, 2);
+  upb_test_ModelWithExtensions_set_random_name(
+      child, upb_StringView_FromString("child"));
+  size_t size;
+  char* buf = upb_test_ModelWithSubMessages_serialize(src, arena.ptr(), &size);
+  ASSERT_NE(buf, nullptr);
+
+  upb_DecodeProjection* projection = upb_DecodeProjection_New(arena.ptr());
+  const uint32_t long_path[] = {5, 4};
+  const uint32_t short_path[] = {5};
+  ASSERT_TRUE(
+      upb_DecodeProjection_AddPath(projection, long_path, 2, arena.ptr()));
+  ASSERT_TRUE(
+      upb_DecodeProjection_AddPath(projection, short_path, 1, arena.ptr()));
+  ASSERT_TRUE(
+      upb_DecodeProjection_AddPath(projection, long_path, 2, arena.ptr()));
+
+  upb_test_ModelWithSubMessages* dst =
+      upb_test_ModelWithSubMessages_new(arena.ptr());
+  upb_DecodeStatus result = upb_DecodeWithProjection(
+      buf, size, UPB_UPCAST(dst), &upb_0test__ModelWithSubMessages_msg_init,
+      nullptr, projection, 0, arena.ptr());
+  ASSERT_EQ(result, kUpb_DecodeStatus_Ok) << upb_DecodeStatus_String(result);
+  const upb_test_ModelWithExtensions* dst_child =
+      upb_test_ModelWithSubMessages_optional_child(dst);
+  ASSERT_NE(dst_child, nullptr);
+  EXPECT_EQ(upb_test_ModelWithExtensions_random_int32(dst_child), 2);
+  EXPECT_TRUE(upb_test_ModelWithExtensions_has_random_name(dst_child));
+}
+
+TEST(DecodeProjectionTest, InvalidFieldNumberRejected) {
+  Arena arena;
+  upb_DecodeProjection* projection = upb_DecodeProjection_New(arena.ptr());
+  const uint32_t zero[] = {0};
+  const uint32_t too_large[] = {1u << 29};
+  EXPECT_FALSE(upb_DecodeProjection_AddPath(projection, zero, 1, arena.ptr()));
+  EXPECT_FALSE(
+      upb_DecodeProjection_AddPath(projection, too_large, 1, arena.ptr()));
+}
+
+TEST(DecodeStatsTest, CountsSampledFields) {
+  upb::Arena mt_arena;
+  upb::MtDataEncoder e;
+  e.StartMessage(0);
+  e.PutField(kUpb_FieldType_Int32, 1, 0);
+  e.PutField(kUpb_FieldType_Int32, 2, 0);
+  upb_Status status;
+  upb_Status_Clear(&status);
+  const upb_MiniTable* mt = upb_MiniTable_Build(
+      e.data().data(), e.data().size(), mt_arena.ptr(), &status);
+  ASSERT_TRUE(upb_Status_IsOk(&status)) << upb_Status_ErrorMessage(&status);
+
+  // Field 1 twice, field 2 once, and an unknown field 3.
+  std::string payload = ToBinaryPayload(wire_types::WireMessage{
+      {1, wire_types::Varint(1)},
+      {2, wire_types::Varint(2)},
+      {1, wire_types::Varint(3)},
+      {3, wire_types::Varint(4)},
+  });
+
+  Arena arena;
+  upb_DecodeStats* stats = upb_DecodeStats_New(2, arena.ptr());
+  ASSERT_NE(stats, nullptr);
+  for (int i = 0; i < 4; i++) {
+    upb_Message* msg = upb_Message_New(mt, arena.ptr());
+    upb_DecodeStatus result =
+        upb_DecodeWithStats(payload.data(), payload.size(), msg, mt, nullptr,
+                            0, arena.ptr(), stats);
+    ASSERT_EQ(result, kUpb_DecodeStatus_Ok) << upb_DecodeStatus_String(result);
+    EXPECT_EQ(upb_Message_GetInt32(msg, upb_MiniTable_GetFieldByIndex(mt, 0),
+                                   0),
+              3);
+  }
+
+  EXPECT_EQ(upb_DecodeStats_Decodes(stats), 4);
+  EXPECT_EQ(upb_DecodeStats_SampledDecodes(stats), 2);
+  EXPECT_EQ(upb_DecodeStats_FieldCount(stats, mt, 1), 4);
+  EXPECT_EQ(upb_DecodeStats_FieldCount(stats, mt, 2), 2);
+  EXPECT_EQ(upb_DecodeStats_FieldCount(stats, mt, 3), 0);
+  EXPECT_EQ(upb_DecodeStats_Fields(stats), 6);
+#if UPB_FASTTABLE
+  EXPECT_EQ(upb_DecodeStats_FastFields(stats), 6);
+#else
+  EXPECT_EQ(upb_DecodeStats_FastFields(stats), 0);
+#endif
+
+  const upb_MiniTable* m;
+  uint32_t number;
+  uint64_t count;
+  size_t iter = 0;
+  uint64_t total = 0;
+  while (upb_DecodeStats_NextField(stats, &m, &number, &count, &iter)) {
+    EXPECT_EQ(m, mt);
+    EXPECT_EQ(count, upb_DecodeStats_FieldCount(stats, mt, number));
+    total += count;
+  }
+  EXPECT_EQ(total, 6);
+}
+
+const upb_MiniTable* BuildTwoInt32MiniTable(upb_Arena* arena) {
+  upb::MtDataEncoder e;
+  e.StartMessage(0);
+  e.PutField(kUpb_FieldType_Int32, 1, 0);
+  e.PutField(kUpb_FieldType_Int32, 2, 0);
+  upb_Status status;
+  upb_Status_Clear(&status);
+  const upb_MiniTable* mt =
+      upb_MiniTable_Build(e.data().data(), e.data().size(), arena, &status);
+  EXPECT_TRUE(upb_Status_IsOk(&status)) << upb_Status_ErrorMessage(&status);
+  return mt;
+}
+
+std::string TwoInt32Payload(int a, int b) {
+  return ToBinaryPayload(wire_types::WireMessage{
+      {1, wire_types::Varint(a)},
+      {2, wire_types::Varint(b)},
+  });
+}
+
+TEST(DecodeBatchTest, DecodesEachItem) {
+  upb::Arena mt_arena;
+  const upb_MiniTable* mt = BuildTwoInt32MiniTable(mt_arena.ptr());
+  ASSERT_NE(mt, nullptr);
+  const upb_MiniTableField* f1 = upb_MiniTable_GetFieldByIndex(mt, 0);
+  const upb_MiniTableField* f2 = upb_MiniTable_GetFieldByIndex(mt, 1);
+
+  Arena arena;
+  std::vector<std::string> payloads;
+  for (int i = 0; i < 10; i++) payloads.push_back(TwoInt32Payload(i, i * 2));
+  payloads.push_back("");  // An empty message.
+  std::vector<upb_DecodeBatchItem> items;
+  for (const std::string& payload : payloads) {
+    items.push_back({payload.data(), payload.size(),
+                     upb_Message_New(mt, arena.ptr())});
+  }
+
+  size_t num_decoded;
+  upb_DecodeStatus result = upb_DecodeBatch(
+      items.data(), items.size(), mt, nullptr, 0, arena.ptr(), &num_decoded);
+  ASSERT_EQ(result, kUpb_DecodeStatus_Ok) << upb_DecodeStatus_String(result);
+  EXPECT_EQ(num_decoded, items.size());
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(upb_Message_GetInt32(items[i].msg, f1, -1), i);
+    EXPECT_EQ(upb_Message_GetInt32(items[i].msg, f2, -1), i * 2);
+  }
+  EXPECT_FALSE(upb_Message_HasBaseField(items[10].msg, f1));
+}
+
+TEST(DecodeBatchTest, StopsAtFirstError) {
+  upb::Arena mt_arena;
+  const upb_MiniTable* mt = BuildTwoInt32MiniTable(mt_arena.ptr());
+  ASSERT_NE(mt, nullptr);
+  const upb_MiniTableField* f1 = upb_MiniTable_GetFieldByIndex(mt, 0);
+
+  Arena arena;
+  std::string good = TwoInt32Payload(1, 2);
+  std::string bad = "\x08";  // Truncated varint.
+  upb_DecodeBatchItem items[] = {
+      {good.data(), good.size(), upb_Message_New(mt, arena.ptr())},
+      {bad.data(), bad.size(), upb_Message_New(mt, arena.ptr())},
+      {good.data(), good.size(), upb_Message_New(mt, arena.ptr())},
+  };
+
+  size_t num_decoded;
+  upb_DecodeStatus result =
+      upb_DecodeBatch(items, 3, mt, nullptr, 0, arena.ptr(), &num_decoded);
+  EXPECT_EQ(result, kUpb_DecodeStatus_Malformed);
+  EXPECT_EQ(num_decoded, 1);
+  EXPECT_EQ(upb_Message_GetInt32(items[0].msg, f1, -1), 1);
+
+  // The caller can skip the bad input and carry on.
+  result = upb_DecodeBatch(items + 2, 1, mt, nullptr, 0, arena.ptr(),
+                           &num_decoded);
+  EXPECT_EQ(result, kUpb_DecodeStatus_Ok);
+  EXPECT_EQ(num_decoded, 1);
+  EXPECT_EQ(upb_Message_GetInt32(items[2].msg, f1, -1), 1);
+}
+
+TEST(DecodeBatchTest, LengthPrefixedStream) {
+  upb::Arena mt_arena;
+  const upb_MiniTable* mt = BuildTwoInt32MiniTable(mt_arena.ptr());
+  ASSERT_NE(mt, nullptr);
+  const upb_MiniTableField* f2 = upb_MiniTable_GetFieldByIndex(mt, 1);
+
+  std::string stream;
+  for (int i = 0; i < 5; i++) {
+    std::string payload = TwoInt32Payload(i, i + 100);
+    stream.push_back(static_cast<char>(payload.size()));
+    stream += payload;
+  }
+
+  Arena arena;
+  upb_Message* msgs[3];
+  size_t num_msgs;
+  size_t num_bytes_read;
+  upb_DecodeStatus result = upb_DecodeBatchLengthPrefixed(
+      stream.data(), stream.size(), msgs, 3, &num_msgs, &num_bytes_read, mt,
+      nullptr, 0, arena.ptr());
+  ASSERT_EQ(result, kUpb_DecodeStatus_Ok) << upb_DecodeStatus_String(result);
+  ASSERT_EQ(num_msgs, 3);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(upb_Message_GetInt32(msgs[i], f2, -1), i + 100);
+  }
+
+  // Resume, with the last message truncated.
+  size_t offset = num_bytes_read;
+  result = upb_DecodeBatchLengthPrefixed(
+      stream.data() + offset, stream.size() - offset - 1, msgs, 3, &num_msgs,
+      &num_bytes_read, mt, nullptr, 0, arena.ptr());
+  EXPECT_EQ(result, kUpb_DecodeStatus_Malformed);
+  ASSERT_EQ(num_msgs, 1);
+  EXPECT_EQ(upb_Message_GetInt32(msgs[0], f2, -1), 103);
+  EXPECT_EQ(offset + num_bytes_read + stream.size() / 5, stream.size());
+}
+
+std::string EncodeToString(const upb_Message* msg, const upb_MiniTable* mt,
+                           int options, upb_Arena* arena) {
+  char* buf;
+  size_t size;
+  EXPECT_EQ(upb_Encode(msg, mt, options, arena, &buf, &size),
+            kUpb_EncodeStatus_Ok);
+  return std::string(buf, size);
+}
+
+TEST(RetainEncodingTest, UnchangedSubMessagesAreCopiedVerbatim) {
+  Arena arena;
+  // Fields of both submessages are in reverse field number order, which the
+  // encoder never produces on its own:
+  //   id: 1
+  //   optional_child { random_name: "c" random_int32: 2 }
+  //   items { random_name: "i" random_int32: 3 }
+  std::string payload(
+      "\x20\x01"
+      "\x2a\x05\x22\x01"
+      "c\x18\x02"
+      "\x32\x05\x22\x01"
+      "i\x18\x03",
+      16);
+  const upb_MiniTable* mt = &upb_0test__ModelWithSubMessages_msg_init;
+  upb_test_ModelWithSubMessages* msg =
+      upb_test_ModelWithSubMessages_new(arena.ptr());
+  ASSERT_EQ(upb_Decode(payload.data(), payload.size(), UPB_UPCAST(msg), mt,
+                       nullptr, kUpb_DecodeOption_RetainEncoding, arena.ptr()),
+            kUpb_DecodeStatus_Ok);
+
+  const upb_test_ModelWithExtensions* child =
+      upb_test_ModelWithSubMessages_optional_child(msg);
+  size_t items_size;
+  const upb_test_ModelWithExtensions* const* items =
+      upb_test_ModelWithSubMessages_items(msg, &items_size);
+  ASSERT_EQ(items_size, 1);
+  EXPECT_FALSE(upb_Message_IsFrozen(UPB_UPCAST(msg)));
+  EXPECT_TRUE(upb_Message_IsFrozen(UPB_UPCAST(child)));
+  EXPECT_TRUE(upb_Message_IsFrozen(UPB_UPCAST(items[0])));
+
+  EXPECT_EQ(EncodeToString(UPB_UPCAST(msg), mt, 0, arena.ptr()), payload);
+  // Deterministic output is always re-encoded.
+  EXPECT_EQ(EncodeToString(UPB_UPCAST(msg), mt, kUpb_EncodeOption_Deterministic,
+                           arena.ptr()),
+            std::string("\x20\x01"
+                        "\x2a\x05\x18\x02\x22\x01"
+                        "c"
+                        "\x32\x05\x18\x03\x22\x01"
+                        "i",
+                        16));
+
+  // Modifying the child requires a mutable copy, which is re-encoded while
+  // the untouched item is still copied verbatim.
+  upb_test_ModelWithExtensions* new_child =
+      (upb_test_ModelWithExtensions*)upb_Message_ShallowClone(
+          UPB_UPCAST(child), &upb_0test__ModelWithExtensions_msg_init,
+          arena.ptr());
+  ASSERT_NE(new_child, nullptr);
+  EXPECT_FALSE(upb_Message_IsFrozen(UPB_UPCAST(new_child)));
+  upb_test_ModelWithExtensions_set_random_int32(new_child, 7);
+  upb_test_ModelWithSubMessages_set_optional_child(msg, new_child);
+  EXPECT_EQ(EncodeToString(UPB_UPCAST(msg), mt, 0, arena.ptr()),
+            std::string("\x20\x01"
+                        "\x2a\x05\x18\x07\x22\x01"
+                        "c"
+                        "\x32\x05\x22\x01"
+                        "i\x18\x03",
+                        16));
+}
+
+TEST(RetainEncodingTest, MergedSubMessageIsReencoded) {
+  Arena arena;
+  // optional_child { random_int32: 2 } optional_child { random_name: "c" }
+  std::string payload(
+      "\x2a\x02\x18\x02"
+      "\x2a\x03\x22\x01"
+      "c",
+      9);
+  const upb_MiniTable* mt = &upb_0test__ModelWithSubMessages_msg_init;
+  upb_test_ModelWithSubMessages* msg =
+      upb_test_ModelWithSubMessages_new(arena.ptr());
+  ASSERT_EQ(upb_Decode(payload.data(), payload.size(), UPB_UPCAST(msg), mt,
+                       nullptr, kUpb_DecodeOption_RetainEncoding, arena.ptr()),
+            kUpb_DecodeStatus_Ok);
+  EXPECT_EQ(EncodeToString(UPB_UPCAST(msg), mt, 0, arena.ptr()),
+            std::string("\x2a\x05\x18\x02\x22\x01"
+                        "c",
+                        7));
+}
+
+TEST(RetainEncodingTest, FailedParseFreezesNothing) {
+  Arena arena;
+  // optional_child { random_int32: 2 } items { <truncated> }
+  std::string payload(
+      "\x2a\x02\x18\x02"
+      "\x32\x05\x22\x01",
+      8);
+  const upb_MiniTable* mt = &upb_0test__ModelWithSubMessages_msg_init;
+  upb_test_ModelWithSubMessages* msg =
+      upb_test_ModelWithSubMessages_new(arena.ptr());
+  ASSERT_NE(upb_Decode(payload.data(), payload.size(), UPB_UPCAST(msg), mt,
+                       nullptr, kUpb_DecodeOption_RetainEncoding, arena.ptr()),
+            kUpb_DecodeStatus_Ok);
+
+  const upb_test_ModelWithExtensions* child =
+      upb_test_ModelWithSubMessages_optional_child(msg);
+  ASSERT_NE(child, nullptr);
+  EXPECT_FALSE(upb_Message_IsFrozen(UPB_UPCAST(child)));
+  EXPECT_EQ(UPB_PRIVATE(_upb_Message_GetEncoding)(UPB_UPCAST(child)), nullptr);
+}
+
+// Returns a MiniTable for a message with a nested copy of itself in each of
+// its message fields (singular, repeated, and group):
+//
+//   message M {
+//     int32 id = 1;
+//     string name = 2;
+//     M child = 3;
+//     repeated M children = 4;
+//     group Group = 5 { <M> };
+//   }
+const upb_MiniTable* BuildRecursiveMiniTable(upb_Arena* arena) {
+  upb::MtDataEncoder e;
+  e.StartMessage(0);
+  e.PutField(kUpb_FieldType_Int32, 1, 0);
+  e.PutField(kUpb_FieldType_String, 2, 0);
+  e.PutField(kUpb_FieldType_Message, 3, 0);
+  e.PutField(kUpb_FieldType_Message, 4, kUpb_FieldModifier_IsRepeated);
+  e.PutField(kUpb_FieldType_Group, 5, 0);
+  upb_Status status;
+  upb_Status_Clear(&status);
+  upb_MiniTable* mt =
+      upb_MiniTable_Build(e.data().data(), e.data().size(), arena, &status);
+  EXPECT_TRUE(upb_Status_IsOk(&status)) << upb_Status_ErrorMessage(&status);
+  const upb_MiniTable* subs[] = {mt, mt, mt};
+  EXPECT_TRUE(upb_MiniTable_Link(mt, subs, 3, nullptr, 0));
+  return mt;
+}
+
+wire_types::WireMessage RecursivePayload(int depth, int id) {
+  wire_types::WireMessage msg{
+      {1, wire_types::Varint(id)},
+      {2, wire_types::Delimited(absl::StrCat("name", id))},
+  };
+  if (depth == 0) return msg;
+  msg.push_back({3, wire_types::Delimited(
+                        ToBinaryPayload(RecursivePayload(depth - 1, id + 1)))});
+  for (int i = 0; i < 3; i++) {
+    msg.push_back(
+        {4, wire_types::Delimited(ToBinaryPayload(
+                RecursivePayload(depth - 1, id * 3 + i)))});
+  }
+  wire_types::Group group{};
+  group.val = RecursivePayload(depth - 1, id + 7);
+  msg.push_back({5, group});
+  // Unknown fields, including an unknown group.
+  msg.push_back({99, wire_types::Delimited("unknown")});
+  msg.push_back({98, wire_types::Group{{1, wire_types::Varint(id)}}});
+  return msg;
+}
+
+upb_DecodeStatus StreamDecode(absl::string_view payload, size_t chunk_size,
+                              upb_Message* msg, const upb_MiniTable* mt,
+                              int options, upb_Arena* arena) {
+  upb_StreamDecoder* d =
+      upb_StreamDecoder_New(msg, mt, nullptr, options, arena);
+  EXPECT_NE(d, nullptr);
+  upb_DecodeStatus status = kUpb_DecodeStatus_Ok;
+  for (size_t i = 0; i < payload.size(); i += chunk_size) {
+    absl::string_view chunk = payload.substr(i, chunk_size);
+    status = upb_StreamDecoder_Feed(d, chunk.data(), chunk.size());
+    if (status != kUpb_DecodeStatus_Ok &&
+        status != kUpb_DecodeStatus_NeedMoreInput) {
+      break;
+    }
+  }
+  if (status == kUpb_DecodeStatus_Ok ||
+      status == kUpb_DecodeStatus_NeedMoreInput) {
+    status = upb_StreamDecoder_Finish(d);
+  }
+  upb_StreamDecoder_Free(d);
+  return status;
+}
+
+TEST(StreamDecoderTest, MatchesDecodeForAnyChunkSize) {
+  upb::Arena mt_arena;
+  const upb_MiniTable* mt = BuildRecursiveMiniTable(mt_arena.ptr());
+  ASSERT_NE(mt, nullptr);
+
+  wire_types::WireMessage wire = RecursivePayload(3, 1);
+  for (int i = 0; i < 20; i++) {
+    wire.push_back({4, wire_types::Delimited(
+                           ToBinaryPayload(RecursivePayload(2, 100 + i)))});
+  }
+  wire.push_back({2, wire_types::Delimited(std::string(300, 'x'))});
+  // Merges into the existing child.
+  wire.push_back(
+      {3, wire_types::Delimited(ToBinaryPayload(RecursivePayload(1, 50)))});
+  std::string payload = ToBinaryPayload(wire);
+
+  Arena arena;
+  upb_Message* expected = upb_Message_New(mt, arena.ptr());
+  ASSERT_EQ(upb_Decode(payload.data(), payload.size(), expected, mt, nullptr,
+                       0, arena.ptr()),
+            kUpb_DecodeStatus_Ok);
+  std::string expected_encoding = EncodeToString(
+      expected, mt, kUpb_EncodeOption_Deterministic, arena.ptr());
+
+  for (size_t chunk_size : {1, 2, 3, 7, 16, 100, 4096}) {
+    SCOPED_TRACE(chunk_size);
+    upb_Message* msg = upb_Message_New(mt, arena.ptr());
+    upb_DecodeStatus status =
+        StreamDecode(payload, chunk_size, msg, mt, 0, arena.ptr());
+    ASSERT_EQ(status, kUpb_DecodeStatus_Ok) << upb_DecodeStatus_String(status);
+    EXPECT_EQ(EncodeToString(msg, mt, kUpb_EncodeOption_Deterministic,
+                             arena.ptr()),
+              expected_encoding);
+  }
+}
+
+TEST(StreamDecoderTest, ReportsWhetherMoreInputIsNeeded) {
+  upb::Arena mt_arena;
+  const upb_MiniTable* mt = BuildRecursiveMiniTable(mt_arena.ptr());
+  ASSERT_NE(mt, nullptr);
+  std::string first = ToBinaryPayload(wire_types::WireMessage{
+      {1, wire_types::Varint(1)},
+  });
+  std::string second = ToBinaryPayload(wire_types::WireMessage{
+      {3, wire_types::Delimited(ToBinaryPayload(RecursivePayload(0, 2)))},
+  });
+
+  Arena arena;
+  upb_Message* msg = upb_Message_New(mt, arena.ptr());
+  upb_StreamDecoder* d =
+      upb_StreamDecoder_New(msg, mt, nullptr, 0, arena.ptr());
+  ASSERT_NE(d, nullptr);
+  EXPECT_EQ(upb_StreamDecoder_Feed(d, first.data(), first.size()),
+            kUpb_DecodeStatus_Ok);
+  EXPECT_EQ(upb_Message_GetInt32(msg, upb_MiniTable_FindFieldByNumber(mt, 1),
+                                 0),
+            1);
+  // Stop inside the submessage.
+  EXPECT_EQ(upb_StreamDecoder_Feed(d, second.data(), 4),
+            kUpb_DecodeStatus_NeedMoreInput);
+  EXPECT_EQ(upb_StreamDecoder_Feed(d, second.data() + 4, second.size() - 4),
+            kUpb_DecodeStatus_Ok);
+  EXPECT_EQ(upb_StreamDecoder_Finish(d), kUpb_DecodeStatus_Ok);
+  upb_StreamDecoder_Free(d);
+}
+
+TEST(StreamDecoderTest, LargeStringsGoStraightToTheArena) {
+  upb::Arena mt_arena;
+  upb::MtDataEncoder e;
+  e.StartMessage(0);
+  e.PutField(kUpb_FieldType_Bytes, 1, 0);
+  e.PutField(kUpb_FieldType_String, 2, kUpb_FieldModifier_IsRepeated);
+  upb_Status status;
+  upb_Status_Clear(&status);
+  upb_MiniTable* mt = upb_MiniTable_Build(e.data().data(), e.data().size(),
+                                          mt_arena.ptr(), &status);
+  ASSERT_TRUE(upb_Status_IsOk(&status)) << upb_Status_ErrorMessage(&status);
+
+  const size_t kSize = 1 << 20;
+  std::string payload = ToBinaryPayload(wire_types::WireMessage{
+      {2, wire_types::Delimited("first")},
+      {1, wire_types::Delimited(std::string(kSize, 'x'))},
+      {2, wire_types::Delimited(std::string(5000, 'y'))},
+  });
+
+  Arena expected_arena;
+  upb_Message* expected = upb_Message_New(mt, expected_arena.ptr());
+  ASSERT_EQ(upb_Decode(payload.data(), payload.size(), expected, mt, nullptr,
+                       0, expected_arena.ptr()),
+            kUpb_DecodeStatus_Ok);
+
+  Arena arena;
+  upb_Message* msg = upb_Message_New(mt, arena.ptr());
+  ASSERT_EQ(StreamDecode(payload, 4096, msg, mt, 0, arena.ptr()),
+            kUpb_DecodeStatus_Ok);
+  // The bytes field is copied into the arena once, rather than also being
+  // buffered there while it is incomplete.
+  EXPECT_LT(upb_Arena_SpaceAllocated(arena.ptr(), nullptr), kSize * 5 / 4);
+  EXPECT_EQ(EncodeToString(msg, mt, kUpb_EncodeOption_Deterministic,
+                           expected_arena.ptr()),
+            EncodeToString(expected, mt, kUpb_EncodeOption_Deterministic,
+                           expected_arena.ptr()));
+}
+
+TEST(StreamDecoderTest, ValidatesStreamedStrings) {
+  upb::Arena mt_arena;
+  const upb_MiniTable* mt = BuildRecursiveMiniTable(mt_arena.ptr());
+  ASSERT_NE(mt, nullptr);
+  std::string name(100, 'x');
+  name[50] = '\xff';
+  std::string payload = ToBinaryPayload(wire_types::WireMessage{
+      {3, wire_types::Delimited(ToBinaryPayload(wire_types::WireMessage{
+              {2, wire_types::Delimited(name)}}))},
+  });
+
+  Arena arena;
+  upb_Message* msg = upb_Message_New(mt, arena.ptr());
+  EXPECT_EQ(upb_Decode(payload.data(), payload.size(), msg, mt, nullptr,
+                       kUpb_DecodeOption_AlwaysValidateUtf8, arena.ptr()),
+            kUpb_DecodeStatus_BadUtf8);
+  for (size_t chunk_size : {1, 7, 60}) {
+    msg = upb_Message_New(mt, arena.ptr());
+    EXPECT_EQ(StreamDecode(payload, chunk_size, msg, mt,
+                           kUpb_DecodeOption_AlwaysValidateUtf8, arena.ptr()),
+              kUpb_DecodeStatus_BadUtf8);
+    // Without the option, these proto2 strings are not validated.
+    msg = upb_Message_New(mt, arena.ptr());
+    EXPECT_EQ(StreamDecode(payload, chunk_size, msg, mt, 0, arena.ptr()),
+              kUpb_DecodeStatus_Ok);
+  }
+}
+
+TEST(StreamDecoderTest, TruncatedInputIsMalformed) {
+  upb::Arena mt_arena;
+  const upb_MiniTable* mt = BuildRecursiveMiniTable(mt_arena.ptr());
+  ASSERT_NE(mt, nullptr);
+  std::string payload = ToBinaryPayload(RecursivePayload(2, 1));
+
+  Arena arena;
+  for (size_t size : {payload.size() - 1, payload.size() / 2}) {
+    upb_Message* msg = upb_Message_New(mt, arena.ptr());
+    EXPECT_EQ(StreamDecode(payload.substr(0, size), 3, msg, mt, 0, arena.ptr()),
+              kUpb_DecodeStatus_Malformed);
+  }
+}
+
+TEST(StreamDecoderTest, SubMessageOverrunIsMalformed) {
+  upb::Arena mt_arena;
+  const upb_MiniTable* mt = BuildRecursiveMiniTable(mt_arena.ptr());
+  ASSERT_NE(mt, nullptr);
+  // child { child { <5 bytes> } }, but the outer child is only 3 bytes long.
+  std::string payload("\x1a\x03\x1a\x05\x08\x01\x08\x01\x08", 9);
+
+  Arena arena;
+  for (size_t chunk_size : {1, 4, 9}) {
+    upb_Message* msg = upb_Message_New(mt, arena.ptr());
+    EXPECT_EQ(StreamDecode(payload, chunk_size, msg, mt, 0, arena.ptr()),
+              kUpb_DecodeStatus_Malformed);
+  }
+}
+
+TEST(StreamDecoderTest, ChecksRequiredFieldsAtTheEnd) {
+  upb::Arena mt_arena;
+  upb::MtDataEncoder e;
+  e.StartMessage(0);
+  e.PutField(kUpb_FieldType_Int32, 1, kUpb_FieldModifier_IsRequired);
+  e.PutField(kUpb_FieldType_Message, 2, 0);
+  upb_Status status;
+  upb_Status_Clear(&status);
+  upb_MiniTable* mt = upb_MiniTable_Build(e.data().data(), e.data().size(),
+                                          mt_arena.ptr(), &status);
+  ASSERT_TRUE(upb_Status_IsOk(&status)) << upb_Status_ErrorMessage(&status);
+  const upb_MiniTable* subs[] = {mt};
+  ASSERT_TRUE(upb_MiniTable_Link(mt, subs, 1, nullptr, 0));
+
+  // The required field of the top-level message comes last.
+  std::string missing_in_child = ToBinaryPayload(wire_types::WireMessage{
+      {2, wire_types::Delimited(ToBinaryPayload(wire_types::WireMessage{
+              {2, wire_types::Delimited("")}}))},
+      {1, wire_types::Varint(1)},
+  });
+  std::string complete = ToBinaryPayload(wire_types::WireMessage{
+      {2, wire_types::Delimited(ToBinaryPayload(wire_types::WireMessage{
+              {1, wire_types::Varint(2)}}))},
+      {1, wire_types::Varint(1)},
+  });
+
+  Arena arena;
+  for (size_t chunk_size : {1, 3, 100}) {
+    upb_Message* msg = upb_Message_New(mt, arena.ptr());
+    EXPECT_EQ(StreamDecode(missing_in_child, chunk_size, msg, mt,
+                           kUpb_DecodeOption_CheckRequired, arena.ptr()),
+              kUpb_DecodeStatus_MissingRequired);
+    msg = upb_Message_New(mt, arena.ptr());
+    EXPECT_EQ(StreamDecode(complete, chunk_size, msg, mt,
+                           kUpb_DecodeOption_CheckRequired, arena.ptr()),
+              kUpb_DecodeStatus_Ok);
+  }
+}
+
 }  // namespace
 
 }  // namespace test
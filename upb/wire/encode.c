@@ -35,6 +35,14 @@ upb_EncodeStatus upb_EncodeLengthPrefixed(const upb_Message* msg,
   return _upb_Encode(msg, l, options, arena, buf, size, true);
 }
 
+upb_EncodeStatus upb_EncodeToSink(const upb_Message* msg,
+                                  const upb_MiniTable* l, int options,
+                                  upb_Arena* arena, size_t chunk_size,
+                                  upb_EncodeSinkFunc* sink, void* closure) {
+  return UPB_PRIVATE(_upb_EncodeToSink)(msg, l, options, arena, chunk_size,
+                                        sink, closure);
+}
+
 const char* upb_EncodeStatus_String(upb_EncodeStatus status) {
   switch (status) {
     case kUpb_EncodeStatus_Ok:
@@ -45,6 +53,8 @@ const char* upb_EncodeStatus_String(upb_EncodeStatus status) {
       return "Max depth exceeded";
     case kUpb_EncodeStatus_OutOfMemory:
       return "Arena alloc failed";
+    case kUpb_EncodeStatus_SinkError:
+      return "Sink failed";
     default:
       return "Unknown encode status";
   }
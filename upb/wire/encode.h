@@ -54,6 +54,8 @@ typedef enum {
   kUpb_EncodeStatus_MissingRequired = 10,
   // The message is larger than protobuf's 2GB size limit.
   kUpb_EncodeStatus_MaxSizeExceeded = 11,
+  // The sink passed to upb_EncodeToSink() returned false.
+  kUpb_EncodeStatus_SinkError = 12,
 } upb_EncodeStatus;
 // LINT.ThenChange(//depot/google3/third_party/upb/rust/sys/wire/wire.rs:encode_status)
 
@@ -87,6 +89,30 @@ UPB_NODISCARD UPB_API upb_EncodeStatus upb_Encode(const upb_Message* msg,
 UPB_NODISCARD UPB_API upb_EncodeStatus upb_EncodeLengthPrefixed(
     const upb_Message* msg, const upb_MiniTable* l, int options,
     upb_Arena* arena, char** buf, size_t* size);
+
+// Receives the output of upb_EncodeToSink(), in order.  Returns false to stop
+// the encode, which then fails with kUpb_EncodeStatus_SinkError.
+typedef bool upb_EncodeSinkFunc(void* closure, const char* data, size_t size);
+
+// Encodes the message front to back and passes the output to `sink` as it is
+// produced, so that it is never held in memory all at once.  This is meant for
+// writing large messages to files and sockets.
+//
+// The sizes of all submessages are computed first, in the same way as
+// upb_ByteSize().  Besides a `chunk_size` byte output buffer (or a default
+// size if 0), `arena` holds four bytes per submessage, map entry and packed
+// field.  Strings of at least `chunk_size` bytes are passed to the sink
+// directly instead of being copied.
+//
+// The output is the same as upb_Encode() with the same options, except that
+// map entries are emitted in a different order unless
+// kUpb_EncodeOption_Deterministic is set.  If an error is returned, some output
+// may already have been passed to the sink.
+UPB_NODISCARD UPB_API upb_EncodeStatus upb_EncodeToSink(
+    const upb_Message* msg, const upb_MiniTable* l, int options,
+    upb_Arena* arena, size_t chunk_size, upb_EncodeSinkFunc* sink,
+    void* closure);
+
 // Utility function for wrapper languages to get an error string from a
 // upb_EncodeStatus.
 UPB_API const char* upb_EncodeStatus_String(upb_EncodeStatus status);
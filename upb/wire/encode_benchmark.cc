@@ -0,0 +1,115 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+#include "absl/log/absl_check.h"
+#include "absl/strings/str_format.h"
+#include "upb/base/descriptor_constants.h"
+#include "upb/base/status.hpp"
+#include "upb/mem/arena.h"
+#include "upb/message/message.h"
+#include "upb/mini_descriptor/decode.h"
+#include "upb/mini_descriptor/internal/encode.hpp"
+#include "upb/mini_descriptor/internal/modifiers.h"
+#include "upb/mini_descriptor/link.h"
+#include "upb/mini_table/message.h"
+#include "upb/wire/decode.h"
+#include "upb/wire/encode.h"
+#include "upb/wire/test_util/wire_message.h"
+
+// Must be last.
+#include "upb/port/def.inc"
+
+namespace upb {
+namespace test {
+
+namespace {
+
+bool DiscardSink(void* closure, const char* data, size_t size) {
+  benchmark::DoNotOptimize(data);
+  *static_cast<size_t*>(closure) += size;
+  return true;
+}
+
+// Encodes a large message either with upb_Encode() (chunk_size == 0), which
+// builds the whole output in the arena, or with upb_EncodeToSink(), which
+// hands it to the sink in chunks of the given size.  The "arena_bytes" counter
+// is the memory the encode itself allocated.
+void BM_EncodeLarge(benchmark::State& state, const upb_MiniTable* mt,
+                    const upb_Message* msg, size_t payload_size,
+                    size_t chunk_size) {
+  size_t arena_bytes = 0;
+  for (auto s : state) {
+    upb_Arena* arena = upb_Arena_New();
+    upb_EncodeStatus result;
+    size_t size = 0;
+    if (chunk_size == 0) {
+      char* buf;
+      result = upb_Encode(msg, mt, 0, arena, &buf, &size);
+      benchmark::DoNotOptimize(buf);
+    } else {
+      result = upb_EncodeToSink(msg, mt, 0, arena, chunk_size, DiscardSink,
+                                &size);
+    }
+    ASSERT_EQ(result, kUpb_EncodeStatus_Ok) << upb_EncodeStatus_String(result);
+    ASSERT_EQ(size, payload_size);
+    arena_bytes = upb_Arena_SpaceAllocated(arena, nullptr);
+    upb_Arena_Free(arena);
+  }
+  state.SetBytesProcessed(state.iterations() * payload_size);
+  state.counters["arena_bytes"] = arena_bytes;
+}
+
+// About 100 MiB of submessages, each holding an int32 and a 1 KiB string.
+[[maybe_unused]] upb_Arena* large_benchmark_registration = [] {
+  upb_Arena* arena = upb_Arena_New();
+  upb::Status status;
+  upb::MtDataEncoder sub_e;
+  sub_e.StartMessage(0);
+  sub_e.PutField(kUpb_FieldType_Int32, 1, 0);
+  sub_e.PutField(kUpb_FieldType_Bytes, 2, 0);
+  upb_MiniTable* sub_mt = upb_MiniTable_Build(
+      sub_e.data().data(), sub_e.data().size(), arena, status.ptr());
+  ABSL_CHECK(status.ok()) << status.error_message();
+  upb::MtDataEncoder e;
+  e.StartMessage(0);
+  e.PutField(kUpb_FieldType_Message, 1, kUpb_FieldModifier_IsRepeated);
+  upb_MiniTable* mt = upb_MiniTable_Build(e.data().data(), e.data().size(),
+                                          arena, status.ptr());
+  ABSL_CHECK(status.ok()) << status.error_message();
+  const upb_MiniTable* subs[1] = {sub_mt};
+  ABSL_CHECK(upb_MiniTable_Link(mt, subs, 1, nullptr, 0));
+
+  std::string bytes(1024, 'x');
+  wire_types::WireMessage wire;
+  for (uint32_t i = 0; i < 100 * 1024; i++) {
+    std::string sub = ToBinaryPayload(wire_types::WireMessage{
+        {1, wire_types::Varint(i)}, {2, wire_types::Delimited(bytes)}});
+    wire.push_back({1, wire_types::Delimited(sub)});
+  }
+  std::string payload = ToBinaryPayload(wire);
+  upb_Message* msg = upb_Message_New(mt, arena);
+  upb_DecodeStatus result = upb_Decode(payload.data(), payload.size(), msg, mt,
+                                       nullptr, 0, arena);
+  ABSL_CHECK(result == kUpb_DecodeStatus_Ok) << upb_DecodeStatus_String(result);
+  for (size_t chunk_size : {0, 4096, 65536}) {
+    ::benchmark::RegisterBenchmark(
+        absl::StrFormat("BM_EncodeLarge/%zu", chunk_size).c_str(),
+        BM_EncodeLarge, mt, msg, payload.size(), chunk_size);
+  }
+  return arena;
+}();
+
+}  // namespace
+
+}  // namespace test
+}  // namespace upb
@@ -4,9 +4,14 @@
 #include <stddef.h>
 
 #include <cstdint>
+#include <string>
 
 #include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
+#include "upb/base/descriptor_constants.h"
+#include "upb/base/status.h"
 #include "upb/mem/arena.h"
+#include "upb/mem/arena.hpp"
 #include "upb/message/array.h"
 #include "upb/message/internal/accessors.h"
 #include "upb/message/internal/extension.h"
@@ -14,6 +19,10 @@
 #include "upb/message/internal/message.h"
 #include "upb/message/message.h"
 #include "upb/message/unknown_fields.h"
+#include "upb/mini_descriptor/decode.h"
+#include "upb/mini_descriptor/internal/encode.hpp"
+#include "upb/mini_descriptor/internal/modifiers.h"
+#include "upb/mini_descriptor/link.h"
 #include "upb/mini_table/extension.h"
 #include "upb/mini_table/extension_registry.h"
 #include "upb/mini_table/field.h"
@@ -22,6 +31,7 @@
 #include "upb/wire/encode_test.upb.h"
 #include "upb/wire/encode_test.upb_minitable.h"
 #include "upb/wire/internal/encoder.h"
+#include "upb/wire/test_util/wire_message.h"
 
 // Must be last.
 #include "upb/port/def.inc"
@@ -501,6 +511,258 @@ TEST(EncodeTest, MixedExtensionAndUnknownOrderSuccess) {
 
   upb_Arena_Free(arena);
 }
+
+// Sink tests use a MiniTable that covers every kind of field the encoder
+// handles differently:
+//   1-8    scalars
+//   9-10   packed repeated int32, fixed32
+//   11-13  unpacked repeated sint32, double, string
+//   14-16  message, repeated message, group (all recursive)
+//   17-18  map<int32, Self>, map<string, string>
+const upb_MiniTable* BuildSinkTestMiniTable(upb_Arena* arena) {
+  upb::MtDataEncoder e;
+  e.StartMessage(0);
+  e.PutField(kUpb_FieldType_Int32, 1, 0);
+  e.PutField(kUpb_FieldType_SInt64, 2, 0);
+  e.PutField(kUpb_FieldType_Fixed64, 3, 0);
+  e.PutField(kUpb_FieldType_Double, 4, 0);
+  e.PutField(kUpb_FieldType_Float, 5, 0);
+  e.PutField(kUpb_FieldType_Bool, 6, 0);
+  e.PutField(kUpb_FieldType_String, 7, 0);
+  e.PutField(kUpb_FieldType_Bytes, 8, 0);
+  e.PutField(kUpb_FieldType_Int32, 9,
+             kUpb_FieldModifier_IsRepeated | kUpb_FieldModifier_IsPacked);
+  e.PutField(kUpb_FieldType_Fixed32, 10,
+             kUpb_FieldModifier_IsRepeated | kUpb_FieldModifier_IsPacked);
+  e.PutField(kUpb_FieldType_SInt32, 11, kUpb_FieldModifier_IsRepeated);
+  e.PutField(kUpb_FieldType_Double, 12, kUpb_FieldModifier_IsRepeated);
+  e.PutField(kUpb_FieldType_String, 13, kUpb_FieldModifier_IsRepeated);
+  e.PutField(kUpb_FieldType_Message, 14, 0);
+  e.PutField(kUpb_FieldType_Message, 15, kUpb_FieldModifier_IsRepeated);
+  e.PutField(kUpb_FieldType_Group, 16, 0);
+  e.PutField(kUpb_FieldType_Message, 17, kUpb_FieldModifier_IsRepeated);
+  e.PutField(kUpb_FieldType_Message, 18, kUpb_FieldModifier_IsRepeated);
+  upb_Status status;
+  upb_Status_Clear(&status);
+  upb_MiniTable* mt =
+      upb_MiniTable_Build(e.data().data(), e.data().size(), arena, &status);
+  EXPECT_TRUE(upb_Status_IsOk(&status)) << upb_Status_ErrorMessage(&status);
+
+  upb::MtDataEncoder int_map;
+  int_map.EncodeMap(kUpb_FieldType_Int32, kUpb_FieldType_Message, 0, 0);
+  upb_MiniTable* int_entry = upb_MiniTable_Build(
+      int_map.data().data(), int_map.data().size(), arena, &status);
+  EXPECT_TRUE(upb_Status_IsOk(&status)) << upb_Status_ErrorMessage(&status);
+  const upb_MiniTable* int_entry_subs[] = {mt};
+  EXPECT_TRUE(upb_MiniTable_Link(int_entry, int_entry_subs, 1, nullptr, 0));
+
+  upb::MtDataEncoder str_map;
+  str_map.EncodeMap(kUpb_FieldType_String, kUpb_FieldType_String, 0, 0);
+  upb_MiniTable* str_entry = upb_MiniTable_Build(
+      str_map.data().data(), str_map.data().size(), arena, &status);
+  EXPECT_TRUE(upb_Status_IsOk(&status)) << upb_Status_ErrorMessage(&status);
+
+  const upb_MiniTable* subs[] = {mt, mt, mt, int_entry, str_entry};
+  EXPECT_TRUE(upb_MiniTable_Link(mt, subs, 5, nullptr, 0));
+  return mt;
+}
+
+test::wire_types::WireMessage SinkTestPayload(int depth, int id,
+                                              bool with_maps) {
+  namespace wire_types = test::wire_types;
+  wire_types::WireMessage msg{
+      {1, wire_types::Varint(static_cast<uint64_t>(-id))},
+      {2, wire_types::Varint(2 * id + 1)},
+      {3, wire_types::Fixed64(0x0123456789abcdefULL + id)},
+      {4, wire_types::Fixed64(0x3ff0000000000000ULL)},
+      {5, wire_types::Fixed32(0x3f800000U + id)},
+      {6, wire_types::Varint(1)},
+      {7, wire_types::Delimited(absl::StrCat("name", id))},
+      {8, wire_types::Delimited(std::string(id % 7, '\xff'))},
+      {12, wire_types::Fixed64(id)},
+      {13, wire_types::Delimited(std::string(200 + id, 's'))},
+      {13, wire_types::Delimited("")},
+  };
+  for (int i = 0; i < 5; i++) {
+    msg.push_back({9, wire_types::Varint(i * 1000 - 2000)});
+    msg.push_back({10, wire_types::Fixed32(i)});
+    msg.push_back({11, wire_types::Varint(i)});
+  }
+  msg.push_back({99, wire_types::Delimited("unknown")});
+  if (depth == 0) return msg;
+
+  msg.push_back({14, wire_types::Delimited(test::ToBinaryPayload(
+                         SinkTestPayload(depth - 1, id + 1, with_maps)))});
+  for (int i = 0; i < 3; i++) {
+    wire_types::WireMessage sub =
+        SinkTestPayload(depth - 1, id * 3 + i, with_maps);
+    msg.push_back({15, wire_types::Delimited(test::ToBinaryPayload(sub))});
+  }
+  wire_types::Group group{};
+  group.val = SinkTestPayload(depth - 1, id + 7, with_maps);
+  msg.push_back({16, group});
+  if (!with_maps) return msg;
+  for (int i = 0; i < 4; i++) {
+    msg.push_back({17, wire_types::Delimited(test::ToBinaryPayload(
+                           wire_types::WireMessage{
+                               {1, wire_types::Varint(i * 37 % 5)},
+                               {2, wire_types::Delimited(test::ToBinaryPayload(
+                                       SinkTestPayload(depth - 1, i, true)))},
+                           }))});
+    msg.push_back({18, wire_types::Delimited(test::ToBinaryPayload(
+                           wire_types::WireMessage{
+                               {1, wire_types::Delimited(absl::StrCat("k", i))},
+                               {2, wire_types::Delimited(absl::StrCat("v", i))},
+                           }))});
+  }
+  return msg;
+}
+
+struct SinkOutput {
+  std::string data;
+  size_t calls = 0;
+  size_t fail_at_call = SIZE_MAX;
+};
+
+bool AppendToSinkOutput(void* closure, const char* data, size_t size) {
+  SinkOutput* out = static_cast<SinkOutput*>(closure);
+  if (++out->calls == out->fail_at_call) return false;
+  out->data.append(data, size);
+  return true;
+}
+
+std::string EncodeToString(const upb_Message* msg, const upb_MiniTable* mt,
+                           int options, upb_Arena* arena) {
+  char* buf;
+  size_t size;
+  EXPECT_EQ(upb_Encode(msg, mt, options, arena, &buf, &size),
+            kUpb_EncodeStatus_Ok);
+  return std::string(buf, size);
+}
+
+std::string EncodeToSinkString(const upb_Message* msg, const upb_MiniTable* mt,
+                               int options, size_t chunk_size) {
+  upb::Arena arena;
+  SinkOutput out;
+  EXPECT_EQ(upb_EncodeToSink(msg, mt, options, arena.ptr(), chunk_size,
+                             &AppendToSinkOutput, &out),
+            kUpb_EncodeStatus_Ok);
+  return out.data;
+}
+
+TEST(EncodeToSinkTest, MatchesEncode) {
+  upb::Arena arena;
+  const upb_MiniTable* mt = BuildSinkTestMiniTable(arena.ptr());
+  std::string payload =
+      test::ToBinaryPayload(SinkTestPayload(3, 1, /*with_maps=*/true));
+  upb_Message* msg = upb_Message_New(mt, arena.ptr());
+  ASSERT_EQ(upb_Decode(payload.data(), payload.size(), msg, mt, nullptr, 0,
+                       arena.ptr()),
+            kUpb_DecodeStatus_Ok);
+
+  for (int options : {int{kUpb_EncodeOption_Deterministic},
+                      kUpb_EncodeOption_Deterministic |
+                          kUpb_EncodeOption_SkipUnknown}) {
+    std::string expected = EncodeToString(msg, mt, options, arena.ptr());
+    for (size_t chunk_size : {0, 1, 16, 100, 4096, 1 << 20}) {
+      SCOPED_TRACE(absl::StrCat("options=", options, " chunk=", chunk_size));
+      EXPECT_EQ(EncodeToSinkString(msg, mt, options, chunk_size), expected);
+    }
+  }
+}
+
+TEST(EncodeToSinkTest, NonDeterministicMatchesAfterRoundTrip) {
+  upb::Arena arena;
+  const upb_MiniTable* mt = BuildSinkTestMiniTable(arena.ptr());
+  std::string payload =
+      test::ToBinaryPayload(SinkTestPayload(2, 1, /*with_maps=*/true));
+  upb_Message* msg = upb_Message_New(mt, arena.ptr());
+  ASSERT_EQ(upb_Decode(payload.data(), payload.size(), msg, mt, nullptr, 0,
+                       arena.ptr()),
+            kUpb_DecodeStatus_Ok);
+
+  // Only the order of map entries may differ from upb_Encode().
+  std::string streamed = EncodeToSinkString(msg, mt, 0, 64);
+  EXPECT_EQ(streamed.size(), EncodeToString(msg, mt, 0, arena.ptr()).size());
+  upb_Message* parsed = upb_Message_New(mt, arena.ptr());
+  ASSERT_EQ(upb_Decode(streamed.data(), streamed.size(), parsed, mt, nullptr,
+                       0, arena.ptr()),
+            kUpb_DecodeStatus_Ok);
+  EXPECT_EQ(
+      EncodeToString(parsed, mt, kUpb_EncodeOption_Deterministic, arena.ptr()),
+      EncodeToString(msg, mt, kUpb_EncodeOption_Deterministic, arena.ptr()));
+}
+
+TEST(EncodeToSinkTest, CopiesRetainedEncodingVerbatim) {
+  upb::Arena arena;
+  const upb_MiniTable* mt = BuildSinkTestMiniTable(arena.ptr());
+  std::string payload =
+      test::ToBinaryPayload(SinkTestPayload(2, 1, /*with_maps=*/false));
+  upb_Message* msg = upb_Message_New(mt, arena.ptr());
+  ASSERT_EQ(upb_Decode(payload.data(), payload.size(), msg, mt, nullptr,
+                       kUpb_DecodeOption_RetainEncoding, arena.ptr()),
+            kUpb_DecodeStatus_Ok);
+
+  for (int options : {0, int{kUpb_EncodeOption_Deterministic}}) {
+    SCOPED_TRACE(options);
+    EXPECT_EQ(EncodeToSinkString(msg, mt, options, 32),
+              EncodeToString(msg, mt, options, arena.ptr()));
+  }
+}
+
+TEST(EncodeToSinkTest, ExtensionsAndUnknowns) {
+  upb::Arena arena;
+  upb_wire_test_TestExtensions* msg =
+      upb_wire_test_TestExtensions_new(arena.ptr());
+  char unknown[] = "\x50\x64";
+  EXPECT_TRUE(UPB_PRIVATE(_upb_Message_AddUnknown)(
+      (upb_Message*)msg, unknown, sizeof(unknown) - 1, arena.ptr(),
+      kUpb_AddUnknown_Copy));
+  int32_t val = 42;
+  UPB_PRIVATE(_upb_Message_SetNonCanonicalExtension)(
+      (upb_Message*)msg, upb_wire_test_ext_i32_ext, &val, arena.ptr());
+  upb_wire_test_TestRecursive* sub_msg =
+      upb_wire_test_TestRecursive_new(arena.ptr());
+  upb_wire_test_TestRecursive_set_recursive(
+      sub_msg, upb_wire_test_TestRecursive_new(arena.ptr()));
+  upb_Extension* ext = UPB_PRIVATE(_upb_Message_GetOrCreateExtension)(
+      (upb_Message*)msg, upb_wire_test_ext_recursive_ext, arena.ptr());
+  ext->data.msg_val = (upb_Message*)sub_msg;
+
+  const upb_MiniTable* mt = &upb_0wire_0test__TestExtensions_msg_init;
+  for (int options : {0, int{kUpb_EncodeOption_Deterministic},
+                      int{kUpb_EncodeOption_SkipUnknown}}) {
+    SCOPED_TRACE(options);
+    EXPECT_EQ(EncodeToSinkString((upb_Message*)msg, mt, options, 0),
+              EncodeToString((upb_Message*)msg, mt, options, arena.ptr()));
+  }
+}
+
+TEST(EncodeToSinkTest, ReportsErrors) {
+  upb::Arena arena;
+  const upb_MiniTable* mt = BuildSinkTestMiniTable(arena.ptr());
+  std::string payload =
+      test::ToBinaryPayload(SinkTestPayload(3, 1, /*with_maps=*/true));
+  upb_Message* msg = upb_Message_New(mt, arena.ptr());
+  ASSERT_EQ(upb_Decode(payload.data(), payload.size(), msg, mt, nullptr, 0,
+                       arena.ptr()),
+            kUpb_DecodeStatus_Ok);
+
+  SinkOutput out;
+  out.fail_at_call = 3;
+  EXPECT_EQ(upb_EncodeToSink(msg, mt, 0, arena.ptr(), 16, &AppendToSinkOutput,
+                             &out),
+            kUpb_EncodeStatus_SinkError);
+  EXPECT_EQ(out.calls, 3u);
+
+  // Errors from the size pass are reported before anything is written.
+  SinkOutput too_deep;
+  EXPECT_EQ(upb_EncodeToSink(msg, mt, upb_EncodeOptions_MaxDepth(3),
+                             arena.ptr(), 16, &AppendToSinkOutput, &too_deep),
+            kUpb_EncodeStatus_MaxDepthExceeded);
+  EXPECT_EQ(too_deep.calls, 0u);
+}
+
 }  // namespace
 }  // namespace upb
 
@@ -0,0 +1,192 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "upb/wire/find_path.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "upb/base/string_view.h"
+#include "upb/wire/eps_copy_input_stream.h"
+#include "upb/wire/reader.h"
+#include "upb/wire/types.h"
+
+// Must be last.
+#include "upb/port/def.inc"
+
+// Recursion limit for groups that are skipped, matching the default that the
+// upb_WireReader uses.
+#define kUpb_FindPath_DepthLimit 100
+
+typedef struct {
+  upb_EpsCopyInputStream stream;
+  const uint32_t* path;
+  size_t path_len;
+  upb_WireValue* value;
+  bool found;
+  bool stop;  // Set once a value is found under kUpb_FindPathOption_FirstMatch.
+  bool first_match;
+} upb_FindPathState;
+
+static const char* _upb_FindPath_Scan(upb_FindPathState* s, const char* ptr,
+                                      size_t depth, uint32_t end_group_tag);
+
+static const char* _upb_FindPath_ReadValue(upb_FindPathState* s,
+                                           const char* ptr, uint32_t tag) {
+  upb_WireValue* v = s->value;
+  uint8_t wire_type = upb_WireReader_GetWireType(tag);
+  switch (wire_type) {
+    case kUpb_WireType_Varint:
+      ptr = upb_WireReader_ReadVarint(ptr, &v->data.varint, &s->stream);
+      break;
+    case kUpb_WireType_64Bit:
+      ptr = upb_WireReader_ReadFixed64(ptr, &v->data.fixed64, &s->stream);
+      break;
+    case kUpb_WireType_32Bit:
+      ptr = upb_WireReader_ReadFixed32(ptr, &v->data.fixed32, &s->stream);
+      break;
+    case kUpb_WireType_Delimited: {
+      int size;
+      ptr = upb_WireReader_ReadSize(ptr, &size, &s->stream);
+      if (!ptr || !upb_EpsCopyInputStream_CheckSize(&s->stream, ptr, size)) {
+        return NULL;
+      }
+      ptr = upb_EpsCopyInputStream_ReadStringAlwaysAlias(
+          &s->stream, ptr, size, &v->data.delimited);
+      break;
+    }
+    case kUpb_WireType_StartGroup: {
+      // Skip the group by hand rather than with _upb_WireReader_SkipGroup(),
+      // so that the returned bytes end where the end group tag starts, however
+      // many bytes that tag was encoded with.
+      const uint32_t end_group_tag = (tag & ~7U) | kUpb_WireType_EndGroup;
+      upb_EpsCopyCapture capture;
+      upb_EpsCopyCapture_Start(&capture, &s->stream, ptr);
+      while (true) {
+        if (upb_EpsCopyInputStream_IsDone(&s->stream, &ptr)) return NULL;
+        const char* field_start = ptr;
+        uint32_t field_tag;
+        ptr = upb_WireReader_ReadTag(ptr, &field_tag, &s->stream);
+        if (!ptr) return NULL;
+        if (field_tag == end_group_tag) {
+          if (!upb_EpsCopyCapture_End(&capture, &s->stream, field_start,
+                                      &v->data.delimited)) {
+            return NULL;
+          }
+          break;
+        }
+        ptr = _upb_WireReader_SkipValue(
+            ptr, field_tag, kUpb_FindPath_DepthLimit - 1, &s->stream);
+        if (!ptr) return NULL;
+      }
+      break;
+    }
+    default:
+      return NULL;
+  }
+  if (!ptr) return NULL;
+  v->wire_type = wire_type;
+  s->found = true;
+  s->stop = s->first_match;
+  return ptr;
+}
+
+static const char* _upb_FindPath_Descend(upb_FindPathState* s, const char* ptr,
+                                         uint32_t tag, size_t depth) {
+  switch (upb_WireReader_GetWireType(tag)) {
+    case kUpb_WireType_Delimited: {
+      int size;
+      ptr = upb_WireReader_ReadSize(ptr, &size, &s->stream);
+      if (!ptr || !upb_EpsCopyInputStream_CheckSize(&s->stream, ptr, size)) {
+        return NULL;
+      }
+      ptrdiff_t delta = upb_EpsCopyInputStream_PushLimit(&s->stream, ptr, size);
+      if (delta < 0) return NULL;
+      ptr = _upb_FindPath_Scan(s, ptr, depth + 1, 0);
+      // Once stopped, the remaining input is abandoned along with its limits.
+      if (!ptr || s->stop) return ptr;
+      upb_EpsCopyInputStream_PopLimit(&s->stream, ptr, delta);
+      return ptr;
+    }
+    case kUpb_WireType_StartGroup:
+      return _upb_FindPath_Scan(s, ptr, depth + 1,
+                                (tag & ~7U) | kUpb_WireType_EndGroup);
+    default:
+      // A scalar cannot contain the rest of the path.
+      return _upb_WireReader_SkipValue(ptr, tag, kUpb_FindPath_DepthLimit,
+                                       &s->stream);
+  }
+}
+
+// Scans the fields of one message for `path[depth]`, until the current limit
+// is reached or, if `end_group_tag` is non-zero, until that tag is read.
+static const char* _upb_FindPath_Scan(upb_FindPathState* s, const char* ptr,
+                                      size_t depth, uint32_t end_group_tag) {
+  const uint32_t number = s->path[depth];
+  const bool last = depth + 1 == s->path_len;
+  while (!upb_EpsCopyInputStream_IsDone(&s->stream, &ptr)) {
+    uint32_t tag;
+    ptr = upb_WireReader_ReadTag(ptr, &tag, &s->stream);
+    if (!ptr) return NULL;
+    if (end_group_tag && tag == end_group_tag) return ptr;
+    if (upb_WireReader_GetFieldNumber(tag) != number) {
+      ptr = _upb_WireReader_SkipValue(ptr, tag, kUpb_FindPath_DepthLimit,
+                                      &s->stream);
+    } else if (last) {
+      ptr = _upb_FindPath_ReadValue(s, ptr, tag);
+    } else {
+      ptr = _upb_FindPath_Descend(s, ptr, tag, depth);
+    }
+    if (!ptr || s->stop) return ptr;
+  }
+  // Reaching the limit inside a group means the end group tag is missing.
+  if (ptr && end_group_tag) return NULL;
+  return ptr;
+}
+
+static upb_FindPath_Status _upb_FindPath_Run(upb_FindPathState* s,
+                                             const char* buf, size_t size) {
+  s->found = false;
+  s->stop = false;
+  upb_EpsCopyInputStream_Init(&s->stream, &buf, size);
+  const char* ptr = _upb_FindPath_Scan(s, buf, 0, 0);
+  if (!ptr || upb_EpsCopyInputStream_IsError(&s->stream)) {
+    return kUpb_FindPath_ParseError;
+  }
+  return s->found ? kUpb_FindPath_Ok : kUpb_FindPath_NotPresent;
+}
+
+upb_FindPath_Status upb_Wire_FindPath(const char* buf, size_t size,
+                                      const uint32_t* path, size_t path_len,
+                                      int options, upb_WireValue* value) {
+  UPB_ASSERT(path_len > 0);
+  upb_FindPathState s;
+  s.path = path;
+  s.path_len = path_len;
+  s.value = value;
+  s.first_match = options & kUpb_FindPathOption_FirstMatch;
+  return _upb_FindPath_Run(&s, buf, size);
+}
+
+size_t upb_Wire_FindPathBatch(const upb_StringView* inputs, size_t count,
+                              const uint32_t* path, size_t path_len,
+                              int options, upb_WireValue* values,
+                              upb_FindPath_Status* statuses) {
+  UPB_ASSERT(path_len > 0);
+  upb_FindPathState s;
+  s.path = path;
+  s.path_len = path_len;
+  s.first_match = options & kUpb_FindPathOption_FirstMatch;
+  size_t found = 0;
+  for (size_t i = 0; i < count; i++) {
+    s.value = &values[i];
+    statuses[i] = _upb_FindPath_Run(&s, inputs[i].data, inputs[i].size);
+    found += statuses[i] == kUpb_FindPath_Ok;
+  }
+  return found;
+}
@@ -0,0 +1,99 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// upb_Wire_FindPath: evaluates a field-number path directly on serialized
+// bytes, without a MiniTable and without parsing into a message.
+//
+// This is intended for callers that need one or two values (e.g. a request id
+// used for routing) out of a large number of serialized messages. Fields that
+// are not on the path are skipped by length, so the cost is roughly one tag
+// read per field at each level of the path.
+
+#ifndef UPB_WIRE_FIND_PATH_H_
+#define UPB_WIRE_FIND_PATH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "upb/base/string_view.h"
+
+// Must be last.
+#include "upb/port/def.inc"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+  // Return the first occurrence of the field instead of the last one. This
+  // lets the scan stop as soon as the value is found, but does not follow the
+  // "last one wins" rule that a full parse applies to singular fields.
+  kUpb_FindPathOption_FirstMatch = 1,
+};
+
+typedef enum {
+  kUpb_FindPath_Ok,
+  kUpb_FindPath_NotPresent,
+  kUpb_FindPath_ParseError,
+} upb_FindPath_Status;
+
+// A single value as it appears on the wire. No type information is available,
+// so interpreting the value (zigzag decoding, float bit casts, etc.) is left
+// to the caller.
+typedef struct {
+  // One of kUpb_WireType_Varint, kUpb_WireType_64Bit, kUpb_WireType_32Bit,
+  // kUpb_WireType_Delimited or kUpb_WireType_StartGroup.
+  uint8_t wire_type;
+  union {
+    uint64_t varint;
+    uint32_t fixed32;
+    uint64_t fixed64;
+    // For kUpb_WireType_Delimited, the payload after the length prefix. For
+    // kUpb_WireType_StartGroup, the bytes between the start and end group
+    // tags. Always aliases the input buffer.
+    upb_StringView delimited;
+  } data;
+} upb_WireValue;
+
+// Looks up the field identified by the field numbers `path[0..path_len)` in
+// the serialized message `buf[0..size)`. Every element of the path except the
+// last must name a length-delimited or group field; occurrences of those
+// fields whose wire type cannot hold a message are ignored.
+//
+// By default this follows the semantics of a full parse: if the field occurs
+// more than once the last occurrence is returned, and occurrences of
+// intermediate messages are merged. For repeated fields this means that the
+// last element is returned; packed fields are returned as a delimited value.
+//
+// Skipped fields are only checked for well-formed lengths, so inputs that a
+// full parse would reject (e.g. bad UTF-8 or malformed nested messages off the
+// path) may still return kUpb_FindPath_Ok. With kUpb_FindPathOption_FirstMatch,
+// the input past the returned value is not examined at all.
+//
+// REQUIRES: path_len > 0.
+UPB_API upb_FindPath_Status upb_Wire_FindPath(const char* buf, size_t size,
+                                              const uint32_t* path,
+                                              size_t path_len, int options,
+                                              upb_WireValue* value);
+
+// Evaluates the same path over `count` inputs, storing the result for
+// `inputs[i]` in `statuses[i]` and `values[i]`. `values[i]` is only
+// meaningful when `statuses[i]` is kUpb_FindPath_Ok. Returns the number of
+// inputs in which the field was found.
+UPB_API size_t upb_Wire_FindPathBatch(const upb_StringView* inputs,
+                                      size_t count, const uint32_t* path,
+                                      size_t path_len, int options,
+                                      upb_WireValue* values,
+                                      upb_FindPath_Status* statuses);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#include "upb/port/undef.inc"
+
+#endif /* UPB_WIRE_FIND_PATH_H_ */
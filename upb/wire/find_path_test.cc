@@ -0,0 +1,199 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "upb/wire/find_path.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/strings/string_view.h"
+#include "upb/base/string_view.h"
+#include "upb/wire/test_util/wire_message.h"
+#include "upb/wire/types.h"
+
+namespace upb {
+namespace test {
+namespace {
+
+using wire_types::Delimited;
+using wire_types::Fixed32;
+using wire_types::Fixed64;
+using wire_types::Group;
+using wire_types::Varint;
+using wire_types::WireMessage;
+
+upb_FindPath_Status FindPath(absl::string_view data,
+                             std::vector<uint32_t> path, upb_WireValue* value,
+                             int options = 0) {
+  return upb_Wire_FindPath(data.data(), data.size(), path.data(), path.size(),
+                           options, value);
+}
+
+absl::string_view ToStringView(upb_StringView sv) {
+  return absl::string_view(sv.data, sv.size);
+}
+
+TEST(FindPathTest, TopLevelScalars) {
+  std::string data = ToBinaryPayload(WireMessage{
+      {1, Varint(150)},
+      {2, Fixed32(7)},
+      {3, Fixed64(8)},
+      {4, Delimited("abc")},
+  });
+  upb_WireValue value;
+  ASSERT_EQ(FindPath(data, {1}, &value), kUpb_FindPath_Ok);
+  EXPECT_EQ(value.wire_type, kUpb_WireType_Varint);
+  EXPECT_EQ(value.data.varint, 150);
+  ASSERT_EQ(FindPath(data, {2}, &value), kUpb_FindPath_Ok);
+  EXPECT_EQ(value.wire_type, kUpb_WireType_32Bit);
+  EXPECT_EQ(value.data.fixed32, 7);
+  ASSERT_EQ(FindPath(data, {3}, &value), kUpb_FindPath_Ok);
+  EXPECT_EQ(value.wire_type, kUpb_WireType_64Bit);
+  EXPECT_EQ(value.data.fixed64, 8);
+  ASSERT_EQ(FindPath(data, {4}, &value), kUpb_FindPath_Ok);
+  EXPECT_EQ(value.wire_type, kUpb_WireType_Delimited);
+  EXPECT_EQ(ToStringView(value.data.delimited), "abc");
+  // The returned string aliases the input.
+  EXPECT_GE(value.data.delimited.data, data.data());
+  EXPECT_LT(value.data.delimited.data, data.data() + data.size());
+
+  EXPECT_EQ(FindPath(data, {5}, &value), kUpb_FindPath_NotPresent);
+  EXPECT_EQ(FindPath("", {1}, &value), kUpb_FindPath_NotPresent);
+}
+
+TEST(FindPathTest, NestedMessagesAndGroups) {
+  std::string data = ToBinaryPayload(WireMessage{
+      {1, Varint(1)},
+      {2, Delimited(ToBinaryPayload(WireMessage{
+              {1, Delimited("skipped")},
+              {3, Delimited(ToBinaryPayload(WireMessage{{4, Varint(42)}}))},
+          }))},
+      {5, Group{{6, Varint(7)}, {8, Group{{9, Fixed32(10)}}}}},
+  });
+  upb_WireValue value;
+  ASSERT_EQ(FindPath(data, {2, 3, 4}, &value), kUpb_FindPath_Ok);
+  EXPECT_EQ(value.data.varint, 42);
+  ASSERT_EQ(FindPath(data, {5, 8, 9}, &value), kUpb_FindPath_Ok);
+  EXPECT_EQ(value.data.fixed32, 10);
+  EXPECT_EQ(FindPath(data, {2, 3, 5}, &value), kUpb_FindPath_NotPresent);
+
+  // Selecting a group returns the bytes between the start and end tags.
+  ASSERT_EQ(FindPath(data, {5, 8}, &value), kUpb_FindPath_Ok);
+  EXPECT_EQ(value.wire_type, kUpb_WireType_StartGroup);
+  EXPECT_EQ(ToStringView(value.data.delimited),
+            ToBinaryPayload(WireMessage{{9, Fixed32(10)}}));
+
+  // A scalar cannot contain the rest of the path.
+  EXPECT_EQ(FindPath(data, {1, 1}, &value), kUpb_FindPath_NotPresent);
+}
+
+TEST(FindPathTest, GroupWithLongTags) {
+  // Tags padded to 3 bytes, including the end group tags.
+  std::string data = ToBinaryPayloadWithLongVarints(
+      WireMessage{{5, Group{{6, Varint(7)}, {8, Group{{9, Fixed32(10)}}}}}},
+      3, 1);
+  upb_WireValue value;
+  ASSERT_EQ(FindPath(data, {5, 8}, &value), kUpb_FindPath_Ok);
+  EXPECT_EQ(value.wire_type, kUpb_WireType_StartGroup);
+  EXPECT_EQ(ToStringView(value.data.delimited),
+            ToBinaryPayloadWithLongVarints(WireMessage{{9, Fixed32(10)}}, 3,
+                                           1));
+  ASSERT_EQ(FindPath(data, {5}, &value), kUpb_FindPath_Ok);
+  EXPECT_EQ(ToStringView(value.data.delimited),
+            ToBinaryPayloadWithLongVarints(
+                WireMessage{{6, Varint(7)}, {8, Group{{9, Fixed32(10)}}}}, 3,
+                1));
+}
+
+TEST(FindPathTest, LastOccurrenceWins) {
+  std::string data = ToBinaryPayload(WireMessage{
+      {1, Delimited(ToBinaryPayload(WireMessage{{2, Varint(1)}}))},
+      {3, Varint(4)},
+      {1, Delimited(ToBinaryPayload(WireMessage{{5, Varint(6)}}))},
+      {3, Varint(7)},
+  });
+  upb_WireValue value;
+  ASSERT_EQ(FindPath(data, {3}, &value), kUpb_FindPath_Ok);
+  EXPECT_EQ(value.data.varint, 7);
+  // Occurrences of the intermediate message are merged.
+  ASSERT_EQ(FindPath(data, {1, 2}, &value), kUpb_FindPath_Ok);
+  EXPECT_EQ(value.data.varint, 1);
+
+  ASSERT_EQ(FindPath(data, {3}, &value, kUpb_FindPathOption_FirstMatch),
+            kUpb_FindPath_Ok);
+  EXPECT_EQ(value.data.varint, 4);
+}
+
+TEST(FindPathTest, FirstMatchStopsScanning) {
+  std::string data = ToBinaryPayload(WireMessage{
+      {1, Delimited(ToBinaryPayload(WireMessage{{2, Varint(3)}}))},
+  });
+  // Trailing garbage is only detected when the whole input is scanned.
+  data.append("\xff\xff\xff\xff\xff\xff");
+  upb_WireValue value;
+  EXPECT_EQ(FindPath(data, {1, 2}, &value), kUpb_FindPath_ParseError);
+  ASSERT_EQ(FindPath(data, {1, 2}, &value, kUpb_FindPathOption_FirstMatch),
+            kUpb_FindPath_Ok);
+  EXPECT_EQ(value.data.varint, 3);
+}
+
+TEST(FindPathTest, MalformedInput) {
+  std::string head = ToBinaryPayload(WireMessage{
+      {1, Varint(1)},
+      {2, Delimited(ToBinaryPayload(WireMessage{{3, Delimited("abc")}}))},
+  });
+  std::string data = head + ToBinaryPayload(WireMessage{
+                                {4, Group{{5, Varint(6)}}},
+                            });
+  upb_WireValue value;
+  // Truncating anywhere except a field boundary is an error.
+  for (size_t size = 1; size < data.size(); ++size) {
+    if (size == 2 || size == head.size()) continue;
+    absl::string_view truncated(data.data(), size);
+    EXPECT_EQ(FindPath(truncated, {4, 5}, &value), kUpb_FindPath_ParseError)
+        << size;
+  }
+  // Delimited field extending past the end of its parent.
+  std::string bad = ToBinaryPayload(WireMessage{{1, Delimited("\x12\x05x")}});
+  EXPECT_EQ(FindPath(bad, {1, 2}, &value), kUpb_FindPath_ParseError);
+  // Unterminated group.
+  bad = ToBinaryPayload(WireMessage{{1, Delimited("\x1b\x20\x01")}});
+  EXPECT_EQ(FindPath(bad, {1, 3, 4}, &value), kUpb_FindPath_ParseError);
+}
+
+TEST(FindPathTest, Batch) {
+  std::vector<std::string> data = {
+      ToBinaryPayload(WireMessage{{1, Varint(10)}}),
+      ToBinaryPayload(WireMessage{{2, Varint(20)}}),
+      std::string("\x08", 1),
+      ToBinaryPayload(WireMessage{{2, Varint(30)}, {1, Varint(40)}}),
+  };
+  std::vector<upb_StringView> inputs;
+  for (const auto& d : data) {
+    inputs.push_back(upb_StringView_FromDataAndSize(d.data(), d.size()));
+  }
+  std::vector<upb_WireValue> values(inputs.size());
+  std::vector<upb_FindPath_Status> statuses(inputs.size());
+  const uint32_t path[] = {1};
+  EXPECT_EQ(upb_Wire_FindPathBatch(inputs.data(), inputs.size(), path, 1, 0,
+                                   values.data(), statuses.data()),
+            2);
+  EXPECT_EQ(statuses[0], kUpb_FindPath_Ok);
+  EXPECT_EQ(values[0].data.varint, 10);
+  EXPECT_EQ(statuses[1], kUpb_FindPath_NotPresent);
+  EXPECT_EQ(statuses[2], kUpb_FindPath_ParseError);
+  EXPECT_EQ(statuses[3], kUpb_FindPath_Ok);
+  EXPECT_EQ(values[3].data.varint, 40);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace upb
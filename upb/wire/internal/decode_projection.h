@@ -0,0 +1,70 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef UPB_WIRE_INTERNAL_DECODE_PROJECTION_H_
+#define UPB_WIRE_INTERNAL_DECODE_PROJECTION_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "upb/wire/decode.h"
+
+// Must be last.
+#include "upb/port/def.inc"
+
+typedef struct {
+  uint32_t number;
+  // NULL if the entire field (including all of its sub-fields) is selected.
+  upb_DecodeProjection* child;
+} upb_DecodeProjection_Entry;
+
+// A projection is a tree of field numbers. Each node lists the fields that
+// are selected at that level of nesting, sorted by field number.
+struct upb_DecodeProjection {
+  // Bit (n - 1) is set if field n is selected, for 1 <= n <= 64. Lets the
+  // decoder reject most unselected fields without searching `entries`.
+  uint64_t low_mask;
+  upb_DecodeProjection_Entry* entries;
+  uint32_t size;
+  uint32_t capacity;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Returns true if `number` is selected by `p`. On success `*child` is set to
+// the projection that applies to the field's sub-message, or NULL if the
+// entire field is selected.
+UPB_INLINE bool UPB_PRIVATE(_upb_DecodeProjection_Find)(
+    const upb_DecodeProjection* p, uint32_t number,
+    const upb_DecodeProjection** child) {
+  if (number - 1 < 64 && !(p->low_mask & (1ULL << (number - 1)))) {
+    return false;
+  }
+  uint32_t lo = 0;
+  uint32_t hi = p->size;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (p->entries[mid].number < number) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == p->size || p->entries[lo].number != number) return false;
+  *child = p->entries[lo].child;
+  return true;
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#include "upb/port/undef.inc"
+
+#endif /* UPB_WIRE_INTERNAL_DECODE_PROJECTION_H_ */
@@ -0,0 +1,78 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef UPB_WIRE_INTERNAL_DECODE_STATS_H_
+#define UPB_WIRE_INTERNAL_DECODE_STATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "upb/hash/int_table.h"
+#include "upb/mem/arena.h"
+#include "upb/mini_table/message.h"
+#include "upb/wire/decode.h"
+
+// Must be last.
+#include "upb/port/def.inc"
+
+// Per-field counts for one message type.
+typedef struct {
+  const upb_MiniTable* mt;
+  uint64_t counts[];  // Indexed like the MiniTable's fields.
+} upb_DecodeStats_Message;
+
+struct upb_DecodeStats {
+  upb_Arena* arena;
+  // Where new entries are allocated from. This is normally `arena`, but the
+  // decoder works on a private copy of its arena, so if `arena` is also the
+  // decode arena, this points to the copy for the duration of the decode.
+  upb_Arena* alloc;
+  uint32_t sample_rate;
+  uint32_t countdown;  // Decodes left until the next sampled one.
+  uint64_t decodes;
+  uint64_t sampled_decodes;
+  uint64_t fields;
+  uint64_t fast_fields;
+
+  // Keyed by upb_MiniTable*. The values are also kept in `messages` so that
+  // they can be iterated in a stable order.
+  upb_inttable by_table;
+  upb_DecodeStats_Message** messages;
+  uint32_t size;
+  uint32_t capacity;
+
+  // Most messages repeat the same field types many times in a row.
+  upb_DecodeStats_Message* last;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Counts one occurrence of field `number` of `mt` in a sampled decode.
+// `has_fast_slot` says whether the field's tag has a fasttable slot. Returns
+// false on allocation failure.
+bool UPB_PRIVATE(_upb_DecodeStats_Record)(upb_DecodeStats* s,
+                                         const upb_MiniTable* mt,
+                                         uint32_t number, bool has_fast_slot);
+
+// Starts a decode, and returns whether it should be sampled.
+UPB_INLINE bool UPB_PRIVATE(_upb_DecodeStats_StartDecode)(upb_DecodeStats* s) {
+  s->decodes++;
+  if (--s->countdown > 0) return false;
+  s->countdown = s->sample_rate;
+  s->sampled_decodes++;
+  return true;
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#include "upb/port/undef.inc"
+
+#endif /* UPB_WIRE_INTERNAL_DECODE_STATS_H_ */
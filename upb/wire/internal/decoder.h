@@ -50,6 +50,11 @@ typedef union {
 typedef struct upb_Decoder {
   upb_EpsCopyInputStream input;
   const upb_ExtensionRegistry* extreg;
+  // Fields selected at the current nesting level, or NULL to decode all
+  // fields. See upb_DecodeWithProjection().
+  const upb_DecodeProjection* projection;
+  // Non-NULL if this is a sampled decode. See upb_DecodeWithStats().
+  upb_DecodeStats* stats;
   upb_Message* original_msg;  // Pointer to preserve data to
   int depth;                  // Tracks recursion depth to bound stack usage.
   uint32_t end_group;  // field number of END_GROUP tag, else DECODE_NOGROUP.
@@ -93,12 +98,15 @@ UPB_INLINE const char* upb_Decoder_Init(upb_Decoder* d, const char* buf,
       (int)kUpb_DecodeStatus_Malformed == (int)kUpb_ErrorCode_Malformed,
       "mismatched error codes");
 
-  if (options & kUpb_DecodeOption_AlwaysValidateUtf8) {
-    // Fasttable decoder does not support this option.
+  if (options & (kUpb_DecodeOption_AlwaysValidateUtf8 |
+                 kUpb_DecodeOption_RetainEncoding)) {
+    // Fasttable decoder does not support these options.
     options |= kUpb_DecodeOption_DisableFastTable;
   }
 
   d->extreg = extreg;
+  d->projection = NULL;
+  d->stats = NULL;
   d->depth = upb_DecodeOptions_GetEffectiveMaxDepth(options);
   d->end_group = DECODE_NOGROUP;
   d->options = (uint16_t)options;
@@ -139,6 +147,8 @@ UPB_INLINE void upb_Decoder_Reset(upb_Decoder* d, int options,
   d->end_group = DECODE_NOGROUP;
   d->missing_required = false;
   d->message_is_done = false;
+  d->projection = NULL;
+  d->stats = NULL;
   d->original_msg = msg;
 }
 
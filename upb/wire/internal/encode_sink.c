@@ -0,0 +1,888 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2025 Google LLC.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// A two-pass encoder that writes front to back, for upb_EncodeToSink() and
+// upb_ByteSize().
+//
+// The size pass walks the message and records every length prefix it will need
+// (submessages, map entries and packed arrays) in pre-order.  The write pass
+// then walks the message again in exactly the same order, consuming those
+// lengths as it goes, and writes through a fixed-size buffer that is flushed to
+// the sink whenever it fills up.  Both passes visit fields in the order that
+// upb_Encode() emits them, so the output is the same.
+
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "upb/base/descriptor_constants.h"
+#include "upb/base/internal/endian.h"
+#include "upb/base/string_view.h"
+#include "upb/hash/common.h"
+#include "upb/hash/int_table.h"
+#include "upb/hash/str_table.h"
+#include "upb/mem/arena.h"
+#include "upb/message/array.h"
+#include "upb/message/internal/accessors.h"
+#include "upb/message/internal/array.h"
+#include "upb/message/internal/extension.h"
+#include "upb/message/internal/map.h"
+#include "upb/message/internal/map_entry.h"
+#include "upb/message/internal/map_sorter.h"
+#include "upb/message/internal/message.h"
+#include "upb/message/map.h"
+#include "upb/message/message.h"
+#include "upb/mini_table/extension.h"
+#include "upb/mini_table/field.h"
+#include "upb/mini_table/internal/field.h"
+#include "upb/mini_table/internal/message.h"
+#include "upb/mini_table/message.h"
+#include "upb/wire/encode.h"
+#include "upb/wire/internal/constants.h"
+#include "upb/wire/internal/encoder.h"
+#include "upb/wire/types.h"
+
+// Must be last.
+#include "upb/port/def.inc"
+
+enum {
+  kUpb_SinkEncoder_DefaultChunkSize = 16 * 1024,
+
+  // Large enough for any tag or varint, which are written without splitting.
+  kUpb_SinkEncoder_MinChunkSize = 16,
+};
+
+typedef struct {
+  int options;
+  int depth;
+  upb_EncodeStatus status;
+  jmp_buf* err;
+  _upb_mapsorter sorter;
+  upb_Arena* arena;
+
+  // Length prefixes in pre-order, or NULL if only the total size is wanted.
+  // The size pass appends to this, and the write pass reads it back from
+  // `lengths_pos`.
+  uint32_t* lengths;
+  size_t lengths_count;
+  size_t lengths_cap;
+  size_t lengths_pos;
+
+  // The write pass buffers output in [buf, end) and flushes it to `sink`.
+  char* buf;
+  char* ptr;
+  char* end;
+  upb_EncodeSinkFunc* sink;
+  void* closure;
+} upb_SinkEncoder;
+
+UPB_NORETURN static void sink_err(upb_SinkEncoder* e, upb_EncodeStatus s) {
+  UPB_ASSERT(s != kUpb_EncodeStatus_Ok);
+  e->status = s;
+  UPB_LONGJMP(*e->err, 1);
+}
+
+static uint32_t sink_zz32(int32_t n) { return ((uint32_t)n << 1) ^ (n >> 31); }
+
+static uint64_t sink_zz64(int64_t n) { return ((uint64_t)n << 1) ^ (n >> 63); }
+
+// Returns the value that a varint-typed field is encoded as.
+UPB_FORCEINLINE
+uint64_t sink_varintval(const void* mem, upb_FieldType type) {
+  switch (type) {
+    case kUpb_FieldType_Int64:
+    case kUpb_FieldType_UInt64:
+      return *(const uint64_t*)mem;
+    case kUpb_FieldType_UInt32:
+      return *(const uint32_t*)mem;
+    case kUpb_FieldType_Int32:
+    case kUpb_FieldType_Enum:
+      return (uint64_t)(int64_t)*(const int32_t*)mem;
+    case kUpb_FieldType_Bool:
+      return *(const bool*)mem;
+    case kUpb_FieldType_SInt32:
+      return sink_zz32(*(const int32_t*)mem);
+    case kUpb_FieldType_SInt64:
+      return sink_zz64(*(const int64_t*)mem);
+    default:
+      UPB_UNREACHABLE();
+  }
+}
+
+// Iteration over map entries and extensions, shared by both passes so that
+// they always agree on the order.  upb_Encode() writes back to front, so it
+// emits sorted entries in descending order; we do the same.
+
+typedef struct {
+  const upb_Map* map;
+  _upb_sortedmap sorted;
+  intptr_t iter;
+  bool deterministic;
+} upb_SinkMapIter;
+
+static void sink_mapiter_begin(upb_SinkEncoder* e, upb_SinkMapIter* it,
+                               const upb_Map* map,
+                               const upb_MiniTable* layout) {
+  it->map = map;
+  it->deterministic = (e->options & kUpb_EncodeOption_Deterministic) != 0;
+  if (it->deterministic) {
+    if (!_upb_mapsorter_pushmap(
+            &e->sorter,
+            layout->UPB_PRIVATE(fields)[0].UPB_PRIVATE(descriptortype), map,
+            &it->sorted)) {
+      sink_err(e, kUpb_EncodeStatus_OutOfMemory);
+    }
+  } else {
+    it->iter = map->UPB_PRIVATE(is_strtable) ? UPB_STRTABLE_BEGIN
+                                             : UPB_INTTABLE_BEGIN;
+  }
+}
+
+static bool sink_mapiter_next(upb_SinkEncoder* e, upb_SinkMapIter* it,
+                              upb_MapEntry* ent) {
+  const upb_Map* map = it->map;
+  upb_value val;
+  if (it->deterministic) {
+    if (it->sorted.end == it->sorted.start) return false;
+    const upb_tabent* tabent =
+        (const upb_tabent*)e->sorter.entries[--it->sorted.end];
+    if (map->UPB_PRIVATE(is_strtable)) {
+      _upb_map_fromkey(upb_key_strview(tabent->key), &ent->k, map->key_size);
+    } else {
+      uintptr_t key = tabent->key.num;
+      memcpy(&ent->k, &key, map->key_size);
+    }
+    val.val = tabent->val.val;
+  } else if (map->UPB_PRIVATE(is_strtable)) {
+    upb_StringView strkey;
+    if (!upb_strtable_next2(&map->t.strtable, &strkey, &val, &it->iter)) {
+      return false;
+    }
+    _upb_map_fromkey(strkey, &ent->k, map->key_size);
+  } else {
+    uintptr_t intkey = 0;
+    if (!upb_inttable_next(&map->t.inttable, &intkey, &val, &it->iter)) {
+      return false;
+    }
+    memcpy(&ent->k, &intkey, map->key_size);
+  }
+  _upb_map_fromvalue(val, &ent->v, map->val_size);
+  return true;
+}
+
+static void sink_mapiter_end(upb_SinkEncoder* e, upb_SinkMapIter* it) {
+  if (it->deterministic) _upb_mapsorter_popmap(&e->sorter, &it->sorted);
+}
+
+typedef struct {
+  const upb_Message* msg;
+  _upb_sortedmap sorted;
+  uintptr_t iter;
+  bool deterministic;
+} upb_SinkExtIter;
+
+static void sink_extiter_begin(upb_SinkEncoder* e, upb_SinkExtIter* it,
+                               const upb_Message* msg,
+                               const upb_Message_Internal* in) {
+  it->msg = msg;
+  it->iter = kUpb_Message_ExtensionBegin;
+  it->deterministic = (e->options & kUpb_EncodeOption_Deterministic) != 0;
+  if (it->deterministic && !_upb_mapsorter_pushexts(&e->sorter, in,
+                                                    &it->sorted)) {
+    sink_err(e, kUpb_EncodeStatus_OutOfMemory);
+  }
+}
+
+static bool sink_extiter_next(upb_SinkEncoder* e, upb_SinkExtIter* it,
+                              const upb_MiniTableExtension** ext,
+                              upb_MessageValue* ext_val) {
+  if (!it->deterministic) {
+    return upb_Message_NextExtension(it->msg, ext, ext_val, &it->iter);
+  }
+  if (it->sorted.end == it->sorted.start) return false;
+  const upb_Extension* sorted_ext =
+      (const upb_Extension*)e->sorter.entries[--it->sorted.end];
+  *ext = sorted_ext->ext;
+  *ext_val = sorted_ext->data;
+  return true;
+}
+
+static void sink_extiter_end(upb_SinkEncoder* e, upb_SinkExtIter* it) {
+  if (it->deterministic) _upb_mapsorter_popmap(&e->sorter, &it->sorted);
+}
+
+static bool sink_ismessageset(const upb_MiniTable* m) {
+  return UPB_PRIVATE(_upb_MiniTable_ExtModeBase)(m) ==
+         kUpb_ExtMode_IsMessageSet;
+}
+
+/* Size pass ******************************************************************/
+
+static size_t sink_varintsize(uint64_t val) {
+  size_t size = 1;
+  while (val >= 128) {
+    val >>= 7;
+    size++;
+  }
+  return size;
+}
+
+static size_t sink_tagsize(uint32_t field_number) {
+  return sink_varintsize(field_number << 3);
+}
+
+// Returns the size of a length prefix, which is limited to 2GB.
+static size_t sink_lengthsize(upb_SinkEncoder* e, size_t len) {
+  if (len > INT32_MAX) sink_err(e, kUpb_EncodeStatus_MaxSizeExceeded);
+  return sink_varintsize(len);
+}
+
+// Reserves the next length prefix, to be filled in by sink_setlength() once
+// the contents have been sized.
+static size_t sink_reservelength(upb_SinkEncoder* e) {
+  if (!e->lengths) return 0;
+  if (e->lengths_count == e->lengths_cap) {
+    size_t old_bytes = e->lengths_cap * sizeof(*e->lengths);
+    size_t new_cap = UPB_MAX(e->lengths_cap * 2, 128);
+    e->lengths = upb_Arena_Realloc(e->arena, e->lengths, old_bytes,
+                                   new_cap * sizeof(*e->lengths));
+    if (!e->lengths) sink_err(e, kUpb_EncodeStatus_OutOfMemory);
+    e->lengths_cap = new_cap;
+  }
+  return e->lengths_count++;
+}
+
+// Records a length reserved with sink_reservelength(), and returns the size
+// of the length prefix plus the contents.
+static size_t sink_setlength(upb_SinkEncoder* e, size_t slot, size_t len) {
+  size_t prefix = sink_lengthsize(e, len);
+  if (e->lengths) e->lengths[slot] = (uint32_t)len;
+  return prefix + len;
+}
+
+static size_t sink_sizemsg(upb_SinkEncoder* e, const upb_Message* msg,
+                           const upb_MiniTable* m);
+
+static size_t sink_sizesubmsg(upb_SinkEncoder* e, const upb_Message* msg,
+                              const upb_MiniTable* m) {
+  size_t slot = sink_reservelength(e);
+  return sink_setlength(e, slot, sink_sizemsg(e, msg, m));
+}
+
+static size_t sink_sizescalar(upb_SinkEncoder* e, const void* field_mem,
+                              const upb_MiniTableField* f) {
+  size_t tag = sink_tagsize(upb_MiniTableField_Number(f));
+  switch (f->UPB_PRIVATE(descriptortype)) {
+    case kUpb_FieldType_Double:
+    case kUpb_FieldType_SFixed64:
+    case kUpb_FieldType_Fixed64:
+      return tag + 8;
+    case kUpb_FieldType_Float:
+    case kUpb_FieldType_Fixed32:
+    case kUpb_FieldType_SFixed32:
+      return tag + 4;
+    case kUpb_FieldType_String:
+    case kUpb_FieldType_Bytes: {
+      const upb_StringView* view = field_mem;
+      return tag + sink_lengthsize(e, view->size) + view->size;
+    }
+    case kUpb_FieldType_Group: {
+      const upb_Message* submsg = *(upb_Message* const*)field_mem;
+      if (submsg == NULL) return 0;
+      if (--e->depth == 0) sink_err(e, kUpb_EncodeStatus_MaxDepthExceeded);
+      const upb_MiniTable* subm = upb_MiniTable_GetSubMessageTable(f);
+      size_t size = 2 * tag + sink_sizemsg(e, submsg, subm);
+      e->depth++;
+      return size;
+    }
+    case kUpb_FieldType_Message: {
+      const upb_Message* submsg = *(upb_Message* const*)field_mem;
+      if (submsg == NULL) return 0;
+      if (--e->depth == 0) sink_err(e, kUpb_EncodeStatus_MaxDepthExceeded);
+      size_t size = tag + sink_sizesubmsg(e, submsg,
+                                          upb_MiniTable_GetSubMessageTable(f));
+      e->depth++;
+      return size;
+    }
+    default: {
+      const upb_FieldType type = f->UPB_PRIVATE(descriptortype);
+      return tag + sink_varintsize(sink_varintval(field_mem, type));
+    }
+  }
+}
+
+static size_t sink_sizearray(upb_SinkEncoder* e, const upb_Message* msg,
+                             const upb_MiniTableField* f) {
+  const upb_Array* arr = *UPB_PTR_AT(msg, f->UPB_PRIVATE(offset), upb_Array*);
+  if (arr == NULL || upb_Array_Size(arr) == 0) return 0;
+
+  const size_t n = upb_Array_Size(arr);
+  const char* data = upb_Array_DataPtr(arr);
+  const upb_FieldType type = f->UPB_PRIVATE(descriptortype);
+  const size_t tag = sink_tagsize(upb_MiniTableField_Number(f));
+  size_t size = 0;
+
+  switch (type) {
+    case kUpb_FieldType_String:
+    case kUpb_FieldType_Bytes: {
+      const upb_StringView* strs = (const upb_StringView*)data;
+      for (size_t i = 0; i < n; i++) {
+        size += tag + sink_lengthsize(e, strs[i].size) + strs[i].size;
+      }
+      return size;
+    }
+    case kUpb_FieldType_Group:
+    case kUpb_FieldType_Message: {
+      const upb_Message* const* msgs = (const upb_Message* const*)data;
+      const upb_MiniTable* subm = upb_MiniTable_GetSubMessageTable(f);
+      if (--e->depth == 0) sink_err(e, kUpb_EncodeStatus_MaxDepthExceeded);
+      for (size_t i = 0; i < n; i++) {
+        size += type == kUpb_FieldType_Group
+                    ? 2 * tag + sink_sizemsg(e, msgs[i], subm)
+                    : tag + sink_sizesubmsg(e, msgs[i], subm);
+      }
+      e->depth++;
+      return size;
+    }
+    default:
+      break;
+  }
+
+  // Reserve the packed length before sizing the elements, so that it stays in
+  // pre-order.
+  const bool packed = upb_MiniTableField_IsPacked(f);
+  size_t slot = packed ? sink_reservelength(e) : 0;
+  switch (type) {
+    case kUpb_FieldType_Double:
+    case kUpb_FieldType_SFixed64:
+    case kUpb_FieldType_Fixed64:
+      size = n * 8;
+      break;
+    case kUpb_FieldType_Float:
+    case kUpb_FieldType_Fixed32:
+    case kUpb_FieldType_SFixed32:
+      size = n * 4;
+      break;
+    default: {
+      const size_t elem_size = (size_t)1
+                               << UPB_PRIVATE(_upb_Array_ElemSizeLg2)(arr);
+      for (size_t i = 0; i < n; i++) {
+        size += sink_varintsize(sink_varintval(data + i * elem_size, type));
+      }
+      break;
+    }
+  }
+  return packed ? tag + sink_setlength(e, slot, size) : n * tag + size;
+}
+
+static size_t sink_sizemap(upb_SinkEncoder* e, const upb_Message* msg,
+                           const upb_MiniTableField* f) {
+  const upb_Map* map = *UPB_PTR_AT(msg, f->UPB_PRIVATE(offset), const upb_Map*);
+  const upb_MiniTable* layout = upb_MiniTable_MapEntrySubMessage(f);
+  UPB_ASSERT(upb_MiniTable_FieldCount(layout) == 2);
+  if (!map || !upb_Map_Size(map)) return 0;
+
+  const upb_MiniTableField* key_field = upb_MiniTable_MapKey(layout);
+  const upb_MiniTableField* val_field = upb_MiniTable_MapValue(layout);
+  const size_t tag = sink_tagsize(upb_MiniTableField_Number(f));
+  size_t size = 0;
+  upb_SinkMapIter it;
+  upb_MapEntry ent;
+  sink_mapiter_begin(e, &it, map, layout);
+  while (sink_mapiter_next(e, &it, &ent)) {
+    size_t slot = sink_reservelength(e);
+    size_t entry_size = sink_sizescalar(e, &ent.k, key_field) +
+                        sink_sizescalar(e, &ent.v, val_field);
+    size += tag + sink_setlength(e, slot, entry_size);
+  }
+  sink_mapiter_end(e, &it);
+  return size;
+}
+
+static size_t sink_sizefield(upb_SinkEncoder* e, const upb_Message* msg,
+                             const upb_MiniTableField* f) {
+  switch (UPB_PRIVATE(_upb_MiniTableField_Mode)(f)) {
+    case kUpb_FieldMode_Array:
+      return sink_sizearray(e, msg, f);
+    case kUpb_FieldMode_Map:
+      return sink_sizemap(e, msg, f);
+    case kUpb_FieldMode_Scalar:
+      return sink_sizescalar(e, UPB_PTR_AT(msg, f->UPB_PRIVATE(offset), void),
+                             f);
+    default:
+      UPB_UNREACHABLE();
+  }
+}
+
+static size_t sink_sizeext(upb_SinkEncoder* e,
+                           const upb_MiniTableExtension* ext,
+                           upb_MessageValue ext_val, bool is_message_set) {
+  if (UPB_UNLIKELY(is_message_set)) {
+    return 2 * sink_tagsize(kUpb_MsgSet_Item) +
+           sink_tagsize(kUpb_MsgSet_TypeId) +
+           sink_varintsize(upb_MiniTableExtension_Number(ext)) +
+           sink_tagsize(kUpb_MsgSet_Message) +
+           sink_sizesubmsg(e, ext_val.msg_val,
+                           upb_MiniTableExtension_GetSubMessage(ext));
+  }
+  return sink_sizefield(e, &ext_val.UPB_PRIVATE(ext_msg_val),
+                        &ext->UPB_PRIVATE(field));
+}
+
+// Returns the retained encoding of `msg` if upb_Encode() would copy it
+// verbatim.
+static const upb_StringView* sink_verbatim(upb_SinkEncoder* e,
+                                           const upb_Message* msg) {
+  const upb_StringView* encoding = UPB_PRIVATE(_upb_Message_GetEncoding)(msg);
+  if (UPB_LIKELY(!encoding)) return NULL;
+  if (e->options &
+      (kUpb_EncodeOption_Deterministic | kUpb_EncodeOption_SkipUnknown |
+       kUpb_EncodeOption_CheckRequired)) {
+    return NULL;
+  }
+  return encoding;
+}
+
+static size_t sink_sizemsg(upb_SinkEncoder* e, const upb_Message* msg,
+                           const upb_MiniTable* m) {
+  const upb_StringView* encoding = sink_verbatim(e, msg);
+  if (encoding) return encoding->size;
+
+  if ((e->options & kUpb_EncodeOption_CheckRequired) &&
+      m->UPB_PRIVATE(required_count) &&
+      !UPB_PRIVATE(_upb_Message_IsInitializedShallow)(msg, m)) {
+    sink_err(e, kUpb_EncodeStatus_MissingRequired);
+  }
+
+  size_t size = 0;
+  const upb_MiniTableField* f = &m->UPB_PRIVATE(fields)[0];
+  const upb_MiniTableField* end = f + upb_MiniTable_FieldCount(m);
+  for (; f != end; f++) {
+    if (UPB_PRIVATE(_upb_Message_FieldIsSet)(msg, f)) {
+      size += sink_sizefield(e, msg, f);
+    }
+  }
+
+  const upb_Message_Internal* in = UPB_PRIVATE(_upb_Message_GetInternal)(msg);
+  if (!in) return size;
+  const bool is_message_set = sink_ismessageset(m);
+
+  if (UPB_PRIVATE(_upb_MiniTable_ExtModeBase)(m) !=
+      kUpb_ExtMode_NonExtendable) {
+    upb_SinkExtIter it;
+    const upb_MiniTableExtension* ext;
+    upb_MessageValue ext_val;
+    sink_extiter_begin(e, &it, msg, in);
+    while (sink_extiter_next(e, &it, &ext, &ext_val)) {
+      size += sink_sizeext(e, ext, ext_val, is_message_set);
+    }
+    sink_extiter_end(e, &it);
+  }
+
+  if (e->options & kUpb_EncodeOption_SkipUnknown) return size;
+  for (size_t i = 0; i < in->size; i++) {
+    upb_TaggedAuxPtr tagged_ptr = in->aux_data[i];
+    if (upb_TaggedAuxPtr_IsUnknownStringView(tagged_ptr)) {
+      size += upb_TaggedPtrAux_StringViewRepr(tagged_ptr)->size;
+    } else if (upb_TaggedAuxPtr_IsNonCanonicalExtension(tagged_ptr)) {
+      const upb_Extension* ext =
+          upb_TaggedAuxPtr_NonCanonicalExtension(tagged_ptr);
+      size += sink_sizeext(e, ext->ext, ext->data, is_message_set);
+    }
+  }
+  return size;
+}
+
+/* Write pass *****************************************************************/
+
+// The size pass has already checked depth, lengths and required fields, and
+// the message cannot change in between, so none of that is repeated here.
+
+UPB_NOINLINE static void sink_flush(upb_SinkEncoder* e) {
+  size_t size = e->ptr - e->buf;
+  e->ptr = e->buf;
+  if (size && !e->sink(e->closure, e->buf, size)) {
+    sink_err(e, kUpb_EncodeStatus_SinkError);
+  }
+}
+
+// Ensures that at least `bytes` (<= kUpb_SinkEncoder_MinChunkSize) bytes are
+// available at e->ptr.
+UPB_FORCEINLINE
+void sink_reserve(upb_SinkEncoder* e, size_t bytes) {
+  if ((size_t)(e->end - e->ptr) < bytes) sink_flush(e);
+}
+
+UPB_NOINLINE static void sink_writebytes_slow(upb_SinkEncoder* e,
+                                              const char* data, size_t len) {
+  size_t avail = e->end - e->ptr;
+  memcpy(e->ptr, data, avail);
+  e->ptr += avail;
+  data += avail;
+  len -= avail;
+  sink_flush(e);
+  if (len >= (size_t)(e->end - e->buf)) {
+    // Hand large strings to the sink directly rather than copying them
+    // through the buffer.
+    if (!e->sink(e->closure, data, len)) {
+      sink_err(e, kUpb_EncodeStatus_SinkError);
+    }
+  } else {
+    memcpy(e->ptr, data, len);
+    e->ptr += len;
+  }
+}
+
+static void sink_writebytes(upb_SinkEncoder* e, const void* data, size_t len) {
+  if (UPB_LIKELY(len <= (size_t)(e->end - e->ptr))) {
+    if (len) memcpy(e->ptr, data, len);  // memcpy() with NULL is UB
+    e->ptr += len;
+  } else {
+    sink_writebytes_slow(e, data, len);
+  }
+}
+
+UPB_FORCEINLINE
+void sink_writevarint(upb_SinkEncoder* e, uint64_t val) {
+  sink_reserve(e, kUpb_Encoder_EncodeVarint64MaxSize);
+  e->ptr = upb_Encoder_EncodeVarint64(val, e->ptr);
+}
+
+UPB_FORCEINLINE
+void sink_writetag(upb_SinkEncoder* e, uint32_t field_number,
+                   uint8_t wire_type) {
+  sink_reserve(e, kUpb_Encoder_EncodeVarint32MaxSize);
+  e->ptr = upb_Encoder_EncodeVarint32((field_number << 3) | wire_type, e->ptr);
+}
+
+static uint32_t sink_nextlength(upb_SinkEncoder* e) {
+  UPB_ASSERT(e->lengths_pos < e->lengths_count);
+  return e->lengths[e->lengths_pos++];
+}
+
+static void sink_writefixed64(upb_SinkEncoder* e, const void* mem) {
+  uint64_t val;
+  memcpy(&val, mem, sizeof(val));
+  val = upb_BigEndian64(val);
+  sink_reserve(e, sizeof(val));
+  memcpy(e->ptr, &val, sizeof(val));
+  e->ptr += sizeof(val);
+}
+
+static void sink_writefixed32(upb_SinkEncoder* e, const void* mem) {
+  uint32_t val;
+  memcpy(&val, mem, sizeof(val));
+  val = upb_BigEndian32(val);
+  sink_reserve(e, sizeof(val));
+  memcpy(e->ptr, &val, sizeof(val));
+  e->ptr += sizeof(val);
+}
+
+static void sink_writemsg(upb_SinkEncoder* e, const upb_Message* msg,
+                          const upb_MiniTable* m);
+
+static void sink_writesubmsg(upb_SinkEncoder* e, const upb_Message* msg,
+                             const upb_MiniTable* m) {
+  sink_writevarint(e, sink_nextlength(e));
+  sink_writemsg(e, msg, m);
+}
+
+static void sink_writescalar(upb_SinkEncoder* e, const void* field_mem,
+                             const upb_MiniTableField* f) {
+  const uint32_t number = upb_MiniTableField_Number(f);
+  switch (f->UPB_PRIVATE(descriptortype)) {
+    case kUpb_FieldType_Double:
+    case kUpb_FieldType_SFixed64:
+    case kUpb_FieldType_Fixed64:
+      sink_writetag(e, number, kUpb_WireType_64Bit);
+      sink_writefixed64(e, field_mem);
+      return;
+    case kUpb_FieldType_Float:
+    case kUpb_FieldType_Fixed32:
+    case kUpb_FieldType_SFixed32:
+      sink_writetag(e, number, kUpb_WireType_32Bit);
+      sink_writefixed32(e, field_mem);
+      return;
+    case kUpb_FieldType_String:
+    case kUpb_FieldType_Bytes: {
+      const upb_StringView* view = field_mem;
+      sink_writetag(e, number, kUpb_WireType_Delimited);
+      sink_writevarint(e, view->size);
+      sink_writebytes(e, view->data, view->size);
+      return;
+    }
+    case kUpb_FieldType_Group: {
+      const upb_Message* submsg = *(upb_Message* const*)field_mem;
+      if (submsg == NULL) return;
+      sink_writetag(e, number, kUpb_WireType_StartGroup);
+      sink_writemsg(e, submsg, upb_MiniTable_GetSubMessageTable(f));
+      sink_writetag(e, number, kUpb_WireType_EndGroup);
+      return;
+    }
+    case kUpb_FieldType_Message: {
+      const upb_Message* submsg = *(upb_Message* const*)field_mem;
+      if (submsg == NULL) return;
+      sink_writetag(e, number, kUpb_WireType_Delimited);
+      sink_writesubmsg(e, submsg, upb_MiniTable_GetSubMessageTable(f));
+      return;
+    }
+    default:
+      sink_writetag(e, number, kUpb_WireType_Varint);
+      sink_writevarint(
+          e, sink_varintval(field_mem, f->UPB_PRIVATE(descriptortype)));
+      return;
+  }
+}
+
+static void sink_writefixedarray(upb_SinkEncoder* e, const upb_Array* arr,
+                                 const upb_MiniTableField* f, size_t elem_size,
+                                 bool packed, uint8_t wire_type) {
+  const size_t n = upb_Array_Size(arr);
+  const char* data = upb_Array_DataPtr(arr);
+  if (packed && upb_IsLittleEndian()) {
+    sink_writebytes(e, data, n * elem_size);
+    return;
+  }
+  const uint32_t number = upb_MiniTableField_Number(f);
+  for (size_t i = 0; i < n; i++) {
+    if (!packed) sink_writetag(e, number, wire_type);
+    if (elem_size == 8) {
+      sink_writefixed64(e, data + i * 8);
+    } else {
+      sink_writefixed32(e, data + i * 4);
+    }
+  }
+}
+
+static void sink_writearray(upb_SinkEncoder* e, const upb_Message* msg,
+                            const upb_MiniTableField* f) {
+  const upb_Array* arr = *UPB_PTR_AT(msg, f->UPB_PRIVATE(offset), upb_Array*);
+  if (arr == NULL || upb_Array_Size(arr) == 0) return;
+
+  const size_t n = upb_Array_Size(arr);
+  const char* data = upb_Array_DataPtr(arr);
+  const upb_FieldType type = f->UPB_PRIVATE(descriptortype);
+  const uint32_t number = upb_MiniTableField_Number(f);
+  const bool packed = upb_MiniTableField_IsPacked(f);
+  if (packed) {
+    sink_writetag(e, number, kUpb_WireType_Delimited);
+    sink_writevarint(e, sink_nextlength(e));
+  }
+
+  switch (type) {
+    case kUpb_FieldType_Double:
+    case kUpb_FieldType_SFixed64:
+    case kUpb_FieldType_Fixed64:
+      sink_writefixedarray(e, arr, f, 8, packed, kUpb_WireType_64Bit);
+      return;
+    case kUpb_FieldType_Float:
+    case kUpb_FieldType_Fixed32:
+    case kUpb_FieldType_SFixed32:
+      sink_writefixedarray(e, arr, f, 4, packed, kUpb_WireType_32Bit);
+      return;
+    case kUpb_FieldType_String:
+    case kUpb_FieldType_Bytes: {
+      const upb_StringView* strs = (const upb_StringView*)data;
+      for (size_t i = 0; i < n; i++) {
+        sink_writetag(e, number, kUpb_WireType_Delimited);
+        sink_writevarint(e, strs[i].size);
+        sink_writebytes(e, strs[i].data, strs[i].size);
+      }
+      return;
+    }
+    case kUpb_FieldType_Group: {
+      const upb_Message* const* msgs = (const upb_Message* const*)data;
+      const upb_MiniTable* subm = upb_MiniTable_GetSubMessageTable(f);
+      for (size_t i = 0; i < n; i++) {
+        sink_writetag(e, number, kUpb_WireType_StartGroup);
+        sink_writemsg(e, msgs[i], subm);
+        sink_writetag(e, number, kUpb_WireType_EndGroup);
+      }
+      return;
+    }
+    case kUpb_FieldType_Message: {
+      const upb_Message* const* msgs = (const upb_Message* const*)data;
+      const upb_MiniTable* subm = upb_MiniTable_GetSubMessageTable(f);
+      for (size_t i = 0; i < n; i++) {
+        sink_writetag(e, number, kUpb_WireType_Delimited);
+        sink_writesubmsg(e, msgs[i], subm);
+      }
+      return;
+    }
+    default: {
+      const size_t elem_size = (size_t)1
+                               << UPB_PRIVATE(_upb_Array_ElemSizeLg2)(arr);
+      for (size_t i = 0; i < n; i++) {
+        if (!packed) sink_writetag(e, number, kUpb_WireType_Varint);
+        sink_writevarint(e, sink_varintval(data + i * elem_size, type));
+      }
+      return;
+    }
+  }
+}
+
+static void sink_writemap(upb_SinkEncoder* e, const upb_Message* msg,
+                          const upb_MiniTableField* f) {
+  const upb_Map* map = *UPB_PTR_AT(msg, f->UPB_PRIVATE(offset), const upb_Map*);
+  const upb_MiniTable* layout = upb_MiniTable_MapEntrySubMessage(f);
+  if (!map || !upb_Map_Size(map)) return;
+
+  const upb_MiniTableField* key_field = upb_MiniTable_MapKey(layout);
+  const upb_MiniTableField* val_field = upb_MiniTable_MapValue(layout);
+  const uint32_t number = upb_MiniTableField_Number(f);
+  upb_SinkMapIter it;
+  upb_MapEntry ent;
+  sink_mapiter_begin(e, &it, map, layout);
+  while (sink_mapiter_next(e, &it, &ent)) {
+    sink_writetag(e, number, kUpb_WireType_Delimited);
+    sink_writevarint(e, sink_nextlength(e));
+    sink_writescalar(e, &ent.k, key_field);
+    sink_writescalar(e, &ent.v, val_field);
+  }
+  sink_mapiter_end(e, &it);
+}
+
+static void sink_writefield(upb_SinkEncoder* e, const upb_Message* msg,
+                            const upb_MiniTableField* f) {
+  switch (UPB_PRIVATE(_upb_MiniTableField_Mode)(f)) {
+    case kUpb_FieldMode_Array:
+      sink_writearray(e, msg, f);
+      return;
+    case kUpb_FieldMode_Map:
+      sink_writemap(e, msg, f);
+      return;
+    case kUpb_FieldMode_Scalar:
+      sink_writescalar(e, UPB_PTR_AT(msg, f->UPB_PRIVATE(offset), void), f);
+      return;
+    default:
+      UPB_UNREACHABLE();
+  }
+}
+
+static void sink_writeext(upb_SinkEncoder* e, const upb_MiniTableExtension* ext,
+                          upb_MessageValue ext_val, bool is_message_set) {
+  if (UPB_UNLIKELY(is_message_set)) {
+    sink_writetag(e, kUpb_MsgSet_Item, kUpb_WireType_StartGroup);
+    sink_writetag(e, kUpb_MsgSet_TypeId, kUpb_WireType_Varint);
+    sink_writevarint(e, upb_MiniTableExtension_Number(ext));
+    sink_writetag(e, kUpb_MsgSet_Message, kUpb_WireType_Delimited);
+    sink_writesubmsg(e, ext_val.msg_val,
+                     upb_MiniTableExtension_GetSubMessage(ext));
+    sink_writetag(e, kUpb_MsgSet_Item, kUpb_WireType_EndGroup);
+    return;
+  }
+  sink_writefield(e, &ext_val.UPB_PRIVATE(ext_msg_val),
+                  &ext->UPB_PRIVATE(field));
+}
+
+static void sink_writemsg(upb_SinkEncoder* e, const upb_Message* msg,
+                          const upb_MiniTable* m) {
+  const upb_StringView* encoding = sink_verbatim(e, msg);
+  if (encoding) {
+    sink_writebytes(e, encoding->data, encoding->size);
+    return;
+  }
+
+  const upb_MiniTableField* f = &m->UPB_PRIVATE(fields)[0];
+  const upb_MiniTableField* end = f + upb_MiniTable_FieldCount(m);
+  for (; f != end; f++) {
+    if (UPB_PRIVATE(_upb_Message_FieldIsSet)(msg, f)) {
+      sink_writefield(e, msg, f);
+    }
+  }
+
+  const upb_Message_Internal* in = UPB_PRIVATE(_upb_Message_GetInternal)(msg);
+  if (!in) return;
+  const bool is_message_set = sink_ismessageset(m);
+
+  if (UPB_PRIVATE(_upb_MiniTable_ExtModeBase)(m) !=
+      kUpb_ExtMode_NonExtendable) {
+    upb_SinkExtIter it;
+    const upb_MiniTableExtension* ext;
+    upb_MessageValue ext_val;
+    sink_extiter_begin(e, &it, msg, in);
+    while (sink_extiter_next(e, &it, &ext, &ext_val)) {
+      sink_writeext(e, ext, ext_val, is_message_set);
+    }
+    sink_extiter_end(e, &it);
+  }
+
+  if (e->options & kUpb_EncodeOption_SkipUnknown) return;
+  for (size_t i = 0; i < in->size; i++) {
+    upb_TaggedAuxPtr tagged_ptr = in->aux_data[i];
+    if (upb_TaggedAuxPtr_IsUnknownStringView(tagged_ptr)) {
+      const upb_StringView* unknown =
+          upb_TaggedPtrAux_StringViewRepr(tagged_ptr);
+      sink_writebytes(e, unknown->data, unknown->size);
+    } else if (upb_TaggedAuxPtr_IsNonCanonicalExtension(tagged_ptr)) {
+      const upb_Extension* ext =
+          upb_TaggedAuxPtr_NonCanonicalExtension(tagged_ptr);
+      sink_writeext(e, ext->ext, ext->data, is_message_set);
+    }
+  }
+}
+
+/* Entry points ***************************************************************/
+
+static void sink_init(upb_SinkEncoder* e, jmp_buf* err, int options,
+                      upb_Arena* arena) {
+  memset(e, 0, sizeof(*e));
+  e->status = kUpb_EncodeStatus_Ok;
+  e->err = err;
+  e->options = options;
+  e->depth = upb_EncodeOptions_GetEffectiveMaxDepth(options);
+  e->arena = arena;
+  _upb_mapsorter_init(&e->sorter);
+}
+
+upb_EncodeStatus UPB_PRIVATE(_upb_Encode_Size)(const upb_Message* msg,
+                                               const upb_MiniTable* l,
+                                               int options, size_t* size) {
+  upb_SinkEncoder e;
+  jmp_buf err;
+  sink_init(&e, &err, options, NULL);
+  *size = 0;
+  if (UPB_SETJMP(err) == 0) {
+    *size = sink_sizemsg(&e, msg, l);
+  }
+  _upb_mapsorter_destroy(&e.sorter);
+  return e.status;
+}
+
+upb_EncodeStatus UPB_PRIVATE(_upb_EncodeToSink)(const upb_Message* msg,
+                                                const upb_MiniTable* l,
+                                                int options, upb_Arena* arena,
+                                                size_t chunk_size,
+                                                upb_EncodeSinkFunc* sink,
+                                                void* closure) {
+  upb_SinkEncoder e;
+  jmp_buf err;
+  sink_init(&e, &err, options, arena);
+  e.sink = sink;
+  e.closure = closure;
+  if (chunk_size == 0) chunk_size = kUpb_SinkEncoder_DefaultChunkSize;
+  chunk_size = UPB_MAX(chunk_size, kUpb_SinkEncoder_MinChunkSize);
+
+  if (UPB_SETJMP(err) == 0) {
+    // A non-NULL array turns on recording of lengths in the size pass.
+    e.lengths = upb_Arena_Malloc(arena, 128 * sizeof(*e.lengths));
+    e.buf = upb_Arena_Malloc(arena, chunk_size);
+    if (!e.lengths || !e.buf) sink_err(&e, kUpb_EncodeStatus_OutOfMemory);
+    e.lengths_cap = 128;
+    e.ptr = e.buf;
+    e.end = e.buf + chunk_size;
+
+    sink_sizemsg(&e, msg, l);
+    sink_writemsg(&e, msg, l);
+    UPB_ASSERT(e.lengths_pos == e.lengths_count);
+    sink_flush(&e);
+  }
+  _upb_mapsorter_destroy(&e.sorter);
+  return e.status;
+}
@@ -732,6 +732,19 @@ char* encode_message(char* ptr, upb_encstate* e, const upb_Message* msg,
                      const upb_MiniTable* m, size_t* size) {
   size_t pre_len = upb_BackAlloc_Size(&e->alloc, ptr);
 
+  // A message frozen since it was parsed with kUpb_DecodeOption_RetainEncoding
+  // is unchanged, so its input bytes can be emitted verbatim unless the
+  // options ask for a transformation of them.
+  const upb_StringView* encoding = UPB_PRIVATE(_upb_Message_GetEncoding)(msg);
+  if (UPB_UNLIKELY(encoding) &&
+      !(e->options &
+        (kUpb_EncodeOption_Deterministic | kUpb_EncodeOption_SkipUnknown |
+         kUpb_EncodeOption_CheckRequired))) {
+    ptr = encode_bytes(ptr, e, encoding->data, encoding->size);
+    *size = encoding->size;
+    return ptr;
+  }
+
   if (e->options & kUpb_EncodeOption_CheckRequired) {
     if (m->UPB_PRIVATE(required_count)) {
       if (!UPB_PRIVATE(_upb_Message_IsInitializedShallow)(msg, m)) {
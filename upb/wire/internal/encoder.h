@@ -74,6 +74,19 @@ upb_EncodeStatus UPB_PRIVATE(_upb_Encode_Extension)(
     upb_MessageValue ext_val, bool is_message_set, char** buf, size_t* size,
     int options);
 
+// Computes the size of the encoding of `msg` without producing it.
+upb_EncodeStatus UPB_PRIVATE(_upb_Encode_Size)(const upb_Message* msg,
+                                               const upb_MiniTable* l,
+                                               int options, size_t* size);
+
+// Implements upb_EncodeToSink().
+upb_EncodeStatus UPB_PRIVATE(_upb_EncodeToSink)(const upb_Message* msg,
+                                                const upb_MiniTable* l,
+                                                int options, upb_Arena* arena,
+                                                size_t chunk_size,
+                                                upb_EncodeSinkFunc* sink,
+                                                void* closure);
+
 char* encode_message(char* ptr, upb_encstate* e, const upb_Message* msg,
                      const upb_MiniTable* m, size_t* size);
 
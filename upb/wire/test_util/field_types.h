@@ -297,7 +297,7 @@ struct Group {
   using Value = std::string;
   static constexpr upb_FieldType kFieldType = kUpb_FieldType_Group;
   static constexpr absl::string_view kName = "Group";
-  static constexpr upb_DecodeFast_Type kFastType = kUpb_DecodeFast_Message;
+  static constexpr upb_DecodeFast_Type kFastType = kUpb_DecodeFast_Group;
 
   static wire_types::WireValue WireValue(std::string value) {
     return wire_types::Delimited(value);
@@ -29,6 +29,7 @@ static const google__protobuf__compiler__Version_msg_init_Fields google_protobuf
 const upb_MiniTable google__protobuf__compiler__Version_msg_init = {
   &google_protobuf_compiler_Version__fields.fields[0],
   UPB_SIZE(32, 40), 4, kUpb_ExtMode_NonExtendable, 4, UPB_FASTTABLE_MASK(56), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.compiler.Version",
 #endif
@@ -65,6 +66,7 @@ static const google__protobuf__compiler__CodeGeneratorRequest_msg_init_Fields go
 const upb_MiniTable google__protobuf__compiler__CodeGeneratorRequest_msg_init = {
   &google_protobuf_compiler_CodeGeneratorRequest__fields.fields[0],
   UPB_SIZE(40, 64), 5, kUpb_ExtMode_NonExtendable, 3, UPB_FASTTABLE_MASK(248), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.compiler.CodeGeneratorRequest",
 #endif
@@ -123,6 +125,7 @@ static const google__protobuf__compiler__CodeGeneratorResponse_msg_init_Fields g
 const upb_MiniTable google__protobuf__compiler__CodeGeneratorResponse_msg_init = {
   &google_protobuf_compiler_CodeGeneratorResponse__fields.fields[0],
   UPB_SIZE(40, 56), 5, kUpb_ExtMode_NonExtendable, 4, UPB_FASTTABLE_MASK(120), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.compiler.CodeGeneratorResponse",
 #endif
@@ -164,6 +167,7 @@ static const google__protobuf__compiler__CodeGeneratorResponse__File_msg_init_Fi
 const upb_MiniTable google__protobuf__compiler__CodeGeneratorResponse__File_msg_init = {
   &google_protobuf_compiler_CodeGeneratorResponse_File__fields.fields[0],
   UPB_SIZE(40, 72), 4, kUpb_ExtMode_NonExtendable, 2, UPB_FASTTABLE_MASK(248), 0,
+  NULL,
 #ifdef UPB_TRACING_ENABLED
   "google.protobuf.compiler.CodeGeneratorResponse.File",
 #endif
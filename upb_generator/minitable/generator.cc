@@ -224,8 +224,53 @@ void WriteMessage(upb::MessageDefPtr message, const DefPoolPair& pools,
     output("}};\n\n");
   }
 
+  // The index is platform-independent, and upb_MiniTable_Build() has already
+  // computed it for us.
+  std::string field_index_ref = "NULL";
+  const upb_MiniTableFieldIndex* field_index =
+      mt_64->UPB_PRIVATE(field_index);
+  if (field_index) {
+    std::string field_index_name =
+        MiniTableFieldIndexVarName(message.full_name());
+    size_t data_size = field_index->UPB_PRIVATE(bucket_count) +
+                       field_index->UPB_PRIVATE(slot_mask) + 1;
+    output("static const uint16_t $0_data[$1] = {\n", field_index_name,
+           data_size);
+    for (size_t i = 0; i < data_size; i += 8) {
+      std::string line = " ";
+      for (size_t j = i; j < i + 8 && j < data_size; j++) {
+        absl::StrAppend(&line, " 0x",
+                        absl::Hex(field_index->UPB_PRIVATE(data)[j],
+                                  absl::kZeroPad4),
+                        ",");
+      }
+      output("$0\n", line);
+    }
+    output("};\n\n");
+    output("static const upb_MiniTableFieldIndex $0 = {\n", field_index_name);
+    output("  &$0_data[0], UINT64_C(0x$1), $2, $3, $4,\n", field_index_name,
+           absl::Hex(field_index->UPB_PRIVATE(mul), absl::kZeroPad16),
+           field_index->UPB_PRIVATE(bucket_count),
+           field_index->UPB_PRIVATE(slot_mask),
+           field_index->UPB_PRIVATE(bucket_shift));
+    output("};\n\n");
+    field_index_ref = "&" + field_index_name;
+  }
+
   upb_DecodeFast_TableEntry table_entries[32];
-  int table_size = upb_DecodeFast_BuildTable(mt_64, table_entries);
+  std::vector<uint64_t> field_weights;
+  if (!options.fasttable_profile.empty()) {
+    field_weights.resize(field_count);
+    for (int i = 0; i < field_count; i++) {
+      auto it = options.fasttable_profile.find(
+          {std::string(message.full_name()),
+           upb_MiniTableField_Number(&mt_64->UPB_PRIVATE(fields)[i])});
+      if (it != options.fasttable_profile.end()) field_weights[i] = it->second;
+    }
+  }
+  int table_size = upb_DecodeFast_BuildTableWithProfile(
+      mt_64, field_weights.empty() ? nullptr : field_weights.data(),
+      table_entries);
   uint8_t table_mask = upb_DecodeFast_GetTableMask(table_size);
 
   std::string msgext = "kUpb_ExtMode_NonExtendable";
@@ -245,6 +290,7 @@ void WriteMessage(upb::MessageDefPtr message, const DefPoolPair& pools,
          mt_64->UPB_PRIVATE(field_count), msgext,
          mt_64->UPB_PRIVATE(dense_below), table_mask,
          mt_64->UPB_PRIVATE(required_count));
+  output("  $0,\n", field_index_ref);
   output("#ifdef UPB_TRACING_ENABLED\n");
   output("  \"$0\",\n", message.full_name());
   output("#endif\n");
@@ -5,6 +5,11 @@
 // license that can be found in the LICENSE file or at
 // https://developers.google.com/open-source/licenses/bsd
 
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
 #include "google/protobuf/compiler/code_generator.h"
 #include "upb/reflection/def.hpp"
 #include "upb_generator/common.h"
@@ -17,6 +22,12 @@ struct MiniTableOptions {
   bool bootstrap = false;
   bool one_output_per_message = false;
   bool strip_nonfunctional_codegen = false;
+
+  // Observed decode counts keyed by (message full name, field number), as
+  // loaded from a `fasttable_profile=<file>` parameter.  When fields compete
+  // for the same fasttable slot, the field with the higher count wins.
+  absl::flat_hash_map<std::pair<std::string, uint32_t>, uint64_t>
+      fasttable_profile;
 };
 
 void WriteMiniTableSource(const DefPoolPair& pools, upb::FileDefPtr file,
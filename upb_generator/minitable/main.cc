@@ -6,6 +6,8 @@
 // https://developers.google.com/open-source/licenses/bsd
 
 #include <cstdint>
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -60,6 +62,36 @@ void GenerateFile(const DefPoolPair& pools, upb::FileDefPtr file,
   }
 }
 
+// Reads a fasttable profile, as produced from upb_DecodeStats_NextField() and
+// upb_DefPool_FindMessageByMiniTable() (see upb/wire/decode.h). Each non-empty
+// line is "<message full name> <field number> <count>"; lines starting with
+// '#' are ignored.
+bool ParseFasttableProfile(MiniTableOptions* options, const std::string& path,
+                           std::string* error) {
+  std::ifstream in(path);
+  if (!in) {
+    *error = absl::Substitute("Unable to open fasttable profile: $0", path);
+    return false;
+  }
+  std::string line;
+  int line_number = 0;
+  while (std::getline(in, line)) {
+    line_number++;
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream fields(line);
+    std::string name;
+    uint32_t number;
+    uint64_t count;
+    if (!(fields >> name >> number >> count)) {
+      *error = absl::Substitute("Malformed fasttable profile line $0:$1: $2",
+                                path, line_number, line);
+      return false;
+    }
+    options->fasttable_profile[{name, number}] += count;
+  }
+  return true;
+}
+
 bool ParseOptions(MiniTableOptions* options, absl::string_view parameter,
                   std::string* error) {
   for (const auto& pair : ParseGeneratorParameter(parameter)) {
@@ -69,6 +101,8 @@ bool ParseOptions(MiniTableOptions* options, absl::string_view parameter,
       options->strip_nonfunctional_codegen = true;
     } else if (pair.first == "one_output_per_message") {
       options->one_output_per_message = true;
+    } else if (pair.first == "fasttable_profile") {
+      if (!ParseFasttableProfile(options, pair.second, error)) return false;
     } else {
       *error = absl::Substitute("Unknown parameter: $0", pair.first);
       return false;
@@ -41,6 +41,10 @@ std::string MiniTableFieldsVarName(absl::string_view msg_full_name) {
   return ToCIdent(msg_full_name) + "__fields";
 }
 
+std::string MiniTableFieldIndexVarName(absl::string_view msg_full_name) {
+  return ToCIdent(msg_full_name) + "__field_index";
+}
+
 std::string MiniTableSubMessagesVarName(absl::string_view msg_full_name) {
   return ToCIdent(msg_full_name) + "__submsgs";
 }
@@ -27,6 +27,7 @@ constexpr char kMessagesInit[] = "messages_layout";
 
 // Per-message static variables used in the generated .c file.
 std::string MiniTableFieldsVarName(absl::string_view msg_full_name);
+std::string MiniTableFieldIndexVarName(absl::string_view msg_full_name);
 std::string MiniTableSubMessagesVarName(absl::string_view msg_full_name);
 
 }  // namespace generator